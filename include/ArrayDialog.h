@@ -0,0 +1,66 @@
+#ifndef ARRAYDIALOG_H
+#define ARRAYDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QStackedWidget>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QVector>
+#include <gp_Trsf.hxx>
+
+/**
+ * @brief Linear, rectangular or polar array of the selected objects
+ *
+ * Produces one rigid placement per copy; the original stays where it is.
+ */
+class ArrayDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    enum Pattern {
+        LINEAR = 0,
+        RECTANGULAR = 1,
+        POLAR = 2
+    };
+    
+    explicit ArrayDialog(QWidget* parent = nullptr);
+    
+    Pattern getPattern() const;
+    QVector<gp_Trsf> getPlacements() const;
+
+private slots:
+    void updateSummary();
+
+private:
+    void setupUI();
+    void applyStyles();
+    QDoubleSpinBox* createLengthSpin(double value) const;
+    
+    QComboBox* m_patternCombo;
+    QStackedWidget* m_pages;
+    
+    // Linear: copies along one vector
+    QSpinBox* m_linearCount;
+    QDoubleSpinBox* m_linearDx;
+    QDoubleSpinBox* m_linearDy;
+    QDoubleSpinBox* m_linearDz;
+    
+    // Rectangular: columns x rows in the XY plane, original at the first corner
+    QSpinBox* m_columnCount;
+    QSpinBox* m_rowCount;
+    QDoubleSpinBox* m_columnSpacing;
+    QDoubleSpinBox* m_rowSpacing;
+    
+    // Polar: copies rotated about a vertical axis
+    QSpinBox* m_polarCount;
+    QDoubleSpinBox* m_centerX;
+    QDoubleSpinBox* m_centerY;
+    QDoubleSpinBox* m_angleStep;
+    
+    QLabel* m_summaryLabel;
+};
+
+#endif // ARRAYDIALOG_H
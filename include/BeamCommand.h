@@ -33,6 +33,7 @@ public:
 
 private:
     TopoDS_Shape createBeam(const gp_Pnt& start, const gp_Pnt& end);
+    void buildOutline();
     
     QList<gp_Pnt> m_points;
     double m_width;
@@ -7,6 +7,7 @@
 #include <TopoDS_Shape.hxx>
 #include <AIS_InteractiveContext.hxx>
 #include <AIS_Shape.hxx>
+#include "PreviewOutline.h"
 
 class OCCTViewer;
 
@@ -35,9 +36,14 @@ protected:
     void showPreview(const TopoDS_Shape& shape);
     void clearPreview();
     
+    // Rubber-band preview: subclasses fill m_outline once, then every move
+    // only repositions it
+    void showOutline(const gp_GTrsf& placement);
+    
     Handle(AIS_InteractiveContext) m_context;
     OCCTViewer* m_viewer;
     Handle(AIS_Shape) m_previewShape;
+    Handle(PreviewOutline) m_outline;
     bool m_active;
 };
 
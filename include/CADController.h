@@ -7,6 +7,7 @@
 #include "CADCommand.h"
 #include "WorkPlane.h"
 #include "SnapManager.h"
+#include "SnapService.h"
 #include "OCCTViewer.h"
 
 class TObjectCollection;
@@ -38,6 +39,17 @@ public:
     void setWorkPlaneVisible(bool visible);
     bool isWorkPlaneVisible() const { return m_showWorkPlane; }
     
+    // Structural grid on the work plane
+    void setGrid(const StructuralGrid& grid);
+    const StructuralGrid& getGrid() const { return m_workPlane.getGrid(); }
+    void setGridVisible(bool visible);
+    bool isGridVisible() const { return m_showGrid; }
+    
+    // Columns at every intersection of the given U and V axes (indices into
+    // the grid), added to the collection in one batch. Returns the count.
+    int placeColumnsAtGrid(const QVector<int>& uAxes, const QVector<int>& vAxes,
+                           double width, double depth, double height);
+    
     // Snap management
     SnapManager* getSnapManager() { return &m_snapManager; }
     void setSnapEnabled(bool enabled) { m_snapEnabled = enabled; }
@@ -45,20 +57,28 @@ public:
     void showSnapMarker(const gp_Pnt& point, int snapType, const QString& label);
     void hideSnapMarker();
     
+    // Asynchronous snapping for mouse moves: the query runs on a worker and the
+    // newest answer updates marker and preview. cursorPoint is the unsnapped point.
+    void requestSnap(int x, int y, const gp_Pnt& cursorPoint, const Handle(V3d_View)& view);
+    void cancelSnap();
+    
     // Access current command
     CADCommand* getCurrentCommand() const { return m_activeCommand; }
     
 signals:
     void statusMessage(const QString& message);
     void commandChanged(const QString& commandName);
+    void snapUpdated(const SnapManager::SnapPoint& snap);   // type None when nothing snapped
     
 private slots:
     void onCommandCompleted(const TopoDS_Shape& shape);
     void onCommandCancelled();
     void onStatusUpdate(const QString& message);
+    void onSnapCandidates(int serial, const QList<SnapManager::SnapPoint>& ranked);
     
 private:
     void setActiveCommand(CADCommand* command);
+    void updateGridVisual();
     
     Handle(AIS_InteractiveContext) m_context;
     OCCTViewer* m_viewer;
@@ -70,8 +90,15 @@ private:
     Handle(AIS_Shape) m_workPlaneVisual;
     bool m_showWorkPlane;
     
+    // Structural grid
+    Handle(AIS_Shape) m_gridVisual;
+    QList<Handle(AIS_TextLabel)> m_gridLabels;
+    bool m_showGrid;
+    
     // Snap system
     SnapManager m_snapManager;
+    SnapService* m_snapService;
+    gp_Pnt m_snapCursor;        // Unsnapped point of the newest request
     bool m_snapEnabled;
 };
 
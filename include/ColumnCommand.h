@@ -18,10 +18,14 @@ public:
     QString getPrompt() const override;
     
     void setDimensions(double width, double depth, double height);
+    
+    // Parameters of the last placed column, read by the controller on completion
+    gp_Pnt getLastBasePoint() const { return m_basePoint; }
+    double getWidth() const { return m_width; }
+    double getDepth() const { return m_depth; }
+    double getHeight() const { return m_height; }
 
 private:
-    TopoDS_Shape createColumn(const gp_Pnt& basePoint);
-    
     gp_Pnt m_basePoint;
     bool m_pointSet;
     double m_width;
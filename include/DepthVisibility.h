@@ -0,0 +1,46 @@
+#ifndef DEPTHVISIBILITY_H
+#define DEPTHVISIBILITY_H
+
+#include <V3d_View.hxx>
+#include <Image_PixMap.hxx>
+#include <Graphic3d_WorldViewProjState.hxx>
+#include <gp_Pnt.hxx>
+#include <vector>
+
+/**
+ * @brief Occlusion test for snap candidates against the rendered depth buffer
+ *
+ * The view's depth buffer is read back once per camera state (or after
+ * invalidate() when the scene changed). Each candidate is then projected
+ * and compared against the stored depth, so testing costs no ray casts.
+ */
+class DepthVisibility
+{
+public:
+    DepthVisibility();
+    
+    // Forget the stored depth, e.g. after objects were added or changed
+    void invalidate() { m_valid = false; }
+    
+    // Read the depth buffer back if the camera or viewport changed.
+    // Returns false if no depth is available; everything is then visible.
+    bool update(const Handle(V3d_View)& view);
+    
+    // visible[i] = 1 unless points[i] lies behind rendered geometry
+    void classify(const Handle(V3d_View)& view, const std::vector<gp_Pnt>& points,
+                  std::vector<char>& visible);
+    bool isVisible(const Handle(V3d_View)& view, const gp_Pnt& point);
+
+private:
+    // Farthest depth in the 3x3 pixels around (col, row), so edges on a silhouette pass
+    float sampleDepth(int col, int row) const;
+    
+    Image_PixMap m_depth;
+    Graphic3d_WorldViewProjState m_state;
+    int m_width;
+    int m_height;
+    bool m_valid;
+    bool m_failed;      // Readback unsupported for this state; don't retry every query
+};
+
+#endif // DEPTHVISIBILITY_H
@@ -0,0 +1,92 @@
+#ifndef DIMENSIONOVERLAY_H
+#define DIMENSIONOVERLAY_H
+
+#include "StructuralGrid.h"
+#include <AIS_InteractiveContext.hxx>
+#include <AIS_InteractiveObject.hxx>
+#include <Graphic3d_WorldViewProjState.hxx>
+#include <V3d_View.hxx>
+#include <gp_Ax3.hxx>
+#include <gp_Pnt.hxx>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QVector>
+
+class TObjectCollection;
+
+/**
+ * @brief Automatic dimensions: beam lengths, grid spacings and member offsets
+ *
+ * What to measure is kept per object and recomputed only for objects the
+ * collection reports as added or modified. Placement (which side, how far
+ * out, which labels fit) depends on the camera and is redone once the
+ * camera comes to rest, or after an edit. The result is one segment buffer
+ * plus labels in the Topmost layer; orbiting just redraws it.
+ */
+class DimensionOverlay : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum MeasureKind {
+        LENGTH,     // Member length
+        GRID,       // Spacing between adjacent grid axes
+        OFFSET      // Member reference point to the nearest grid axis
+    };
+
+    struct Measure {
+        gp_Pnt first;
+        gp_Pnt second;
+        MeasureKind kind;
+    };
+
+    DimensionOverlay(const Handle(AIS_InteractiveContext)& context, TObjectCollection* collection,
+                     QObject* parent = nullptr);
+    ~DimensionOverlay();
+
+    void setVisible(bool visible, const Handle(V3d_View)& view);
+    bool isVisible() const { return m_visible; }
+
+    // Grid to dimension and to measure offsets from, in plane coordinates
+    void setGrid(const StructuralGrid& grid, const gp_Ax3& plane);
+
+    // Re-places the dimensions for the view's camera; cheap if nothing changed
+    void updateLayout(const Handle(V3d_View)& view);
+    int shownCount() const { return m_shownCount; }
+
+private slots:
+    void invalidate(int objectID);
+    void invalidateObjects(const QList<int>& objectIDs);
+    void clearObjects();
+
+private:
+    void scheduleLayout();
+    void measureDirtyObjects();
+    void measureGrid();
+    void addOffsets(const gp_Pnt& point, QVector<Measure>& measures) const;
+
+    Handle(AIS_InteractiveContext) m_context;
+    TObjectCollection* m_collection;
+    Handle(AIS_InteractiveObject) m_presentation;
+    Handle(V3d_View) m_view;
+    bool m_visible;
+    bool m_layoutPending;
+
+    StructuralGrid m_grid;
+    gp_Ax3 m_plane;
+    QVector<Measure> m_gridMeasures;
+    QHash<int, QVector<Measure>> m_objectMeasures;
+    QSet<int> m_dirty;
+    bool m_allDirty;
+
+    // Camera and window of the current layout
+    Graphic3d_WorldViewProjState m_layoutState;
+    int m_layoutWidth;
+    int m_layoutHeight;
+    bool m_layoutValid;
+    int m_shownCount;
+};
+
+#endif // DIMENSIONOVERLAY_H
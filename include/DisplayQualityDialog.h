@@ -0,0 +1,40 @@
+#ifndef DISPLAYQUALITYDIALOG_H
+#define DISPLAYQUALITYDIALOG_H
+
+#include <QDialog>
+#include <QDoubleSpinBox>
+#include <QCheckBox>
+#include <QMap>
+#include "TObjectCollection.h"
+
+class DisplayQualityDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DisplayQualityDialog(QWidget* parent = nullptr);
+    
+    void setQuality(TGraphicObject::ObjectType type, const TObjectCollection::DisplayQuality& quality);
+    TObjectCollection::DisplayQuality getQuality(TGraphicObject::ObjectType type) const;
+    QList<TGraphicObject::ObjectType> getTypes() const { return m_rows.keys(); }
+    
+    void setThresholds(double coarseBelowPixels, double fullAbovePixels);
+    double getCoarseBelowPixels() const { return m_coarseBelowSpin->value(); }
+    double getFullAbovePixels() const { return m_fullAboveSpin->value(); }
+
+private:
+    struct Row {
+        QDoubleSpinBox* coefficient;
+        QDoubleSpinBox* angle;      // degrees
+        QCheckBox* levelOfDetail;
+    };
+    
+    void setupUI();
+    void applyStyles();
+    
+    QMap<TGraphicObject::ObjectType, Row> m_rows;
+    QDoubleSpinBox* m_coarseBelowSpin;
+    QDoubleSpinBox* m_fullAboveSpin;
+};
+
+#endif // DISPLAYQUALITYDIALOG_H
@@ -0,0 +1,84 @@
+#ifndef DRAWINGGENERATOR_H
+#define DRAWINGGENERATOR_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <TopoDS_Shape.hxx>
+
+class TObjectCollection;
+
+/**
+ * @brief Hidden-line views of the model for general-arrangement drawings
+ *
+ * Objects outside a view's region are culled through the collection's
+ * spatial index, and each view projects what is left in one
+ * HLRBRep_PolyAlgo pass, so members hide each other; the views run in
+ * parallel. The meshed copies the projection works on are cached per
+ * object until it changes, so regenerating after editing one beam meshes
+ * only that beam.
+ */
+class DrawingGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum ViewDirection {
+        TOP,        // Looking down -Z, X to the right
+        FRONT,      // Looking along +Y, X to the right
+        SIDE,       // Looking along -X, Y to the right
+        VIEW_COUNT
+    };
+
+    struct Line {
+        double x1, y1, x2, y2;      // View plane coordinates [mm]
+    };
+
+    struct View {
+        ViewDirection direction;
+        double min[3];              // Model region drawn, everything by default
+        double max[3];
+        QVector<Line> visible;
+        QVector<Line> hidden;
+        int objectCount;
+
+        explicit View(ViewDirection dir = TOP);
+    };
+
+    struct Options {
+        double deflection;      // Chordal deflection of the projected mesh [mm]
+        double angle;           // Angular deflection [rad]
+
+        Options() : deflection(1.0), angle(0.35) {}
+    };
+
+    explicit DrawingGenerator(TObjectCollection* collection, const Options& options = Options(),
+                              QObject* parent = nullptr);
+
+    // Meshes the objects missing from the cache and projects each view
+    void generate(QVector<View>& views);
+    void clearCache();
+    int meshedCount() const { return m_meshedCount; }    // Objects meshed by the last generate()
+
+    // Writes the views side by side as an R12 DXF, visible and hidden lines on separate layers
+    static bool writeDxf(const QVector<View>& views, const QString& fileName, QString* error = nullptr);
+
+private slots:
+    void invalidate(int objectID);
+    void invalidateObjects(const QList<int>& objectIDs);
+
+private:
+    struct MeshedCopy {
+        TopoDS_Shape source;        // Object shape the copy was made from
+        TopoDS_Shape copy;          // Own B-rep with the drawing's mesh
+    };
+
+    TObjectCollection* m_collection;
+    Options m_options;
+    QHash<int, MeshedCopy> m_meshes;
+    int m_meshedCount;
+};
+
+#endif // DRAWINGGENERATOR_H
@@ -0,0 +1,78 @@
+#ifndef EDGESNAPINDEX_H
+#define EDGESNAPINDEX_H
+
+#include <TopoDS_Shape.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Lin.hxx>
+#include <vector>
+
+/**
+ * @brief Bounding volume hierarchy over the edges of one shape
+ *
+ * Straight edges are stored as a single segment and projected exactly;
+ * curved edges are discretised once to the given deflection. Queries take
+ * the pick ray through the cursor and a world-space tolerance, so only the
+ * few leaves near the ray are visited.
+ */
+class EdgeSnapIndex
+{
+public:
+    struct Segment {
+        gp_Pnt a;
+        gp_Pnt b;
+        bool interior;      // Runs inside the solid (a centreline); exempt from occlusion tests
+    };
+    
+    struct Hit {
+        bool valid;
+        gp_Pnt point;           // Closest point on the segment
+        double rayDistance;     // Distance from the pick ray [world units]
+        int segment;
+        
+        Hit() : valid(false), rayDistance(1e100), segment(-1) {}
+    };
+    
+    EdgeSnapIndex();
+    
+    // Collect segments, then build() once before querying
+    void addShape(const TopoDS_Shape& shape, double deflection);
+    void addSegment(const gp_Pnt& a, const gp_Pnt& b, bool interior = false);
+    void build();
+    
+    bool isEmpty() const { return m_segments.empty(); }
+    int segmentCount() const { return static_cast<int>(m_segments.size()); }
+    const Segment& segment(int index) const { return m_segments[index]; }
+    
+    // Closest segment to the ray within tolerance
+    Hit nearest(const gp_Lin& ray, double tolerance) const;
+    
+    // All segments passing within tolerance of the ray
+    void collect(const gp_Lin& ray, double tolerance, std::vector<int>& result) const;
+    
+    // Closest point of segment index to the ray; returns the distance
+    double closestToRay(int index, const gp_Lin& ray, gp_Pnt& point) const;
+    
+    // Does the infinite ray pass within tolerance of the box?
+    static bool rayNearBox(const gp_Lin& ray, const double min[3], const double max[3], double tolerance);
+
+private:
+    struct Node {
+        double min[3];
+        double max[3];
+        int left;       // Children, -1 for leaves
+        int right;
+        int first;      // Leaves: range in m_order
+        int count;
+    };
+    
+    int buildNode(int begin, int end);
+    
+    template <typename Visitor>
+    void traverse(const gp_Lin& ray, double tolerance, Visitor visit) const;
+    
+    std::vector<Segment> m_segments;
+    std::vector<int> m_order;       // Segment indices, grouped by leaf
+    std::vector<Node> m_nodes;
+};
+
+#endif // EDGESNAPINDEX_H
@@ -0,0 +1,37 @@
+#ifndef GEOMETRYCACHE_H
+#define GEOMETRYCACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <TopoDS_Shape.hxx>
+
+/**
+ * @brief Local part shapes keyed by TGraphicObject::GetGeometryHash()
+ *
+ * Objects with the same hash take the cached shape under their own location,
+ * so they share one TShape: the B-rep is built once and the triangulation
+ * meshed for one of them serves all. Safe to use from worker threads.
+ */
+class GeometryCache
+{
+public:
+    static GeometryCache& instance();
+    
+    TopoDS_Shape find(quint64 hash) const;     // Null if not cached
+    // Stores localShape unless the hash is already cached, and returns the
+    // cached shape: threads that built the same part concurrently all end up
+    // sharing the first one stored
+    TopoDS_Shape findOrInsert(quint64 hash, const TopoDS_Shape& localShape);
+    void clear();
+    int size() const;
+
+private:
+    GeometryCache() = default;
+    GeometryCache(const GeometryCache&) = delete;
+    GeometryCache& operator=(const GeometryCache&) = delete;
+    
+    mutable QMutex m_mutex;
+    QHash<quint64, TopoDS_Shape> m_shapes;
+};
+
+#endif // GEOMETRYCACHE_H
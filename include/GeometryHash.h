@@ -0,0 +1,47 @@
+#ifndef GEOMETRYHASH_H
+#define GEOMETRYHASH_H
+
+#include <QString>
+#include <QtGlobal>
+#include <cmath>
+
+/**
+ * @brief Incremental 64-bit FNV-1a over the parameters that define a part
+ *
+ * Lengths are rounded to LengthQuantum before hashing, so members that differ
+ * only by floating-point noise from their placement hash the same.
+ */
+class GeometryHash
+{
+public:
+    static constexpr double LengthQuantum = 0.1;   // mm
+    
+    GeometryHash() : m_hash(14695981039346656037ull) {}
+    
+    GeometryHash& addBytes(const void* data, int size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (int i = 0; i < size; ++i) {
+            m_hash ^= bytes[i];
+            m_hash *= 1099511628211ull;
+        }
+        return *this;
+    }
+    
+    GeometryHash& add(qint64 value) { return addBytes(&value, sizeof(value)); }
+    GeometryHash& add(int value) { return add(static_cast<qint64>(value)); }
+    GeometryHash& addLength(double mm) { return add(static_cast<qint64>(std::llround(mm / LengthQuantum))); }
+    GeometryHash& add(const QString& text)
+    {
+        add(text.size());
+        return addBytes(text.constData(), text.size() * static_cast<int>(sizeof(QChar)));
+    }
+    
+    // 0 is reserved for "no hash"
+    quint64 value() const { return m_hash != 0 ? m_hash : 1; }
+
+private:
+    quint64 m_hash;
+};
+
+#endif // GEOMETRYHASH_H
@@ -0,0 +1,43 @@
+#ifndef GLTFEXPORTER_H
+#define GLTFEXPORTER_H
+
+#include "TGraphicObject.h"
+#include <NCollection_Sequence.hxx>
+#include <QString>
+
+/**
+ * @brief Writes graphic objects as a binary glTF 2.0 (GLB) scene
+ *
+ * Each distinct solid (shared TShape, see GeometryCache) is triangulated
+ * once, on a worker thread, and stored as one mesh; every object is a node
+ * placing that mesh. Positions are 16-bit and normals 8-bit
+ * (KHR_mesh_quantization), with the dequantization folded into the node
+ * matrices. The root node converts millimetres to metres and Z-up to the
+ * Y-up axes glTF expects.
+ */
+class GltfExporter
+{
+public:
+    struct Options {
+        double deflection;      // Chordal deflection [mm]
+        double angle;           // Angular deflection [rad]
+
+        Options() : deflection(1.0), angle(0.35) {}
+    };
+
+    explicit GltfExporter(const Options& options = Options());
+
+    bool exportObjects(const NCollection_Sequence<Handle(TGraphicObject)>& objects, const QString& fileName);
+
+    QString errorString() const { return m_error; }
+    int meshCount() const { return m_meshCount; }   // Distinct solids triangulated
+    int nodeCount() const { return m_nodeCount; }   // Objects written
+
+private:
+    Options m_options;
+    QString m_error;
+    int m_meshCount;
+    int m_nodeCount;
+};
+
+#endif // GLTFEXPORTER_H
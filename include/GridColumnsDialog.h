@@ -0,0 +1,48 @@
+#ifndef GRIDCOLUMNSDIALOG_H
+#define GRIDCOLUMNSDIALOG_H
+
+#include <QDialog>
+#include <QListWidget>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QVector>
+#include "StructuralGrid.h"
+
+/**
+ * @brief Picks grid axes and column dimensions for bulk column placement
+ *
+ * A column is placed at every intersection of the selected U and V axes.
+ */
+class GridColumnsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit GridColumnsDialog(const StructuralGrid& grid, QWidget* parent = nullptr);
+    
+    QVector<int> getUAxes() const { return selectedRows(m_uList); }
+    QVector<int> getVAxes() const { return selectedRows(m_vList); }
+    double getWidth() const { return m_widthSpin->value(); }
+    double getDepth() const { return m_depthSpin->value(); }
+    double getHeight() const { return m_heightSpin->value(); }
+
+private slots:
+    void updateCount();
+
+private:
+    void setupUI();
+    void applyStyles();
+    QListWidget* createAxisList(const StructuralGrid& grid, StructuralGrid::Direction direction);
+    static QVector<int> selectedRows(const QListWidget* list);
+    
+    QListWidget* m_uList;
+    QListWidget* m_vList;
+    QDoubleSpinBox* m_widthSpin;
+    QDoubleSpinBox* m_depthSpin;
+    QDoubleSpinBox* m_heightSpin;
+    QLabel* m_countLabel;
+    QPushButton* m_okButton;
+};
+
+#endif // GRIDCOLUMNSDIALOG_H
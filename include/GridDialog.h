@@ -0,0 +1,42 @@
+#ifndef GRIDDIALOG_H
+#define GRIDDIALOG_H
+
+#include <QDialog>
+#include <QLineEdit>
+#include <QDoubleSpinBox>
+#include <QCheckBox>
+#include <QLabel>
+#include <QPushButton>
+#include "StructuralGrid.h"
+
+/**
+ * @brief Edits the structural grid: coordinate and label lists per direction
+ */
+class GridDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit GridDialog(const StructuralGrid& grid, bool visible, QWidget* parent = nullptr);
+    
+    StructuralGrid getGrid() const;
+    bool isGridVisible() const;
+
+private slots:
+    void validateInput();
+
+private:
+    void setupUI();
+    void applyStyles();
+    
+    QLineEdit* m_uCoordinatesEdit;
+    QLineEdit* m_uLabelsEdit;
+    QLineEdit* m_vCoordinatesEdit;
+    QLineEdit* m_vLabelsEdit;
+    QDoubleSpinBox* m_extensionSpin;
+    QCheckBox* m_visibleCheck;
+    QLabel* m_errorLabel;
+    QPushButton* m_okButton;
+};
+
+#endif // GRIDDIALOG_H
@@ -0,0 +1,88 @@
+#ifndef IFCEXPORTER_H
+#define IFCEXPORTER_H
+
+#include "TGraphicObject.h"
+#include <NCollection_Sequence.hxx>
+#include <QHash>
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+#include <gp_Dir.hxx>
+#include <gp_Pnt.hxx>
+
+class TBeam;
+
+/**
+ * @brief Writes beams, columns and slabs as an IFC4 physical file
+ *
+ * Members become IfcBeam/IfcColumn/IfcSlab with an IfcExtrudedAreaSolid
+ * over a parametric profile (I, U, L, RHS, CHS or rectangle) taken from the
+ * section parameters rather than the B-rep. Scaled or mirrored members, whose
+ * shape no longer matches their parameters, are written as an
+ * IfcTriangulatedFaceSet of the shape instead. Material, layer and part/assembly
+ * marks go into relationships and a property set.
+ *
+ * Entities are written to disk as they are produced. Only shared entities
+ * (profiles, materials, property sets) are remembered, and relationship
+ * lists are flushed every Options::chunkSize members, so memory does not
+ * grow with the model.
+ */
+class IfcExporter
+{
+public:
+    struct Options {
+        int chunkSize;      // Members per containment/material relationship
+        double deflection;  // Chordal deflection of tessellated members [mm]
+
+        Options() : chunkSize(1000), deflection(1.0) {}
+    };
+
+    explicit IfcExporter(const Options& options = Options());
+
+    bool exportObjects(const NCollection_Sequence<Handle(TGraphicObject)>& objects, const QString& fileName);
+
+    QString errorString() const { return m_error; }
+    int elementCount() const { return m_elementCount; }    // Members written
+
+private:
+    int add(const QString& entity);     // Writes "#n=entity;" and returns n
+    void writeHeader(const QString& fileName);
+    void writeSpatialStructure();
+    bool writeElement(const Handle(TGraphicObject)& object);
+    void flushRelations();
+
+    int direction(const gp_Dir& dir);   // Shared for the principal axes
+    int axisPlacement(const gp_Pnt& origin, const gp_Dir& axis, const gp_Dir& refDirection);
+    int triangulatedFaceSet(const TopoDS_Shape& shape);    // 0 if the shape cannot be meshed
+    int beamProfile(const Handle(TBeam)& beam, QString& profileName);
+    int rectangleProfile(double xDim, double yDim);
+    int material(const QString& name);
+    int propertySet(const Handle(TGraphicObject)& object);     // 0 if the object has no marks
+
+    Options m_options;
+    QString m_error;
+    int m_elementCount;
+
+    QTextStream m_out;
+    int m_nextId;
+    int m_ownerHistory;
+    int m_bodyContext;
+    int m_storey;
+    int m_storeyPlacement;
+    int m_originPlacement;
+    int m_originPlacement2D;
+
+    // Shared entities, bounded by distinct sections, materials and marks
+    QHash<QString, int> m_directions;
+    QHash<QString, int> m_profiles;
+    QHash<QString, int> m_materials;
+    QHash<QString, int> m_propertySets;
+
+    // Relationships of the current chunk
+    QVector<int> m_contained;
+    QHash<int, QVector<int>> m_byMaterial;
+    QHash<int, QVector<int>> m_byPropertySet;
+    QHash<QString, QVector<int>> m_representationsByLayer;
+};
+
+#endif // IFCEXPORTER_H
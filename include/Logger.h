@@ -0,0 +1,147 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QString>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+/**
+ * @brief Structured logging off the interactive path
+ *
+ * Call sites only copy a record (level, category, format literal, raw
+ * arguments) into a lock-free ring buffer. A background thread formats the
+ * records and writes them to the log file and the console. When the buffer
+ * is full records are dropped and counted rather than blocking the caller.
+ *
+ * Levels below CAD_LOG_LEVEL are removed at compile time, arguments included.
+ * Formats use Qt placeholders: LOG_DEBUG("snap", "%1 candidates", n).
+ */
+
+#define CAD_LOG_LEVEL_TRACE   0
+#define CAD_LOG_LEVEL_DEBUG   1
+#define CAD_LOG_LEVEL_INFO    2
+#define CAD_LOG_LEVEL_WARNING 3
+#define CAD_LOG_LEVEL_ERROR   4
+
+#ifndef CAD_LOG_LEVEL
+#ifdef NDEBUG
+#define CAD_LOG_LEVEL CAD_LOG_LEVEL_INFO
+#else
+#define CAD_LOG_LEVEL CAD_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+class Logger
+{
+public:
+    enum Level {
+        Trace = CAD_LOG_LEVEL_TRACE,
+        Debug = CAD_LOG_LEVEL_DEBUG,
+        Info = CAD_LOG_LEVEL_INFO,
+        Warning = CAD_LOG_LEVEL_WARNING,
+        Error = CAD_LOG_LEVEL_ERROR
+    };
+
+    enum { MaxArgs = 8, TextCapacity = 96, Capacity = 4096 };    // Capacity: power of two
+
+    static Logger& instance();
+
+    // Starts the writer thread; records logged before start() wait in the buffer
+    bool start(const QString& filePath, bool console = true);
+    void stop();    // Drains the buffer and joins the writer
+    QString filePath() const { return m_filePath; }
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    template <typename... Args>
+    void write(Level level, const char* category, const char* format, const Args&... args)
+    {
+        static_assert(sizeof...(Args) <= MaxArgs, "too many log arguments");
+        Record record;
+        record.level = level;
+        record.category = category;
+        record.format = format;
+        record.argCount = 0;
+        record.textUsed = 0;
+        (pack(record, args), ...);
+        push(record);
+    }
+
+private:
+    struct Arg {
+        enum Kind { Int, UInt, Double, Text } kind;
+        quint16 textOffset;     // Text: range in Record::text
+        quint16 textLength;
+        union {
+            qint64 i;
+            quint64 u;
+            double d;
+        };
+    };
+    
+    // Plain data so a slot can be copied without allocating
+    struct Record {
+        qint64 timestamp;       // ms since epoch, taken by the producer
+        quintptr threadId;
+        Level level;
+        const char* category;   // String literals only
+        const char* format;
+        int argCount;
+        int textUsed;
+        Arg args[MaxArgs];
+        ushort text[TextCapacity];  // Copied string arguments (UTF-16), truncated when full
+    };
+
+    struct Slot {
+        std::atomic<quint64> sequence;
+        Record record;
+    };
+
+    Logger();
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Built-in integer types rather than qint64/quint64, which alias long on some platforms
+    static void pack(Record& record, long long value) { Arg& a = record.args[record.argCount++]; a.kind = Arg::Int; a.i = value; }
+    static void pack(Record& record, long value) { pack(record, static_cast<long long>(value)); }
+    static void pack(Record& record, int value) { pack(record, static_cast<long long>(value)); }
+    static void pack(Record& record, unsigned long long value) { Arg& a = record.args[record.argCount++]; a.kind = Arg::UInt; a.u = value; }
+    static void pack(Record& record, unsigned long value) { pack(record, static_cast<unsigned long long>(value)); }
+    static void pack(Record& record, unsigned value) { pack(record, static_cast<unsigned long long>(value)); }
+    static void pack(Record& record, bool value) { pack(record, value ? 1 : 0); }
+    static void pack(Record& record, double value) { Arg& a = record.args[record.argCount++]; a.kind = Arg::Double; a.d = value; }
+    static void pack(Record& record, float value) { pack(record, static_cast<double>(value)); }
+    static void pack(Record& record, const char* value);
+    static void pack(Record& record, const QString& value);
+    static Arg& packText(Record& record, int length);
+
+    void push(Record& record);
+    bool pop(Record& record);
+    void run();
+    static QString format(const Record& record);
+
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<quint64> m_head;   // Next slot producers claim
+    alignas(64) std::atomic<quint64> m_tail;   // Next slot the writer reads
+    alignas(64) std::atomic<quint64> m_dropped;
+    std::atomic<bool> m_running;
+    std::thread m_writer;
+    QString m_filePath;
+    bool m_console;
+};
+
+#define CAD_LOG(level, category, ...) \
+    do { \
+        if constexpr ((level) >= CAD_LOG_LEVEL) { \
+            Logger::instance().write(static_cast<Logger::Level>(level), category, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_TRACE(category, ...)   CAD_LOG(CAD_LOG_LEVEL_TRACE, category, __VA_ARGS__)
+#define LOG_DEBUG(category, ...)   CAD_LOG(CAD_LOG_LEVEL_DEBUG, category, __VA_ARGS__)
+#define LOG_INFO(category, ...)    CAD_LOG(CAD_LOG_LEVEL_INFO, category, __VA_ARGS__)
+#define LOG_WARNING(category, ...) CAD_LOG(CAD_LOG_LEVEL_WARNING, category, __VA_ARGS__)
+#define LOG_ERROR(category, ...)   CAD_LOG(CAD_LOG_LEVEL_ERROR, category, __VA_ARGS__)
+
+#endif // LOGGER_H
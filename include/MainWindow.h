@@ -18,8 +18,12 @@
 #include "PropertiesPanel.h"
 #include "TObjectCollection.h"
 #include "WorkPlaneDialog.h"
+#include "GridDialog.h"
 #include "SnapToolbar.h"
 
+class DimensionOverlay;
+class DrawingGenerator;
+
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -34,11 +38,13 @@ private slots:
     void onOpenProject();
     void onSaveProject();
     void onExport();
+    void onCreateDrawings();
     void onExit();
 
     // Create menu actions
     void onCreateBeam();
     void onCreateColumn();
+    void onColumnsAtGrid();
     void onCreateSlab();
     void onCreateWall();
     void onCreateFoundation();
@@ -49,19 +55,23 @@ private slots:
     void onViewRight();
     void onViewIsometric();
     void onViewFit();
+    void onDisplayQuality();
 
     // Edit menu actions
     void onSelectMode();
     void onMoveMode();
     void onRotateMode();
+    void onArrayCopy();
     void onDeleteSelected();
 
     // Analysis menu actions
     void onCheckInterferences();
+    void onNumberParts();
     void onShowDimensions();
     
     // Work plane actions
     void onSetWorkPlane();
+    void onGridSettings();
     void onFaceHovered(int x, int y);
     void onFaceClicked(int x, int y, Qt::MouseButton button);
 
@@ -75,6 +85,7 @@ private:
     void createDockWidgets();
     void setupUI();
     void updatePropertiesPanel();
+    void updateDimensionGrid();
     void enterFacePickingMode();
     void exitFacePickingMode();
     bool extractFaceGeometry(const TopoDS_Face& face, gp_Pnt& origin, gp_Dir& normal);
@@ -87,6 +98,12 @@ private:
     
     // Object collection manager
     TObjectCollection *m_objectCollection;
+    
+    // Hidden-line views, cached per object between drawings
+    DrawingGenerator *m_drawingGenerator;
+    
+    // Automatic dimensions, laid out when the camera comes to rest
+    DimensionOverlay *m_dimensionOverlay;
 
     // Dock widgets
     QDockWidget *m_projectTreeDock;
@@ -113,11 +130,13 @@ private:
     QAction *m_openAction;
     QAction *m_saveAction;
     QAction *m_exportAction;
+    QAction *m_createDrawingsAction;
     QAction *m_exitAction;
 
     // Create menu actions
     QAction *m_createBeamAction;
     QAction *m_createColumnAction;
+    QAction *m_gridColumnsAction;
     QAction *m_createSlabAction;
     QAction *m_createWallAction;
     QAction *m_createFoundationAction;
@@ -128,15 +147,18 @@ private:
     QAction *m_viewRightAction;
     QAction *m_viewIsoAction;
     QAction *m_viewFitAction;
+    QAction *m_displayQualityAction;
 
     // Edit menu actions
     QAction *m_selectAction;
     QAction *m_moveAction;
     QAction *m_rotateAction;
+    QAction *m_arrayAction;
     QAction *m_deleteAction;
 
     // Analysis menu actions
     QAction *m_checkInterferencesAction;
+    QAction *m_numberPartsAction;
     QAction *m_showDimensionsAction;
     
     // Face picking mode for workplane
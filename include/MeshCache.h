@@ -0,0 +1,63 @@
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <TopoDS_Shape.hxx>
+
+/**
+ * @brief Triangulations kept on disk next to the project
+ *
+ * Entries are keyed by geometry hash plus display quality and hold one
+ * triangulation per face, in TopExp::MapShapes order of the part's faces,
+ * with the polygon of each of the face's edges on it. Opening maps the file
+ * and reads only its index; a lookup copies one entry into
+ * Poly_Triangulation and Poly_PolygonOnTriangulation and attaches them, so
+ * the shape counts as meshed and is displayed without running BRepMesh.
+ */
+class MeshCache
+{
+public:
+    struct Entry {
+        quint64 key;
+        TopoDS_Shape shape;     // Meshed shape to store, or unmeshed to keep the old entry
+    };
+
+    MeshCache();
+    ~MeshCache();
+
+    static QString pathFor(const QString& modelPath);     // <model>.meshcache
+    // deviation is the drawer's coefficient (relative) or chordal deflection
+    static quint64 key(quint64 geometryHash, double deviation, double angle);
+
+    bool open(const QString& path);     // false if missing or not a mesh cache
+    void close();
+    bool isOpen() const { return m_mapping != nullptr; }
+    int count() const { return m_index.size(); }
+
+    // Attaches the stored faces and edge polygons to shape; false if the key
+    // is unknown or the face or edge counts do not match
+    bool attach(quint64 key, const TopoDS_Shape& shape) const;
+
+    // Rewrites path with the given entries and reopens it. Shapes without a
+    // complete triangulation keep the entry of the open file, if any.
+    bool save(const QString& path, const QVector<Entry>& entries);
+
+private:
+    MeshCache(const MeshCache&) = delete;
+    MeshCache& operator=(const MeshCache&) = delete;
+
+    bool appendShape(QByteArray& data, quint64 key, const TopoDS_Shape& shape) const;
+    bool appendMapped(QByteArray& data, quint64 key) const;
+    qint64 entrySize(qint64 offset) const;     // 0 if the entry runs past the file
+
+    QFile m_file;
+    uchar* m_mapping;
+    qint64 m_size;
+    QHash<quint64, qint64> m_index;     // key -> entry offset
+};
+
+#endif // MESHCACHE_H
@@ -0,0 +1,46 @@
+#ifndef MESHSCHEDULER_H
+#define MESHSCHEDULER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <TopoDS_Shape.hxx>
+
+class MeshTask;
+
+/**
+ * @brief Triangulates shapes on worker threads ahead of display
+ *
+ * Each request runs BRepMesh_IncrementalMesh in parallel mode on a private
+ * thread pool. Results come back on the scheduler's thread through
+ * meshReady(); the caller decides whether the shape is still current.
+ * While a shape is queued or meshing nothing else may read or display it.
+ */
+class MeshScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MeshScheduler(QObject* parent = nullptr);
+    ~MeshScheduler();
+    
+    void schedule(int objectID, const TopoDS_Shape& shape, double deflection, double angle);
+    void cancelPending();                   // Drop queued requests; running ones still report
+    int pendingCount() const { return m_pending.load(); }   // Requests not yet reported or dropped
+    
+    // True if every face already carries a triangulation at least this fine
+    static bool isMeshed(const TopoDS_Shape& shape, double deflection);
+
+signals:
+    void meshReady(int objectID, const TopoDS_Shape& shape);
+
+private:
+    friend class MeshTask;
+    void taskFinished(int objectID, const TopoDS_Shape& shape, bool meshed);
+    
+    QThreadPool m_pool;
+    QAtomicInt m_pending;
+    QAtomicInt m_generation;    // Bumped by cancelPending(); older queued tasks skip their work
+};
+
+#endif // MESHSCHEDULER_H
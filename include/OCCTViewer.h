@@ -7,10 +7,14 @@
 #include <QShowEvent>
 #include <QFocusEvent>
 #include <QEvent>
+#include <QTimer>
+#include <QVector>
+#include <QPoint>
 
 #include <AIS_InteractiveContext.hxx>
 #include <AIS_Shape.hxx>
 #include <AIS_Point.hxx>
+#include <AIS_RubberBand.hxx>
 #include <V3d_View.hxx>
 #include <V3d_Viewer.hxx>
 #include <Aspect_Handle.hxx>
@@ -75,6 +79,11 @@ public:
 signals:
     void viewClicked(int x, int y, Qt::MouseButton button);
     void viewMouseMove(int x, int y, Qt::KeyboardModifiers modifiers);
+    void cameraChanged();   // Debounced: emitted once the camera has come to rest
+    // Shift-drag area selection in pixels: a rectangle (four corners, crossing when
+    // dragged right to left) or, with Alt, a lasso polygon
+    void areaSelected(const QVector<QPoint>& region, bool crossing);
+    void pickSelectionChanged();    // Context selection changed by a pick
 
 protected:
     // Qt event handlers
@@ -95,6 +104,9 @@ private:
     void initializeOCC();
     void setupViewer();
     gp_Pnt worldToScreen(const gp_Pnt& worldPoint);
+    void notifyCameraChanged();
+    void updateRubberBand(const QPoint& pos);
+    void finishAreaSelection(const QPoint& pos);
 
     // OpenCascade objects
     Handle(V3d_Viewer) m_viewer;
@@ -110,6 +122,12 @@ private:
     bool m_isZooming;
     bool m_altWasPressed;  // Track Alt key state for highlighting
     
+    // Area selection
+    bool m_isBanding;
+    bool m_bandLasso;
+    QVector<QPoint> m_bandPoints;   // Start point, plus the lasso path
+    Handle(AIS_RubberBand) m_rubberBand;
+    
     // Overlay AIS objects (for tracking line and snap markers)
     Handle(AIS_Shape) m_trackingLineShape;
     Handle(AIS_Point) m_snapMarkerShape;  // Changed to AIS_Point for better visibility
@@ -123,6 +141,9 @@ private:
     
     // Flag to track if OCC view needs redrawing
     bool m_occNeedsRedraw;
+    
+    // Coalesces camera changes during rotate/pan/zoom into one cameraChanged()
+    QTimer *m_cameraTimer;
 };
 
 #endif // OCCTVIEWER_H
@@ -0,0 +1,42 @@
+#ifndef OBJECTIDALLOCATOR_H
+#define OBJECTIDALLOCATOR_H
+
+#include <atomic>
+
+/**
+ * @brief Hands out object IDs for one collection
+ *
+ * IDs are taken with a single atomic increment, so objects can be numbered
+ * from any thread. Batch builders reserve a contiguous block up front and
+ * number their objects from it without touching the shared counter again.
+ * IDs read from a file are claimed explicitly; the counter then moves past
+ * them so later allocations cannot collide. Whether an explicit ID is
+ * already taken is decided by the collection, which owns the ID map.
+ */
+class ObjectIdAllocator
+{
+public:
+    // Contiguous block [first, first + count)
+    struct Range {
+        int first;
+        int count;
+        
+        Range() : first(0), count(0) {}
+        Range(int f, int c) : first(f), count(c) {}
+        int at(int index) const { return first + index; }
+        bool contains(int id) const { return id >= first && id < first + count; }
+    };
+    
+    ObjectIdAllocator() : m_next(1) {}
+    
+    int allocate() { return m_next.fetch_add(1, std::memory_order_relaxed); }
+    Range reserve(int count);
+    bool claim(int id);                 // false for IDs that can never be valid (<= 0)
+    int peekNext() const { return m_next.load(std::memory_order_relaxed); }
+    void reset() { m_next.store(1, std::memory_order_relaxed); }
+
+private:
+    std::atomic<int> m_next;
+};
+
+#endif // OBJECTIDALLOCATOR_H
@@ -0,0 +1,80 @@
+#ifndef OBJECTSPATIALINDEX_H
+#define OBJECTSPATIALINDEX_H
+
+#include <gp_XYZ.hxx>
+#include <vector>
+
+/**
+ * @brief Bounding volume hierarchy over object bounding boxes
+ *
+ * Built once from the object boxes and queried with a convex region such
+ * as a selection frustum. Subtrees entirely inside the region are reported
+ * wholesale, so selecting thousands of objects visits only the boundary.
+ */
+class ObjectSpatialIndex
+{
+public:
+    enum Containment {
+        OUTSIDE,
+        PARTIAL,
+        INSIDE
+    };
+    
+    // Convex region bounded by planes; p is inside when normal.p + offset >= 0 for every plane
+    struct Frustum {
+        int planeCount;
+        gp_XYZ normal[6];
+        double offset[6];
+        
+        Frustum() : planeCount(0), offset() {}
+        void addPlane(const gp_XYZ& n, const gp_XYZ& pointOnPlane) {
+            normal[planeCount] = n;
+            offset[planeCount] = -n.Dot(pointOnPlane);
+            ++planeCount;
+        }
+    };
+    
+    struct Hit {
+        int id;
+        bool inside;    // Box entirely inside the region
+    };
+    
+    ObjectSpatialIndex();
+    
+    // Collect boxes, then build() once before querying
+    void clear();
+    void add(int id, const double min[3], const double max[3]);
+    void build();
+    
+    bool isEmpty() const { return m_items.empty(); }
+    int itemCount() const { return static_cast<int>(m_items.size()); }
+    
+    // Objects whose box touches the region
+    void query(const Frustum& frustum, std::vector<Hit>& result) const;
+    
+    static Containment classify(const Frustum& frustum, const double min[3], const double max[3]);
+
+private:
+    struct Item {
+        int id;
+        double min[3];
+        double max[3];
+    };
+    
+    struct Node {
+        double min[3];
+        double max[3];
+        int left;       // Children, -1 for leaves
+        int right;
+        int first;      // Range in m_order covered by the subtree
+        int count;
+    };
+    
+    int buildNode(int begin, int end);
+    
+    std::vector<Item> m_items;
+    std::vector<int> m_order;       // Item indices, grouped by leaf
+    std::vector<Node> m_nodes;
+};
+
+#endif // OBJECTSPATIALINDEX_H
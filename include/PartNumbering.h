@@ -0,0 +1,36 @@
+#ifndef PARTNUMBERING_H
+#define PARTNUMBERING_H
+
+#include "TGraphicObject.h"
+#include <NCollection_Sequence.hxx>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Tekla-style part and assembly marks from TGraphicObject::GetPartHash()
+ *
+ * Members with the same hash (section, length, material - not placement) are
+ * the same part and share a mark. Grouping is one hash-map pass over the
+ * objects, so numbering is linear in the model size. Numbers run per type
+ * prefix in ascending object ID order, which keeps them stable between runs.
+ *
+ * Every member is currently its own single-part assembly, so the assembly
+ * mark is the part mark in upper case (part "b3", assembly "B3").
+ */
+class PartNumbering
+{
+public:
+    struct Group {
+        quint64 hash;           // 0 for objects that cannot be compared
+        QString partMark;
+        QString assemblyMark;
+        QVector<int> objectIDs;
+    };
+    
+    static QString prefix(TGraphicObject::ObjectType type);
+    
+    // Writes the marks to the objects and returns one group per distinct part
+    static QVector<Group> assign(const NCollection_Sequence<Handle(TGraphicObject)>& objects);
+};
+
+#endif // PARTNUMBERING_H
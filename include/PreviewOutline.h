@@ -0,0 +1,64 @@
+#ifndef PREVIEWOUTLINE_H
+#define PREVIEWOUTLINE_H
+
+#include <AIS_InteractiveObject.hxx>
+#include <Graphic3d_ArrayOfSegments.hxx>
+#include <Quantity_Color.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_GTrsf.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_XYZ.hxx>
+#include <vector>
+
+class PreviewOutline;
+DEFINE_STANDARD_HANDLE(PreviewOutline, AIS_InteractiveObject)
+
+/**
+ * @brief Wireframe rubber-band preview for the drawing commands
+ *
+ * The outline is collected once in local coordinates and uploaded as one
+ * mutable segment buffer. Each mouse move only maps the local vertices
+ * through a new affine placement and rewrites the buffer in place - no
+ * edges, wires or presentations are rebuilt. The affine map lets one
+ * outline stretch: a section swept over local X 0..1 becomes a beam of any
+ * length, a unit rectangle a slab of any size.
+ */
+class PreviewOutline : public AIS_InteractiveObject
+{
+    DEFINE_STANDARD_RTTI_INLINE(PreviewOutline, AIS_InteractiveObject)
+
+public:
+    explicit PreviewOutline(const Quantity_Color& color = Quantity_Color(1.0, 1.0, 0.0, Quantity_TOC_RGB));
+    
+    // Outline construction (local coordinates), before the first display
+    void addSegment(const gp_XYZ& a, const gp_XYZ& b);
+    void addBox(const gp_XYZ& min, const gp_XYZ& max);
+    // Section edges (in the YZ plane) at x = 0 and x = 1, joined at the section vertices
+    void addSweptSection(const TopoDS_Shape& section, double deflection);
+    bool isEmpty() const { return m_local.empty(); }
+    
+    // Local to world map; cheap, may be called on every mouse move
+    void setPlacement(const gp_GTrsf& placement);
+    
+    // Placement sweeping local X from start to end, matching SteelProfile::createProfile
+    static gp_GTrsf sweepPlacement(const gp_Pnt& start, const gp_Pnt& end);
+    // Local axes scaled by (sx, sy, sz) and moved to origin
+    static gp_GTrsf boxPlacement(const gp_Pnt& origin, double sx = 1.0, double sy = 1.0, double sz = 1.0);
+    
+    Standard_Boolean AcceptDisplayMode(const Standard_Integer mode) const override { return mode == 0; }
+
+protected:
+    void Compute(const Handle(PrsMgr_PresentationManager)& presentationManager,
+                 const Handle(Prs3d_Presentation)& presentation,
+                 const Standard_Integer mode) override;
+    void ComputeSelection(const Handle(SelectMgr_Selection)& selection,
+                          const Standard_Integer mode) override;
+
+private:
+    std::vector<gp_XYZ> m_local;    // Segment end points, in pairs
+    gp_GTrsf m_placement;
+    Quantity_Color m_color;
+    Handle(Graphic3d_ArrayOfSegments) m_segments;   // Shared with the displayed group
+};
+
+#endif // PREVIEWOUTLINE_H
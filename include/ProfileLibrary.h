@@ -0,0 +1,65 @@
+#ifndef PROFILELIBRARY_H
+#define PROFILELIBRARY_H
+
+#include "SteelProfile.h"
+#include <QFile>
+#include <QString>
+
+/**
+ * @brief External steel section catalogue backed by a memory-mapped file
+ *
+ * The catalogue is authored as CSV (name, shape, h, b, tw, tf, r, t) and
+ * compiled once into a binary file of fixed-size records sorted by name;
+ * an optional first row of column labels is ignored, and rows that do not
+ * parse are logged with their line number and left out.
+ * Opening maps that file; nothing is parsed at startup and every lookup is
+ * a binary search over the mapping.
+ */
+class ProfileLibrary
+{
+public:
+    enum { NameLength = 32 };
+
+    // On-disk record, 8-byte aligned so it can be read in place
+    struct Record {
+        char name[NameLength];      // NUL-padded
+        quint32 shape;              // SteelProfile::SectionShape
+        quint32 reserved;
+        SteelProfile::Dimensions dim;
+        SteelProfile::SectionProperties props;
+    };
+
+    static ProfileLibrary& instance();
+
+    // Opens a compiled catalogue, or a .csv (compiled next to it on first use)
+    bool open(const QString& path, QString* error = nullptr);
+    void close();
+    bool isOpen() const { return m_records != nullptr; }
+    QString fileName() const { return m_file.fileName(); }
+
+    int count() const { return m_count; }
+    const Record& record(int index) const { return m_records[index]; }
+    QString name(int index) const;
+
+    // O(log n) lookups, case-insensitive
+    int find(const QString& name) const;            // -1 if missing
+    int lowerBound(const QString& prefix) const;    // first name >= prefix
+    int upperBound(const QString& prefix) const;    // first name past the prefix range
+
+    static bool compileCatalog(const QString& csvPath, const QString& binaryPath,
+                               QString* error = nullptr);
+    static QString defaultCatalogPath();
+
+private:
+    ProfileLibrary();
+    ~ProfileLibrary();
+    ProfileLibrary(const ProfileLibrary&) = delete;
+    ProfileLibrary& operator=(const ProfileLibrary&) = delete;
+
+    QFile m_file;
+    uchar* m_mapping;
+    const Record* m_records;
+    int m_count;
+};
+
+#endif // PROFILELIBRARY_H
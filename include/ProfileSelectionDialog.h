@@ -3,10 +3,38 @@
 
 #include <QDialog>
 #include <QComboBox>
-#include <QListWidget>
+#include <QListView>
+#include <QLineEdit>
 #include <QLabel>
+#include <QAbstractListModel>
+#include <QVector>
 #include "SteelProfile.h"
 
+// Lists the sizes of one profile type. Rows are handed to the view in pages
+// (canFetchMore/fetchMore) so catalogues with thousands of sections open
+// instantly; names are read from the catalogue only when a row is painted.
+class ProfileListModel : public QAbstractListModel
+{
+public:
+    explicit ProfileListModel(QObject *parent = nullptr);
+    
+    void setSource(SteelProfile::ProfileType type, const QString& prefix);
+    int catalogIndex(int row) const;
+    QString sizeName(int row) const;
+    
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+private:
+    SteelProfile::ProfileType m_type;
+    QVector<int> m_indices;     // Built-in tables: filtered catalogue indices
+    int m_first;                // Library: first index of the prefix range
+    int m_total;                // Rows available
+    int m_loaded;               // Rows exposed to the view so far
+};
+
 class ProfileSelectionDialog : public QDialog
 {
     Q_OBJECT
@@ -22,15 +50,20 @@ private slots:
     void onProfileTypeChanged(int index);
     void onSizeSelected();
     void onUseRectangular();
+    void onFilterChanged(const QString& text);
+    void onOpenCatalog();
 
 private:
     QComboBox *m_profileTypeCombo;
-    QListWidget *m_sizeList;
+    QLineEdit *m_filterEdit;
+    QListView *m_sizeList;
+    ProfileListModel *m_sizeModel;
     QLabel *m_dimensionsLabel;
     bool m_useProfile;
     
     void updateSizeList();
     void updateDimensions();
+    void selectRow(int row);
 };
 
 #endif // PROFILESELECTIONDIALOG_H
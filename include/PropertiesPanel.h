@@ -13,11 +13,25 @@
 #include <QScrollArea>
 #include <QCheckBox>
 #include <QTabWidget>
+#include <QTimer>
 #include "TGraphicObject.h"
 #include "TBeam.h"
 #include "TColumn.h"
 #include "TSlab.h"
+#include "SelectionStatistics.h"
+#include <NCollection_Sequence.hxx>
+#include <QList>
 
+/**
+ * @brief Dock showing and editing the properties of the current selection
+ *
+ * With several objects selected, fields shared by all of them show their
+ * value and the rest show "<varies>"; an edit is applied to every selected
+ * object. Aggregate quantities are summed on a worker thread.
+ *
+ * Widgets for each object type are built once and reused; a refresh only
+ * writes fields whose value changed and runs at most once per frame.
+ */
 class PropertiesPanel : public QDockWidget
 {
     Q_OBJECT
@@ -27,11 +41,12 @@ public:
     ~PropertiesPanel();
     
     void setObject(const Handle(TGraphicObject)& object);
+    void setObjects(const NCollection_Sequence<Handle(TGraphicObject)>& objects);
     void clearProperties();
-    void setMultipleSelection(int count);
 
 signals:
-    void propertyChanged(int objectID);
+    // Objects whose shape or display must be refreshed, in one batch
+    void propertiesChanged(const QList<int>& objectIDs);
     void colorChanged(int objectID, int r, int g, int b);
     void layerChanged(int objectID, const QString& layer);
     void nameChanged(int objectID, const QString& name);
@@ -50,6 +65,9 @@ private slots:
     void onBeamPropertyChanged();
     void onColumnPropertyChanged();
     void onSlabPropertyChanged();
+    
+    void onStatisticsFinished(const SelectionStatistics::Totals& totals);
+    void onRefreshTimeout();
 
 private:
     void setupUI();
@@ -61,6 +79,14 @@ private:
     void createGeometryGroup();
     void createTypeSpecificGroup();
     void createStatisticsGroup();
+    void createBeamWidgets();
+    void createColumnWidgets();
+    void createSlabWidgets();
+    void showTypeSpecificWidget(QWidget* widget);   // nullptr hides all
+    
+    void refresh();
+    // Same objects as displayed, none modified since the statistics started
+    bool isUnchangedSelection(const NCollection_Sequence<Handle(TGraphicObject)>& objects) const;
     
     void updateCommonProperties();
     void updateGeometryProperties();
@@ -70,6 +96,11 @@ private:
     void updateStatistics();
     
     void enableEditing(bool enabled);
+    bool isMultiple() const { return m_objects.Length() > 1; }
+    QList<int> selectedIDs() const;
+    QDoubleSpinBox* createDimensionSpin(double minimum, double maximum) const;
+    void setSpinValue(QDoubleSpinBox* spin, bool shared, double value);
+    bool hasSpinValue(const QDoubleSpinBox* spin) const;    // false while showing "<varies>"
 
 private:
     // Main layout
@@ -92,6 +123,7 @@ private:
     QLineEdit* m_materialEdit;
     QLabel* m_objectTypeLabel;
     QLabel* m_objectIDLabel;
+    QLabel* m_partMarkLabel;
     QPushButton* m_colorButton;
     QCheckBox* m_visibleCheckBox;
     QCheckBox* m_lockedCheckBox;
@@ -105,11 +137,17 @@ private:
     QGroupBox* m_typeSpecificGroup;
     QVBoxLayout* m_typeSpecificLayout;
     
+    QWidget* m_beamWidget;
+    QWidget* m_columnWidget;
+    QWidget* m_slabWidget;
+    QLabel* m_mixedTypeLabel;
+    
     // Beam properties
     QLabel* m_beamStartLabel;
     QLabel* m_beamEndLabel;
     QLabel* m_beamLengthLabel;
     QLabel* m_beamDirectionLabel;
+    QLabel* m_beamSectionLabel;
     QComboBox* m_beamProfileTypeCombo;
     QComboBox* m_beamProfileSizeCombo;
     QDoubleSpinBox* m_beamWidthSpin;
@@ -133,14 +171,24 @@ private:
     QGroupBox* m_statisticsGroup;
     QLabel* m_volumeLabel;
     QLabel* m_surfaceAreaLabel;
+    QLabel* m_weightLabel;
+    QLabel* m_totalBeamLengthLabel;
     QLabel* m_creationTimeLabel;
     QLabel* m_modificationTimeLabel;
     
     // Apply button
     QPushButton* m_applyButton;
     
-    // Current object
+    // Current selection; m_currentObject is its first object
+    NCollection_Sequence<Handle(TGraphicObject)> m_objects;
     Handle(TGraphicObject) m_currentObject;
+    SelectionStatistics* m_statistics;
+    QDateTime m_statisticsTime;
+    
+    // Selection waiting for the next frame
+    NCollection_Sequence<Handle(TGraphicObject)> m_pendingObjects;
+    QTimer* m_refreshTimer;
+    bool m_refreshPending;
     bool m_updatingUI;
     int m_selectedColor[3];
 };
@@ -0,0 +1,58 @@
+#ifndef SELECTIONSTATISTICS_H
+#define SELECTIONSTATISTICS_H
+
+#include "TGraphicObject.h"
+#include <NCollection_Sequence.hxx>
+#include <QObject>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+class StatisticsTask;
+
+/**
+ * @brief Sums quantities over a selection on a worker thread
+ *
+ * One pass runs at a time. Starting a new pass or calling cancel() stops
+ * the running one at the next object and drops its result, so clicking
+ * through large selections never waits for stale totals. Each pass works
+ * on values and shapes copied when it starts, so editing objects meanwhile
+ * is safe; the totals describe the selection as it was at start().
+ */
+class SelectionStatistics : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Totals {
+        int objectCount;
+        int beamCount;
+        double volume;          // mm3
+        double surfaceArea;     // mm2
+        double weight;          // kg
+        double beamLength;      // mm
+        
+        Totals() : objectCount(0), beamCount(0), volume(0.0), surfaceArea(0.0), weight(0.0), beamLength(0.0) {}
+    };
+    
+    explicit SelectionStatistics(QObject* parent = nullptr);
+    ~SelectionStatistics();
+    
+    void start(const NCollection_Sequence<Handle(TGraphicObject)>& objects);
+    void cancel();      // Stops the running pass and waits for it to return
+    bool isRunning() const { return m_running; }
+
+signals:
+    void finished(const SelectionStatistics::Totals& totals);
+
+private:
+    friend class StatisticsTask;
+    void taskFinished(int generation, const Totals& totals);
+    
+    QThreadPool m_pool;
+    std::shared_ptr<std::atomic<bool>> m_cancel;    // Flag of the running pass
+    int m_generation;
+    bool m_running;
+};
+
+#endif // SELECTIONSTATISTICS_H
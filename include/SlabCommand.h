@@ -19,11 +19,16 @@ public:
     QString getPrompt() const override;
     
     void setThickness(double thickness);
+    
+    // Parameters of the last completed slab, read by the controller on completion
+    gp_Pnt getLastCorner1() const { return m_lastCorner1; }
+    gp_Pnt getLastCorner2() const { return m_lastCorner2; }
+    double getThickness() const { return m_thickness; }
 
 private:
-    TopoDS_Shape createSlab(const gp_Pnt& corner1, const gp_Pnt& corner2);
-    
     QList<gp_Pnt> m_points;
+    gp_Pnt m_lastCorner1;
+    gp_Pnt m_lastCorner2;
     double m_thickness;
 };
 
@@ -1,14 +1,27 @@
 #ifndef SNAPMANAGER_H
 #define SNAPMANAGER_H
 
+#include "EdgeSnapIndex.h"
+#include "DepthVisibility.h"
+#include "WorkPlane.h"
+#include "TGraphicObject.h"
 #include <gp_Pnt.hxx>
 #include <AIS_InteractiveContext.hxx>
 #include <V3d_View.hxx>
+#include <Graphic3d_Camera.hxx>
 #include <TopoDS_Shape.hxx>
 #include <TopoDS_Edge.hxx>
 #include <TopExp_Explorer.hxx>
+#include <NCollection_Sequence.hxx>
+#include <NCollection_DataMap.hxx>
+#include <TopTools_ShapeMapHasher.hxx>
+#include <Bnd_Box.hxx>
 #include <QList>
 #include <QString>
+#include <QHash>
+#include <QAtomicInt>
+#include <memory>
+#include <vector>
 
 // Forward declaration
 class TObjectCollection;
@@ -23,7 +36,9 @@ public:
         Center      = 0x04,   // Center of faces/shapes
         Vertex      = 0x08,   // All vertices
         Nearest     = 0x10,   // Nearest point on edge/face
-        Grid        = 0x20,   // Grid points
+        Grid        = 0x20,   // Grid axis intersections
+        Intersection = 0x40,  // Apparent crossing of edges/centrelines
+        GridLine    = 0x80,   // Foot on the nearest grid axis line
         All         = 0xFF
     };
     
@@ -32,10 +47,45 @@ public:
         SnapType type;
         QString description;
         double distance;  // Distance from cursor
+        bool interior;    // Inside its own solid (centres, centrelines): skip occlusion tests
         
-        SnapPoint() : type(None), distance(1e10) {}
+        SnapPoint() : type(None), distance(1e10), interior(false) {}
         SnapPoint(const gp_Pnt& p, SnapType t, const QString& desc, double dist)
-            : point(p), type(t), description(desc), distance(dist) {}
+            : point(p), type(t), description(desc), distance(dist), interior(false) {}
+    };
+    
+    // Snap data of one object; immutable once built, so any thread may read it
+    struct ObjectSnapData {
+        int id;
+        double min[3];
+        double max[3];
+        QList<SnapPoint> points;                    // Distance unset
+        std::shared_ptr<const EdgeSnapIndex> edges;
+    };
+    
+    // Snapshot of every snappable object
+    struct SnapScene {
+        std::vector<std::shared_ptr<const ObjectSnapData>> objects;
+        int objectCount;            // Collection size when taken
+        
+        SnapScene() : objectCount(0) {}
+    };
+    
+    // Everything a query needs from the view, copied so it can run off the GUI thread
+    struct SnapQuery {
+        int screenX;
+        int screenY;
+        int width;                          // Viewport [pixels]
+        int height;
+        Handle(Graphic3d_Camera) camera;    // Private copy
+        WorkPlane workPlane;                // With its structural grid
+        double tolerancePixels;
+        int enabledTypes;
+        int serial;
+        const QAtomicInt* latestSerial;     // When set, stop early once serial is superseded
+        
+        SnapQuery() : screenX(0), screenY(0), width(0), height(0), tolerancePixels(0.0),
+                      enabledTypes(0), serial(0), latestSerial(nullptr) {}
     };
     
     SnapManager();
@@ -46,6 +96,9 @@ public:
     void enableSnap(SnapType type, bool enabled);
     bool isSnapEnabled(SnapType type) const { return (m_enabledSnaps & type) != 0; }
     
+    // Work plane whose structural grid provides Grid and GridLine snaps
+    void setWorkPlane(const WorkPlane& plane) { m_workPlane = plane; }
+    
     // Snap tolerance (in pixels and world units)
     void setSnapTolerance(double pixels) { m_snapTolerancePixels = pixels; }
     double getSnapTolerance() const { return m_snapTolerancePixels; }
@@ -65,26 +118,66 @@ public:
                                        const Handle(AIS_InteractiveContext)& context,
                                        const Handle(V3d_View)& view);
     
+    // Split form of findSnapPointFromObjects: sceneFor() and makeQuery() on the
+    // GUI thread, rankCandidates() anywhere, pickVisible() back on the GUI thread
+    std::shared_ptr<const SnapScene> sceneFor(TObjectCollection* collection);
+    SnapQuery makeQuery(int screenX, int screenY, const Handle(V3d_View)& view) const;
+    static QList<SnapPoint> rankCandidates(const SnapScene& scene, const SnapQuery& query);
+    SnapPoint pickVisible(const QList<SnapPoint>& ranked, const Handle(V3d_View)& view);
+    
+    // Call when the scene changed without a camera move, so occlusion is re-read
+    void invalidateVisibility() { m_visibility.invalidate(); }
+    void invalidateScene() { m_scene.reset(); }
+    
     // Get all visible shapes from context
     static QList<TopoDS_Shape> getVisibleShapes(const Handle(AIS_InteractiveContext)& context);
     
 private:
     int m_enabledSnaps;
     double m_snapTolerancePixels;
+    DepthVisibility m_visibility;
+    WorkPlane m_workPlane;
+    
+    // Snap data per object, rebuilt when the object's shape changes
+    struct ObjectCacheEntry {
+        TopoDS_Shape source;
+        std::shared_ptr<const ObjectSnapData> data;
+    };
+    QHash<int, ObjectCacheEntry> m_objectData;
+    std::shared_ptr<const SnapScene> m_scene;
+    
+    static std::shared_ptr<const ObjectSnapData> buildObjectData(const Handle(TGraphicObject)& object);
+    
+    // Everything the context-based queries need from one shape, computed once.
+    // Keyed by TShape and location, so a rebuilt or moved shape gets a new entry.
+    struct ShapeSnapData {
+        Bnd_Box box;
+        bool beamLike;
+        QList<SnapPoint> points;            // All candidates, distance unset
+        std::shared_ptr<EdgeSnapIndex> edges;                                   // Built on first Nearest query
+        unsigned int lastUsed;
+        
+        ShapeSnapData() : beamLike(false), lastUsed(0) {}
+    };
+    NCollection_DataMap<TopoDS_Shape, ShapeSnapData, TopTools_ShapeMapHasher> m_shapeData;
+    unsigned int m_queryStamp;
+    
+    ShapeSnapData& snapDataFor(const TopoDS_Shape& shape);
+    void buildSnapData(const TopoDS_Shape& shape, ShapeSnapData& data);
+    const EdgeSnapIndex& edgeIndexFor(const TopoDS_Shape& shape, ShapeSnapData& data);
+    void collectCandidates(const ShapeSnapData& data, const gp_Pnt& cursor, double tolerance,
+                           QList<SnapPoint>& candidates) const;
+    void sweepShapeData(int liveShapes);
     
     // Find specific snap types
     void findEndpoints(const TopoDS_Shape& shape, const gp_Pnt& cursor, QList<SnapPoint>& candidates);
     void findMidpoints(const TopoDS_Shape& shape, const gp_Pnt& cursor, QList<SnapPoint>& candidates);
     void findVertices(const TopoDS_Shape& shape, const gp_Pnt& cursor, QList<SnapPoint>& candidates);
     void findCenter(const TopoDS_Shape& shape, const gp_Pnt& cursor, QList<SnapPoint>& candidates);
-    void findNearest(const TopoDS_Shape& shape, const gp_Pnt& cursor, QList<SnapPoint>& candidates);
     
     // Helper to calculate bounding box center
     gp_Pnt calculateCenter(const TopoDS_Shape& shape);
     
-    // Check if edge is on a large horizontal planar face (like slab surface)
-    bool isEdgeOnHorizontalFace(const TopoDS_Edge& edge, const TopoDS_Shape& shape);
-    
     // Check if snap point is visible from the current view (not occluded)
     bool isPointVisible(const gp_Pnt& point, const Handle(AIS_InteractiveContext)& context,
                        const Handle(V3d_View)& view);
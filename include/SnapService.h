@@ -0,0 +1,45 @@
+#ifndef SNAPSERVICE_H
+#define SNAPSERVICE_H
+
+#include "SnapManager.h"
+#include <QObject>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <memory>
+
+class SnapTask;
+
+/**
+ * @brief Runs snap queries on a worker thread, newest request wins
+ *
+ * Each request carries an immutable SnapScene and a SnapQuery with its own
+ * camera copy, so the worker never touches the view or the collection.
+ * A new request drops any queued one and makes a running one stop early;
+ * only the result of the newest request is delivered, on the service's thread.
+ */
+class SnapService : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SnapService(QObject* parent = nullptr);
+    ~SnapService();
+    
+    // Returns the serial the result will carry
+    int request(const std::shared_ptr<const SnapManager::SnapScene>& scene, SnapManager::SnapQuery query);
+    void cancel();                          // Results still in flight are discarded
+    int latestSerial() const { return m_latestSerial.load(); }
+
+signals:
+    // Candidates best first; SnapManager::pickVisible() makes the final choice
+    void candidatesReady(int serial, const QList<SnapManager::SnapPoint>& ranked);
+
+private:
+    friend class SnapTask;
+    void taskFinished(int serial, const QList<SnapManager::SnapPoint>& ranked);
+    
+    QThreadPool m_pool;
+    QAtomicInt m_latestSerial;
+};
+
+#endif // SNAPSERVICE_H
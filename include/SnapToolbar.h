@@ -40,6 +40,9 @@ private:
     QCheckBox* m_centerCheck;
     QCheckBox* m_vertexCheck;
     QCheckBox* m_nearestCheck;
+    QCheckBox* m_intersectionCheck;
+    QCheckBox* m_gridCheck;
+    QCheckBox* m_gridLineCheck;
     QPushButton* m_toggleAllBtn;
     
     bool m_allEnabled;
@@ -2,8 +2,9 @@
 #define STEELPROFILE_H
 
 #include <QString>
-#include <QMap>
+#include <QStringList>
 #include <TopoDS_Shape.hxx>
+#include <TopoDS_Face.hxx>
 #include <gp_Pnt.hxx>
 #include <gp_Vec.hxx>
 
@@ -15,7 +16,17 @@ public:
         HEA,        // European wide flange (light)
         HEB,        // European wide flange (medium)
         HEM,        // European wide flange (heavy)
-        RHS         // Rectangular Hollow Section
+        RHS,        // Rectangular Hollow Section
+        LIBRARY     // Entry of the external catalogue (see ProfileLibrary)
+    };
+    
+    // Generic cross-section shapes understood by createProfile()
+    enum SectionShape {
+        SECTION_I,          // I/H/W shapes: h, b, tw, tf, r
+        SECTION_CHANNEL,    // U/UPN/C shapes: h, b, tw, tf, r
+        SECTION_ANGLE,      // L shapes: h (vertical leg), b (horizontal leg), t, r
+        SECTION_RHS,        // Rectangular/square hollow: h, b, t
+        SECTION_CHS         // Circular hollow: h (outside diameter), t
     };
     
     struct Dimensions {
@@ -29,24 +40,76 @@ public:
         double thickness;       // t - wall thickness for RHS
     };
     
-    static TopoDS_Shape createProfile(ProfileType type, const QString& size, 
+    // Closed-form cross-section properties (units: mm, kg/m)
+    // y-y is the strong axis (bending about the flange width), z-z the weak axis
+    struct SectionProperties {
+        double area;            // A    [mm2]
+        double weightPerMetre;  // G    [kg/m] for steel (7850 kg/m3)
+        double perimeter;       // AL   [mm] painting surface per unit length
+        double Iy;              // Iy   [mm4] second moment of area, strong axis
+        double Iz;              // Iz   [mm4] second moment of area, weak axis
+        double Wely;            // Wel,y [mm3] elastic section modulus
+        double Welz;            // Wel,z [mm3]
+        double Wply;            // Wpl,y [mm3] plastic section modulus
+        double Wplz;            // Wpl,z [mm3]
+    };
+    
+    // Shape plus dimensions - everything needed to build or describe a section
+    struct SectionDescriptor {
+        SectionShape shape;
+        Dimensions dim;
+    };
+    
+    // Compile-time catalogue entry; see SteelProfile.cpp for the tables
+    struct CatalogEntry {
+        const char* name;
+        quint32 nameHash;       // FNV-1a of name, unique per type
+        Dimensions dim;
+        SectionProperties props;
+    };
+    
+    static TopoDS_Shape createProfile(ProfileType type, const QString& size,
+                                      const gp_Pnt& start, const gp_Pnt& end);
+    static TopoDS_Shape createProfile(const SectionDescriptor& section,
                                       const gp_Pnt& start, const gp_Pnt& end);
     
+    // Cross-section face in the YZ plane, bottom at Z=0, centred on Y; extruded along X
+    static TopoDS_Face createSectionFace(const SectionDescriptor& section);
+    
+    // Indexed access: sizes are numbered 0..getSizeCount(type)-1 in catalogue order.
+    // For LIBRARY the index is the position in the open ProfileLibrary.
+    static int getSizeCount(ProfileType type);
+    static int getDefaultSizeIndex(ProfileType type);
+    static int findSizeIndex(ProfileType type, const QString& size);   // -1 if unknown
+    static const CatalogEntry& getEntry(ProfileType type, int index);  // built-in types only
+    static const Dimensions& getDimensions(ProfileType type, int index);
+    static const SectionProperties& getSectionProperties(ProfileType type, int index);
+    static SectionDescriptor getSection(ProfileType type, int index);
+    static SectionShape getSectionShape(ProfileType type);
+    
+    // QString adapters for the UI (unknown sizes fall back to the type default)
     static QStringList getAvailableSizes(ProfileType type);
-    static Dimensions getDimensions(ProfileType type, const QString& size);
+    static const Dimensions& getDimensions(ProfileType type, const QString& size);
+    static const SectionProperties& getSectionProperties(ProfileType type, const QString& size);
+    static SectionDescriptor getSection(ProfileType type, const QString& size);
     static QString getProfileName(ProfileType type, const QString& size);
+    
+    static SectionProperties computeSectionProperties(ProfileType type, const Dimensions& dim);
+    static SectionProperties computeSectionProperties(const SectionDescriptor& section);
+    static SectionProperties computeRectangularProperties(double width, double height);
+    
+    static const double SteelDensity;   // kg/m3
 
 private:
-    static TopoDS_Shape createIProfile(const Dimensions& dim, const gp_Pnt& start, const gp_Pnt& end);
-    static TopoDS_Shape createRHSProfile(const Dimensions& dim, const gp_Pnt& start, const gp_Pnt& end);
-    
-    static void initializeProfiles();
-    static QMap<QString, Dimensions> s_ipeProfiles;
-    static QMap<QString, Dimensions> s_heaProfiles;
-    static QMap<QString, Dimensions> s_hebProfiles;
-    static QMap<QString, Dimensions> s_hemProfiles;
-    static QMap<QString, Dimensions> s_rhsProfiles;
-    static bool s_initialized;
+    // Cross-section faces in the YZ plane, bottom at Z=0, centred on Y
+    static TopoDS_Face createIFace(const Dimensions& dim);
+    static TopoDS_Face createChannelFace(const Dimensions& dim);
+    static TopoDS_Face createAngleFace(const Dimensions& dim);
+    static TopoDS_Face createRHSFace(const Dimensions& dim);
+    static TopoDS_Face createCHSFace(const Dimensions& dim);
+    
+    // Extrude a section face along X and place it from start to end
+    static TopoDS_Shape extrudeSection(const TopoDS_Face& face, const gp_Pnt& start, const gp_Pnt& end);
 };
 
 #endif // STEELPROFILE_H
@@ -0,0 +1,48 @@
+#ifndef STEPEXPORTER_H
+#define STEPEXPORTER_H
+
+#include "TGraphicObject.h"
+#include <NCollection_Sequence.hxx>
+#include <QString>
+
+/**
+ * @brief Writes graphic objects to a STEP file through an XDE document
+ *
+ * Every object becomes a named, coloured instance under one "Model"
+ * assembly. Objects sharing a TShape (equal part hashes, copies, arrays)
+ * reference a single part and differ only by placement, so the file and
+ * the part geometry grows with the number of distinct parts rather than
+ * with the member count. The translator builds the whole document before
+ * writing, so each instance still costs a label and a placement in memory.
+ */
+class StepExporter
+{
+public:
+    enum Schema {
+        AP214,
+        AP242
+    };
+
+    struct Options {
+        Schema schema;
+        bool instancing;    // Shared solids as one part with placed instances
+
+        Options() : schema(AP214), instancing(true) {}
+    };
+
+    explicit StepExporter(const Options& options = Options());
+
+    bool exportObjects(const NCollection_Sequence<Handle(TGraphicObject)>& objects, const QString& fileName);
+
+    QString errorString() const { return m_error; }
+    int partCount() const { return m_partCount; }           // Distinct parts written
+    int instanceCount() const { return m_instanceCount; }   // Objects written
+
+private:
+    Options m_options;
+    QString m_error;
+    int m_partCount;
+    int m_instanceCount;
+};
+
+#endif // STEPEXPORTER_H
@@ -0,0 +1,87 @@
+#ifndef STRUCTURALGRID_H
+#define STRUCTURALGRID_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <gp_Ax3.hxx>
+#include <AIS_Shape.hxx>
+#include <AIS_TextLabel.hxx>
+#include <QList>
+
+/**
+ * @brief Structural grid of labelled axis lines in work-plane coordinates
+ *
+ * Axes are given Tekla-style as a start coordinate followed by spacings,
+ * with "n*d" meaning n bays of d, e.g. "0 4*6000 7500". U axes are lines of
+ * constant u (numbered 1, 2, ...), V axes lines of constant v (lettered
+ * A, B, ...). Positions are kept sorted, so snapping is a binary search
+ * per direction regardless of the number of axes.
+ */
+class StructuralGrid
+{
+public:
+    enum Direction {
+        U,      // Along the plane's X direction
+        V       // Along the plane's Y direction
+    };
+    
+    struct Axis {
+        double position;    // Plane coordinate [mm]
+        QString label;
+    };
+    
+    // Result of a grid snap in plane coordinates
+    struct Snap {
+        enum Kind { NONE, LINE, INTERSECTION };
+        Kind kind;
+        double u;
+        double v;
+        QString description;
+        
+        Snap() : kind(NONE), u(0.0), v(0.0) {}
+    };
+    
+    StructuralGrid();
+    
+    // "0 4*6000 7500" -> 0, 6000, 12000, 18000, 24000, 31500. Empty on error.
+    static QVector<double> parseCoordinates(const QString& text, bool* ok = nullptr);
+    static QString formatCoordinates(const QVector<double>& positions);
+    
+    // Labels default to 1, 2, 3... for U and A, B, C... for V; a single
+    // label is a start value ("A" or "1"), otherwise one label per axis
+    bool setAxes(Direction direction, const QString& coordinates, const QString& labels = QString());
+    void setAxes(Direction direction, const QVector<double>& positions, const QStringList& labels = QStringList());
+    void clear();
+    
+    bool isEmpty() const { return m_u.isEmpty() && m_v.isEmpty(); }
+    int axisCount(Direction direction) const { return axes(direction).size(); }
+    const Axis& axis(Direction direction, int index) const { return axes(direction)[index]; }
+    QString coordinatesText(Direction direction) const;
+    QString labelsText(Direction direction) const;
+    
+    // How far lines run past the outermost axes
+    void setExtension(double extension) { m_extension = extension; }
+    double getExtension() const { return m_extension; }
+    
+    // Index of the axis closest to coordinate, -1 if there are none. O(log n).
+    int nearestAxis(Direction direction, double coordinate) const;
+    
+    // Closed-form snap of plane point (u, v): an axis intersection if both
+    // nearest axes are within tolerance, else the foot on the nearest axis line
+    Snap snap(double u, double v, double tolerance) const;
+    
+    // Display: one compound of lines and a label at the start of every axis
+    Handle(AIS_Shape) createLinesVisual(const gp_Ax3& plane) const;
+    QList<Handle(AIS_TextLabel)> createLabels(const gp_Ax3& plane) const;
+
+private:
+    const QVector<Axis>& axes(Direction direction) const { return direction == U ? m_u : m_v; }
+    static QStringList makeLabels(Direction direction, const QString& labels, int count);
+    
+    QVector<Axis> m_u;
+    QVector<Axis> m_v;
+    double m_extension;
+};
+
+#endif // STRUCTURALGRID_H
@@ -30,6 +30,7 @@ public:
     Standard_EXPORT virtual QString GetTypeName() const override { return "Beam"; }
     Standard_EXPORT virtual TopoDS_Shape BuildShape() override;
     Standard_EXPORT virtual Handle(AIS_Shape) GetAISShape() override;
+    Standard_EXPORT virtual TopoDS_Shape BuildCoarseShape() const override;
     
     // Beam-specific properties
     Standard_EXPORT void SetStartPoint(const gp_Pnt& point);
@@ -49,7 +50,25 @@ public:
     Standard_EXPORT SteelProfile::ProfileType GetProfileType() const { return m_profileType; }
     Standard_EXPORT QString GetProfileSize() const { return m_profileSize; }
     
+    Standard_EXPORT SteelProfile::SectionDescriptor GetSection() const;
     Standard_EXPORT void GetSectionDimensions(double& width, double& height) const;
+    Standard_EXPORT SteelProfile::SectionProperties GetSectionProperties() const;
+    
+    // Analytic quantities (prismatic member: section x length)
+    Standard_EXPORT virtual double GetVolume() const override;
+    Standard_EXPORT virtual double GetSurfaceArea() const override;
+    Standard_EXPORT virtual double GetWeight() const override;
+    
+    // Keep the reference line in step with the shape
+    Standard_EXPORT virtual void Translate(const gp_Vec& vector) override;
+    Standard_EXPORT virtual void Rotate(const gp_Ax1& axis, double angle) override;
+    
+    Standard_EXPORT virtual Handle(TGraphicObject) CreateCopy(const gp_Trsf& placement) const override;
+    
+    // Section and length; the local member runs along +X from the origin
+    Standard_EXPORT virtual quint64 GetGeometryHash() const override;
+    Standard_EXPORT virtual TopoDS_Shape BuildLocalShape() const override;
+    Standard_EXPORT virtual gp_Trsf GetPlacement() const override;
     
     // Override serialization
     Standard_EXPORT virtual QString Serialize() const override;
@@ -69,6 +88,7 @@ protected:
     bool m_useProfile;
     SteelProfile::ProfileType m_profileType;
     QString m_profileSize;
+    int m_profileIndex;     // Catalogue index of m_profileSize, resolved once
 };
 
 #endif // TBEAM_H
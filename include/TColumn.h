@@ -24,10 +24,24 @@ public:
     Standard_EXPORT void SetBasePoint(const gp_Pnt& point);
     Standard_EXPORT gp_Pnt GetBasePoint() const { return m_basePoint; }
     
+    // Turn in plan about the base point [rad]; width runs along X at 0
+    Standard_EXPORT void SetRotation(double angle);
+    Standard_EXPORT double GetRotation() const { return m_rotation; }
+    
     Standard_EXPORT void SetDimensions(double width, double depth, double height);
     Standard_EXPORT void GetDimensions(double& width, double& depth, double& height) const;
     
+    Standard_EXPORT virtual double GetVolume() const override;
+    Standard_EXPORT virtual double GetSurfaceArea() const override;
+    
+    Standard_EXPORT virtual Handle(TGraphicObject) CreateCopy(const gp_Trsf& placement) const override;
+    
+    Standard_EXPORT virtual quint64 GetGeometryHash() const override;
+    Standard_EXPORT virtual TopoDS_Shape BuildLocalShape() const override;
+    Standard_EXPORT virtual gp_Trsf GetPlacement() const override;
+    
     Standard_EXPORT virtual QString Serialize() const override;
+    Standard_EXPORT virtual bool Deserialize(const QString& data) override;
     Standard_EXPORT virtual bool IsValid() const override;
 
 protected:
@@ -35,6 +49,7 @@ protected:
     double m_width;
     double m_depth;
     double m_height;
+    double m_rotation;
 };
 
 #endif // TCOLUMN_H
@@ -6,9 +6,12 @@
 #include <Standard_Transient.hxx>
 #include <TopoDS_Shape.hxx>
 #include <AIS_Shape.hxx>
+#include <Bnd_Box.hxx>
 #include <QString>
+#include <QHash>
 #include <QDateTime>
 #include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
 
 // Forward declaration for OCCT handle system
 class TGraphicObject;
@@ -43,6 +46,12 @@ public:
         STATE_HIDDEN = 3,
         STATE_LOCKED = 4
     };
+    
+    // Presentation level of detail
+    enum DetailLevel {
+        DETAIL_COARSE = 0,  // Cheap stand-in (bounding box, centreline)
+        DETAIL_FULL = 1     // Exact shape
+    };
 
 public:
     // Constructor
@@ -60,12 +69,15 @@ public:
     Standard_EXPORT virtual TopoDS_Shape BuildShape() = 0;
     Standard_EXPORT virtual Handle(AIS_Shape) GetAISShape() = 0;
     
-    // Common properties
+    // Common properties. The ID is 0 until the owning collection assigns one
+    // (or an explicit ID is set, e.g. from a file)
     Standard_EXPORT void SetID(int id) { m_id = id; }
     Standard_EXPORT int GetID() const { return m_id; }
+    Standard_EXPORT bool HasID() const { return m_id > 0; }
     
+    // Without an explicit name the object is called <type>_<id>
     Standard_EXPORT void SetName(const QString& name) { m_name = name; }
-    Standard_EXPORT QString GetName() const { return m_name; }
+    Standard_EXPORT QString GetName() const;
     
     Standard_EXPORT void SetDescription(const QString& desc) { m_description = desc; }
     Standard_EXPORT QString GetDescription() const { return m_description; }
@@ -93,10 +105,19 @@ public:
     Standard_EXPORT QDateTime GetModificationTime() const { return m_modificationTime; }
     Standard_EXPORT void UpdateModificationTime() { m_modificationTime = QDateTime::currentDateTime(); }
     
+    // Level of detail - the AIS presentation may show a coarse stand-in,
+    // GetShape() always returns the exact model shape
+    Standard_EXPORT const TopoDS_Shape& GetShape() const { return m_shape; }
+    Standard_EXPORT virtual TopoDS_Shape BuildCoarseShape() const;
+    Standard_EXPORT DetailLevel GetDetailLevel() const;
+    Standard_EXPORT bool SetDetailLevel(DetailLevel level);    // true if the presentation must be redisplayed
+    
     // Geometry queries
     Standard_EXPORT virtual gp_Pnt GetCenterPoint() const;
     Standard_EXPORT virtual double GetVolume() const;
     Standard_EXPORT virtual double GetSurfaceArea() const;
+    Standard_EXPORT virtual double GetWeight() const;   // kg
+    Standard_EXPORT static double GetMaterialDensity(const QString& material);   // kg/m3
     Standard_EXPORT virtual void GetBoundingBox(double& xmin, double& ymin, double& zmin,
                                                  double& xmax, double& ymax, double& zmax) const;
     
@@ -122,21 +143,60 @@ public:
     Standard_EXPORT virtual void Scale(const gp_Pnt& center, double factor);
     Standard_EXPORT virtual void Mirror(const gp_Ax2& plane);
     
-    // Serialization
+    // New object sharing this one's B-rep, moved by an extra location (rigid
+    // placements only); null for types that cannot be copied or cannot hold
+    // the placement, e.g. a tilted column or slab
+    Standard_EXPORT virtual Handle(TGraphicObject) CreateCopy(const gp_Trsf& placement) const;
+    
+    // Canonical part geometry, independent of placement: objects with equal
+    // hashes have the same BuildLocalShape(). 0 if the type is not hashable.
+    Standard_EXPORT virtual quint64 GetGeometryHash() const { return 0; }
+    Standard_EXPORT quint64 GetPartHash() const;    // Geometry and material
+    Standard_EXPORT virtual TopoDS_Shape BuildLocalShape() const { return TopoDS_Shape(); }
+    Standard_EXPORT virtual gp_Trsf GetPlacement() const { return gp_Trsf(); }   // Local frame -> model
+    // True while the shape is the cached part for GetGeometryHash() under a
+    // location; Scale() and Mirror() rebuild it into geometry of its own
+    Standard_EXPORT bool HasPartShape() const;
+    
+    // Part and assembly marks, assigned by PartNumbering
+    Standard_EXPORT void SetPartMark(const QString& mark) { m_partMark = mark; }
+    Standard_EXPORT QString GetPartMark() const { return m_partMark; }
+    Standard_EXPORT void SetAssemblyMark(const QString& mark) { m_assemblyMark = mark; }
+    Standard_EXPORT QString GetAssemblyMark() const { return m_assemblyMark; }
+    
+    // Serialization as one "Key=value;" record. Deserialize() restores the
+    // parameters only; the caller rebuilds the shape with BuildShape()
     Standard_EXPORT virtual QString Serialize() const;
     Standard_EXPORT virtual bool Deserialize(const QString& data);
+    Standard_EXPORT static QHash<QString, QString> ParseFields(const QString& data);
     
     // Validation
     Standard_EXPORT virtual bool IsValid() const;
     Standard_EXPORT virtual QString GetValidationError() const { return m_validationError; }
 
 protected:
+    // Attributes, located shape and snap points shared by every CreateCopy()
+    Standard_EXPORT void CopyCommonTo(const Handle(TGraphicObject)& copy, const gp_Trsf& placement) const;
+    
+    // Local shape for GetGeometryHash(), from GeometryCache when another object
+    // already built it, moved by GetPlacement()
+    Standard_EXPORT TopoDS_Shape BuildPlacedShape() const;
+    
+    // True if the placement moves and turns about a vertical axis only, as
+    // columns and slabs can store; angle receives the turn in radians
+    Standard_EXPORT static bool IsPlanPlacement(const gp_Trsf& placement, double& angle);
+    
+    // Numeric field of a ParseFields() record, fallback if missing or malformed
+    Standard_EXPORT static double FieldValue(const QHash<QString, QString>& fields, const QString& key, double fallback);
+    
     // Common member variables
     int m_id;
     QString m_name;
     QString m_description;
     QString m_layer;
     QString m_material;
+    QString m_partMark;
+    QString m_assemblyMark;
     ObjectState m_state;
     bool m_visible;
     bool m_locked;
@@ -150,10 +210,13 @@ protected:
     
     QList<SnapPoint> m_snapPoints;  // Cached snap points
     
-    mutable QString m_validationError;
+    // Caches keyed by the shape they were computed from (IsSame)
+    TopoDS_Shape m_coarseShape;
+    TopoDS_Shape m_coarseSource;
+    mutable Bnd_Box m_boundingBox;
+    mutable TopoDS_Shape m_boundingBoxSource;
     
-    // Static ID counter
-    static int s_nextID;
+    mutable QString m_validationError;
 };
 
 #endif // TGRAPHICOBJECT_H
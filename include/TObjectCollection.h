@@ -2,11 +2,21 @@
 #define TOBJECTCOLLECTION_H
 
 #include "TGraphicObject.h"
+#include "MeshCache.h"
+#include "MeshScheduler.h"
+#include "ObjectSpatialIndex.h"
+#include "ObjectIdAllocator.h"
+#include "PartNumbering.h"
 #include <NCollection_Sequence.hxx>
 #include <NCollection_DataMap.hxx>
 #include <AIS_InteractiveContext.hxx>
+#include <V3d_View.hxx>
 #include <QString>
 #include <QObject>
+#include <QMap>
+#include <QHash>
+#include <QVector>
+#include <QPoint>
 
 /**
  * @brief Master collection class for managing all graphic objects
@@ -19,11 +29,26 @@ class TObjectCollection : public QObject
     Q_OBJECT
     
 public:
+    // Tessellation and level-of-detail settings for one object type
+    struct DisplayQuality {
+        double deviationCoefficient;    // Chordal deflection relative to object size
+        double deviationAngle;          // Angular deflection [rad]
+        bool levelOfDetail;             // Show a coarse stand-in when small on screen
+    };
+    
     explicit TObjectCollection(const Handle(AIS_InteractiveContext)& context, QObject* parent = nullptr);
     virtual ~TObjectCollection();
     
-    // Object management
+    // Object management. Objects without an ID are numbered on insert; objects
+    // carrying one (loaded from a file) keep it unless it is already taken
     Standard_EXPORT bool AddObject(const Handle(TGraphicObject)& object);
+    // Batch insert: one viewer update and one objectsAdded() for the whole set;
+    // new objects are numbered from one reserved block in sequence order
+    Standard_EXPORT int AddObjects(const NCollection_Sequence<Handle(TGraphicObject)>& objects);
+    
+    // Block of IDs for builders that number objects themselves, possibly on
+    // worker threads, before handing them to AddObjects()
+    Standard_EXPORT ObjectIdAllocator::Range ReserveIDs(int count) { return m_idAllocator.reserve(count); }
     Standard_EXPORT bool RemoveObject(int objectID);
     Standard_EXPORT bool RemoveObject(const Handle(TGraphicObject)& object);
     Standard_EXPORT void Clear();
@@ -42,6 +67,21 @@ public:
     Standard_EXPORT void DeselectAll();
     Standard_EXPORT NCollection_Sequence<Handle(TGraphicObject)> GetSelectedObjects() const;
     
+    // Batch selection: one highlight pass and one selectionChanged() for the whole set
+    Standard_EXPORT void SelectObjects(const NCollection_Sequence<int>& objectIDs, bool replace = true);
+    // Adopt the context's selection after a pick in the viewer
+    Standard_EXPORT void SyncSelectionFromContext();
+    Standard_EXPORT int FindObjectID(const Handle(AIS_InteractiveObject)& presentation) const;   // -1 if unknown
+    
+    // Area selection against a screen polygon in pixels (four axis-aligned corners
+    // make a rectangle). Window keeps objects entirely inside, crossing also those
+    // touching it. Boxes are culled through the spatial index, survivors tested
+    // against their triangulation.
+    Standard_EXPORT NCollection_Sequence<int> PickObjects(const Handle(V3d_View)& view,
+                                                          const QVector<QPoint>& region, bool crossing);
+    // Visible objects whose bounding box touches the axis-aligned box
+    Standard_EXPORT NCollection_Sequence<int> FindObjectsInBox(const double min[3], const double max[3]);
+    
     // Visibility management
     Standard_EXPORT void ShowObject(int objectID);
     Standard_EXPORT void HideObject(int objectID);
@@ -52,6 +92,23 @@ public:
     Standard_EXPORT void ShowByLayer(const QString& layer);
     Standard_EXPORT void HideByLayer(const QString& layer);
     
+    // Display quality and view-dependent level of detail
+    Standard_EXPORT void SetDisplayQuality(TGraphicObject::ObjectType type, const DisplayQuality& quality);
+    Standard_EXPORT DisplayQuality GetDisplayQuality(TGraphicObject::ObjectType type) const;
+    Standard_EXPORT void SetDetailThresholds(double coarseBelowPixels, double fullAbovePixels);
+    Standard_EXPORT void GetDetailThresholds(double& coarseBelowPixels, double& fullAbovePixels) const;
+    Standard_EXPORT int UpdateLevelOfDetail(const Handle(V3d_View)& view);
+    
+    // Re-mesh and redisplay an object after its shape was rebuilt
+    Standard_EXPORT void RefreshObject(int objectID);
+    // Batch variant: one viewer update and one objectsModified() for the whole set
+    Standard_EXPORT void RefreshObjects(const QList<int>& objectIDs);
+    
+    // Part and assembly marks for every object, one group per distinct part
+    Standard_EXPORT QVector<PartNumbering::Group> NumberParts();
+    Standard_EXPORT int GetPendingMeshCount() const { return m_meshInFlight.size(); }
+    Standard_EXPORT bool IsMeshPending(int objectID) const { return m_meshInFlight.contains(objectID); }
+    
     // Layer management
     Standard_EXPORT QStringList GetAllLayers() const;
     Standard_EXPORT void CreateLayer(const QString& layer);
@@ -69,7 +126,11 @@ public:
     Standard_EXPORT void RotateObjects(const NCollection_Sequence<int>& objectIDs, const gp_Ax1& axis, double angle);
     Standard_EXPORT void ScaleObjects(const NCollection_Sequence<int>& objectIDs, const gp_Pnt& center, double factor);
     Standard_EXPORT void MirrorObjects(const NCollection_Sequence<int>& objectIDs, const gp_Ax2& plane);
-    Standard_EXPORT NCollection_Sequence<Handle(TGraphicObject)> CopyObjects(const NCollection_Sequence<int>& objectIDs);
+    // Copies share the originals' B-rep and differ only by location; not added to the collection
+    Standard_EXPORT NCollection_Sequence<Handle(TGraphicObject)> CopyObjects(const NCollection_Sequence<int>& objectIDs,
+                                                                             const gp_Trsf& placement = gp_Trsf());
+    // One copy of the objects per placement, inserted as a single batch; returns the number added
+    Standard_EXPORT int ArrayObjects(const NCollection_Sequence<int>& objectIDs, const QVector<gp_Trsf>& placements);
     
     // Undo/Redo support
     Standard_EXPORT void BeginTransaction(const QString& description);
@@ -80,7 +141,8 @@ public:
     Standard_EXPORT void Undo();
     Standard_EXPORT void Redo();
     
-    // Serialization
+    // Serialization. Model files hold one Serialize() record per line;
+    // loading replaces the collection and builds the solids in parallel
     Standard_EXPORT bool SaveToFile(const QString& filename);
     Standard_EXPORT bool LoadFromFile(const QString& filename);
     Standard_EXPORT QString ExportToXML() const;
@@ -100,21 +162,58 @@ public:
 
 signals:
     void objectAdded(int objectID);
+    void objectsAdded(const QList<int>& objectIDs);
     void objectRemoved(int objectID);
     void objectModified(int objectID);
+    void objectsModified(const QList<int>& objectIDs);
     void selectionChanged();
     void collectionCleared();
+    void meshingProgress(int pending);
+
+private slots:
+    void onMeshReady(int objectID, const TopoDS_Shape& shape);
 
 private:
     Handle(AIS_InteractiveContext) m_context;
     NCollection_DataMap<int, Handle(TGraphicObject)> m_objects;
+    ObjectIdAllocator m_idAllocator;
     NCollection_Sequence<int> m_selectedObjects;
     QStringList m_layers;
     
+    QMap<int, DisplayQuality> m_displayQuality;
+    double m_coarseBelowPixels;     // Switch to coarse when the projected size drops below
+    double m_fullAbovePixels;       // Switch back to full above (hysteresis band in between)
+    
+    // Background meshing: shapes in flight are shown through a proxy box and
+    // must not be displayed or queried until their mesh arrives
+    MeshScheduler* m_meshScheduler;
+    QMap<int, TopoDS_Shape> m_meshInFlight;
+    // Objects waiting per TShape with a request out; a key stays until its
+    // result arrives, even if its objects were removed or rebuilt meanwhile
+    QHash<const TopoDS_TShape*, QVector<int>> m_meshWaiters;
+    QMap<int, Handle(AIS_Shape)> m_meshProxies;
+    bool m_viewerUpdatePending;
+    MeshCache m_meshCache;          // Triangulations saved with the model
+    
+    // Area selection: BVH over object boxes, rebuilt lazily after edits
+    ObjectSpatialIndex m_spatialIndex;
+    bool m_spatialIndexDirty;
+    QHash<const AIS_InteractiveObject*, int> m_idByPresentation;
+    
     // Helper methods
+    bool claimID(const Handle(TGraphicObject)& object);     // false if the explicit ID is taken
+    bool scheduleMesh(const Handle(TGraphicObject)& object);   // false if the mesh is already usable
+    quint64 meshCacheKey(const Handle(TGraphicObject)& object) const;  // 0 if not cacheable
+    void releaseMesh(int objectID);     // Stop waiting for the object's mesh
+    void showMeshProxy(const Handle(TGraphicObject)& object);
+    void removeMeshProxy(int objectID);
+    void scheduleViewerUpdate();
+    void applyDisplayQuality(const Handle(TGraphicObject)& object);
     void displayObject(const Handle(TGraphicObject)& object);
     void eraseObject(const Handle(TGraphicObject)& object);
     void updateDisplay(const Handle(TGraphicObject)& object);
+    void updateSpatialIndex();
+    void syncContextSelection();
 };
 
 #endif // TOBJECTCOLLECTION_H
@@ -21,21 +21,39 @@ public:
     Standard_EXPORT virtual TopoDS_Shape BuildShape() override;
     Standard_EXPORT virtual Handle(AIS_Shape) GetAISShape() override;
     
+    // Opposite corners of the slab; its sides run along the plan rotation
     Standard_EXPORT void SetCorners(const gp_Pnt& corner1, const gp_Pnt& corner2);
     Standard_EXPORT void GetCorners(gp_Pnt& corner1, gp_Pnt& corner2) const;
     
+    // Turn of the sides in plan [rad]; 0 keeps them on X and Y
+    Standard_EXPORT void SetRotation(double angle);
+    Standard_EXPORT double GetRotation() const { return m_rotation; }
+    // Side lengths along the rotated X and Y
+    Standard_EXPORT void GetPlanSize(double& dx, double& dy) const;
+    
     Standard_EXPORT void SetThickness(double thickness);
     Standard_EXPORT double GetThickness() const { return m_thickness; }
     
     Standard_EXPORT double GetArea() const;
     
+    Standard_EXPORT virtual double GetVolume() const override;
+    Standard_EXPORT virtual double GetSurfaceArea() const override;
+    
+    Standard_EXPORT virtual Handle(TGraphicObject) CreateCopy(const gp_Trsf& placement) const override;
+    
+    Standard_EXPORT virtual quint64 GetGeometryHash() const override;
+    Standard_EXPORT virtual TopoDS_Shape BuildLocalShape() const override;
+    Standard_EXPORT virtual gp_Trsf GetPlacement() const override;
+    
     Standard_EXPORT virtual QString Serialize() const override;
+    Standard_EXPORT virtual bool Deserialize(const QString& data) override;
     Standard_EXPORT virtual bool IsValid() const override;
 
 protected:
     gp_Pnt m_corner1;
     gp_Pnt m_corner2;
     double m_thickness;
+    double m_rotation;
 };
 
 #endif // TSLAB_H
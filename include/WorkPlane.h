@@ -6,6 +6,7 @@
 #include <QString>
 #include <AIS_InteractiveContext.hxx>
 #include <AIS_Shape.hxx>
+#include "StructuralGrid.h"
 
 class WorkPlane
 {
@@ -38,10 +39,19 @@ public:
     // Create visual representation
     Handle(AIS_Shape) createVisual(double size = 5000.0) const;
     
+    // Structural grid, in the plane's own coordinates
+    void setGrid(const StructuralGrid& grid) { m_grid = grid; }
+    const StructuralGrid& getGrid() const { return m_grid; }
+    
+    // Snap a point on the plane to the grid; false if no axis is within tolerance
+    bool snapToGrid(const gp_Pnt& point, double tolerance,
+                    gp_Pnt& snapped, StructuralGrid::Snap& snap) const;
+    
 private:
     PlaneType m_type;
     gp_Pln m_plane;
     double m_offset;
+    StructuralGrid m_grid;
     
     void initializePlane(PlaneType type);
 };
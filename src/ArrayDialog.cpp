@@ -0,0 +1,235 @@
+#include "ArrayDialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QPushButton>
+#include <QGroupBox>
+#include <gp_Ax1.hxx>
+#include <gp_Vec.hxx>
+#include <cmath>
+
+ArrayDialog::ArrayDialog(QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle("Array Copy");
+    setupUI();
+    applyStyles();
+    updateSummary();
+    resize(380, 320);
+}
+
+QDoubleSpinBox* ArrayDialog::createLengthSpin(double value) const
+{
+    QDoubleSpinBox* spin = new QDoubleSpinBox();
+    spin->setRange(-1000000.0, 1000000.0);
+    spin->setSuffix(" mm");
+    spin->setDecimals(0);
+    spin->setSingleStep(500.0);
+    spin->setValue(value);
+    return spin;
+}
+
+void ArrayDialog::setupUI()
+{
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    
+    QFormLayout* patternLayout = new QFormLayout();
+    m_patternCombo = new QComboBox();
+    m_patternCombo->addItem("Linear");
+    m_patternCombo->addItem("Rectangular");
+    m_patternCombo->addItem("Polar");
+    patternLayout->addRow("Pattern:", m_patternCombo);
+    mainLayout->addLayout(patternLayout);
+    
+    m_pages = new QStackedWidget();
+    
+    // Linear
+    QGroupBox* linearGroup = new QGroupBox("Linear");
+    QFormLayout* linearLayout = new QFormLayout();
+    m_linearCount = new QSpinBox();
+    m_linearCount->setRange(1, 10000);
+    m_linearCount->setValue(5);
+    linearLayout->addRow("Copies:", m_linearCount);
+    m_linearDx = createLengthSpin(6000.0);
+    m_linearDy = createLengthSpin(0.0);
+    m_linearDz = createLengthSpin(0.0);
+    linearLayout->addRow("Spacing X:", m_linearDx);
+    linearLayout->addRow("Spacing Y:", m_linearDy);
+    linearLayout->addRow("Spacing Z:", m_linearDz);
+    linearGroup->setLayout(linearLayout);
+    m_pages->addWidget(linearGroup);
+    
+    // Rectangular
+    QGroupBox* rectGroup = new QGroupBox("Rectangular");
+    QFormLayout* rectLayout = new QFormLayout();
+    m_columnCount = new QSpinBox();
+    m_columnCount->setRange(1, 1000);
+    m_columnCount->setValue(5);
+    m_columnCount->setToolTip("Number of positions along X, including the original");
+    rectLayout->addRow("Along X:", m_columnCount);
+    m_rowCount = new QSpinBox();
+    m_rowCount->setRange(1, 1000);
+    m_rowCount->setValue(4);
+    m_rowCount->setToolTip("Number of positions along Y, including the original");
+    rectLayout->addRow("Along Y:", m_rowCount);
+    m_columnSpacing = createLengthSpin(6000.0);
+    m_rowSpacing = createLengthSpin(6000.0);
+    rectLayout->addRow("Spacing X:", m_columnSpacing);
+    rectLayout->addRow("Spacing Y:", m_rowSpacing);
+    rectGroup->setLayout(rectLayout);
+    m_pages->addWidget(rectGroup);
+    
+    // Polar
+    QGroupBox* polarGroup = new QGroupBox("Polar");
+    QFormLayout* polarLayout = new QFormLayout();
+    m_polarCount = new QSpinBox();
+    m_polarCount->setRange(1, 10000);
+    m_polarCount->setValue(7);
+    polarLayout->addRow("Copies:", m_polarCount);
+    m_centerX = createLengthSpin(0.0);
+    m_centerY = createLengthSpin(0.0);
+    polarLayout->addRow("Centre X:", m_centerX);
+    polarLayout->addRow("Centre Y:", m_centerY);
+    m_angleStep = new QDoubleSpinBox();
+    m_angleStep->setRange(-360.0, 360.0);
+    m_angleStep->setSuffix(QString::fromUtf8(" °"));
+    m_angleStep->setDecimals(2);
+    m_angleStep->setValue(45.0);
+    polarLayout->addRow("Angle step:", m_angleStep);
+    polarGroup->setLayout(polarLayout);
+    m_pages->addWidget(polarGroup);
+    
+    mainLayout->addWidget(m_pages);
+    
+    m_summaryLabel = new QLabel();
+    mainLayout->addWidget(m_summaryLabel);
+    
+    // Buttons
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    buttonLayout->addStretch();
+    
+    QPushButton* okButton = new QPushButton("OK");
+    QPushButton* cancelButton = new QPushButton("Cancel");
+    
+    connect(okButton, &QPushButton::clicked, this, &QDialog::accept);
+    connect(cancelButton, &QPushButton::clicked, this, &QDialog::reject);
+    
+    buttonLayout->addWidget(okButton);
+    buttonLayout->addWidget(cancelButton);
+    
+    mainLayout->addLayout(buttonLayout);
+    
+    connect(m_patternCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            m_pages, &QStackedWidget::setCurrentIndex);
+    connect(m_patternCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &ArrayDialog::updateSummary);
+    for (QSpinBox* spin : { m_linearCount, m_columnCount, m_rowCount, m_polarCount }) {
+        connect(spin, QOverload<int>::of(&QSpinBox::valueChanged), this, &ArrayDialog::updateSummary);
+    }
+}
+
+void ArrayDialog::updateSummary()
+{
+    m_summaryLabel->setText(QString("%1 copies of each selected object").arg(getPlacements().size()));
+}
+
+void ArrayDialog::applyStyles()
+{
+    setStyleSheet(R"(
+        QDialog {
+            background-color: #2b2b2b;
+            color: #ffffff;
+        }
+        QGroupBox {
+            border: 1px solid #555555;
+            border-radius: 4px;
+            margin-top: 8px;
+            padding-top: 8px;
+            font-weight: bold;
+            color: #ffffff;
+        }
+        QGroupBox::title {
+            subcontrol-origin: margin;
+            left: 10px;
+            padding: 0 5px;
+        }
+        QLabel {
+            color: #cccccc;
+        }
+        QComboBox, QSpinBox, QDoubleSpinBox {
+            background-color: #3c3c3c;
+            border: 1px solid #555555;
+            border-radius: 3px;
+            padding: 5px;
+            color: #ffffff;
+            min-height: 25px;
+        }
+        QComboBox:hover, QSpinBox:hover, QDoubleSpinBox:hover {
+            border: 1px solid #0d6efd;
+        }
+        QPushButton {
+            background-color: #0d6efd;
+            color: white;
+            border: none;
+            border-radius: 4px;
+            padding: 8px 20px;
+            font-weight: bold;
+            min-width: 80px;
+        }
+        QPushButton:hover {
+            background-color: #0b5ed7;
+        }
+    )");
+}
+
+ArrayDialog::Pattern ArrayDialog::getPattern() const
+{
+    return static_cast<Pattern>(m_patternCombo->currentIndex());
+}
+
+QVector<gp_Trsf> ArrayDialog::getPlacements() const
+{
+    QVector<gp_Trsf> placements;
+    
+    switch (getPattern()) {
+    case LINEAR: {
+        const gp_Vec step(m_linearDx->value(), m_linearDy->value(), m_linearDz->value());
+        placements.reserve(m_linearCount->value());
+        for (int i = 1; i <= m_linearCount->value(); ++i) {
+            gp_Trsf trsf;
+            trsf.SetTranslation(step * i);
+            placements.append(trsf);
+        }
+        break;
+    }
+    case RECTANGULAR: {
+        const int columns = m_columnCount->value();
+        const int rows = m_rowCount->value();
+        placements.reserve(columns * rows - 1);
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < columns; ++column) {
+                if (row == 0 && column == 0) {
+                    continue;   // The original
+                }
+                gp_Trsf trsf;
+                trsf.SetTranslation(gp_Vec(column * m_columnSpacing->value(), row * m_rowSpacing->value(), 0.0));
+                placements.append(trsf);
+            }
+        }
+        break;
+    }
+    case POLAR: {
+        const gp_Ax1 axis(gp_Pnt(m_centerX->value(), m_centerY->value(), 0.0), gp_Dir(0, 0, 1));
+        const double step = m_angleStep->value() * M_PI / 180.0;
+        placements.reserve(m_polarCount->value());
+        for (int i = 1; i <= m_polarCount->value(); ++i) {
+            gp_Trsf trsf;
+            trsf.SetRotation(axis, step * i);
+            placements.append(trsf);
+        }
+        break;
+    }
+    }
+    
+    return placements;
+}
@@ -1,8 +1,7 @@
 #include "BeamCommand.h"
 #include "OCCTViewer.h"
+#include "Logger.h"
 #include <BRepPrimAPI_MakeBox.hxx>
-#include <BRepBuilderAPI_MakeEdge.hxx>
-#include <BRepBuilderAPI_MakeWire.hxx>
 #include <gp_Vec.hxx>
 #include <gp_Trsf.hxx>
 #include <BRepBuilderAPI_Transform.hxx>
@@ -12,10 +11,6 @@
 #include <Precision.hxx>
 #include <QMessageBox>
 #include <cmath>
-#include <QDebug>
-#include <QFile>
-#include <QTextStream>
-#include <QDateTime>
 
 BeamCommand::BeamCommand(const Handle(AIS_InteractiveContext)& context, OCCTViewer* viewer, QObject* parent)
     : CADCommand(context, viewer, parent)
@@ -32,39 +27,26 @@ void BeamCommand::execute(const gp_Pnt& point)
     m_points.append(point);
     
     if (m_points.size() == 1) {
-        qDebug() << "Beam start point:" << point.X() << point.Y() << point.Z();
+        LOG_DEBUG("beam", "Start point (%1, %2, %3)", point.X(), point.Y(), point.Z());
         emit statusUpdate(QString("Start point: (%1, %2, %3). Select end point")
                          .arg(point.X(), 0, 'f', 1)
                          .arg(point.Y(), 0, 'f', 1)
                          .arg(point.Z(), 0, 'f', 1));
     } else if (m_points.size() == 2) {
-        // Log to file for debugging
-        QFile logFile("beam_debug.log");
-        if (logFile.open(QIODevice::Append | QIODevice::Text)) {
-            QTextStream out(&logFile);
-            out << "\n=== " << QDateTime::currentDateTime().toString() << " ===\n";
-            out << "Start point: (" << m_points[0].X() << ", " << m_points[0].Y() << ", " << m_points[0].Z() << ")\n";
-            out << "End point: (" << point.X() << ", " << point.Y() << ", " << point.Z() << ")\n";
-            
-            double distance = m_points[0].Distance(m_points[1]);
-            out << "Distance: " << distance << " mm\n";
-            
-            if (m_useProfile) {
-                out << "Profile: " << m_profileSize.toStdString().c_str() << "\n";
-            } else {
-                out << "Rectangular: " << m_width << " x " << m_height << " mm\n";
-            }
-            logFile.close();
+        if (m_useProfile) {
+            LOG_DEBUG("beam", "Creating beam (%1, %2, %3) -> (%4, %5, %6), profile %7",
+                      m_points[0].X(), m_points[0].Y(), m_points[0].Z(),
+                      point.X(), point.Y(), point.Z(), m_profileSize);
+        } else {
+            LOG_DEBUG("beam", "Creating beam (%1, %2, %3) -> (%4, %5, %6), rectangular %7 x %8",
+                      m_points[0].X(), m_points[0].Y(), m_points[0].Z(),
+                      point.X(), point.Y(), point.Z(), m_width, m_height);
         }
-        
-        qDebug() << "Beam end point:" << point.X() << point.Y() << point.Z();
-        qDebug() << "Creating beam from" << m_points[0].X() << m_points[0].Y() << m_points[0].Z() 
-                 << "to" << m_points[1].X() << m_points[1].Y() << m_points[1].Z();
         clearPreview();
         
         // Check if points are not too close
         double distance = m_points[0].Distance(m_points[1]);
-        qDebug() << "Distance between points:" << distance << "mm";
+        LOG_DEBUG("beam", "Distance between points: %1 mm", distance);
         
         if (distance < 1.0) {
             emit statusUpdate("Points too close - minimum distance is 1mm");
@@ -76,29 +58,29 @@ void BeamCommand::execute(const gp_Pnt& point)
             TopoDS_Shape beam = createBeam(m_points[0], m_points[1]);
             
             if (!beam.IsNull()) {
-                qDebug() << "Beam shape created successfully";
                 displayShape(beam);
                 emit statusUpdate(QString("Beam created: length %1 mm").arg(distance, 0, 'f', 1));
                 emit commandCompleted(beam);
             } else {
-                qDebug() << "ERROR: Beam shape is NULL";
-                QString msg = "Failed to create beam - geometry error\nCheck beam_debug.log for details";
+                LOG_ERROR("beam", "Beam shape is null");
+                QString msg = QString("Failed to create beam - geometry error\nCheck %1 for details").arg(Logger::instance().filePath());
                 QMessageBox::warning(nullptr, "Beam Creation Error", msg);
                 emit statusUpdate("Failed to create beam - geometry error");
             }
         } catch (const Standard_Failure& e) {
-            qDebug() << "OpenCascade exception:" << e.GetMessageString();
-            QString msg = QString("OpenCascade Error: %1\nCheck beam_debug.log for details").arg(e.GetMessageString());
+            LOG_ERROR("beam", "OpenCascade exception: %1", e.GetMessageString());
+            QString msg = QString("OpenCascade Error: %1\nCheck %2 for details").arg(e.GetMessageString()).arg(Logger::instance().filePath());
             QMessageBox::critical(nullptr, "Beam Creation Error", msg);
             emit statusUpdate(QString("Error creating beam: %1").arg(e.GetMessageString()));
         } catch (const std::exception& e) {
-            qDebug() << "Standard exception:" << e.what();
-            QString msg = QString("Error: %1\nCheck beam_debug.log for details").arg(e.what());
+            LOG_ERROR("beam", "Standard exception: %1", e.what());
+            QString msg = QString("Error: %1\nCheck %2 for details").arg(e.what()).arg(Logger::instance().filePath());
             QMessageBox::critical(nullptr, "Beam Creation Error", msg);
             emit statusUpdate(QString("Error creating beam: %1").arg(e.what()));
         } catch (...) {
-            qDebug() << "Unknown exception in beam creation";
-            QMessageBox::critical(nullptr, "Beam Creation Error", "Unknown error\nCheck beam_debug.log for details");
+            LOG_ERROR("beam", "Unknown exception in beam creation");
+            QMessageBox::critical(nullptr, "Beam Creation Error",
+                                  QString("Unknown error\nCheck %1 for details").arg(Logger::instance().filePath()));
             emit statusUpdate("Unknown error creating beam");
         }
         
@@ -115,10 +97,11 @@ void BeamCommand::updatePreview(const gp_Pnt& point)
         
         // Only create preview if points are different enough
         if (distance > Precision::Confusion()) {
-            // Use viewer overlay for smooth tracking line
-            if (m_viewer) {
-                m_viewer->setTrackingLine(m_points[0], point);
+            // Section outline built once, then only stretched and moved
+            if (m_outline.IsNull()) {
+                buildOutline();
             }
+            showOutline(PreviewOutline::sweepPlacement(m_points[0], point));
             
             // Update status less frequently to reduce overhead
             static int updateCounter = 0;
@@ -153,6 +136,8 @@ void BeamCommand::setDimensions(double width, double height)
     m_width = width;
     m_height = height;
     m_useProfile = false;
+    clearPreview();
+    m_outline.Nullify();
 }
 
 void BeamCommand::setProfile(SteelProfile::ProfileType type, const QString& size)
@@ -160,6 +145,28 @@ void BeamCommand::setProfile(SteelProfile::ProfileType type, const QString& size
     m_profileType = type;
     m_profileSize = size;
     m_useProfile = true;
+    clearPreview();
+    m_outline.Nullify();
+}
+
+void BeamCommand::buildOutline()
+{
+    m_outline = new PreviewOutline();
+    try {
+        if (m_useProfile) {
+            TopoDS_Face section = SteelProfile::createSectionFace(SteelProfile::getSection(m_profileType, m_profileSize));
+            if (!section.IsNull()) {
+                m_outline->addSweptSection(section, 1.0);
+            }
+        } else {
+            m_outline->addBox(gp_XYZ(0, -m_width / 2, -m_height / 2), gp_XYZ(1, m_width / 2, m_height / 2));
+        }
+    } catch (const Standard_Failure& e) {
+        LOG_WARNING("beam", "Preview outline failed: %1", e.GetMessageString());
+    }
+    
+    // Reference line, start to end
+    m_outline->addSegment(gp_XYZ(0, 0, 0), gp_XYZ(1, 0, 0));
 }
 
 TopoDS_Shape BeamCommand::createBeam(const gp_Pnt& start, const gp_Pnt& end)
@@ -58,11 +58,36 @@ void CADCommand::showPreview(const TopoDS_Shape& shape)
     m_context->CurrentViewer()->Update();
 }
 
+void CADCommand::showOutline(const gp_GTrsf& placement)
+{
+    if (m_outline.IsNull() || m_outline->isEmpty()) {
+        return;
+    }
+    
+    m_outline->setPlacement(placement);
+    if (!m_context->IsDisplayed(m_outline)) {
+        m_context->Display(m_outline, 0, -1, Standard_False);   // Display only, never selectable
+    }
+    
+    // Only vertex data changed, and the outline lives in the immediate Top
+    // layer: redraw that layer over the cached scene, not the whole model
+    m_context->CurrentViewer()->RedrawImmediate();
+}
+
 void CADCommand::clearPreview()
 {
+    bool changed = false;
     if (!m_previewShape.IsNull()) {
         m_context->Remove(m_previewShape, Standard_False);
         m_previewShape.Nullify();
+        changed = true;
+    }
+    if (!m_outline.IsNull() && m_context->IsDisplayed(m_outline)) {
+        // Keep the outline itself: the next element of this command reuses it
+        m_context->Remove(m_outline, Standard_False);
+        changed = true;
+    }
+    if (changed) {
         m_context->CurrentViewer()->Update();
     }
 }
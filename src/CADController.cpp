@@ -6,11 +6,12 @@
 #include "TColumn.h"
 #include "TSlab.h"
 #include "TObjectCollection.h"
+#include "Logger.h"
+#include <ElSLib.hxx>
 #include <gp_Lin.hxx>
 #include <gp_Pln.hxx>
 #include <IntAna_IntLinTorus.hxx>
 #include <Precision.hxx>
-#include <QDebug>
 
 CADController::CADController(const Handle(AIS_InteractiveContext)& context, OCCTViewer* viewer, TObjectCollection* collection, QObject* parent)
     : QObject(parent)
@@ -20,8 +21,11 @@ CADController::CADController(const Handle(AIS_InteractiveContext)& context, OCCT
     , m_activeCommand(nullptr)
     , m_workPlane(WorkPlane::XY)
     , m_showWorkPlane(false)
+    , m_showGrid(true)
+    , m_snapService(new SnapService(this))
     , m_snapEnabled(true)
 {
+    connect(m_snapService, &SnapService::candidatesReady, this, &CADController::onSnapCandidates);
 }
 
 CADController::~CADController()
@@ -138,7 +142,12 @@ gp_Pnt CADController::convertViewToWorld(int x, int y, const Handle(V3d_View)& v
 
 void CADController::setWorkPlane(const WorkPlane& plane)
 {
+    // The grid belongs to the model, not to the plane it is shown on
+    StructuralGrid grid = m_workPlane.getGrid();
     m_workPlane = plane;
+    m_workPlane.setGrid(grid);
+    m_snapManager.setWorkPlane(m_workPlane);
+    updateGridVisual();
     
     // Update visual if shown
     if (m_showWorkPlane) {
@@ -175,6 +184,99 @@ void CADController::setWorkPlaneVisible(bool visible)
     }
 }
 
+void CADController::setGrid(const StructuralGrid& grid)
+{
+    m_workPlane.setGrid(grid);
+    m_snapManager.setWorkPlane(m_workPlane);
+    updateGridVisual();
+    
+    if (m_viewer) {
+        m_viewer->requestRedraw();
+    }
+    
+    emit statusMessage(grid.isEmpty()
+        ? QString("Grid cleared")
+        : QString("Grid: %1 x %2 axes").arg(grid.axisCount(StructuralGrid::U)).arg(grid.axisCount(StructuralGrid::V)));
+}
+
+int CADController::placeColumnsAtGrid(const QVector<int>& uAxes, const QVector<int>& vAxes,
+                                      double width, double depth, double height)
+{
+    const StructuralGrid& grid = m_workPlane.getGrid();
+    if (!m_collection || uAxes.isEmpty() || vAxes.isEmpty()) {
+        return 0;
+    }
+    
+    // One column is built; the others are placed copies sharing its B-rep
+    Handle(TColumn) prototype;
+    gp_Pnt origin;
+    NCollection_Sequence<Handle(TGraphicObject)> columns;
+    for (int u : uAxes) {
+        for (int v : vAxes) {
+            gp_Pnt point = ElSLib::Value(grid.axis(StructuralGrid::U, u).position,
+                                         grid.axis(StructuralGrid::V, v).position,
+                                         m_workPlane.getPlane());
+            if (prototype.IsNull()) {
+                prototype = new TColumn(point, width, depth, height);
+                origin = point;
+                columns.Append(prototype);
+                continue;
+            }
+            gp_Trsf placement;
+            placement.SetTranslation(origin, point);
+            Handle(TGraphicObject) column = prototype->CreateCopy(placement);
+            if (!column.IsNull()) {
+                columns.Append(column);
+            }
+        }
+    }
+    
+    int count = m_collection->AddObjects(columns);
+    LOG_INFO("controller", "Placed %1 columns at %2 x %3 grid intersections", count, uAxes.size(), vAxes.size());
+    emit statusMessage(QString("Placed %1 columns at grid intersections").arg(count));
+    return count;
+}
+
+void CADController::setGridVisible(bool visible)
+{
+    m_showGrid = visible;
+    updateGridVisual();
+    
+    if (m_viewer) {
+        m_viewer->requestRedraw();
+    }
+}
+
+void CADController::updateGridVisual()
+{
+    if (!m_gridVisual.IsNull()) {
+        m_context->Remove(m_gridVisual, Standard_False);
+        m_gridVisual.Nullify();
+    }
+    for (const Handle(AIS_TextLabel)& label : m_gridLabels) {
+        m_context->Remove(label, Standard_False);
+    }
+    m_gridLabels.clear();
+    
+    const StructuralGrid& grid = m_workPlane.getGrid();
+    if (!m_showGrid || grid.isEmpty()) {
+        return;
+    }
+    
+    // Display only; the grid is never picked, snapping is analytic
+    const gp_Ax3 axes = m_workPlane.getCoordinateSystem();
+    m_gridVisual = grid.createLinesVisual(axes);
+    if (!m_gridVisual.IsNull()) {
+        m_context->Display(m_gridVisual, Standard_False);
+        m_context->Deactivate(m_gridVisual);
+    }
+    m_gridLabels = grid.createLabels(axes);
+    for (const Handle(AIS_TextLabel)& label : m_gridLabels) {
+        m_context->Display(label, Standard_False);
+        m_context->Deactivate(label);
+    }
+}
+
 void CADController::setActiveCommand(CADCommand* command)
 {
     if (m_activeCommand) {
@@ -200,15 +302,11 @@ void CADController::onCommandCompleted(const TopoDS_Shape& shape)
     if (m_activeCommand && m_collection) {
         BeamCommand* beamCmd = qobject_cast<BeamCommand*>(m_activeCommand);
         if (beamCmd) {
-            qDebug() << "CADController: Creating TBeam object from command";
             
             // Get beam parameters from command
             gp_Pnt start = beamCmd->getLastStartPoint();
             gp_Pnt end = beamCmd->getLastEndPoint();
             
-            qDebug() << "  Start:" << start.X() << start.Y() << start.Z();
-            qDebug() << "  End:" << end.X() << end.Y() << end.Z();
-            
             // Create TBeam with proper parameters
             Handle(TBeam) beam = new TBeam(start, end);
             
@@ -223,21 +321,28 @@ void CADController::onCommandCompleted(const TopoDS_Shape& shape)
             
             // Add to collection
             m_collection->AddObject(beam);
-            qDebug() << "TBeam object added to collection, ID:" << beam->GetID();
+            LOG_DEBUG("controller", "Beam %1 added (%2, %3, %4) -> (%5, %6, %7)", beam->GetID(),
+                      start.X(), start.Y(), start.Z(), end.X(), end.Y(), end.Z());
         }
         
+        // Column and slab commands only collect parameters; the parametric
+        // constructors build the shape once and the collection displays it
         ColumnCommand* columnCmd = qobject_cast<ColumnCommand*>(m_activeCommand);
         if (columnCmd) {
-            Handle(TColumn) column = new TColumn();
+            gp_Pnt base = columnCmd->getLastBasePoint();
+            Handle(TColumn) column = new TColumn(base, columnCmd->getWidth(),
+                                                 columnCmd->getDepth(), columnCmd->getHeight());
             m_collection->AddObject(column);
-            qDebug() << "TColumn object added to collection";
+            LOG_DEBUG("controller", "Column %1 added at (%2, %3, %4)", column->GetID(),
+                      base.X(), base.Y(), base.Z());
         }
         
         SlabCommand* slabCmd = qobject_cast<SlabCommand*>(m_activeCommand);
         if (slabCmd) {
-            Handle(TSlab) slab = new TSlab();
+            Handle(TSlab) slab = new TSlab(slabCmd->getLastCorner1(), slabCmd->getLastCorner2(),
+                                           slabCmd->getThickness());
             m_collection->AddObject(slab);
-            qDebug() << "TSlab object added to collection";
+            LOG_DEBUG("controller", "Slab %1 added, %2 mm thick", slab->GetID(), slab->GetThickness());
         }
     }
     
@@ -274,3 +379,35 @@ void CADController::hideSnapMarker()
         m_viewer->clearSnapMarker();
     }
 }
+
+void CADController::requestSnap(int x, int y, const gp_Pnt& cursorPoint, const Handle(V3d_View)& view)
+{
+    if (view.IsNull() || !m_collection) {
+        return;
+    }
+    m_snapCursor = cursorPoint;
+    m_snapService->request(m_snapManager.sceneFor(m_collection), m_snapManager.makeQuery(x, y, view));
+}
+
+void CADController::cancelSnap()
+{
+    m_snapService->cancel();
+}
+
+void CADController::onSnapCandidates(int serial, const QList<SnapManager::SnapPoint>& ranked)
+{
+    Q_UNUSED(serial);
+    if (!m_viewer) {
+        return;
+    }
+    
+    SnapManager::SnapPoint snap = m_snapManager.pickVisible(ranked, m_viewer->getView());
+    if (snap.type != SnapManager::None) {
+        showSnapMarker(snap.point, snap.type, snap.description);
+        handleMove(snap.point);
+    } else {
+        hideSnapMarker();
+        handleMove(m_snapCursor);
+    }
+    emit snapUpdated(snap);
+}
@@ -1,8 +1,5 @@
 #include "ColumnCommand.h"
 #include "OCCTViewer.h"
-#include <BRepPrimAPI_MakeBox.hxx>
-#include <BRepBuilderAPI_MakeEdge.hxx>
-#include <BRepBuilderAPI_MakeWire.hxx>
 #include <Precision.hxx>
 #include <Standard_Failure.hxx>
 
@@ -20,14 +17,13 @@ void ColumnCommand::execute(const gp_Pnt& point)
     m_basePoint = point;
     m_pointSet = true;
     
-    TopoDS_Shape column = createColumn(m_basePoint);
-    displayShape(column);
-    
     emit statusUpdate(QString("Column created at (%1, %2, %3)")
                      .arg(point.X(), 0, 'f', 1)
                      .arg(point.Y(), 0, 'f', 1)
                      .arg(point.Z(), 0, 'f', 1));
-    emit commandCompleted(column);
+    
+    // The controller builds and displays the parametric TColumn from the getters
+    emit commandCompleted(TopoDS_Shape());
     
     m_pointSet = false;
 }
@@ -43,24 +39,13 @@ void ColumnCommand::updatePreview(const gp_Pnt& point)
                 return;
             }
             
-            // Create base rectangle outline + vertical line to show column footprint
-            gp_Pnt corner1(point.X() - m_width/2, point.Y() - m_depth/2, point.Z());
-            gp_Pnt corner2(point.X() + m_width/2, point.Y() - m_depth/2, point.Z());
-            gp_Pnt corner3(point.X() + m_width/2, point.Y() + m_depth/2, point.Z());
-            gp_Pnt corner4(point.X() - m_width/2, point.Y() + m_depth/2, point.Z());
-            gp_Pnt top(point.X(), point.Y(), point.Z() + m_height);
-            
-            // Base rectangle + vertical line
-            BRepBuilderAPI_MakeWire wireBuilder;
-            wireBuilder.Add(BRepBuilderAPI_MakeEdge(corner1, corner2));
-            wireBuilder.Add(BRepBuilderAPI_MakeEdge(corner2, corner3));
-            wireBuilder.Add(BRepBuilderAPI_MakeEdge(corner3, corner4));
-            wireBuilder.Add(BRepBuilderAPI_MakeEdge(corner4, corner1));
-            wireBuilder.Add(BRepBuilderAPI_MakeEdge(point, top));
-            
-            if (wireBuilder.IsDone() && !wireBuilder.Wire().IsNull()) {
-                showPreview(wireBuilder.Wire());
+            // Column box + axis around the base point, built once and then only moved
+            if (m_outline.IsNull()) {
+                m_outline = new PreviewOutline();
+                m_outline->addBox(gp_XYZ(-m_width / 2, -m_depth / 2, 0), gp_XYZ(m_width / 2, m_depth / 2, m_height));
+                m_outline->addSegment(gp_XYZ(0, 0, 0), gp_XYZ(0, 0, m_height));
             }
+            showOutline(PreviewOutline::boxPlacement(point));
             
             emit statusUpdate(QString("Position: (%1, %2, %3) - Click to place column")
                              .arg(point.X(), 0, 'f', 1)
@@ -92,15 +77,6 @@ void ColumnCommand::setDimensions(double width, double depth, double height)
     m_width = width;
     m_depth = depth;
     m_height = height;
-}
-
-TopoDS_Shape ColumnCommand::createColumn(const gp_Pnt& basePoint)
-{
-    gp_Pnt corner(
-        basePoint.X() - m_width / 2.0,
-        basePoint.Y() - m_depth / 2.0,
-        basePoint.Z()
-    );
-    
-    return BRepPrimAPI_MakeBox(corner, m_width, m_depth, m_height).Shape();
+    clearPreview();
+    m_outline.Nullify();
 }
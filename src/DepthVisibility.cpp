@@ -0,0 +1,143 @@
+#include "DepthVisibility.h"
+#include "Logger.h"
+#include <V3d_Viewer.hxx>
+#include <V3d_ImageDumpOptions.hxx>
+#include <Graphic3d_Camera.hxx>
+#include <Graphic3d_ZLayerSettings.hxx>
+#include <Aspect_Window.hxx>
+#include <Standard_Failure.hxx>
+#include <algorithm>
+#include <cmath>
+
+DepthVisibility::DepthVisibility()
+    : m_width(0)
+    , m_height(0)
+    , m_valid(false)
+    , m_failed(false)
+{
+}
+
+bool DepthVisibility::update(const Handle(V3d_View)& view)
+{
+    if (view.IsNull() || view->Window().IsNull()) {
+        return false;
+    }
+    
+    Standard_Integer width = 0, height = 0;
+    view->Window()->Size(width, height);
+    const Graphic3d_WorldViewProjState state = view->Camera()->WorldViewProjState();
+    
+    if ((m_valid || m_failed) && state == m_state && width == m_width && height == m_height) {
+        return m_valid;
+    }
+    
+    m_state = state;
+    m_width = width;
+    m_height = height;
+    m_valid = false;
+    m_failed = true;
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    
+    // Overlay layers clear the depth buffer before drawing (snap marker, labels).
+    // Draw them without depth for the readback so the scene depth survives.
+    Handle(V3d_Viewer) viewer = view->Viewer();
+    const Graphic3d_ZLayerId overlays[2] = { Graphic3d_ZLayerId_Topmost, Graphic3d_ZLayerId_TopOSD };
+    Graphic3d_ZLayerSettings saved[2];
+    for (int i = 0; i < 2; ++i) {
+        saved[i] = viewer->ZLayerSettings(overlays[i]);
+        Graphic3d_ZLayerSettings flat = saved[i];
+        flat.SetClearDepth(Standard_False);
+        flat.SetEnableDepthTest(Standard_False);
+        flat.SetEnableDepthWrite(Standard_False);
+        viewer->SetZLayerSettings(overlays[i], flat);
+    }
+    
+    try {
+        V3d_ImageDumpOptions options;
+        options.Width = width;
+        options.Height = height;
+        options.BufferType = Graphic3d_BT_Depth;
+        options.StereoOptions = V3d_SDO_MONO;
+        options.ToAdjustAspect = Standard_True;
+        
+        m_depth.Clear();
+        if (m_depth.InitZero(Image_Format_GrayF, width, height)
+            && view->ToPixMap(m_depth, options)) {
+            m_valid = true;
+            m_failed = false;
+        }
+    } catch (Standard_Failure const& ex) {
+        LOG_WARNING("snap", "Depth readback failed: %1", ex.GetMessageString());
+    }
+    
+    for (int i = 0; i < 2; ++i) {
+        viewer->SetZLayerSettings(overlays[i], saved[i]);
+    }
+    
+    if (!m_valid) {
+        LOG_INFO("snap", "No depth buffer, occlusion test disabled for this view");
+    }
+    return m_valid;
+}
+
+float DepthVisibility::sampleDepth(int col, int row) const
+{
+    const int width = static_cast<int>(m_depth.SizeX());
+    const int height = static_cast<int>(m_depth.SizeY());
+    float depth = 0.0f;
+    for (int r = std::max(0, row - 1); r <= std::min(height - 1, row + 1); ++r) {
+        for (int c = std::max(0, col - 1); c <= std::min(width - 1, col + 1); ++c) {
+            depth = std::max(depth, m_depth.Value<float>(r, c));
+        }
+    }
+    return depth;
+}
+
+void DepthVisibility::classify(const Handle(V3d_View)& view, const std::vector<gp_Pnt>& points,
+                               std::vector<char>& visible)
+{
+    visible.assign(points.size(), 1);
+    if (points.empty() || !update(view)) {
+        return;
+    }
+    
+    const Handle(Graphic3d_Camera)& camera = view->Camera();
+    const gp_Vec direction(camera->Direction());
+    // Depth precision is poor far from the camera; allow a little slack
+    const double tolerance = std::max(1.0, camera->Distance() * 0.002);
+    const int width = static_cast<int>(m_depth.SizeX());
+    const int height = static_cast<int>(m_depth.SizeY());
+    
+    for (size_t i = 0; i < points.size(); ++i) {
+        const gp_Pnt ndc = camera->Project(points[i]);
+        if (std::abs(ndc.X()) > 1.0 || std::abs(ndc.Y()) > 1.0) {
+            continue;   // Off screen, nothing to compare against
+        }
+        
+        // NDC y runs bottom-up; the pixmap may store rows either way
+        int col = std::min(width - 1, static_cast<int>((ndc.X() + 1.0) * 0.5 * width));
+        int row = std::min(height - 1, static_cast<int>((ndc.Y() + 1.0) * 0.5 * height));
+        if (m_depth.IsTopDown()) {
+            row = height - 1 - row;
+        }
+        
+        const float depth = sampleDepth(col, row);
+        if (depth >= 1.0f) {
+            continue;   // Background
+        }
+        
+        // Compare in world units along the view direction
+        const gp_Pnt surface = camera->UnProject(gp_Pnt(ndc.X(), ndc.Y(), 2.0 * depth - 1.0));
+        visible[i] = gp_Vec(surface, points[i]).Dot(direction) <= tolerance;
+    }
+}
+
+bool DepthVisibility::isVisible(const Handle(V3d_View)& view, const gp_Pnt& point)
+{
+    std::vector<gp_Pnt> points(1, point);
+    std::vector<char> visible;
+    classify(view, points, visible);
+    return visible[0] != 0;
+}
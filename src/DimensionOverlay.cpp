@@ -0,0 +1,465 @@
+#include "DimensionOverlay.h"
+#include "TObjectCollection.h"
+#include "TBeam.h"
+#include "TColumn.h"
+#include "Logger.h"
+#include <Aspect_Window.hxx>
+#include <ElSLib.hxx>
+#include <Graphic3d_ArrayOfSegments.hxx>
+#include <Graphic3d_AspectLine3d.hxx>
+#include <Graphic3d_Camera.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <Prs3d_Text.hxx>
+#include <Prs3d_TextAspect.hxx>
+#include <Quantity_Color.hxx>
+#include <TCollection_ExtendedString.hxx>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Screen sizes [px]
+const double kMinLength = 30.0;         // Shorter dimensions are not shown
+const double kExtensionGap = 3.0;
+const double kExtensionOvershoot = 4.0;
+const double kTickSize = 5.0;
+const double kLabelGap = 3.0;
+const double kLabelHeight = 12.0;
+const double kCharWidth = 7.0;
+const int kCellSize = 8;                // Label occupancy grid
+const int kMaxDimensions = 1500;
+
+inline quint64 cellKey(int cx, int cy)
+{
+    return (quint64(quint32(cx)) << 32) | quint32(cy);
+}
+
+double offsetPixels(DimensionOverlay::MeasureKind kind)
+{
+    switch (kind) {
+    case DimensionOverlay::GRID:   return 30.0;
+    case DimensionOverlay::OFFSET: return 12.0;
+    default:                       return 18.0;
+    }
+}
+
+struct Label {
+    gp_Pnt position;
+    QString text;
+};
+
+} // namespace
+
+/**
+ * @brief Laid-out dimension lines and labels, drawn on top of the scene
+ *
+ * Holds world-space geometry only; DimensionOverlay decides what goes in.
+ */
+class DimensionPresentation : public AIS_InteractiveObject
+{
+    DEFINE_STANDARD_RTTI_INLINE(DimensionPresentation, AIS_InteractiveObject)
+
+public:
+    DimensionPresentation()
+        : m_color(0.35, 0.85, 1.0, Quantity_TOC_RGB)
+    {
+        // Drawn over the model and left out of Fit All
+        SetInfiniteState(Standard_True);
+        SetZLayer(Graphic3d_ZLayerId_Topmost);
+    }
+
+    void setLayout(std::vector<gp_Pnt>& segments, std::vector<Label>& labels)
+    {
+        m_segments.swap(segments);
+        m_labels.swap(labels);
+    }
+
+    Standard_Boolean AcceptDisplayMode(const Standard_Integer mode) const override { return mode == 0; }
+
+protected:
+    void Compute(const Handle(PrsMgr_PresentationManager)& presentationManager,
+                 const Handle(Prs3d_Presentation)& presentation,
+                 const Standard_Integer mode) override
+    {
+        Q_UNUSED(presentationManager);
+        if (mode != 0 || m_segments.empty()) {
+            return;
+        }
+
+        Handle(Graphic3d_ArrayOfSegments) segments = new Graphic3d_ArrayOfSegments(static_cast<int>(m_segments.size()));
+        for (const gp_Pnt& p : m_segments) {
+            segments->AddVertex(p);
+        }
+        Handle(Graphic3d_Group) group = presentation->CurrentGroup();
+        group->SetGroupPrimitivesAspect(new Graphic3d_AspectLine3d(m_color, Aspect_TOL_SOLID, 1.0));
+        group->AddPrimitiveArray(segments);
+
+        Handle(Prs3d_TextAspect) textAspect = new Prs3d_TextAspect();
+        textAspect->SetColor(m_color);
+        textAspect->SetHeight(kLabelHeight);
+        textAspect->SetHorizontalJustification(Graphic3d_HTA_CENTER);
+        textAspect->SetVerticalJustification(Graphic3d_VTA_BOTTOM);
+        for (const Label& label : m_labels) {
+            Prs3d_Text::Draw(group, textAspect,
+                             TCollection_ExtendedString(label.text.toUtf8().constData(), Standard_True),
+                             label.position);
+        }
+    }
+
+    void ComputeSelection(const Handle(SelectMgr_Selection)& selection,
+                          const Standard_Integer mode) override
+    {
+        // Never picked
+        Q_UNUSED(selection);
+        Q_UNUSED(mode);
+    }
+
+private:
+    std::vector<gp_Pnt> m_segments;     // End points, in pairs
+    std::vector<Label> m_labels;
+    Quantity_Color m_color;
+};
+
+DimensionOverlay::DimensionOverlay(const Handle(AIS_InteractiveContext)& context, TObjectCollection* collection,
+                                   QObject* parent)
+    : QObject(parent)
+    , m_context(context)
+    , m_collection(collection)
+    , m_presentation(new DimensionPresentation())
+    , m_visible(false)
+    , m_layoutPending(false)
+    , m_allDirty(true)
+    , m_layoutWidth(0)
+    , m_layoutHeight(0)
+    , m_layoutValid(false)
+    , m_shownCount(0)
+{
+    connect(collection, &TObjectCollection::objectAdded, this, &DimensionOverlay::invalidate);
+    connect(collection, &TObjectCollection::objectModified, this, &DimensionOverlay::invalidate);
+    connect(collection, &TObjectCollection::objectRemoved, this, &DimensionOverlay::invalidate);
+    connect(collection, &TObjectCollection::objectsAdded, this, &DimensionOverlay::invalidateObjects);
+    connect(collection, &TObjectCollection::objectsModified, this, &DimensionOverlay::invalidateObjects);
+    connect(collection, &TObjectCollection::collectionCleared, this, &DimensionOverlay::clearObjects);
+}
+
+DimensionOverlay::~DimensionOverlay()
+{
+    if (!m_context.IsNull() && m_context->IsDisplayed(m_presentation)) {
+        m_context->Remove(m_presentation, Standard_False);
+    }
+}
+
+void DimensionOverlay::setVisible(bool visible, const Handle(V3d_View)& view)
+{
+    m_visible = visible;
+    if (!view.IsNull()) {
+        m_view = view;
+    }
+    if (m_context.IsNull()) {
+        return;
+    }
+
+    if (visible) {
+        m_layoutValid = false;
+        updateLayout(view);
+    } else if (m_context->IsDisplayed(m_presentation)) {
+        m_context->Erase(m_presentation, Standard_True);
+    }
+}
+
+void DimensionOverlay::setGrid(const StructuralGrid& grid, const gp_Ax3& plane)
+{
+    m_grid = grid;
+    m_plane = plane;
+    measureGrid();
+
+    // Offsets are measured from the grid
+    m_allDirty = true;
+    m_layoutValid = false;
+    scheduleLayout();
+}
+
+void DimensionOverlay::updateLayout(const Handle(V3d_View)& view)
+{
+    if (!view.IsNull()) {
+        m_view = view;
+    }
+    if (!m_visible || m_view.IsNull() || m_view->Window().IsNull() || m_context.IsNull()) {
+        return;
+    }
+
+    Standard_Integer width = 0, height = 0;
+    m_view->Window()->Size(width, height);
+    const Handle(Graphic3d_Camera)& camera = m_view->Camera();
+    const Graphic3d_WorldViewProjState state = camera->WorldViewProjState();
+    const bool measuresChanged = m_allDirty || !m_dirty.isEmpty();
+    if (m_layoutValid && !measuresChanged && state == m_layoutState
+        && width == m_layoutWidth && height == m_layoutHeight) {
+        return;
+    }
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    measureDirtyObjects();
+
+    m_layoutState = state;
+    m_layoutWidth = width;
+    m_layoutHeight = height;
+    m_layoutValid = true;
+
+    auto toPixels = [&](const gp_Pnt& p, double& x, double& y) {
+        const gp_Pnt ndc = camera->Project(p);
+        x = (ndc.X() + 1.0) * 0.5 * width;
+        y = (1.0 - ndc.Y()) * 0.5 * height;
+        return ndc.Z() >= -1.0 && ndc.Z() <= 1.0;
+    };
+
+    // Dimensions on screen and long enough to read, longest first
+    struct Candidate {
+        const Measure* measure;
+        double pixels;
+    };
+    std::vector<Candidate> candidates;
+    auto consider = [&](const Measure& measure) {
+        double x1, y1, x2, y2;
+        if (!toPixels(measure.first, x1, y1) || !toPixels(measure.second, x2, y2)) {
+            return;
+        }
+        if (std::max(x1, x2) < 0.0 || std::min(x1, x2) > width
+            || std::max(y1, y2) < 0.0 || std::min(y1, y2) > height) {
+            return;
+        }
+        const double pixels = std::hypot(x2 - x1, y2 - y1);
+        if (pixels >= kMinLength) {
+            candidates.push_back({ &measure, pixels });
+        }
+    };
+    for (const Measure& measure : m_gridMeasures) {
+        consider(measure);
+    }
+    for (auto it = m_objectMeasures.constBegin(); it != m_objectMeasures.constEnd(); ++it) {
+        Handle(TGraphicObject) object = m_collection->FindObject(it.key());
+        if (object.IsNull() || !object->IsVisible()) {
+            continue;
+        }
+        for (const Measure& measure : it.value()) {
+            consider(measure);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.pixels > b.pixels;
+    });
+
+    const gp_XYZ viewDir = camera->Direction().XYZ();
+    const gp_XYZ up = camera->Up().XYZ();
+    const gp_XYZ right = viewDir.Crossed(up);
+
+    std::vector<gp_Pnt> segments;
+    std::vector<Label> labels;
+    QSet<quint64> occupied;
+    for (const Candidate& candidate : candidates) {
+        if (static_cast<int>(labels.size()) >= kMaxDimensions) {
+            break;
+        }
+        const Measure& measure = *candidate.measure;
+        gp_XYZ along = measure.second.XYZ() - measure.first.XYZ();
+        const double length = along.Modulus();
+        if (length < 1e-6) {
+            continue;
+        }
+        along /= length;
+
+        // Offset in the view plane, perpendicular to the measured line
+        gp_XYZ side = along.Crossed(viewDir);
+        if (side.Modulus() < 0.1) {
+            continue;   // Measured along the line of sight
+        }
+        side.Normalize();
+        const double upward = side.Dot(up);
+        if (upward < -1e-3 || (std::abs(upward) <= 1e-3 && side.Dot(right) < 0.0)) {
+            side.Reverse();
+        }
+
+        // World size of a pixel at the dimension, right for perspective too
+        const gp_Pnt mid((measure.first.XYZ() + measure.second.XYZ()) * 0.5);
+        const gp_Pnt midNdc = camera->Project(mid);
+        const gp_Pnt nextPixel = camera->UnProject(gp_Pnt(midNdc.X() + 2.0 / width, midNdc.Y(), midNdc.Z()));
+        const double pixel = mid.Distance(nextPixel);
+        if (pixel < 1e-12) {
+            continue;
+        }
+
+        // Skip dimensions whose label would overlap one already placed
+        const QString text = QString::number(qRound(length));
+        const double offset = offsetPixels(measure.kind);
+        const gp_Pnt labelPoint(mid.XYZ() + side * (offset + kLabelGap) * pixel);
+        double lx, ly;
+        toPixels(labelPoint, lx, ly);
+        const double halfWidth = 0.5 * (text.size() * kCharWidth + 4.0);
+        const int cx0 = static_cast<int>(std::floor((lx - halfWidth) / kCellSize));
+        const int cx1 = static_cast<int>(std::floor((lx + halfWidth) / kCellSize));
+        const int cy0 = static_cast<int>(std::floor((ly - kLabelHeight - 2.0) / kCellSize));
+        const int cy1 = static_cast<int>(std::floor((ly + 2.0) / kCellSize));
+        bool fits = true;
+        for (int cx = cx0; cx <= cx1 && fits; ++cx) {
+            for (int cy = cy0; cy <= cy1 && fits; ++cy) {
+                fits = !occupied.contains(cellKey(cx, cy));
+            }
+        }
+        if (!fits) {
+            continue;
+        }
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            for (int cy = cy0; cy <= cy1; ++cy) {
+                occupied.insert(cellKey(cx, cy));
+            }
+        }
+
+        const gp_XYZ a = measure.first.XYZ() + side * offset * pixel;
+        const gp_XYZ b = measure.second.XYZ() + side * offset * pixel;
+        const gp_XYZ tick = (along + side).Normalized() * kTickSize * pixel;
+
+        // Extension lines, dimension line and ticks
+        segments.push_back(gp_Pnt(measure.first.XYZ() + side * kExtensionGap * pixel));
+        segments.push_back(gp_Pnt(a + side * kExtensionOvershoot * pixel));
+        segments.push_back(gp_Pnt(measure.second.XYZ() + side * kExtensionGap * pixel));
+        segments.push_back(gp_Pnt(b + side * kExtensionOvershoot * pixel));
+        segments.push_back(gp_Pnt(a));
+        segments.push_back(gp_Pnt(b));
+        segments.push_back(gp_Pnt(a - tick));
+        segments.push_back(gp_Pnt(a + tick));
+        segments.push_back(gp_Pnt(b - tick));
+        segments.push_back(gp_Pnt(b + tick));
+        labels.push_back({ labelPoint, text });
+    }
+    m_shownCount = static_cast<int>(labels.size());
+
+    Handle(DimensionPresentation)::DownCast(m_presentation)->setLayout(segments, labels);
+    if (m_context->IsDisplayed(m_presentation)) {
+        m_context->Redisplay(m_presentation, Standard_False);
+    } else {
+        m_context->Display(m_presentation, 0, -1, Standard_False);
+    }
+    m_context->UpdateCurrentViewer();
+
+    LOG_DEBUG("viewer", "Dimensions: %1 shown of %2 candidates", m_shownCount, static_cast<int>(candidates.size()));
+}
+
+void DimensionOverlay::invalidate(int objectID)
+{
+    m_dirty.insert(objectID);
+    scheduleLayout();
+}
+
+void DimensionOverlay::invalidateObjects(const QList<int>& objectIDs)
+{
+    for (int id : objectIDs) {
+        m_dirty.insert(id);
+    }
+    scheduleLayout();
+}
+
+void DimensionOverlay::clearObjects()
+{
+    m_objectMeasures.clear();
+    m_dirty.clear();
+    m_allDirty = false;
+    m_layoutValid = false;
+    scheduleLayout();
+}
+
+void DimensionOverlay::scheduleLayout()
+{
+    // Edits arrive in bursts; lay out once when control returns to the event loop
+    if (m_layoutPending || !m_visible) {
+        return;
+    }
+    m_layoutPending = true;
+    QTimer::singleShot(0, this, [this]() {
+        m_layoutPending = false;
+        updateLayout(Handle(V3d_View)());
+    });
+}
+
+void DimensionOverlay::measureDirtyObjects()
+{
+    if (m_allDirty) {
+        m_objectMeasures.clear();
+        m_dirty.clear();
+        NCollection_Sequence<Handle(TGraphicObject)> objects = m_collection->GetAllObjects();
+        for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(objects); it.More(); it.Next()) {
+            m_dirty.insert(it.Value()->GetID());
+        }
+        m_allDirty = false;
+    }
+
+    for (int id : m_dirty) {
+        QVector<Measure> measures;
+        Handle(TGraphicObject) object = m_collection->FindObject(id);
+        Handle(TBeam) beam = Handle(TBeam)::DownCast(object);
+        Handle(TColumn) column = Handle(TColumn)::DownCast(object);
+        if (!beam.IsNull()) {
+            measures.append({ beam->GetStartPoint(), beam->GetEndPoint(), LENGTH });
+            addOffsets(beam->GetStartPoint(), measures);
+            addOffsets(beam->GetEndPoint(), measures);
+        } else if (!column.IsNull()) {
+            addOffsets(column->GetBasePoint(), measures);
+        }
+
+        if (measures.isEmpty()) {
+            m_objectMeasures.remove(id);
+        } else {
+            m_objectMeasures.insert(id, measures);
+        }
+    }
+    m_dirty.clear();
+}
+
+void DimensionOverlay::measureGrid()
+{
+    m_gridMeasures.clear();
+
+    // A chain of spacings per direction, just outside the first axis of the other
+    const double extension = m_grid.getExtension() * 0.5;
+    const int uCount = m_grid.axisCount(StructuralGrid::U);
+    const int vCount = m_grid.axisCount(StructuralGrid::V);
+    const double vLine = (vCount > 0 ? m_grid.axis(StructuralGrid::V, 0).position : 0.0) - extension;
+    const double uLine = (uCount > 0 ? m_grid.axis(StructuralGrid::U, 0).position : 0.0) - extension;
+    for (int i = 1; i < uCount; ++i) {
+        m_gridMeasures.append({ ElSLib::PlaneValue(m_grid.axis(StructuralGrid::U, i - 1).position, vLine, m_plane),
+                                ElSLib::PlaneValue(m_grid.axis(StructuralGrid::U, i).position, vLine, m_plane),
+                                GRID });
+    }
+    for (int i = 1; i < vCount; ++i) {
+        m_gridMeasures.append({ ElSLib::PlaneValue(uLine, m_grid.axis(StructuralGrid::V, i - 1).position, m_plane),
+                                ElSLib::PlaneValue(uLine, m_grid.axis(StructuralGrid::V, i).position, m_plane),
+                                GRID });
+    }
+}
+
+void DimensionOverlay::addOffsets(const gp_Pnt& point, QVector<Measure>& measures) const
+{
+    if (m_grid.isEmpty()) {
+        return;
+    }
+
+    double u, v;
+    ElSLib::PlaneParameters(m_plane, point, u, v);
+    const StructuralGrid::Direction directions[2] = { StructuralGrid::U, StructuralGrid::V };
+    for (StructuralGrid::Direction direction : directions) {
+        const double coordinate = direction == StructuralGrid::U ? u : v;
+        const int index = m_grid.nearestAxis(direction, coordinate);
+        if (index < 0) {
+            continue;
+        }
+        const double delta = m_grid.axis(direction, index).position - coordinate;
+        if (std::abs(delta) < 1.0) {
+            continue;   // On the axis
+        }
+        const gp_Dir& axisDir = direction == StructuralGrid::U ? m_plane.XDirection() : m_plane.YDirection();
+        measures.append({ gp_Pnt(point.XYZ() + axisDir.XYZ() * delta), point, OFFSET });
+    }
+}
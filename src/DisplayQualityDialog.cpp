@@ -0,0 +1,196 @@
+#include "DisplayQualityDialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QFormLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QGroupBox>
+#include <cmath>
+
+DisplayQualityDialog::DisplayQualityDialog(QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle("Display Quality");
+    setupUI();
+    applyStyles();
+    resize(460, 320);
+}
+
+void DisplayQualityDialog::setupUI()
+{
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    
+    // Tessellation per object type
+    QGroupBox* meshGroup = new QGroupBox("Tessellation");
+    QGridLayout* meshLayout = new QGridLayout();
+    meshLayout->addWidget(new QLabel("Deviation"), 0, 1);
+    meshLayout->addWidget(new QLabel("Angle"), 0, 2);
+    meshLayout->addWidget(new QLabel("LOD"), 0, 3);
+    
+    const QList<QPair<TGraphicObject::ObjectType, QString>> types = {
+        { TGraphicObject::TYPE_BEAM, "Beams" },
+        { TGraphicObject::TYPE_COLUMN, "Columns" },
+        { TGraphicObject::TYPE_SLAB, "Slabs" }
+    };
+    
+    int gridRow = 1;
+    for (const auto& type : types) {
+        Row row;
+        row.coefficient = new QDoubleSpinBox();
+        row.coefficient->setRange(0.0001, 0.05);
+        row.coefficient->setDecimals(4);
+        row.coefficient->setSingleStep(0.0005);
+        row.coefficient->setToolTip("Chordal deviation relative to the object size (smaller is finer)");
+        
+        row.angle = new QDoubleSpinBox();
+        row.angle->setRange(1.0, 60.0);
+        row.angle->setDecimals(1);
+        row.angle->setSuffix(" deg");
+        
+        row.levelOfDetail = new QCheckBox();
+        row.levelOfDetail->setToolTip("Show a coarse stand-in when the object is small on screen");
+        
+        meshLayout->addWidget(new QLabel(type.second), gridRow, 0);
+        meshLayout->addWidget(row.coefficient, gridRow, 1);
+        meshLayout->addWidget(row.angle, gridRow, 2);
+        meshLayout->addWidget(row.levelOfDetail, gridRow, 3);
+        m_rows.insert(type.first, row);
+        gridRow++;
+    }
+    
+    meshGroup->setLayout(meshLayout);
+    mainLayout->addWidget(meshGroup);
+    
+    // Level of detail switching thresholds
+    QGroupBox* lodGroup = new QGroupBox("Level of Detail");
+    QFormLayout* lodLayout = new QFormLayout();
+    
+    m_coarseBelowSpin = new QDoubleSpinBox();
+    m_coarseBelowSpin->setRange(1.0, 500.0);
+    m_coarseBelowSpin->setDecimals(0);
+    m_coarseBelowSpin->setSuffix(" px");
+    lodLayout->addRow("Coarse below:", m_coarseBelowSpin);
+    
+    m_fullAboveSpin = new QDoubleSpinBox();
+    m_fullAboveSpin->setRange(1.0, 500.0);
+    m_fullAboveSpin->setDecimals(0);
+    m_fullAboveSpin->setSuffix(" px");
+    lodLayout->addRow("Full above:", m_fullAboveSpin);
+    
+    // The full threshold never drops under the coarse one
+    connect(m_coarseBelowSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double value) {
+        m_fullAboveSpin->setMinimum(value);
+    });
+    
+    lodGroup->setLayout(lodLayout);
+    mainLayout->addWidget(lodGroup);
+    
+    // Buttons
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    buttonLayout->addStretch();
+    
+    QPushButton* okButton = new QPushButton("OK");
+    QPushButton* cancelButton = new QPushButton("Cancel");
+    
+    connect(okButton, &QPushButton::clicked, this, &QDialog::accept);
+    connect(cancelButton, &QPushButton::clicked, this, &QDialog::reject);
+    
+    buttonLayout->addWidget(okButton);
+    buttonLayout->addWidget(cancelButton);
+    
+    mainLayout->addLayout(buttonLayout);
+}
+
+void DisplayQualityDialog::applyStyles()
+{
+    setStyleSheet(R"(
+        QDialog {
+            background-color: #2b2b2b;
+            color: #ffffff;
+        }
+        QGroupBox {
+            border: 1px solid #555555;
+            border-radius: 4px;
+            margin-top: 8px;
+            padding-top: 8px;
+            font-weight: bold;
+            color: #ffffff;
+        }
+        QGroupBox::title {
+            subcontrol-origin: margin;
+            left: 10px;
+            padding: 0 5px;
+        }
+        QLabel {
+            color: #cccccc;
+        }
+        QDoubleSpinBox {
+            background-color: #3c3c3c;
+            border: 1px solid #555555;
+            border-radius: 3px;
+            padding: 5px;
+            color: #ffffff;
+            min-height: 25px;
+        }
+        QDoubleSpinBox:hover {
+            border: 1px solid #0d6efd;
+        }
+        QCheckBox::indicator {
+            width: 18px;
+            height: 18px;
+            border: 1px solid #555555;
+            border-radius: 3px;
+            background-color: #3c3c3c;
+        }
+        QCheckBox::indicator:checked {
+            background-color: #0d6efd;
+            border-color: #0d6efd;
+        }
+        QPushButton {
+            background-color: #0d6efd;
+            color: white;
+            border: none;
+            border-radius: 4px;
+            padding: 8px 20px;
+            font-weight: bold;
+            min-width: 80px;
+        }
+        QPushButton:hover {
+            background-color: #0b5ed7;
+        }
+        QPushButton:pressed {
+            background-color: #0a58ca;
+        }
+    )");
+}
+
+void DisplayQualityDialog::setQuality(TGraphicObject::ObjectType type, const TObjectCollection::DisplayQuality& quality)
+{
+    if (!m_rows.contains(type)) {
+        return;
+    }
+    const Row row = m_rows.value(type);
+    row.coefficient->setValue(quality.deviationCoefficient);
+    row.angle->setValue(quality.deviationAngle * 180.0 / M_PI);
+    row.levelOfDetail->setChecked(quality.levelOfDetail);
+}
+
+TObjectCollection::DisplayQuality DisplayQualityDialog::getQuality(TGraphicObject::ObjectType type) const
+{
+    TObjectCollection::DisplayQuality quality = { 0.001, 20.0 * M_PI / 180.0, false };
+    if (!m_rows.contains(type)) {
+        return quality;
+    }
+    const Row row = m_rows.value(type);
+    quality.deviationCoefficient = row.coefficient->value();
+    quality.deviationAngle = row.angle->value() * M_PI / 180.0;
+    quality.levelOfDetail = row.levelOfDetail->isChecked();
+    return quality;
+}
+
+void DisplayQualityDialog::setThresholds(double coarseBelowPixels, double fullAbovePixels)
+{
+    m_coarseBelowSpin->setValue(coarseBelowPixels);
+    m_fullAboveSpin->setValue(fullAbovePixels);
+}
@@ -0,0 +1,281 @@
+#include "DrawingGenerator.h"
+#include "TObjectCollection.h"
+#include "Logger.h"
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <HLRAlgo_Projector.hxx>
+#include <HLRBRep_PolyAlgo.hxx>
+#include <HLRBRep_PolyHLRToShape.hxx>
+#include <OSD_Parallel.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopoDS_Vertex.hxx>
+#include <gp_Ax2.hxx>
+#include <QFile>
+#include <QSet>
+#include <QTextStream>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+const double kUnbounded = 1.0e12;      // mm
+const double kViewGap = 1000.0;        // Between views in the DXF [mm]
+
+gp_Ax2 viewAxes(DrawingGenerator::ViewDirection direction)
+{
+    // Normal points at the viewer, X direction is to the right on the sheet
+    switch (direction) {
+    case DrawingGenerator::FRONT: return gp_Ax2(gp::Origin(), gp_Dir(0, -1, 0), gp_Dir(1, 0, 0));
+    case DrawingGenerator::SIDE:  return gp_Ax2(gp::Origin(), gp_Dir(1, 0, 0), gp_Dir(0, 1, 0));
+    default:                      return gp_Ax2(gp::Origin(), gp_Dir(0, 0, 1), gp_Dir(1, 0, 0));
+    }
+}
+
+// HLR output edges are straight segments in the projection plane
+void appendLines(const TopoDS_Shape& compound, QVector<DrawingGenerator::Line>& lines)
+{
+    if (compound.IsNull()) {
+        return;
+    }
+    for (TopExp_Explorer exp(compound, TopAbs_EDGE); exp.More(); exp.Next()) {
+        TopoDS_Vertex first, last;
+        TopExp::Vertices(TopoDS::Edge(exp.Current()), first, last);
+        if (first.IsNull() || last.IsNull()) {
+            continue;
+        }
+        const gp_Pnt p1 = BRep_Tool::Pnt(first);
+        const gp_Pnt p2 = BRep_Tool::Pnt(last);
+        lines.append({ p1.X(), p1.Y(), p2.X(), p2.Y() });
+    }
+}
+
+} // namespace
+
+DrawingGenerator::View::View(ViewDirection dir)
+    : direction(dir)
+    , min{ -kUnbounded, -kUnbounded, -kUnbounded }
+    , max{ kUnbounded, kUnbounded, kUnbounded }
+    , objectCount(0)
+{
+}
+
+DrawingGenerator::DrawingGenerator(TObjectCollection* collection, const Options& options, QObject* parent)
+    : QObject(parent)
+    , m_collection(collection)
+    , m_options(options)
+    , m_meshedCount(0)
+{
+    connect(collection, &TObjectCollection::objectModified, this, &DrawingGenerator::invalidate);
+    connect(collection, &TObjectCollection::objectRemoved, this, &DrawingGenerator::invalidate);
+    connect(collection, &TObjectCollection::objectsModified, this, &DrawingGenerator::invalidateObjects);
+    connect(collection, &TObjectCollection::collectionCleared, this, &DrawingGenerator::clearCache);
+}
+
+void DrawingGenerator::generate(QVector<View>& views)
+{
+    struct MeshJob {
+        int objectID;
+        TopoDS_Shape shape;
+        bool copyMesh;
+        TopoDS_Shape copy;
+    };
+
+    // Cull each view through the spatial index and queue objects without a current copy
+    QVector<MeshJob> jobs;
+    QVector<QVector<int>> viewObjects(views.size());
+    QSet<int> queued;
+    for (int v = 0; v < views.size(); ++v) {
+        const NCollection_Sequence<int> ids = m_collection->FindObjectsInBox(views.at(v).min, views.at(v).max);
+        for (NCollection_Sequence<int>::Iterator it(ids); it.More(); it.Next()) {
+            Handle(TGraphicObject) object = m_collection->FindObject(it.Value());
+            if (object.IsNull() || object->GetShape().IsNull()) {
+                continue;
+            }
+            viewObjects[v].append(it.Value());
+
+            auto cached = m_meshes.constFind(it.Value());
+            if ((cached != m_meshes.constEnd() && cached->source.IsEqual(object->GetShape()))
+                || queued.contains(it.Value())) {
+                continue;
+            }
+            queued.insert(it.Value());
+            // A shape still being meshed in the background is copied without its faces' meshes
+            jobs.append({ it.Value(), object->GetShape(), !m_collection->IsMeshPending(it.Value()), TopoDS_Shape() });
+        }
+    }
+
+    // Each job meshes its own copy, so objects mesh concurrently
+    const Options options = m_options;
+    MeshJob* data = jobs.data();
+    OSD_Parallel::For(0, jobs.size(), [data, &options](int i) {
+        MeshJob& job = data[i];
+        try {
+            TopoDS_Shape copy = BRepBuilderAPI_Copy(job.shape, Standard_True, job.copyMesh).Shape();
+            BRepMesh_IncrementalMesh(copy, options.deflection, Standard_False, options.angle, Standard_False);
+            job.copy = copy;
+        } catch (Standard_Failure const& ex) {
+            LOG_WARNING("drawing", "Cannot mesh object %1: %2", job.objectID, ex.GetMessageString());
+        }
+    });
+
+    for (const MeshJob& job : jobs) {
+        if (job.copy.IsNull()) {
+            m_meshes.remove(job.objectID);
+        } else {
+            m_meshes.insert(job.objectID, { job.shape, job.copy });
+        }
+    }
+    m_meshedCount = jobs.size();
+
+    // One hidden-line pass per view over all of its objects; the copies are
+    // only read by the projection, so views share them and run in parallel
+    struct ViewJob {
+        ViewDirection direction;
+        TopoDS_Compound compound;
+        int objectCount;
+        QVector<Line> visible;
+        QVector<Line> hidden;
+    };
+    QVector<ViewJob> viewJobs(views.size());
+    BRep_Builder builder;
+    for (int v = 0; v < views.size(); ++v) {
+        ViewJob& job = viewJobs[v];
+        job.direction = views.at(v).direction;
+        job.objectCount = 0;
+        builder.MakeCompound(job.compound);
+        for (int id : viewObjects.at(v)) {
+            auto cached = m_meshes.constFind(id);
+            if (cached != m_meshes.constEnd()) {
+                builder.Add(job.compound, cached->copy);
+                job.objectCount++;
+            }
+        }
+    }
+
+    ViewJob* viewData = viewJobs.data();
+    OSD_Parallel::For(0, viewJobs.size(), [viewData](int i) {
+        ViewJob& job = viewData[i];
+        if (job.objectCount == 0) {
+            return;
+        }
+        try {
+            Handle(HLRBRep_PolyAlgo) algo = new HLRBRep_PolyAlgo();
+            algo->Load(job.compound);
+            algo->Projector(HLRAlgo_Projector(viewAxes(job.direction)));
+            algo->Update();
+
+            HLRBRep_PolyHLRToShape hlr;
+            hlr.Update(algo);
+            appendLines(hlr.VCompound(), job.visible);
+            appendLines(hlr.OutLineVCompound(), job.visible);
+            appendLines(hlr.HCompound(), job.hidden);
+            appendLines(hlr.OutLineHCompound(), job.hidden);
+        } catch (Standard_Failure const& ex) {
+            LOG_WARNING("drawing", "Cannot project view %1: %2", i, ex.GetMessageString());
+        }
+    });
+
+    for (int v = 0; v < views.size(); ++v) {
+        View& view = views[v];
+        view.visible = viewJobs.at(v).visible;
+        view.hidden = viewJobs.at(v).hidden;
+        view.objectCount = viewObjects.at(v).size();
+    }
+
+    LOG_DEBUG("drawing", "Generated %1 views, %2 objects meshed", views.size(), m_meshedCount);
+}
+
+void DrawingGenerator::clearCache()
+{
+    m_meshes.clear();
+}
+
+void DrawingGenerator::invalidate(int objectID)
+{
+    m_meshes.remove(objectID);
+}
+
+void DrawingGenerator::invalidateObjects(const QList<int>& objectIDs)
+{
+    for (int id : objectIDs) {
+        invalidate(id);
+    }
+}
+
+bool DrawingGenerator::writeDxf(const QVector<View>& views, const QString& fileName, QString* error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        if (error) *error = QString("Cannot write %1").arg(fileName);
+        return false;
+    }
+
+    QTextStream out(&file);
+    auto pair = [&out](int code, const QString& value) {
+        out << code << '\n' << value << '\n';
+    };
+    auto real = [](double value) {
+        return QString::number(value, 'f', 3);
+    };
+
+    pair(0, "SECTION"); pair(2, "HEADER"); pair(0, "ENDSEC");
+
+    pair(0, "SECTION"); pair(2, "TABLES");
+    pair(0, "TABLE"); pair(2, "LTYPE"); pair(70, "2");
+    pair(0, "LTYPE"); pair(2, "CONTINUOUS"); pair(70, "0"); pair(3, "Solid line");
+    pair(72, "65"); pair(73, "0"); pair(40, "0.0");
+    pair(0, "LTYPE"); pair(2, "HIDDEN"); pair(70, "0"); pair(3, "Hidden __ __ __");
+    pair(72, "65"); pair(73, "2"); pair(40, "9.0"); pair(49, "6.0"); pair(49, "-3.0");
+    pair(0, "ENDTAB");
+    pair(0, "TABLE"); pair(2, "LAYER"); pair(70, "2");
+    pair(0, "LAYER"); pair(2, "VISIBLE"); pair(70, "0"); pair(62, "7"); pair(6, "CONTINUOUS");
+    pair(0, "LAYER"); pair(2, "HIDDEN"); pair(70, "0"); pair(62, "8"); pair(6, "HIDDEN");
+    pair(0, "ENDTAB");
+    pair(0, "ENDSEC");
+
+    // Views left to right in the order given, bottoms aligned
+    pair(0, "SECTION"); pair(2, "ENTITIES");
+    double sheetX = 0.0;
+    for (const View& view : views) {
+        double xmin = std::numeric_limits<double>::max(), ymin = xmin;
+        double xmax = -xmin;
+        for (const QVector<Line>* lines : { &view.visible, &view.hidden }) {
+            for (const Line& line : *lines) {
+                xmin = std::min(xmin, std::min(line.x1, line.x2));
+                xmax = std::max(xmax, std::max(line.x1, line.x2));
+                ymin = std::min(ymin, std::min(line.y1, line.y2));
+            }
+        }
+        if (xmin > xmax) {
+            continue;   // Nothing in this view
+        }
+
+        const double dx = sheetX - xmin;
+        const double dy = -ymin;
+        for (int layer = 0; layer < 2; ++layer) {
+            const QVector<Line>& lines = layer == 0 ? view.visible : view.hidden;
+            const QString layerName = layer == 0 ? "VISIBLE" : "HIDDEN";
+            for (const Line& line : lines) {
+                pair(0, "LINE"); pair(8, layerName);
+                pair(10, real(line.x1 + dx)); pair(20, real(line.y1 + dy)); pair(30, "0.0");
+                pair(11, real(line.x2 + dx)); pair(21, real(line.y2 + dy)); pair(31, "0.0");
+            }
+        }
+        sheetX += (xmax - xmin) + kViewGap;
+    }
+    pair(0, "ENDSEC");
+    pair(0, "EOF");
+
+    out.flush();
+    if (file.error() != QFileDevice::NoError) {
+        if (error) *error = QString("Cannot write %1").arg(fileName);
+        return false;
+    }
+    return true;
+}
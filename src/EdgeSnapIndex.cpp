@@ -0,0 +1,219 @@
+#include "EdgeSnapIndex.h"
+#include "Logger.h"
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Edge.hxx>
+#include <BRepAdaptor_Curve.hxx>
+#include <BRep_Tool.hxx>
+#include <GCPnts_TangentialDeflection.hxx>
+#include <Standard_Failure.hxx>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int kLeafSize = 4;
+const double kAngularDeflection = 0.2;     // rad, for curved edges
+}
+
+EdgeSnapIndex::EdgeSnapIndex()
+{
+}
+
+void EdgeSnapIndex::addShape(const TopoDS_Shape& shape, double deflection)
+{
+    for (TopExp_Explorer exp(shape, TopAbs_EDGE); exp.More(); exp.Next()) {
+        const TopoDS_Edge& edge = TopoDS::Edge(exp.Current());
+        if (BRep_Tool::Degenerated(edge)) {
+            continue;
+        }
+        
+        try {
+            BRepAdaptor_Curve curve(edge);
+            if (curve.GetType() == GeomAbs_Line) {
+                // Straight edges stay exact: one segment, analytic projection
+                addSegment(curve.Value(curve.FirstParameter()), curve.Value(curve.LastParameter()));
+                continue;
+            }
+            
+            GCPnts_TangentialDeflection points(curve, kAngularDeflection, deflection);
+            for (int i = 2; i <= points.NbPoints(); ++i) {
+                addSegment(points.Value(i - 1), points.Value(i));
+            }
+        } catch (Standard_Failure const& ex) {
+            LOG_WARNING("snap", "Edge index skipping edge: %1", ex.GetMessageString());
+        }
+    }
+}
+
+void EdgeSnapIndex::addSegment(const gp_Pnt& a, const gp_Pnt& b, bool interior)
+{
+    m_segments.push_back({ a, b, interior });
+}
+
+void EdgeSnapIndex::build()
+{
+    m_nodes.clear();
+    m_order.resize(m_segments.size());
+    for (size_t i = 0; i < m_order.size(); ++i) {
+        m_order[i] = static_cast<int>(i);
+    }
+    if (!m_order.empty()) {
+        m_nodes.reserve(2 * m_order.size() / kLeafSize + 1);
+        buildNode(0, static_cast<int>(m_order.size()));
+    }
+}
+
+int EdgeSnapIndex::buildNode(int begin, int end)
+{
+    Node node;
+    for (int k = 0; k < 3; ++k) {
+        node.min[k] = 1e100;
+        node.max[k] = -1e100;
+    }
+    for (int i = begin; i < end; ++i) {
+        const Segment& s = m_segments[m_order[i]];
+        const double ca[3] = { s.a.X(), s.a.Y(), s.a.Z() };
+        const double cb[3] = { s.b.X(), s.b.Y(), s.b.Z() };
+        for (int k = 0; k < 3; ++k) {
+            node.min[k] = std::min(node.min[k], std::min(ca[k], cb[k]));
+            node.max[k] = std::max(node.max[k], std::max(ca[k], cb[k]));
+        }
+    }
+    node.left = node.right = -1;
+    node.first = begin;
+    node.count = end - begin;
+    
+    const int index = static_cast<int>(m_nodes.size());
+    m_nodes.push_back(node);
+    if (end - begin <= kLeafSize) {
+        return index;
+    }
+    
+    // Median split on the longest axis of the node
+    int axis = 0;
+    for (int k = 1; k < 3; ++k) {
+        if (node.max[k] - node.min[k] > node.max[axis] - node.min[axis]) {
+            axis = k;
+        }
+    }
+    const int mid = (begin + end) / 2;
+    std::nth_element(m_order.begin() + begin, m_order.begin() + mid, m_order.begin() + end,
+                     [this, axis](int lhs, int rhs) {
+        const Segment& l = m_segments[lhs];
+        const Segment& r = m_segments[rhs];
+        return l.a.Coord(axis + 1) + l.b.Coord(axis + 1) < r.a.Coord(axis + 1) + r.b.Coord(axis + 1);
+    });
+    
+    const int left = buildNode(begin, mid);
+    const int right = buildNode(mid, end);
+    m_nodes[index].left = left;
+    m_nodes[index].right = right;
+    m_nodes[index].count = 0;
+    return index;
+}
+
+bool EdgeSnapIndex::rayNearBox(const gp_Lin& ray, const double min[3], const double max[3], double tolerance)
+{
+    // Slab test of the infinite pick line against the box grown by tolerance
+    const gp_Pnt& o = ray.Location();
+    const gp_Dir& d = ray.Direction();
+    double tmin = -1e100, tmax = 1e100;
+    for (int k = 0; k < 3; ++k) {
+        const double origin = o.Coord(k + 1);
+        const double dir = d.Coord(k + 1);
+        const double lo = min[k] - tolerance;
+        const double hi = max[k] + tolerance;
+        if (std::abs(dir) < 1e-12) {
+            if (origin < lo || origin > hi) {
+                return false;
+            }
+            continue;
+        }
+        double t1 = (lo - origin) / dir;
+        double t2 = (hi - origin) / dir;
+        if (t1 > t2) std::swap(t1, t2);
+        tmin = std::max(tmin, t1);
+        tmax = std::min(tmax, t2);
+        if (tmin > tmax) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Visitor>
+void EdgeSnapIndex::traverse(const gp_Lin& ray, double tolerance, Visitor visit) const
+{
+    if (m_nodes.empty()) {
+        return;
+    }
+    // Median splits keep the tree shallow, but the walk does not rely on it
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (!rayNearBox(ray, node.min, node.max, tolerance)) {
+            continue;
+        }
+        if (node.left < 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                visit(m_order[i]);
+            }
+        } else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+double EdgeSnapIndex::closestToRay(int index, const gp_Lin& ray, gp_Pnt& point) const
+{
+    const Segment& s = m_segments[index];
+    const gp_XYZ o = ray.Location().XYZ();
+    const gp_XYZ d = ray.Direction().XYZ();
+    const gp_XYZ u = s.b.XYZ() - s.a.XYZ();
+    const gp_XYZ w = s.a.XYZ() - o;
+    
+    // Minimise |a + s*u - line|^2 over s in [0,1]; convex, so clamping is exact
+    const double uu = u.Dot(u);
+    const double ud = u.Dot(d);
+    const double denom = uu - ud * ud;
+    double param = 0.0;
+    if (denom > 1e-12 * std::max(uu, 1.0)) {
+        param = (ud * d.Dot(w) - u.Dot(w)) / denom;
+        param = std::min(1.0, std::max(0.0, param));
+    }
+    
+    point = gp_Pnt(s.a.XYZ() + param * u);
+    const gp_XYZ v = point.XYZ() - o;
+    return (v - v.Dot(d) * d).Modulus();
+}
+
+EdgeSnapIndex::Hit EdgeSnapIndex::nearest(const gp_Lin& ray, double tolerance) const
+{
+    Hit best;
+    best.rayDistance = tolerance;
+    traverse(ray, tolerance, [&](int index) {
+        gp_Pnt p;
+        double dist = closestToRay(index, ray, p);
+        if (dist <= best.rayDistance) {
+            best.valid = true;
+            best.point = p;
+            best.rayDistance = dist;
+            best.segment = index;
+        }
+    });
+    return best;
+}
+
+void EdgeSnapIndex::collect(const gp_Lin& ray, double tolerance, std::vector<int>& result) const
+{
+    traverse(ray, tolerance, [&](int index) {
+        gp_Pnt p;
+        if (closestToRay(index, ray, p) <= tolerance) {
+            result.push_back(index);
+        }
+    });
+}
@@ -0,0 +1,39 @@
+#include "GeometryCache.h"
+
+GeometryCache& GeometryCache::instance()
+{
+    static GeometryCache cache;
+    return cache;
+}
+
+TopoDS_Shape GeometryCache::find(quint64 hash) const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_shapes.value(hash);
+}
+
+TopoDS_Shape GeometryCache::findOrInsert(quint64 hash, const TopoDS_Shape& localShape)
+{
+    if (hash == 0 || localShape.IsNull()) {
+        return localShape;
+    }
+    QMutexLocker lock(&m_mutex);
+    auto it = m_shapes.constFind(hash);
+    if (it != m_shapes.constEnd()) {
+        return it.value();
+    }
+    m_shapes.insert(hash, localShape);
+    return localShape;
+}
+
+void GeometryCache::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_shapes.clear();
+}
+
+int GeometryCache::size() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_shapes.size();
+}
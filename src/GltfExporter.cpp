@@ -0,0 +1,418 @@
+#include "GltfExporter.h"
+#include "Logger.h"
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRep_Tool.hxx>
+#include <OSD_Parallel.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopoDS.hxx>
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPair>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+enum {
+    GL_BYTE = 5120,
+    GL_UNSIGNED_SHORT = 5123,
+    GL_UNSIGNED_INT = 5125,
+    GL_ARRAY_BUFFER = 34962,
+    GL_ELEMENT_ARRAY_BUFFER = 34963
+};
+
+// Triangulated prototype, quantized to the 16-bit grid over its box:
+// position = origin + q * step (uniform step keeps the normals valid)
+struct MeshData {
+    std::vector<quint16> positions;     // x, y, z, pad
+    std::vector<qint8> normals;         // x, y, z, pad
+    std::vector<quint32> indices;
+    double origin[3];
+    double step;
+    quint16 maxQuantized[3];
+
+    MeshData() : step(1.0) {}
+};
+
+MeshData triangulate(const TopoDS_Shape& prototype, double deflection, double angle)
+{
+    MeshData mesh;
+    std::vector<gp_Pnt> points;
+    std::vector<gp_Vec> normals;
+
+    try {
+        // Mesh a copy: the original's faces are shared with the viewer,
+        // which may be meshing them on its own threads
+        TopoDS_Shape copy = BRepBuilderAPI_Copy(prototype, Standard_True, Standard_False).Shape();
+        BRepMesh_IncrementalMesh mesher(copy, deflection, Standard_False, angle, Standard_False);
+
+        for (TopExp_Explorer exp(copy, TopAbs_FACE); exp.More(); exp.Next()) {
+            const TopoDS_Face& face = TopoDS::Face(exp.Current());
+            TopLoc_Location location;
+            const Handle(Poly_Triangulation)& tri = BRep_Tool::Triangulation(face, location);
+            if (tri.IsNull()) {
+                continue;
+            }
+            const gp_Trsf& trsf = location.Transformation();
+            const quint32 base = static_cast<quint32>(points.size());
+            for (int i = 1; i <= tri->NbNodes(); ++i) {
+                points.push_back(tri->Node(i).Transformed(trsf));
+                normals.push_back(gp_Vec(0, 0, 0));
+            }
+
+            // Faces own their nodes, so area-weighted triangle normals give flat faces
+            const bool reversed = face.Orientation() == TopAbs_REVERSED;
+            for (int t = 1; t <= tri->NbTriangles(); ++t) {
+                int n1, n2, n3;
+                tri->Triangle(t).Get(n1, n2, n3);
+                if (reversed) {
+                    std::swap(n2, n3);
+                }
+                const quint32 a = base + n1 - 1, b = base + n2 - 1, c = base + n3 - 1;
+                const gp_Vec normal = gp_Vec(points[a], points[b]).Crossed(gp_Vec(points[a], points[c]));
+                normals[a] += normal;
+                normals[b] += normal;
+                normals[c] += normal;
+                mesh.indices.push_back(a);
+                mesh.indices.push_back(b);
+                mesh.indices.push_back(c);
+            }
+        }
+    } catch (Standard_Failure const& ex) {
+        LOG_WARNING("export", "Triangulating a part failed: %1", ex.GetMessageString());
+        mesh.indices.clear();
+        return mesh;
+    }
+    if (mesh.indices.empty()) {
+        return mesh;
+    }
+
+    double lower[3] = { 1e300, 1e300, 1e300 };
+    double upper[3] = { -1e300, -1e300, -1e300 };
+    for (const gp_Pnt& p : points) {
+        for (int k = 0; k < 3; ++k) {
+            lower[k] = std::min(lower[k], p.Coord(k + 1));
+            upper[k] = std::max(upper[k], p.Coord(k + 1));
+        }
+    }
+    const double extent = std::max({ upper[0] - lower[0], upper[1] - lower[1], upper[2] - lower[2] });
+    mesh.step = extent > 0.0 ? extent / 65535.0 : 1.0;
+    std::copy(lower, lower + 3, mesh.origin);
+    std::fill(mesh.maxQuantized, mesh.maxQuantized + 3, 0);
+
+    mesh.positions.reserve(points.size() * 4);
+    mesh.normals.reserve(points.size() * 4);
+    for (size_t i = 0; i < points.size(); ++i) {
+        for (int k = 0; k < 3; ++k) {
+            const quint16 q = static_cast<quint16>(std::lround((points[i].Coord(k + 1) - lower[k]) / mesh.step));
+            mesh.positions.push_back(q);
+            mesh.maxQuantized[k] = std::max(mesh.maxQuantized[k], q);
+        }
+        mesh.positions.push_back(0);
+
+        gp_Vec n = normals[i];
+        if (n.Magnitude() > 1e-12) {
+            n.Normalize();
+        }
+        mesh.normals.push_back(static_cast<qint8>(std::lround(n.X() * 127.0)));
+        mesh.normals.push_back(static_cast<qint8>(std::lround(n.Y() * 127.0)));
+        mesh.normals.push_back(static_cast<qint8>(std::lround(n.Z() * 127.0)));
+        mesh.normals.push_back(0);
+    }
+    return mesh;
+}
+
+// Appends data as a buffer view, padded to 4 bytes; returns the view index
+int addBufferView(QByteArray& bin, QJsonArray& views, const void* data, int size, int stride, int target)
+{
+    QJsonObject view;
+    view["buffer"] = 0;
+    view["byteOffset"] = bin.size();
+    view["byteLength"] = size;
+    if (stride > 0) {
+        view["byteStride"] = stride;
+    }
+    view["target"] = target;
+    bin.append(static_cast<const char*>(data), size);
+    while (bin.size() % 4) {
+        bin.append('\0');
+    }
+    views.append(view);
+    return views.size() - 1;
+}
+
+QJsonArray toArray(const double* values, int count)
+{
+    QJsonArray array;
+    for (int i = 0; i < count; ++i) {
+        array.append(values[i]);
+    }
+    return array;
+}
+
+} // namespace
+
+GltfExporter::GltfExporter(const Options& options)
+    : m_options(options)
+    , m_meshCount(0)
+    , m_nodeCount(0)
+{
+}
+
+bool GltfExporter::exportObjects(const NCollection_Sequence<Handle(TGraphicObject)>& objects, const QString& fileName)
+{
+    m_error.clear();
+    m_meshCount = 0;
+    m_nodeCount = 0;
+
+    // One prototype per shared TShape, placed by the object's location.
+    // Scaled locations cannot be split off and stay baked into their own prototype.
+    struct Instance {
+        Handle(TGraphicObject) object;
+        int prototype;
+        gp_Trsf placement;
+    };
+    std::vector<TopoDS_Shape> prototypes;
+    std::vector<Instance> instances;
+    QHash<const TopoDS_TShape*, int> prototypeIndex;
+
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(objects); it.More(); it.Next()) {
+        const Handle(TGraphicObject)& object = it.Value();
+        if (object.IsNull() || object->GetShape().IsNull()) {
+            continue;
+        }
+        const TopoDS_Shape& shape = object->GetShape();
+        Instance instance;
+        instance.object = object;
+        if (std::abs(shape.Location().Transformation().ScaleFactor() - 1.0) < 1e-9) {
+            instance.placement = shape.Location().Transformation();
+            auto found = prototypeIndex.constFind(shape.TShape().get());
+            if (found != prototypeIndex.constEnd()) {
+                instance.prototype = found.value();
+            } else {
+                instance.prototype = static_cast<int>(prototypes.size());
+                prototypeIndex.insert(shape.TShape().get(), instance.prototype);
+                prototypes.push_back(shape.Located(TopLoc_Location()));
+            }
+        } else {
+            instance.prototype = static_cast<int>(prototypes.size());
+            prototypes.push_back(shape);
+        }
+        instances.push_back(instance);
+    }
+
+    if (instances.empty()) {
+        m_error = "There are no objects to export";
+        return false;
+    }
+
+    // Prototypes are independent: triangulate them concurrently
+    std::vector<MeshData> meshes(prototypes.size());
+    const double deflection = m_options.deflection;
+    const double angle = m_options.angle;
+    OSD_Parallel::For(0, static_cast<int>(prototypes.size()), [&prototypes, &meshes, deflection, angle](int i) {
+        meshes[i] = triangulate(prototypes[i], deflection, angle);
+    });
+
+    QByteArray bin;
+    QJsonArray bufferViews, accessors, gltfMeshes, materials, nodes;
+
+    // Accessors per prototype, shared by every material variant of its mesh
+    struct Accessors {
+        int position;
+        int normal;
+        int indices;
+    };
+    std::vector<Accessors> prototypeAccessors(prototypes.size(), Accessors{ -1, -1, -1 });
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const MeshData& mesh = meshes[i];
+        if (mesh.indices.empty()) {
+            continue;
+        }
+        const int vertexCount = static_cast<int>(mesh.positions.size() / 4);
+
+        QJsonObject position;
+        position["bufferView"] = addBufferView(bin, bufferViews, mesh.positions.data(),
+                                               static_cast<int>(mesh.positions.size() * sizeof(quint16)), 8, GL_ARRAY_BUFFER);
+        position["componentType"] = GL_UNSIGNED_SHORT;
+        position["count"] = vertexCount;
+        position["type"] = "VEC3";
+        position["min"] = QJsonArray({ 0, 0, 0 });
+        position["max"] = QJsonArray({ mesh.maxQuantized[0], mesh.maxQuantized[1], mesh.maxQuantized[2] });
+        accessors.append(position);
+        prototypeAccessors[i].position = accessors.size() - 1;
+
+        QJsonObject normal;
+        normal["bufferView"] = addBufferView(bin, bufferViews, mesh.normals.data(),
+                                             static_cast<int>(mesh.normals.size()), 4, GL_ARRAY_BUFFER);
+        normal["componentType"] = GL_BYTE;
+        normal["normalized"] = true;
+        normal["count"] = vertexCount;
+        normal["type"] = "VEC3";
+        accessors.append(normal);
+        prototypeAccessors[i].normal = accessors.size() - 1;
+
+        QJsonObject index;
+        // 16-bit indices stop at 65534: glTF reserves 65535 as primitive restart
+        if (vertexCount < 65536) {
+            std::vector<quint16> narrow(mesh.indices.begin(), mesh.indices.end());
+            index["bufferView"] = addBufferView(bin, bufferViews, narrow.data(),
+                                                static_cast<int>(narrow.size() * sizeof(quint16)), 0, GL_ELEMENT_ARRAY_BUFFER);
+            index["componentType"] = GL_UNSIGNED_SHORT;
+        } else {
+            index["bufferView"] = addBufferView(bin, bufferViews, mesh.indices.data(),
+                                                static_cast<int>(mesh.indices.size() * sizeof(quint32)), 0, GL_ELEMENT_ARRAY_BUFFER);
+            index["componentType"] = GL_UNSIGNED_INT;
+        }
+        index["count"] = static_cast<int>(mesh.indices.size());
+        index["type"] = "SCALAR";
+        accessors.append(index);
+        prototypeAccessors[i].indices = accessors.size() - 1;
+        m_meshCount++;
+    }
+
+    // glTF requires non-empty meshes and buffers, so there is no valid empty file
+    if (m_meshCount == 0) {
+        m_error = "None of the objects could be triangulated";
+        LOG_ERROR("export", "%1", m_error);
+        return false;
+    }
+
+    QHash<int, int> materialIndex;                  // Packed RGB -> material
+    QHash<QPair<int, int>, int> meshIndex;          // (prototype, material) -> mesh
+    QJsonArray children;
+
+    for (const Instance& instance : instances) {
+        const Accessors& acc = prototypeAccessors[instance.prototype];
+        if (acc.position < 0) {
+            continue;
+        }
+
+        int r, g, b;
+        instance.object->GetColor(r, g, b);
+        const int rgb = (r << 16) | (g << 8) | b;
+        if (!materialIndex.contains(rgb)) {
+            QJsonObject pbr;
+            pbr["baseColorFactor"] = QJsonArray({ r / 255.0, g / 255.0, b / 255.0, 1.0 });
+            pbr["metallicFactor"] = 0.0;
+            pbr["roughnessFactor"] = 0.8;
+            QJsonObject material;
+            material["pbrMetallicRoughness"] = pbr;
+            materials.append(material);
+            materialIndex.insert(rgb, materials.size() - 1);
+        }
+        const QPair<int, int> meshKey(instance.prototype, materialIndex.value(rgb));
+        if (!meshIndex.contains(meshKey)) {
+            QJsonObject attributes;
+            attributes["POSITION"] = acc.position;
+            attributes["NORMAL"] = acc.normal;
+            QJsonObject primitive;
+            primitive["attributes"] = attributes;
+            primitive["indices"] = acc.indices;
+            primitive["material"] = meshKey.second;
+            QJsonObject mesh;
+            mesh["primitives"] = QJsonArray({ primitive });
+            gltfMeshes.append(mesh);
+            meshIndex.insert(meshKey, gltfMeshes.size() - 1);
+        }
+
+        // Node matrix = placement * dequantization (translate to origin, uniform scale)
+        const MeshData& mesh = meshes[instance.prototype];
+        const gp_Trsf& trsf = instance.placement;
+        const gp_Pnt origin = gp_Pnt(mesh.origin[0], mesh.origin[1], mesh.origin[2]).Transformed(trsf);
+        double matrix[16];
+        for (int col = 0; col < 3; ++col) {
+            for (int row = 0; row < 3; ++row) {
+                matrix[col * 4 + row] = trsf.Value(row + 1, col + 1) * mesh.step;
+            }
+            matrix[col * 4 + 3] = 0.0;
+        }
+        matrix[12] = origin.X();
+        matrix[13] = origin.Y();
+        matrix[14] = origin.Z();
+        matrix[15] = 1.0;
+
+        QJsonObject node;
+        node["name"] = instance.object->GetName();
+        node["mesh"] = meshIndex.value(meshKey);
+        node["matrix"] = toArray(matrix, 16);
+        node["extras"] = QJsonObject({ { "id", instance.object->GetID() } });
+        nodes.append(node);
+        children.append(nodes.size());      // Node 0 is the root, prepended below
+        m_nodeCount++;
+    }
+
+    // Root: millimetres to metres, model Z-up to glTF Y-up (x, y, z) -> (x, z, -y)
+    const double rootMatrix[16] = { 0.001, 0, 0, 0,
+                                    0, 0, -0.001, 0,
+                                    0, 0.001, 0, 0,
+                                    0, 0, 0, 1 };
+    QJsonObject root;
+    root["name"] = "Model";
+    root["matrix"] = toArray(rootMatrix, 16);
+    root["children"] = children;
+    nodes.prepend(root);
+
+    QJsonObject asset;
+    asset["version"] = "2.0";
+    asset["generator"] = QCoreApplication::applicationName() + " " + QCoreApplication::applicationVersion();
+    QJsonObject buffer;
+    buffer["byteLength"] = bin.size();
+
+    QJsonObject gltf;
+    gltf["asset"] = asset;
+    gltf["extensionsUsed"] = QJsonArray({ "KHR_mesh_quantization" });
+    gltf["extensionsRequired"] = QJsonArray({ "KHR_mesh_quantization" });
+    gltf["scene"] = 0;
+    gltf["scenes"] = QJsonArray({ QJsonObject({ { "nodes", QJsonArray({ 0 }) } }) });
+    gltf["nodes"] = nodes;
+    gltf["meshes"] = gltfMeshes;
+    gltf["materials"] = materials;
+    gltf["accessors"] = accessors;
+    gltf["bufferViews"] = bufferViews;
+    gltf["buffers"] = QJsonArray({ buffer });
+
+    QByteArray json = QJsonDocument(gltf).toJson(QJsonDocument::Compact);
+    while (json.size() % 4) {
+        json.append(' ');
+    }
+
+    // GLB: 12-byte header, JSON chunk, BIN chunk (little-endian)
+    auto appendUInt32 = [](QByteArray& out, quint32 value) {
+        for (int i = 0; i < 4; ++i) {
+            out.append(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    };
+    QByteArray header;
+    appendUInt32(header, 0x46546C67);   // "glTF"
+    appendUInt32(header, 2);
+    appendUInt32(header, static_cast<quint32>(12 + 8 + json.size() + 8 + bin.size()));
+    appendUInt32(header, static_cast<quint32>(json.size()));
+    appendUInt32(header, 0x4E4F534A);   // "JSON"
+
+    QByteArray binHeader;
+    appendUInt32(binHeader, static_cast<quint32>(bin.size()));
+    appendUInt32(binHeader, 0x004E4942);    // "BIN"
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || file.write(header) < 0 || file.write(json) < 0
+        || file.write(binHeader) < 0 || file.write(bin) < 0) {
+        m_error = QString("Cannot write %1").arg(fileName);
+        LOG_ERROR("export", "%1", m_error);
+        return false;
+    }
+
+    LOG_INFO("export", "Wrote %1 objects with %2 meshes (%3 KB) to %4",
+             m_nodeCount, m_meshCount, static_cast<int>(file.size() / 1024), fileName);
+    return true;
+}
@@ -0,0 +1,176 @@
+#include "GridColumnsDialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QGroupBox>
+#include <algorithm>
+
+GridColumnsDialog::GridColumnsDialog(const StructuralGrid& grid, QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle("Columns at Grid Intersections");
+    
+    m_uList = createAxisList(grid, StructuralGrid::U);
+    m_vList = createAxisList(grid, StructuralGrid::V);
+    setupUI();
+    applyStyles();
+    
+    updateCount();
+    resize(420, 460);
+}
+
+QListWidget* GridColumnsDialog::createAxisList(const StructuralGrid& grid, StructuralGrid::Direction direction)
+{
+    QListWidget* list = new QListWidget();
+    list->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    for (int i = 0; i < grid.axisCount(direction); i++) {
+        const StructuralGrid::Axis& axis = grid.axis(direction, i);
+        list->addItem(QString("%1  (%2 mm)").arg(axis.label).arg(axis.position, 0, 'f', 0));
+    }
+    list->selectAll();
+    connect(list, &QListWidget::itemSelectionChanged, this, &GridColumnsDialog::updateCount);
+    return list;
+}
+
+void GridColumnsDialog::setupUI()
+{
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    
+    // Axes
+    QGroupBox* axesGroup = new QGroupBox("Grid Axes");
+    QHBoxLayout* axesLayout = new QHBoxLayout();
+    
+    QVBoxLayout* uLayout = new QVBoxLayout();
+    uLayout->addWidget(new QLabel("Along X (numbered):"));
+    uLayout->addWidget(m_uList);
+    axesLayout->addLayout(uLayout);
+    
+    QVBoxLayout* vLayout = new QVBoxLayout();
+    vLayout->addWidget(new QLabel("Along Y (lettered):"));
+    vLayout->addWidget(m_vList);
+    axesLayout->addLayout(vLayout);
+    
+    axesGroup->setLayout(axesLayout);
+    mainLayout->addWidget(axesGroup);
+    
+    // Column section and height, ColumnCommand defaults
+    QGroupBox* sizeGroup = new QGroupBox("Column");
+    QFormLayout* sizeLayout = new QFormLayout();
+    
+    m_widthSpin = new QDoubleSpinBox();
+    m_widthSpin->setRange(50.0, 5000.0);
+    m_widthSpin->setDecimals(0);
+    m_widthSpin->setSuffix(" mm");
+    m_widthSpin->setValue(300.0);
+    sizeLayout->addRow("Width:", m_widthSpin);
+    
+    m_depthSpin = new QDoubleSpinBox();
+    m_depthSpin->setRange(50.0, 5000.0);
+    m_depthSpin->setDecimals(0);
+    m_depthSpin->setSuffix(" mm");
+    m_depthSpin->setValue(300.0);
+    sizeLayout->addRow("Depth:", m_depthSpin);
+    
+    m_heightSpin = new QDoubleSpinBox();
+    m_heightSpin->setRange(100.0, 20000.0);
+    m_heightSpin->setDecimals(0);
+    m_heightSpin->setSingleStep(100.0);
+    m_heightSpin->setSuffix(" mm");
+    m_heightSpin->setValue(3000.0);
+    sizeLayout->addRow("Height:", m_heightSpin);
+    
+    sizeGroup->setLayout(sizeLayout);
+    mainLayout->addWidget(sizeGroup);
+    
+    m_countLabel = new QLabel();
+    mainLayout->addWidget(m_countLabel);
+    
+    // Buttons
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    buttonLayout->addStretch();
+    
+    m_okButton = new QPushButton("OK");
+    QPushButton* cancelButton = new QPushButton("Cancel");
+    
+    connect(m_okButton, &QPushButton::clicked, this, &QDialog::accept);
+    connect(cancelButton, &QPushButton::clicked, this, &QDialog::reject);
+    
+    buttonLayout->addWidget(m_okButton);
+    buttonLayout->addWidget(cancelButton);
+    
+    mainLayout->addLayout(buttonLayout);
+}
+
+QVector<int> GridColumnsDialog::selectedRows(const QListWidget* list)
+{
+    QVector<int> rows;
+    for (const QListWidgetItem* item : list->selectedItems()) {
+        rows.append(list->row(item));
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+void GridColumnsDialog::updateCount()
+{
+    const int count = m_uList->selectedItems().size() * m_vList->selectedItems().size();
+    m_countLabel->setText(QString("%1 columns will be placed").arg(count));
+    m_okButton->setEnabled(count > 0);
+}
+
+void GridColumnsDialog::applyStyles()
+{
+    setStyleSheet(R"(
+        QDialog {
+            background-color: #2b2b2b;
+            color: #ffffff;
+        }
+        QGroupBox {
+            border: 1px solid #555555;
+            border-radius: 4px;
+            margin-top: 8px;
+            padding-top: 8px;
+            font-weight: bold;
+            color: #ffffff;
+        }
+        QGroupBox::title {
+            subcontrol-origin: margin;
+            left: 10px;
+            padding: 0 5px;
+        }
+        QLabel {
+            color: #cccccc;
+        }
+        QListWidget, QDoubleSpinBox {
+            background-color: #3c3c3c;
+            border: 1px solid #555555;
+            border-radius: 3px;
+            padding: 5px;
+            color: #ffffff;
+        }
+        QListWidget::item:selected {
+            background-color: #0d6efd;
+        }
+        QDoubleSpinBox {
+            min-height: 25px;
+        }
+        QDoubleSpinBox:hover {
+            border: 1px solid #0d6efd;
+        }
+        QPushButton {
+            background-color: #0d6efd;
+            color: white;
+            border: none;
+            border-radius: 4px;
+            padding: 8px 20px;
+            font-weight: bold;
+            min-width: 80px;
+        }
+        QPushButton:hover {
+            background-color: #0b5ed7;
+        }
+        QPushButton:disabled {
+            background-color: #555555;
+        }
+    )");
+}
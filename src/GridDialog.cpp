@@ -0,0 +1,207 @@
+#include "GridDialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QPushButton>
+#include <QGroupBox>
+
+GridDialog::GridDialog(const StructuralGrid& grid, bool visible, QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle("Grid Settings");
+    setupUI();
+    applyStyles();
+    
+    if (grid.isEmpty()) {
+        m_uCoordinatesEdit->setText("0 4*6000");
+        m_vCoordinatesEdit->setText("0 3*6000");
+    } else {
+        m_uCoordinatesEdit->setText(grid.coordinatesText(StructuralGrid::U));
+        m_uLabelsEdit->setText(grid.labelsText(StructuralGrid::U));
+        m_vCoordinatesEdit->setText(grid.coordinatesText(StructuralGrid::V));
+        m_vLabelsEdit->setText(grid.labelsText(StructuralGrid::V));
+    }
+    m_extensionSpin->setValue(grid.getExtension());
+    m_visibleCheck->setChecked(visible);
+    
+    validateInput();
+    resize(460, 320);
+}
+
+void GridDialog::setupUI()
+{
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    
+    // U axes: lines of constant X in the work plane
+    QGroupBox* uGroup = new QGroupBox("Axes along X (numbered)");
+    QFormLayout* uLayout = new QFormLayout();
+    
+    m_uCoordinatesEdit = new QLineEdit();
+    m_uCoordinatesEdit->setToolTip("Start coordinate followed by spacings, e.g. 0 4*6000 7500");
+    uLayout->addRow("Coordinates:", m_uCoordinatesEdit);
+    
+    m_uLabelsEdit = new QLineEdit();
+    m_uLabelsEdit->setPlaceholderText("1");
+    m_uLabelsEdit->setToolTip("First label, or one label per axis");
+    uLayout->addRow("Labels:", m_uLabelsEdit);
+    
+    uGroup->setLayout(uLayout);
+    mainLayout->addWidget(uGroup);
+    
+    // V axes: lines of constant Y in the work plane
+    QGroupBox* vGroup = new QGroupBox("Axes along Y (lettered)");
+    QFormLayout* vLayout = new QFormLayout();
+    
+    m_vCoordinatesEdit = new QLineEdit();
+    m_vCoordinatesEdit->setToolTip("Start coordinate followed by spacings, e.g. 0 3*6000");
+    vLayout->addRow("Coordinates:", m_vCoordinatesEdit);
+    
+    m_vLabelsEdit = new QLineEdit();
+    m_vLabelsEdit->setPlaceholderText("A");
+    m_vLabelsEdit->setToolTip("First label, or one label per axis");
+    vLayout->addRow("Labels:", m_vLabelsEdit);
+    
+    vGroup->setLayout(vLayout);
+    mainLayout->addWidget(vGroup);
+    
+    // Display
+    QGroupBox* displayGroup = new QGroupBox("Display");
+    QFormLayout* displayLayout = new QFormLayout();
+    
+    m_extensionSpin = new QDoubleSpinBox();
+    m_extensionSpin->setRange(0.0, 100000.0);
+    m_extensionSpin->setSuffix(" mm");
+    m_extensionSpin->setDecimals(0);
+    m_extensionSpin->setSingleStep(500.0);
+    displayLayout->addRow("Line extension:", m_extensionSpin);
+    
+    m_visibleCheck = new QCheckBox("Show grid");
+    displayLayout->addRow(m_visibleCheck);
+    
+    displayGroup->setLayout(displayLayout);
+    mainLayout->addWidget(displayGroup);
+    
+    m_errorLabel = new QLabel();
+    m_errorLabel->setObjectName("errorLabel");
+    mainLayout->addWidget(m_errorLabel);
+    
+    // Buttons
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    buttonLayout->addStretch();
+    
+    m_okButton = new QPushButton("OK");
+    QPushButton* cancelButton = new QPushButton("Cancel");
+    
+    connect(m_okButton, &QPushButton::clicked, this, &QDialog::accept);
+    connect(cancelButton, &QPushButton::clicked, this, &QDialog::reject);
+    
+    buttonLayout->addWidget(m_okButton);
+    buttonLayout->addWidget(cancelButton);
+    
+    mainLayout->addLayout(buttonLayout);
+    
+    connect(m_uCoordinatesEdit, &QLineEdit::textChanged, this, &GridDialog::validateInput);
+    connect(m_vCoordinatesEdit, &QLineEdit::textChanged, this, &GridDialog::validateInput);
+}
+
+void GridDialog::validateInput()
+{
+    bool uOk = true, vOk = true;
+    if (!m_uCoordinatesEdit->text().trimmed().isEmpty()) {
+        StructuralGrid::parseCoordinates(m_uCoordinatesEdit->text(), &uOk);
+    }
+    if (!m_vCoordinatesEdit->text().trimmed().isEmpty()) {
+        StructuralGrid::parseCoordinates(m_vCoordinatesEdit->text(), &vOk);
+    }
+    
+    if (!uOk || !vOk) {
+        m_errorLabel->setText(QString("Invalid %1 coordinates").arg(!uOk ? "X" : "Y"));
+    } else {
+        m_errorLabel->clear();
+    }
+    m_okButton->setEnabled(uOk && vOk);
+}
+
+void GridDialog::applyStyles()
+{
+    setStyleSheet(R"(
+        QDialog {
+            background-color: #2b2b2b;
+            color: #ffffff;
+        }
+        QGroupBox {
+            border: 1px solid #555555;
+            border-radius: 4px;
+            margin-top: 8px;
+            padding-top: 8px;
+            font-weight: bold;
+            color: #ffffff;
+        }
+        QGroupBox::title {
+            subcontrol-origin: margin;
+            left: 10px;
+            padding: 0 5px;
+        }
+        QLabel {
+            color: #cccccc;
+        }
+        QLabel#errorLabel {
+            color: #e74c3c;
+        }
+        QLineEdit, QDoubleSpinBox {
+            background-color: #3c3c3c;
+            border: 1px solid #555555;
+            border-radius: 3px;
+            padding: 5px;
+            color: #ffffff;
+            min-height: 25px;
+        }
+        QLineEdit:hover, QDoubleSpinBox:hover {
+            border: 1px solid #0d6efd;
+        }
+        QCheckBox {
+            color: #cccccc;
+            spacing: 8px;
+        }
+        QCheckBox::indicator {
+            width: 18px;
+            height: 18px;
+            border: 1px solid #555555;
+            border-radius: 3px;
+            background-color: #3c3c3c;
+        }
+        QCheckBox::indicator:checked {
+            background-color: #0d6efd;
+            border-color: #0d6efd;
+        }
+        QPushButton {
+            background-color: #0d6efd;
+            color: white;
+            border: none;
+            border-radius: 4px;
+            padding: 8px 20px;
+            font-weight: bold;
+            min-width: 80px;
+        }
+        QPushButton:hover {
+            background-color: #0b5ed7;
+        }
+        QPushButton:disabled {
+            background-color: #555555;
+        }
+    )");
+}
+
+StructuralGrid GridDialog::getGrid() const
+{
+    StructuralGrid grid;
+    grid.setAxes(StructuralGrid::U, m_uCoordinatesEdit->text(), m_uLabelsEdit->text());
+    grid.setAxes(StructuralGrid::V, m_vCoordinatesEdit->text(), m_vLabelsEdit->text());
+    grid.setExtension(m_extensionSpin->value());
+    return grid;
+}
+
+bool GridDialog::isGridVisible() const
+{
+    return m_visibleCheck->isChecked();
+}
@@ -0,0 +1,533 @@
+#include "IfcExporter.h"
+#include "TBeam.h"
+#include "TColumn.h"
+#include "TSlab.h"
+#include "Logger.h"
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRep_Tool.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
+#include <gp.hxx>
+#include <gp_Trsf.hxx>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QUuid>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// STEP reals need the decimal point: "200." rather than "200"
+QString real(double value)
+{
+    QString s = QString::number(value, 'f', 6);
+    while (s.endsWith('0')) {
+        s.chop(1);
+    }
+    return s == "-0." ? QString("0.") : s;
+}
+
+// Quoted string with ISO 10303-21 escapes; $ when empty
+QString text(const QString& value)
+{
+    if (value.isEmpty()) {
+        return "$";
+    }
+    QString out = "'";
+    bool wide = false;
+    for (QChar c : value) {
+        const ushort u = c.unicode();
+        if (u < 32 || u > 126) {
+            if (!wide) {
+                out += "\\X2\\";
+                wide = true;
+            }
+            out += QString("%1").arg(u, 4, 16, QChar('0')).toUpper();
+            continue;
+        }
+        if (wide) {
+            out += "\\X0\\";
+            wide = false;
+        }
+        if (c == '\'') {
+            out += "''";
+        } else if (c == '\\') {
+            out += "\\\\";
+        } else {
+            out += c;
+        }
+    }
+    if (wide) {
+        out += "\\X0\\";
+    }
+    return out + "'";
+}
+
+QString ref(int id)
+{
+    return QString("#%1").arg(id);
+}
+
+QString refList(const QVector<int>& ids)
+{
+    QStringList refs;
+    refs.reserve(ids.size());
+    for (int id : ids) {
+        refs.append(ref(id));
+    }
+    return "(" + refs.join(',') + ")";
+}
+
+// 128-bit GUID in the 22-character IFC base-64 form: the top 2 bits,
+// then 21 digits of 6 bits
+QString newGuid()
+{
+    static const char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz_$";
+    const QByteArray bytes = QUuid::createUuid().toRfc4122();
+    int bit = 0;
+    auto take = [&bytes, &bit](int count) {
+        int value = 0;
+        for (int i = 0; i < count; ++i, ++bit) {
+            value = (value << 1) | ((static_cast<uchar>(bytes[bit >> 3]) >> (7 - (bit & 7))) & 1);
+        }
+        return value;
+    };
+    QString guid;
+    guid += QChar(digits[take(2)]);
+    for (int i = 0; i < 21; ++i) {
+        guid += QChar(digits[take(6)]);
+    }
+    return guid;
+}
+
+} // namespace
+
+IfcExporter::IfcExporter(const Options& options)
+    : m_options(options)
+    , m_elementCount(0)
+    , m_nextId(0)
+    , m_ownerHistory(0)
+    , m_bodyContext(0)
+    , m_storey(0)
+    , m_storeyPlacement(0)
+    , m_originPlacement(0)
+    , m_originPlacement2D(0)
+{
+}
+
+bool IfcExporter::exportObjects(const NCollection_Sequence<Handle(TGraphicObject)>& objects, const QString& fileName)
+{
+    m_error.clear();
+    m_elementCount = 0;
+    m_nextId = 0;
+    m_directions.clear();
+    m_profiles.clear();
+    m_materials.clear();
+    m_propertySets.clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_error = QString("Cannot write %1").arg(fileName);
+        LOG_ERROR("export", "%1", m_error);
+        return false;
+    }
+    m_out.setDevice(&file);
+
+    writeHeader(fileName);
+    writeSpatialStructure();
+
+    int skipped = 0;
+    const int chunkSize = std::max(1, m_options.chunkSize);
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(objects); it.More(); it.Next()) {
+        if (!writeElement(it.Value())) {
+            skipped++;
+            continue;
+        }
+        if (m_contained.size() >= chunkSize) {
+            flushRelations();
+        }
+    }
+    flushRelations();
+
+    m_out << "ENDSEC;\nEND-ISO-10303-21;\n";
+    m_out.flush();
+    m_out.setDevice(nullptr);
+
+    if (file.error() != QFileDevice::NoError) {
+        m_error = QString("Writing %1 failed: %2").arg(fileName, file.errorString());
+        LOG_ERROR("export", "%1", m_error);
+        return false;
+    }
+    LOG_INFO("export", "Wrote %1 IFC elements (%2 skipped) to %3", m_elementCount, skipped, fileName);
+    return true;
+}
+
+int IfcExporter::add(const QString& entity)
+{
+    const int id = ++m_nextId;
+    m_out << '#' << id << '=' << entity << ";\n";
+    return id;
+}
+
+void IfcExporter::writeHeader(const QString& fileName)
+{
+    const QString application = QCoreApplication::applicationName();
+    m_out << "ISO-10303-21;\nHEADER;\n"
+          << "FILE_DESCRIPTION(('ViewDefinition [ReferenceView_V1.2]'),'2;1');\n"
+          << "FILE_NAME(" << text(QFileInfo(fileName).fileName()) << ','
+          << text(QDateTime::currentDateTime().toString(Qt::ISODate)) << ",(''),(''),"
+          << text(application) << ',' << text(application + " " + QCoreApplication::applicationVersion()) << ",'');\n"
+          << "FILE_SCHEMA(('IFC4'));\nENDSEC;\nDATA;\n";
+}
+
+void IfcExporter::writeSpatialStructure()
+{
+    QString user = qEnvironmentVariable("USERNAME", qEnvironmentVariable("USER"));
+    QString organizationName = QCoreApplication::organizationName();
+    QString application = QCoreApplication::applicationName();
+    int person = add(QString("IFCPERSON($,%1,$,$,$,$,$,$)").arg(text(user.isEmpty() ? "User" : user)));
+    int organization = add(QString("IFCORGANIZATION($,%1,$,$,$)").arg(text(organizationName.isEmpty() ? application : organizationName)));
+    int personOrganization = add(QString("IFCPERSONANDORGANIZATION(%1,%2,$)").arg(ref(person), ref(organization)));
+    int applicationId = add(QString("IFCAPPLICATION(%1,%2,%3,%4)")
+                            .arg(ref(organization), text(QCoreApplication::applicationVersion()), text(application), text(application)));
+    m_ownerHistory = add(QString("IFCOWNERHISTORY(%1,%2,$,.ADDED.,$,$,$,%3)")
+                         .arg(ref(personOrganization), ref(applicationId), QString::number(QDateTime::currentSecsSinceEpoch())));
+
+    int origin = add("IFCCARTESIANPOINT((0.,0.,0.))");
+    m_originPlacement = add(QString("IFCAXIS2PLACEMENT3D(%1,$,$)").arg(ref(origin)));
+    int origin2D = add("IFCCARTESIANPOINT((0.,0.))");
+    m_originPlacement2D = add(QString("IFCAXIS2PLACEMENT2D(%1,$)").arg(ref(origin2D)));
+    int context = add(QString("IFCGEOMETRICREPRESENTATIONCONTEXT($,'Model',3,1.E-05,%1,$)").arg(ref(m_originPlacement)));
+    m_bodyContext = add(QString("IFCGEOMETRICREPRESENTATIONSUBCONTEXT('Body','Model',*,*,*,*,%1,$,.MODEL_VIEW.,$)").arg(ref(context)));
+
+    // Model coordinates are millimetres
+    int length = add("IFCSIUNIT(*,.LENGTHUNIT.,.MILLI.,.METRE.)");
+    int area = add("IFCSIUNIT(*,.AREAUNIT.,$,.SQUARE_METRE.)");
+    int volume = add("IFCSIUNIT(*,.VOLUMEUNIT.,$,.CUBIC_METRE.)");
+    int angle = add("IFCSIUNIT(*,.PLANEANGLEUNIT.,$,.RADIAN.)");
+    int units = add(QString("IFCUNITASSIGNMENT((%1,%2,%3,%4))").arg(ref(length), ref(area), ref(volume), ref(angle)));
+    int project = add(QString("IFCPROJECT(%1,%2,'Project',$,$,$,$,(%3),%4)")
+                      .arg(text(newGuid()), ref(m_ownerHistory), ref(context), ref(units)));
+
+    int sitePlacement = add(QString("IFCLOCALPLACEMENT($,%1)").arg(ref(m_originPlacement)));
+    int site = add(QString("IFCSITE(%1,%2,'Site',$,$,%3,$,$,.ELEMENT.,$,$,$,$,$)")
+                   .arg(text(newGuid()), ref(m_ownerHistory), ref(sitePlacement)));
+    int buildingPlacement = add(QString("IFCLOCALPLACEMENT(%1,%2)").arg(ref(sitePlacement), ref(m_originPlacement)));
+    int building = add(QString("IFCBUILDING(%1,%2,'Building',$,$,%3,$,$,.ELEMENT.,$,$,$)")
+                       .arg(text(newGuid()), ref(m_ownerHistory), ref(buildingPlacement)));
+    m_storeyPlacement = add(QString("IFCLOCALPLACEMENT(%1,%2)").arg(ref(buildingPlacement), ref(m_originPlacement)));
+    m_storey = add(QString("IFCBUILDINGSTOREY(%1,%2,'Level 0',$,$,%3,$,$,.ELEMENT.,0.)")
+                   .arg(text(newGuid()), ref(m_ownerHistory), ref(m_storeyPlacement)));
+
+    add(QString("IFCRELAGGREGATES(%1,%2,$,$,%3,(%4))").arg(text(newGuid()), ref(m_ownerHistory), ref(project), ref(site)));
+    add(QString("IFCRELAGGREGATES(%1,%2,$,$,%3,(%4))").arg(text(newGuid()), ref(m_ownerHistory), ref(site), ref(building)));
+    add(QString("IFCRELAGGREGATES(%1,%2,$,$,%3,(%4))").arg(text(newGuid()), ref(m_ownerHistory), ref(building), ref(m_storey)));
+}
+
+bool IfcExporter::writeElement(const Handle(TGraphicObject)& object)
+{
+    if (object.IsNull()) {
+        return false;
+    }
+
+    // Profile in the XY plane of the element frame, extruded along its Z.
+    // axis and refDirection give that Z and X in the object's local frame.
+    QString entity, predefinedType, objectType;
+    int profile = 0;
+    double depth = 0.0;
+    gp_Dir axis = gp::DZ();
+    gp_Dir refDirection = gp::DX();
+
+    switch (object->GetType()) {
+    case TGraphicObject::TYPE_BEAM: {
+        Handle(TBeam) beam = Handle(TBeam)::DownCast(object);
+        if (beam.IsNull()) {
+            return false;
+        }
+        depth = beam->GetLength();
+        if (depth <= 0.0) {
+            return false;
+        }
+        // Local beams run along +X with the width along +Y
+        profile = beamProfile(beam, objectType);
+        axis = gp::DX();
+        refDirection = gp::DY();
+        entity = "IFCBEAM";
+        predefinedType = ".BEAM.";
+        break;
+    }
+    case TGraphicObject::TYPE_COLUMN: {
+        Handle(TColumn) column = Handle(TColumn)::DownCast(object);
+        if (column.IsNull()) {
+            return false;
+        }
+        double width, columnDepth, height;
+        column->GetDimensions(width, columnDepth, height);
+        depth = height;
+        profile = rectangleProfile(std::max(width, columnDepth), std::min(width, columnDepth));
+        entity = "IFCCOLUMN";
+        predefinedType = ".COLUMN.";
+        break;
+    }
+    case TGraphicObject::TYPE_SLAB: {
+        Handle(TSlab) slab = Handle(TSlab)::DownCast(object);
+        if (slab.IsNull()) {
+            return false;
+        }
+        double dx, dy;
+        slab->GetPlanSize(dx, dy);
+        depth = slab->GetThickness();
+        profile = rectangleProfile(std::max(dx, dy), std::min(dx, dy));
+        entity = "IFCSLAB";
+        predefinedType = ".FLOOR.";
+        break;
+    }
+    default:
+        return false;
+    }
+
+    const TopoDS_Shape& shape = object->GetShape();
+    int localPlacement = 0;
+    int representation = 0;
+    if (shape.IsNull() || object->HasPartShape()) {
+        // The shape is the local solid under a location (see BuildPlacedShape),
+        // so its location also carries moves applied to the shape alone
+        const gp_Trsf placement = shape.IsNull() ? object->GetPlacement() : shape.Location().Transformation();
+        int frame = axisPlacement(gp::Origin().Transformed(placement), axis.Transformed(placement),
+                                  refDirection.Transformed(placement));
+        localPlacement = add(QString("IFCLOCALPLACEMENT(%1,%2)").arg(ref(m_storeyPlacement), ref(frame)));
+        int extrusion = direction(gp::DZ());
+        int solid = add(QString("IFCEXTRUDEDAREASOLID(%1,%2,%3,%4)")
+                        .arg(ref(profile), ref(m_originPlacement), ref(extrusion), real(depth)));
+        representation = add(QString("IFCSHAPEREPRESENTATION(%1,'Body','SweptSolid',(%2))").arg(ref(m_bodyContext), ref(solid)));
+    } else {
+        // Scaled or mirrored: the parameters no longer describe the solid,
+        // so its faces are written as triangles in model coordinates
+        int faceSet = triangulatedFaceSet(shape);
+        if (!faceSet) {
+            LOG_WARNING("export", "Object %1 was skipped: its transformed shape could not be tessellated", object->GetID());
+            return false;
+        }
+        localPlacement = add(QString("IFCLOCALPLACEMENT(%1,%2)").arg(ref(m_storeyPlacement), ref(m_originPlacement)));
+        representation = add(QString("IFCSHAPEREPRESENTATION(%1,'Body','Tessellation',(%2))").arg(ref(m_bodyContext), ref(faceSet)));
+    }
+    int productShape = add(QString("IFCPRODUCTDEFINITIONSHAPE($,$,(%1))").arg(ref(representation)));
+    int element = add(QString("%1(%2,%3,%4,$,%5,%6,%7,%8,%9)")
+                      .arg(entity, text(newGuid()), ref(m_ownerHistory), text(object->GetName()), text(objectType),
+                           ref(localPlacement), ref(productShape), text(QString::number(object->GetID())), predefinedType));
+
+    m_contained.append(element);
+    if (!object->GetMaterial().isEmpty()) {
+        m_byMaterial[material(object->GetMaterial())].append(element);
+    }
+    int properties = propertySet(object);
+    if (properties) {
+        m_byPropertySet[properties].append(element);
+    }
+    if (!object->GetLayer().isEmpty()) {
+        m_representationsByLayer[object->GetLayer()].append(representation);
+    }
+    m_elementCount++;
+    return true;
+}
+
+void IfcExporter::flushRelations()
+{
+    if (!m_contained.isEmpty()) {
+        add(QString("IFCRELCONTAINEDINSPATIALSTRUCTURE(%1,%2,$,$,%3,%4)")
+            .arg(text(newGuid()), ref(m_ownerHistory), refList(m_contained), ref(m_storey)));
+    }
+    for (auto it = m_byMaterial.constBegin(); it != m_byMaterial.constEnd(); ++it) {
+        add(QString("IFCRELASSOCIATESMATERIAL(%1,%2,$,$,%3,%4)")
+            .arg(text(newGuid()), ref(m_ownerHistory), refList(it.value()), ref(it.key())));
+    }
+    for (auto it = m_byPropertySet.constBegin(); it != m_byPropertySet.constEnd(); ++it) {
+        add(QString("IFCRELDEFINESBYPROPERTIES(%1,%2,$,$,%3,%4)")
+            .arg(text(newGuid()), ref(m_ownerHistory), refList(it.value()), ref(it.key())));
+    }
+    for (auto it = m_representationsByLayer.constBegin(); it != m_representationsByLayer.constEnd(); ++it) {
+        add(QString("IFCPRESENTATIONLAYERASSIGNMENT(%1,$,%2,$)").arg(text(it.key()), refList(it.value())));
+    }
+
+    m_contained.clear();
+    m_byMaterial.clear();
+    m_byPropertySet.clear();
+    m_representationsByLayer.clear();
+}
+
+int IfcExporter::direction(const gp_Dir& dir)
+{
+    const QString coordinates = QString("(%1,%2,%3)").arg(real(dir.X()), real(dir.Y()), real(dir.Z()));
+    const bool principal = std::abs(std::abs(dir.X()) + std::abs(dir.Y()) + std::abs(dir.Z()) - 1.0) < 1e-9;
+    if (principal) {
+        int id = m_directions.value(coordinates);
+        if (id) {
+            return id;
+        }
+    }
+    int id = add("IFCDIRECTION(" + coordinates + ")");
+    if (principal) {
+        m_directions.insert(coordinates, id);
+    }
+    return id;
+}
+
+int IfcExporter::axisPlacement(const gp_Pnt& origin, const gp_Dir& axis, const gp_Dir& refDirection)
+{
+    int point = add(QString("IFCCARTESIANPOINT((%1,%2,%3))").arg(real(origin.X()), real(origin.Y()), real(origin.Z())));
+    int axisId = direction(axis);
+    int refDirectionId = direction(refDirection);
+    return add(QString("IFCAXIS2PLACEMENT3D(%1,%2,%3)").arg(ref(point), ref(axisId), ref(refDirectionId)));
+}
+
+int IfcExporter::triangulatedFaceSet(const TopoDS_Shape& shape)
+{
+    // Mesh a copy: the shape may be in the background mesher's queue
+    TopoDS_Shape copy;
+    try {
+        copy = BRepBuilderAPI_Copy(shape, Standard_True, Standard_False).Shape();
+        BRepMesh_IncrementalMesh(copy, m_options.deflection, Standard_False, 0.5, Standard_False);
+    } catch (Standard_Failure const& ex) {
+        LOG_WARNING("export", "Tessellation failed: %1", ex.GetMessageString());
+        return 0;
+    }
+
+    QStringList points;
+    QStringList triangles;
+    for (TopExp_Explorer exp(copy, TopAbs_FACE); exp.More(); exp.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(exp.Current());
+        TopLoc_Location location;
+        Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(face, location);
+        if (triangulation.IsNull()) {
+            return 0;
+        }
+        const int base = points.size();
+        const gp_Trsf trsf = location.Transformation();
+        for (int i = 1; i <= triangulation->NbNodes(); ++i) {
+            const gp_Pnt p = triangulation->Node(i).Transformed(trsf);
+            points.append(QString("(%1,%2,%3)").arg(real(p.X()), real(p.Y()), real(p.Z())));
+        }
+        // CoordIndex is 1-based; reversed faces flip the winding
+        const bool reversed = face.Orientation() == TopAbs_REVERSED;
+        for (int i = 1; i <= triangulation->NbTriangles(); ++i) {
+            int n1, n2, n3;
+            triangulation->Triangle(i).Get(n1, n2, n3);
+            if (reversed) {
+                std::swap(n2, n3);
+            }
+            triangles.append(QString("(%1,%2,%3)").arg(base + n1).arg(base + n2).arg(base + n3));
+        }
+    }
+    if (triangles.isEmpty()) {
+        return 0;
+    }
+
+    int pointList = add("IFCCARTESIANPOINTLIST3D((" + points.join(',') + "))");
+    return add(QString("IFCTRIANGULATEDFACESET(%1,$,.T.,(%2),$)").arg(ref(pointList), triangles.join(',')));
+}
+
+int IfcExporter::beamProfile(const Handle(TBeam)& beam, QString& profileName)
+{
+    if (!beam->IsProfileSection()) {
+        double width, height;
+        beam->GetSectionDimensions(width, height);
+        profileName = QString("%1x%2").arg(width).arg(height);
+        return rectangleProfile(width, height);
+    }
+
+    profileName = SteelProfile::getProfileName(beam->GetProfileType(), beam->GetProfileSize());
+    int id = m_profiles.value(profileName);
+    if (id) {
+        return id;
+    }
+
+    const SteelProfile::SectionDescriptor section = beam->GetSection();
+    const SteelProfile::Dimensions& d = section.dim;
+    const QString name = text(profileName);
+    const QString fillet = d.radius > 0.0 ? real(d.radius) : QString("$");
+
+    // SteelProfile sections stand on Z=0; IFC profiles are centred on their box
+    int centre = add(QString("IFCCARTESIANPOINT((0.,%1))").arg(real(d.height / 2)));
+    const QString position = ref(add(QString("IFCAXIS2PLACEMENT2D(%1,$)").arg(ref(centre))));
+
+    switch (section.shape) {
+    case SteelProfile::SECTION_I:
+        id = add(QString("IFCISHAPEPROFILEDEF(.AREA.,%1,%2,%3,%4,%5,%6,%7,$,$)")
+                 .arg(name, position, real(d.width), real(d.height), real(d.webThickness), real(d.flangeThickness), fillet));
+        break;
+    case SteelProfile::SECTION_CHANNEL:
+        // Web on the -X side in both conventions
+        id = add(QString("IFCUSHAPEPROFILEDEF(.AREA.,%1,%2,%3,%4,%5,%6,%7,$,$)")
+                 .arg(name, position, real(d.height), real(d.width), real(d.webThickness), real(d.flangeThickness), fillet));
+        break;
+    case SteelProfile::SECTION_ANGLE:
+        id = add(QString("IFCLSHAPEPROFILEDEF(.AREA.,%1,%2,%3,%4,%5,%6,$,$)")
+                 .arg(name, position, real(d.height), real(d.width), real(d.thickness), fillet));
+        break;
+    case SteelProfile::SECTION_RHS:
+        id = add(QString("IFCRECTANGLEHOLLOWPROFILEDEF(.AREA.,%1,%2,%3,%4,%5,$,$)")
+                 .arg(name, position, real(d.width), real(d.height), real(d.thickness)));
+        break;
+    case SteelProfile::SECTION_CHS:
+        id = add(QString("IFCCIRCLEHOLLOWPROFILEDEF(.AREA.,%1,%2,%3,%4)")
+                 .arg(name, position, real(d.height / 2), real(d.thickness)));
+        break;
+    }
+
+    m_profiles.insert(profileName, id);
+    return id;
+}
+
+int IfcExporter::rectangleProfile(double xDim, double yDim)
+{
+    const QString key = QString("RECT %1 %2").arg(real(xDim), real(yDim));
+    int id = m_profiles.value(key);
+    if (!id) {
+        id = add(QString("IFCRECTANGLEPROFILEDEF(.AREA.,$,%1,%2,%3)").arg(ref(m_originPlacement2D), real(xDim), real(yDim)));
+        m_profiles.insert(key, id);
+    }
+    return id;
+}
+
+int IfcExporter::material(const QString& name)
+{
+    int id = m_materials.value(name);
+    if (!id) {
+        id = add(QString("IFCMATERIAL(%1,$,$)").arg(text(name)));
+        m_materials.insert(name, id);
+    }
+    return id;
+}
+
+int IfcExporter::propertySet(const Handle(TGraphicObject)& object)
+{
+    const QString partMark = object->GetPartMark();
+    const QString assemblyMark = object->GetAssemblyMark();
+    if (partMark.isEmpty() && assemblyMark.isEmpty()) {
+        return 0;
+    }
+
+    const QString key = partMark + '\n' + assemblyMark;
+    int id = m_propertySets.value(key);
+    if (id) {
+        return id;
+    }
+
+    QVector<int> properties;
+    if (!partMark.isEmpty()) {
+        properties.append(add(QString("IFCPROPERTYSINGLEVALUE('PartMark',$,IFCLABEL(%1),$)").arg(text(partMark))));
+    }
+    if (!assemblyMark.isEmpty()) {
+        properties.append(add(QString("IFCPROPERTYSINGLEVALUE('AssemblyMark',$,IFCLABEL(%1),$)").arg(text(assemblyMark))));
+    }
+    id = add(QString("IFCPROPERTYSET(%1,%2,'CAD_Marks',$,%3)").arg(text(newGuid()), ref(m_ownerHistory), refList(properties)));
+    m_propertySets.insert(key, id);
+    return id;
+}
@@ -0,0 +1,214 @@
+#include "Logger.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QTextStream>
+#include <QThread>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+const char* levelName(Logger::Level level)
+{
+    switch (level) {
+        case Logger::Trace:   return "TRACE";
+        case Logger::Debug:   return "DEBUG";
+        case Logger::Info:    return "INFO";
+        case Logger::Warning: return "WARN";
+        case Logger::Error:   return "ERROR";
+    }
+    return "?";
+}
+
+} // namespace
+
+static_assert((Logger::Capacity & (Logger::Capacity - 1)) == 0, "ring capacity must be a power of two");
+
+Logger& Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : m_slots(new Slot[Capacity])
+    , m_head(0)
+    , m_tail(0)
+    , m_dropped(0)
+    , m_running(false)
+    , m_console(true)
+{
+    for (quint64 i = 0; i < Capacity; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+Logger::~Logger()
+{
+    stop();
+}
+
+bool Logger::start(const QString& filePath, bool console)
+{
+    if (m_running.load()) {
+        return true;
+    }
+    
+    // Probe the file here so a bad path is reported to the caller, not lost on the writer
+    QFile probe(filePath);
+    if (!probe.open(QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "Logger: cannot open" << filePath;
+        return false;
+    }
+    probe.close();
+    
+    m_filePath = filePath;
+    m_console = console;
+    m_running.store(true);
+    m_writer = std::thread(&Logger::run, this);
+    return true;
+}
+
+void Logger::stop()
+{
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+}
+
+void Logger::pack(Record& record, const char* value)
+{
+    const int length = value ? static_cast<int>(qstrlen(value)) : 0;
+    Arg& arg = packText(record, length);
+    for (int i = 0; i < arg.textLength; ++i) {
+        record.text[arg.textOffset + i] = static_cast<unsigned char>(value[i]);
+    }
+}
+
+void Logger::pack(Record& record, const QString& value)
+{
+    Arg& arg = packText(record, value.size());
+    std::memcpy(record.text + arg.textOffset, value.utf16(), arg.textLength * sizeof(ushort));
+}
+
+Logger::Arg& Logger::packText(Record& record, int length)
+{
+    Arg& arg = record.args[record.argCount++];
+    arg.kind = Arg::Text;
+    arg.textOffset = static_cast<quint16>(record.textUsed);
+    arg.textLength = static_cast<quint16>(qMin(length, TextCapacity - record.textUsed));
+    record.textUsed += arg.textLength;
+    return arg;
+}
+
+void Logger::push(Record& record)
+{
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    
+    // Bounded multi-producer queue: claim a slot by sequence number, never wait
+    quint64 position = m_head.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &m_slots[position & (Capacity - 1)];
+        const quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+        const qint64 diff = static_cast<qint64>(sequence) - static_cast<qint64>(position);
+        if (diff == 0) {
+            if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);     // Full: the writer is behind
+            return;
+        } else {
+            position = m_head.load(std::memory_order_relaxed);
+        }
+    }
+    
+    slot->record = record;
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+bool Logger::pop(Record& record)
+{
+    const quint64 position = m_tail.load(std::memory_order_relaxed);
+    Slot& slot = m_slots[position & (Capacity - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+    record = slot.record;
+    slot.sequence.store(position + Capacity, std::memory_order_release);
+    m_tail.store(position + 1, std::memory_order_relaxed);
+    return true;
+}
+
+QString Logger::format(const Record& record)
+{
+    QString message = QString::fromLatin1(record.format);
+    for (int i = 0; i < record.argCount; ++i) {
+        const Arg& arg = record.args[i];
+        switch (arg.kind) {
+            case Arg::Int:    message = message.arg(arg.i); break;
+            case Arg::UInt:   message = message.arg(arg.u); break;
+            case Arg::Double: message = message.arg(arg.d); break;
+            case Arg::Text:
+                message = message.arg(QString::fromUtf16(record.text + arg.textOffset, arg.textLength));
+                break;
+        }
+    }
+    
+    return QString("%1 %2 [%3] %4: %5")
+        .arg(QDateTime::fromMSecsSinceEpoch(record.timestamp).toString("yyyy-MM-dd hh:mm:ss.zzz"))
+        .arg(record.threadId, 0, 16)
+        .arg(QString::fromLatin1(levelName(record.level)), -5)
+        .arg(QString::fromLatin1(record.category))
+        .arg(message);
+}
+
+void Logger::run()
+{
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::Append | QIODevice::Text)) {
+        return;
+    }
+    QTextStream out(&file);
+    
+    Record record;
+    quint64 reportedDrops = 0;
+    for (;;) {
+        // Read the flag first so records pushed before stop() are still drained
+        const bool running = m_running.load(std::memory_order_acquire);
+        
+        bool wrote = false;
+        while (pop(record)) {
+            const QString line = format(record);
+            out << line << '\n';
+            if (m_console) {
+                qDebug().noquote() << line;
+            }
+            wrote = true;
+        }
+        
+        const quint64 dropped = m_dropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDrops) {
+            out << QString("Logger: %1 records dropped (buffer full)\n").arg(dropped - reportedDrops);
+            reportedDrops = dropped;
+            wrote = true;
+        }
+        if (wrote) {
+            out.flush();
+        }
+        
+        if (!running) {
+            break;
+        }
+        if (!wrote) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+}
@@ -6,12 +6,22 @@
 #include "GeometryBuilder.h"
 #include "ProfileSelectionDialog.h"
 #include "BeamCommand.h"
+#include "DisplayQualityDialog.h"
+#include "ArrayDialog.h"
+#include "GridColumnsDialog.h"
+#include "StepExporter.h"
+#include "IfcExporter.h"
+#include "GltfExporter.h"
+#include "DimensionOverlay.h"
+#include "DrawingGenerator.h"
+#include <QApplication>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QLabel>
 #include <QFormLayout>
 #include <QLineEdit>
 #include <QSpinBox>
+#include <QElapsedTimer>
 #include <StdSelect_BRepOwner.hxx>
 #include <StdSelect_FaceFilter.hxx>
 #include <AIS_ListOfInteractive.hxx>
@@ -24,11 +34,14 @@
 #include <GeomAdaptor_Surface.hxx>
 #include <gp_Pln.hxx>
 #include <Precision.hxx>
+#include <Bnd_Box.hxx>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_controller(nullptr)
     , m_objectCollection(nullptr)
+    , m_drawingGenerator(nullptr)
+    , m_dimensionOverlay(nullptr)
     , m_propertiesPanel(nullptr)
     , m_facePickingMode(false)
 {
@@ -41,6 +54,15 @@ MainWindow::MainWindow(QWidget *parent)
     
     // Create object collection with AIS context
     m_objectCollection = new TObjectCollection(m_viewer->getContext(), this);
+    m_drawingGenerator = new DrawingGenerator(m_objectCollection, DrawingGenerator::Options(), this);
+    m_dimensionOverlay = new DimensionOverlay(m_viewer->getContext(), m_objectCollection, this);
+    connect(m_objectCollection, &TObjectCollection::meshingProgress, this, [this](int pending) {
+        if (pending > 0) {
+            statusBar()->showMessage(QString("Meshing %1 objects...").arg(pending));
+        } else {
+            statusBar()->clearMessage();
+        }
+    });
     
     // Create CAD controller with collection
     m_controller = new CADController(m_viewer->getContext(), m_viewer, m_objectCollection, this);
@@ -50,6 +72,15 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_controller, &CADController::commandChanged, this, [this](const QString& cmd) {
         statusBar()->showMessage(cmd);
     });
+    connect(m_controller, &CADController::snapUpdated, this, [this](const SnapManager::SnapPoint& snap) {
+        if (snap.type != SnapManager::None) {
+            statusBar()->showMessage(QString("SNAP: %1 at 3D(%2, %3, %4)")
+                .arg(snap.description)
+                .arg(snap.point.X(), 0, 'f', 1)
+                .arg(snap.point.Y(), 0, 'f', 1)
+                .arg(snap.point.Z(), 0, 'f', 1));
+        }
+    });
     
     // Connect viewer clicks to controller
     connect(m_viewer, &OCCTViewer::viewClicked, this, [this](int x, int y, Qt::MouseButton button) {
@@ -103,28 +134,14 @@ MainWindow::MainWindow(QWidget *parent)
             // Apply snapping ONLY if Ctrl key is held
             bool ctrlPressed = (modifiers & Qt::ControlModifier);
             if (ctrlPressed && m_controller->getCurrentCommand()) {
-                Handle(V3d_View) view = m_viewer->getView();
-                
-                // Use object-based snap detection (faster)
-                SnapManager::SnapPoint snap = m_controller->getSnapManager()->findSnapPointFromObjects(
-                    x, y, m_objectCollection, view);
-                
-                if (snap.type != SnapManager::None) {
-                    worldPoint = snap.point;  // Use the 3D snap point
-                    m_controller->showSnapMarker(worldPoint, snap.type, snap.description);
-                    
-                    // Show snap info immediately
-                    statusBar()->showMessage(QString("SNAP: %1 at 3D(%2, %3, %4)")
-                        .arg(snap.description)
-                        .arg(snap.point.X(), 0, 'f', 1)
-                        .arg(snap.point.Y(), 0, 'f', 1)
-                        .arg(snap.point.Z(), 0, 'f', 1));
-                } else {
-                    m_controller->hideSnapMarker();
-                }
+                // Query on the snap worker; the controller moves marker and preview
+                // when the answer arrives, so the cursor never waits for it
+                m_controller->requestSnap(x, y, worldPoint, m_viewer->getView());
                 ctrlWasPressed = true;
+                return;
             } else if (ctrlWasPressed) {
                 // Only hide snap marker when Ctrl is released (transition from pressed to not pressed)
+                m_controller->cancelSnap();
                 m_controller->hideSnapMarker();
                 ctrlWasPressed = false;
             }
@@ -138,6 +155,23 @@ MainWindow::MainWindow(QWidget *parent)
         }
     });
     
+    // Swap presentations between coarse and full detail and re-place the
+    // dimensions once the camera settles; nothing is recomputed while orbiting
+    connect(m_viewer, &OCCTViewer::cameraChanged, this, [this]() {
+        m_objectCollection->UpdateLevelOfDetail(m_viewer->getView());
+        m_dimensionOverlay->updateLayout(m_viewer->getView());
+    });
+    
+    // Area and pick selection go to the collection as one batch
+    connect(m_viewer, &OCCTViewer::areaSelected, this, [this](const QVector<QPoint>& region, bool crossing) {
+        NCollection_Sequence<int> ids = m_objectCollection->PickObjects(m_viewer->getView(), region, crossing);
+        m_objectCollection->SelectObjects(ids);
+        m_viewer->requestRedraw();
+        statusBar()->showMessage(QString("%1 object(s) selected (%2)")
+            .arg(ids.Length()).arg(crossing ? "crossing" : "window"), 2000);
+    });
+    connect(m_viewer, &OCCTViewer::pickSelectionChanged, m_objectCollection, &TObjectCollection::SyncSelectionFromContext);
+    
     // Create properties panel
     m_propertiesPanel = new PropertiesPanel(this);
     addDockWidget(Qt::RightDockWidgetArea, m_propertiesPanel);
@@ -155,14 +189,24 @@ MainWindow::MainWindow(QWidget *parent)
     // Initialize snap types from toolbar
     m_controller->getSnapManager()->setSnapTypes(m_snapToolbar->getEnabledSnapTypes());
     
+    // Scene edits change occlusion without moving the camera
+    auto invalidateSnapVisibility = [this]() {
+        m_controller->getSnapManager()->invalidateVisibility();
+        m_controller->getSnapManager()->invalidateScene();
+    };
+    connect(m_objectCollection, &TObjectCollection::objectAdded, this, invalidateSnapVisibility);
+    connect(m_objectCollection, &TObjectCollection::objectsAdded, this, invalidateSnapVisibility);
+    connect(m_objectCollection, &TObjectCollection::objectRemoved, this, invalidateSnapVisibility);
+    connect(m_objectCollection, &TObjectCollection::objectModified, this, invalidateSnapVisibility);
+    connect(m_objectCollection, &TObjectCollection::objectsModified, this, invalidateSnapVisibility);
+    connect(m_objectCollection, &TObjectCollection::collectionCleared, this, invalidateSnapVisibility);
+    connect(m_objectCollection, &TObjectCollection::meshingProgress, this, invalidateSnapVisibility);
+    
     // Connect collection signals to properties panel
     connect(m_objectCollection, &TObjectCollection::selectionChanged, this, &MainWindow::updatePropertiesPanel);
-    connect(m_propertiesPanel, &PropertiesPanel::propertyChanged, this, [this](int objectID) {
-        // Notify collection that object was modified
-        Handle(TGraphicObject) obj = m_objectCollection->FindObject(objectID);
-        if (!obj.IsNull()) {
-            emit m_objectCollection->objectModified(objectID);
-        }
+    connect(m_propertiesPanel, &PropertiesPanel::propertiesChanged, this, [this](const QList<int>& objectIDs) {
+        // One redisplay pass for everything the panel edited
+        m_objectCollection->RefreshObjects(objectIDs);
     });
 
     // Setup UI components
@@ -218,6 +262,10 @@ void MainWindow::createActions()
     m_exportAction->setStatusTip(tr("Export model to file"));
     connect(m_exportAction, &QAction::triggered, this, &MainWindow::onExport);
 
+    m_createDrawingsAction = new QAction(tr("Create &Drawings"), this);
+    m_createDrawingsAction->setStatusTip(tr("Write top, front and side hidden-line views to DXF"));
+    connect(m_createDrawingsAction, &QAction::triggered, this, &MainWindow::onCreateDrawings);
+
     m_exitAction = new QAction(tr("E&xit"), this);
     m_exitAction->setShortcut(QKeySequence::Quit);
     m_exitAction->setStatusTip(tr("Exit the application"));
@@ -232,6 +280,10 @@ void MainWindow::createActions()
     m_createColumnAction->setStatusTip(tr("Create a structural column"));
     connect(m_createColumnAction, &QAction::triggered, this, &MainWindow::onCreateColumn);
 
+    m_gridColumnsAction = new QAction(tr("Columns at &Grid..."), this);
+    m_gridColumnsAction->setStatusTip(tr("Place columns at the intersections of selected grid axes"));
+    connect(m_gridColumnsAction, &QAction::triggered, this, &MainWindow::onColumnsAtGrid);
+
     m_createSlabAction = new QAction(tr("Create &Slab"), this);
     m_createSlabAction->setStatusTip(tr("Create a floor slab"));
     connect(m_createSlabAction, &QAction::triggered, this, &MainWindow::onCreateSlab);
@@ -266,6 +318,10 @@ void MainWindow::createActions()
     m_viewFitAction->setStatusTip(tr("Fit all objects in view"));
     connect(m_viewFitAction, &QAction::triggered, this, &MainWindow::onViewFit);
 
+    m_displayQualityAction = new QAction(tr("Display &Quality..."), this);
+    m_displayQualityAction->setStatusTip(tr("Tessellation and level-of-detail settings"));
+    connect(m_displayQualityAction, &QAction::triggered, this, &MainWindow::onDisplayQuality);
+
     // Edit menu actions
     m_selectAction = new QAction(tr("&Select"), this);
     m_selectAction->setStatusTip(tr("Select objects"));
@@ -279,6 +335,10 @@ void MainWindow::createActions()
     m_rotateAction->setStatusTip(tr("Rotate selected objects"));
     connect(m_rotateAction, &QAction::triggered, this, &MainWindow::onRotateMode);
 
+    m_arrayAction = new QAction(tr("&Array..."), this);
+    m_arrayAction->setStatusTip(tr("Copy selected objects in a linear, rectangular or polar pattern"));
+    connect(m_arrayAction, &QAction::triggered, this, &MainWindow::onArrayCopy);
+
     m_deleteAction = new QAction(tr("&Delete"), this);
     m_deleteAction->setShortcut(QKeySequence::Delete);
     m_deleteAction->setStatusTip(tr("Delete selected objects"));
@@ -289,6 +349,10 @@ void MainWindow::createActions()
     m_checkInterferencesAction->setStatusTip(tr("Check for clashing elements"));
     connect(m_checkInterferencesAction, &QAction::triggered, this, &MainWindow::onCheckInterferences);
 
+    m_numberPartsAction = new QAction(tr("&Number Parts"), this);
+    m_numberPartsAction->setStatusTip(tr("Give identical members the same part and assembly mark"));
+    connect(m_numberPartsAction, &QAction::triggered, this, &MainWindow::onNumberParts);
+
     m_showDimensionsAction = new QAction(tr("Show &Dimensions"), this);
     m_showDimensionsAction->setStatusTip(tr("Display dimensions"));
     m_showDimensionsAction->setCheckable(true);
@@ -304,6 +368,7 @@ void MainWindow::createMenus()
     m_fileMenu->addAction(m_saveAction);
     m_fileMenu->addSeparator();
     m_fileMenu->addAction(m_exportAction);
+    m_fileMenu->addAction(m_createDrawingsAction);
     m_fileMenu->addSeparator();
     m_fileMenu->addAction(m_exitAction);
 
@@ -312,6 +377,7 @@ void MainWindow::createMenus()
     m_editMenu->addAction(m_selectAction);
     m_editMenu->addAction(m_moveAction);
     m_editMenu->addAction(m_rotateAction);
+    m_editMenu->addAction(m_arrayAction);
     m_editMenu->addSeparator();
     m_editMenu->addAction(m_deleteAction);
 
@@ -319,6 +385,7 @@ void MainWindow::createMenus()
     m_createMenu = menuBar()->addMenu(tr("&Create"));
     m_createMenu->addAction(m_createBeamAction);
     m_createMenu->addAction(m_createColumnAction);
+    m_createMenu->addAction(m_gridColumnsAction);
     m_createMenu->addAction(m_createSlabAction);
     m_createMenu->addAction(m_createWallAction);
     m_createMenu->addAction(m_createFoundationAction);
@@ -331,10 +398,13 @@ void MainWindow::createMenus()
     m_viewMenu->addAction(m_viewIsoAction);
     m_viewMenu->addSeparator();
     m_viewMenu->addAction(m_viewFitAction);
+    m_viewMenu->addSeparator();
+    m_viewMenu->addAction(m_displayQualityAction);
 
     // Analysis menu
     m_analysisMenu = menuBar()->addMenu(tr("&Analysis"));
     m_analysisMenu->addAction(m_checkInterferencesAction);
+    m_analysisMenu->addAction(m_numberPartsAction);
     m_analysisMenu->addAction(m_showDimensionsAction);
 
     // Help menu
@@ -370,6 +440,10 @@ void MainWindow::createToolBars()
     workPlaneAction->setStatusTip(tr("Choose construction plane"));
     connect(workPlaneAction, &QAction::triggered, this, &MainWindow::onSetWorkPlane);
     workPlaneToolBar->addAction(workPlaneAction);
+    QAction* gridAction = new QAction(tr("Grid..."), this);
+    gridAction->setStatusTip(tr("Define structural grid axes and labels"));
+    connect(gridAction, &QAction::triggered, this, &MainWindow::onGridSettings);
+    workPlaneToolBar->addAction(gridAction);
     
     // Snap toolbar
     QToolBar* snapToolBar = addToolBar(tr("Snap"));
@@ -430,10 +504,14 @@ void MainWindow::onOpenProject()
 {
     QString fileName = QFileDialog::getOpenFileName(this, tr("Open Project"), 
                                                      QString(), 
-                                                     tr("CAD Files (*.step *.stp *.iges *.igs)"));
+                                                     tr("Model Files (*.model)"));
     if (!fileName.isEmpty()) {
-        statusBar()->showMessage("Opening project: " + fileName, 2000);
-        // TODO: Implement file loading
+        if (!m_objectCollection->LoadFromFile(fileName)) {
+            QMessageBox::warning(this, tr("Open Project"), tr("Cannot open %1").arg(fileName));
+            return;
+        }
+        statusBar()->showMessage(QString("Opened %1 objects from %2")
+                                 .arg(m_objectCollection->GetObjectCount()).arg(fileName), 5000);
     }
 }
 
@@ -441,22 +519,117 @@ void MainWindow::onSaveProject()
 {
     QString fileName = QFileDialog::getSaveFileName(this, tr("Save Project"),
                                                      QString(),
-                                                     tr("STEP Files (*.step *.stp)"));
+                                                     tr("Model Files (*.model)"));
     if (!fileName.isEmpty()) {
-        statusBar()->showMessage("Saving project: " + fileName, 2000);
-        // TODO: Implement file saving
+        if (!m_objectCollection->SaveToFile(fileName)) {
+            QMessageBox::warning(this, tr("Save Project"), tr("Cannot write %1").arg(fileName));
+            return;
+        }
+        statusBar()->showMessage("Saved project: " + fileName, 2000);
     }
 }
 
 void MainWindow::onExport()
 {
+    const QString ap242Filter = tr("STEP AP242 (*.step *.stp)");
+    const QString ifcFilter = tr("IFC4 (*.ifc)");
+    const QString glbFilter = tr("glTF Binary (*.glb)");
+    QString selectedFilter;
     QString fileName = QFileDialog::getSaveFileName(this, tr("Export Model"),
                                                      QString(),
-                                                     tr("All Files (*.step *.iges *.stl);;STEP (*.step);;IGES (*.iges);;STL (*.stl)"));
-    if (!fileName.isEmpty()) {
-        statusBar()->showMessage("Exporting to: " + fileName, 2000);
-        // TODO: Implement export
+                                                     tr("STEP AP214 (*.step *.stp);;") + ap242Filter + ";;" + ifcFilter + ";;" + glbFilter,
+                                                     &selectedFilter);
+    if (fileName.isEmpty()) {
+        return;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    
+    bool ok;
+    QString error, summary;
+    if (selectedFilter == ifcFilter) {
+        IfcExporter exporter;
+        ok = exporter.exportObjects(m_objectCollection->GetAllObjects(), fileName);
+        error = exporter.errorString();
+        summary = QString("Exported %1 elements").arg(exporter.elementCount());
+    } else if (selectedFilter == glbFilter) {
+        GltfExporter exporter;
+        ok = exporter.exportObjects(m_objectCollection->GetAllObjects(), fileName);
+        error = exporter.errorString();
+        summary = QString("Exported %1 objects with %2 meshes").arg(exporter.nodeCount()).arg(exporter.meshCount());
+    } else {
+        StepExporter::Options options;
+        options.schema = (selectedFilter == ap242Filter) ? StepExporter::AP242 : StepExporter::AP214;
+        StepExporter exporter(options);
+        ok = exporter.exportObjects(m_objectCollection->GetAllObjects(), fileName);
+        error = exporter.errorString();
+        summary = QString("Exported %1 objects as %2 parts").arg(exporter.instanceCount()).arg(exporter.partCount());
+    }
+    
+    QApplication::restoreOverrideCursor();
+    
+    if (!ok) {
+        QMessageBox::warning(this, tr("Export Model"), error);
+        return;
     }
+    statusBar()->showMessage(QString("%1 in %2 ms").arg(summary).arg(timer.elapsed()), 5000);
+}
+
+void MainWindow::onCreateDrawings()
+{
+    // Draw the region around the selection, or the whole model without one;
+    // the generator culls everything outside it
+    NCollection_Sequence<Handle(TGraphicObject)> objects = m_objectCollection->GetSelectedObjects();
+    if (objects.IsEmpty()) {
+        objects = m_objectCollection->GetAllObjects();
+    }
+    Bnd_Box region;
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(objects); it.More(); it.Next()) {
+        const Handle(TGraphicObject)& object = it.Value();
+        if (object.IsNull() || !object->IsVisible()) {
+            continue;
+        }
+        double xmin, ymin, zmin, xmax, ymax, zmax;
+        object->GetBoundingBox(xmin, ymin, zmin, xmax, ymax, zmax);
+        region.Update(xmin, ymin, zmin, xmax, ymax, zmax);
+    }
+    if (region.IsVoid()) {
+        statusBar()->showMessage("There are no objects to draw", 3000);
+        return;
+    }
+    region.Enlarge(1.0);    // Keep members that only touch the boundary
+    
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Create Drawings"),
+                                                     QString(),
+                                                     tr("DXF Drawing (*.dxf)"));
+    if (fileName.isEmpty()) {
+        return;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    
+    QVector<DrawingGenerator::View> views;
+    for (DrawingGenerator::ViewDirection direction : { DrawingGenerator::TOP, DrawingGenerator::FRONT, DrawingGenerator::SIDE }) {
+        DrawingGenerator::View view(direction);
+        region.Get(view.min[0], view.min[1], view.min[2], view.max[0], view.max[1], view.max[2]);
+        views.append(view);
+    }
+    m_drawingGenerator->generate(views);
+    
+    QString error;
+    bool ok = DrawingGenerator::writeDxf(views, fileName, &error);
+    QApplication::restoreOverrideCursor();
+    
+    if (!ok) {
+        QMessageBox::warning(this, tr("Create Drawings"), error);
+        return;
+    }
+    statusBar()->showMessage(QString("Drew %1 views, %2 objects meshed, in %3 ms")
+                             .arg(views.size()).arg(m_drawingGenerator->meshedCount()).arg(timer.elapsed()), 5000);
 }
 
 void MainWindow::onExit()
@@ -489,6 +662,26 @@ void MainWindow::onCreateColumn()
     m_controller->startColumnCommand();
 }
 
+void MainWindow::onColumnsAtGrid()
+{
+    const StructuralGrid& grid = m_controller->getGrid();
+    if (grid.axisCount(StructuralGrid::U) == 0 || grid.axisCount(StructuralGrid::V) == 0) {
+        statusBar()->showMessage("Define grid axes in both directions first", 3000);
+        return;
+    }
+    
+    GridColumnsDialog dialog(grid, this);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    int count = m_controller->placeColumnsAtGrid(dialog.getUAxes(), dialog.getVAxes(),
+                                                 dialog.getWidth(), dialog.getDepth(), dialog.getHeight());
+    statusBar()->showMessage(QString("Placed %1 columns in %2 ms").arg(count).arg(timer.elapsed()), 5000);
+}
+
 void MainWindow::onCreateSlab()
 {
     m_controller->startSlabCommand();
@@ -541,6 +734,28 @@ void MainWindow::onViewFit()
     statusBar()->showMessage("Fit all", 2000);
 }
 
+void MainWindow::onDisplayQuality()
+{
+    DisplayQualityDialog dialog(this);
+    for (TGraphicObject::ObjectType type : dialog.getTypes()) {
+        dialog.setQuality(type, m_objectCollection->GetDisplayQuality(type));
+    }
+    double coarseBelow, fullAbove;
+    m_objectCollection->GetDetailThresholds(coarseBelow, fullAbove);
+    dialog.setThresholds(coarseBelow, fullAbove);
+    
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+    
+    m_objectCollection->SetDetailThresholds(dialog.getCoarseBelowPixels(), dialog.getFullAbovePixels());
+    for (TGraphicObject::ObjectType type : dialog.getTypes()) {
+        m_objectCollection->SetDisplayQuality(type, dialog.getQuality(type));
+    }
+    m_objectCollection->UpdateLevelOfDetail(m_viewer->getView());
+    statusBar()->showMessage("Display quality updated", 2000);
+}
+
 // Edit menu slots
 void MainWindow::onSelectMode()
 {
@@ -557,6 +772,30 @@ void MainWindow::onRotateMode()
     statusBar()->showMessage("Rotate mode", 2000);
 }
 
+void MainWindow::onArrayCopy()
+{
+    NCollection_Sequence<Handle(TGraphicObject)> selected = m_objectCollection->GetSelectedObjects();
+    if (selected.IsEmpty()) {
+        statusBar()->showMessage("Select the objects to copy first", 3000);
+        return;
+    }
+    
+    ArrayDialog dialog(this);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+    
+    NCollection_Sequence<int> ids;
+    for (int i = 1; i <= selected.Length(); i++) {
+        ids.Append(selected.Value(i)->GetID());
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    int count = m_objectCollection->ArrayObjects(ids, dialog.getPlacements());
+    statusBar()->showMessage(QString("Created %1 copies in %2 ms").arg(count).arg(timer.elapsed()), 5000);
+}
+
 void MainWindow::onDeleteSelected()
 {
     statusBar()->showMessage("Delete selected", 2000);
@@ -570,10 +809,30 @@ void MainWindow::onCheckInterferences()
                             "Checking for clashing elements...\nNo interferences found.");
 }
 
+void MainWindow::onNumberParts()
+{
+    QElapsedTimer timer;
+    timer.start();
+    QVector<PartNumbering::Group> groups = m_objectCollection->NumberParts();
+    statusBar()->showMessage(QString("%1 objects numbered as %2 parts in %3 ms")
+                             .arg(m_objectCollection->GetObjectCount()).arg(groups.size()).arg(timer.elapsed()), 5000);
+    updatePropertiesPanel();
+}
+
 void MainWindow::onShowDimensions()
 {
     bool show = m_showDimensionsAction->isChecked();
-    statusBar()->showMessage(show ? "Dimensions shown" : "Dimensions hidden", 2000);
+    if (show) {
+        updateDimensionGrid();
+    }
+    m_dimensionOverlay->setVisible(show, m_viewer->getView());
+    statusBar()->showMessage(show ? QString("%1 dimensions shown").arg(m_dimensionOverlay->shownCount())
+                                  : QString("Dimensions hidden"), 2000);
+}
+
+void MainWindow::updateDimensionGrid()
+{
+    m_dimensionOverlay->setGrid(m_controller->getGrid(), m_controller->getWorkPlane().getCoordinateSystem());
 }
 
 void MainWindow::updatePropertiesPanel()
@@ -587,11 +846,8 @@ void MainWindow::updatePropertiesPanel()
     if (selectedObjects.Size() == 0) {
         m_propertiesPanel->clearProperties();
     }
-    else if (selectedObjects.Size() == 1) {
-        m_propertiesPanel->setObject(selectedObjects.First());
-    }
     else {
-        m_propertiesPanel->setMultipleSelection(selectedObjects.Size());
+        m_propertiesPanel->setObjects(selectedObjects);
     }
 }
 
@@ -605,6 +861,16 @@ void MainWindow::onSetWorkPlane()
     }
 }
 
+void MainWindow::onGridSettings()
+{
+    GridDialog dialog(m_controller->getGrid(), m_controller->isGridVisible(), this);
+    if (dialog.exec() == QDialog::Accepted) {
+        m_controller->setGridVisible(dialog.isGridVisible());
+        m_controller->setGrid(dialog.getGrid());
+        updateDimensionGrid();
+    }
+}
+
 void MainWindow::enterFacePickingMode()
 {
     m_facePickingMode = true;
@@ -731,6 +997,7 @@ void MainWindow::onFaceClicked(int x, int y, Qt::MouseButton button)
                     WorkPlane customPlane(origin, normal);
                     m_controller->setWorkPlane(customPlane);
                     m_controller->setWorkPlaneVisible(true);
+                    updateDimensionGrid();
                     
                     statusBar()->showMessage(QString("Workplane set to face (Origin: %1, %2, %3)")
                         .arg(origin.X(), 0, 'f', 1)
@@ -0,0 +1,469 @@
+#include "MeshCache.h"
+#include "GeometryHash.h"
+#include "Logger.h"
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopExp.hxx>
+#include <TopLoc_Location.hxx>
+#include <TColStd_Array1OfInteger.hxx>
+#include <TColStd_Array1OfReal.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Face.hxx>
+#include <QFileInfo>
+#include <QSet>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+struct FileHeader {
+    char magic[8];          // "EMMESH01"
+    quint32 version;
+    quint32 reserved0;
+    quint64 entryCount;
+    quint64 indexOffset;    // IndexRecord[entryCount]
+    quint64 reserved[4];
+};
+
+struct IndexRecord {
+    quint64 key;
+    quint64 offset;
+};
+
+// Followed by faceCount faces, each 8-byte aligned
+struct EntryHeader {
+    quint64 key;
+    quint32 faceCount;
+    quint32 reserved;
+};
+
+// Followed by float[3 * nodeCount] and quint32[3 * triangleCount] (1-based),
+// padded to 8 bytes, then edgeCount edges. Nodes are in part coordinates,
+// where float precision is ample.
+struct FaceHeader {
+    quint32 nodeCount;
+    quint32 triangleCount;
+    quint32 edgeCount;      // TopExp::MapShapes order of the face's edges
+    quint32 reserved;
+    double deflection;
+};
+
+// Polygon of one edge on its face's triangulation: quint32[nodeCount] node
+// indices (1-based) padded to 8 bytes, then double[nodeCount] parameters
+// if hasParameters
+struct EdgeHeader {
+    quint32 nodeCount;
+    quint32 hasParameters;
+    double deflection;
+};
+
+const char kMagic[8] = { 'E', 'M', 'M', 'E', 'S', 'H', '0', '1' };
+const quint32 kVersion = 2;
+
+static_assert(sizeof(FileHeader) == 64, "mesh cache header layout changed");
+static_assert(sizeof(IndexRecord) == 16, "mesh cache index layout changed");
+static_assert(sizeof(EntryHeader) == 16, "mesh cache entry layout changed");
+static_assert(sizeof(FaceHeader) == 24, "mesh cache face layout changed");
+static_assert(sizeof(EdgeHeader) == 16, "mesh cache edge layout changed");
+
+inline qint64 padded(qint64 size)
+{
+    return (size + 7) & ~qint64(7);
+}
+
+inline qint64 edgeDataSize(const EdgeHeader& edge)
+{
+    return sizeof(EdgeHeader) + padded(qint64(edge.nodeCount) * sizeof(quint32))
+         + (edge.hasParameters ? qint64(edge.nodeCount) * sizeof(double) : 0);
+}
+
+// Size of the face at data including its edges; 0 if it runs past end
+qint64 faceDataSize(const uchar* data, const uchar* end)
+{
+    if (end - data < static_cast<qint64>(sizeof(FaceHeader))) {
+        return 0;
+    }
+    const FaceHeader* face = reinterpret_cast<const FaceHeader*>(data);
+    qint64 size = padded(sizeof(FaceHeader) + qint64(face->nodeCount) * 3 * sizeof(float)
+                         + qint64(face->triangleCount) * 3 * sizeof(quint32));
+    for (quint32 i = 0; i < face->edgeCount; ++i) {
+        if (end - data < size + static_cast<qint64>(sizeof(EdgeHeader))) {
+            return 0;
+        }
+        size += edgeDataSize(*reinterpret_cast<const EdgeHeader*>(data + size));
+    }
+    return size <= end - data ? size : 0;
+}
+
+template <class T>
+void appendRaw(QByteArray& data, const T& value)
+{
+    data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+MeshCache::MeshCache()
+    : m_mapping(nullptr)
+    , m_size(0)
+{
+}
+
+MeshCache::~MeshCache()
+{
+    close();
+}
+
+QString MeshCache::pathFor(const QString& modelPath)
+{
+    QFileInfo info(modelPath);
+    return info.absolutePath() + "/" + info.completeBaseName() + ".meshcache";
+}
+
+quint64 MeshCache::key(quint64 geometryHash, double deviation, double angle)
+{
+    return GeometryHash()
+        .add(static_cast<qint64>(geometryHash))
+        .add(static_cast<qint64>(std::llround(deviation * 1.0e6)))
+        .add(static_cast<qint64>(std::llround(angle * 1.0e6)))
+        .value();
+}
+
+bool MeshCache::open(const QString& path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    if (size < static_cast<qint64>(sizeof(FileHeader))) {
+        m_file.close();
+        return false;
+    }
+
+    m_mapping = m_file.map(0, size);
+    if (!m_mapping) {
+        LOG_WARNING("mesh", "Cannot map %1", path);
+        m_file.close();
+        return false;
+    }
+    m_size = size;
+
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(m_mapping);
+    const bool valid = std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0
+                    && header->version == kVersion
+                    && header->indexOffset % alignof(IndexRecord) == 0
+                    && header->indexOffset + header->entryCount * sizeof(IndexRecord) <= static_cast<quint64>(size);
+    if (!valid) {
+        LOG_WARNING("mesh", "%1 has an unsupported mesh cache format", path);
+        close();
+        return false;
+    }
+
+    // Only the index is read here; entries are paged in on lookup
+    const IndexRecord* records = reinterpret_cast<const IndexRecord*>(m_mapping + header->indexOffset);
+    m_index.reserve(static_cast<int>(header->entryCount));
+    for (quint64 i = 0; i < header->entryCount; ++i) {
+        if (records[i].offset % 8 == 0 && records[i].offset < header->indexOffset) {
+            m_index.insert(records[i].key, static_cast<qint64>(records[i].offset));
+        }
+    }
+
+    LOG_INFO("mesh", "Mapped %1 cached meshes from %2", m_index.size(), path);
+    return true;
+}
+
+void MeshCache::close()
+{
+    if (m_mapping) {
+        m_file.unmap(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_size = 0;
+    m_index.clear();
+}
+
+qint64 MeshCache::entrySize(qint64 offset) const
+{
+    if (offset < 0 || offset + static_cast<qint64>(sizeof(EntryHeader)) > m_size) {
+        return 0;
+    }
+    const EntryHeader* header = reinterpret_cast<const EntryHeader*>(m_mapping + offset);
+    const uchar* end = m_mapping + m_size;
+    qint64 position = offset + sizeof(EntryHeader);
+    for (quint32 i = 0; i < header->faceCount; ++i) {
+        const qint64 size = faceDataSize(m_mapping + position, end);
+        if (size == 0) {
+            return 0;
+        }
+        position += size;
+    }
+    return position - offset;
+}
+
+bool MeshCache::attach(quint64 key, const TopoDS_Shape& shape) const
+{
+    if (!m_mapping || shape.IsNull()) {
+        return false;
+    }
+    auto it = m_index.constFind(key);
+    if (it == m_index.constEnd() || entrySize(it.value()) == 0) {
+        return false;
+    }
+
+    const EntryHeader* header = reinterpret_cast<const EntryHeader*>(m_mapping + it.value());
+    TopTools_IndexedMapOfShape faces;
+    TopExp::MapShapes(shape, TopAbs_FACE, faces);
+    if (header->key != key || static_cast<int>(header->faceCount) != faces.Extent()) {
+        return false;
+    }
+
+    struct EdgePolygon {
+        TopoDS_Edge edge;
+        Handle(Poly_PolygonOnTriangulation) polygon;
+    };
+
+    // Build every face and edge before touching the shape, so a bad entry leaves it as it was
+    QVector<Handle(Poly_Triangulation)> triangulations;
+    QVector<QVector<EdgePolygon>> polygons;
+    triangulations.reserve(faces.Extent());
+    polygons.reserve(faces.Extent());
+    const uchar* data = m_mapping + it.value() + sizeof(EntryHeader);
+    for (int f = 1; f <= faces.Extent(); ++f) {
+        const FaceHeader* face = reinterpret_cast<const FaceHeader*>(data);
+        TopTools_IndexedMapOfShape edges;
+        TopExp::MapShapes(faces(f), TopAbs_EDGE, edges);
+        if (face->nodeCount == 0 || face->triangleCount == 0
+            || static_cast<int>(face->edgeCount) != edges.Extent()) {
+            return false;
+        }
+        const float* nodes = reinterpret_cast<const float*>(data + sizeof(FaceHeader));
+        const quint32* triangles = reinterpret_cast<const quint32*>(nodes + 3 * face->nodeCount);
+
+        Handle(Poly_Triangulation) triangulation =
+            new Poly_Triangulation(face->nodeCount, face->triangleCount, Standard_False);
+        for (quint32 i = 0; i < face->nodeCount; ++i) {
+            triangulation->SetNode(i + 1, gp_Pnt(nodes[3 * i], nodes[3 * i + 1], nodes[3 * i + 2]));
+        }
+        for (quint32 i = 0; i < face->triangleCount; ++i) {
+            const quint32 n1 = triangles[3 * i], n2 = triangles[3 * i + 1], n3 = triangles[3 * i + 2];
+            if (n1 < 1 || n2 < 1 || n3 < 1
+                || n1 > face->nodeCount || n2 > face->nodeCount || n3 > face->nodeCount) {
+                return false;
+            }
+            triangulation->SetTriangle(i + 1, Poly_Triangle(int(n1), int(n2), int(n3)));
+        }
+        triangulation->Deflection(face->deflection);
+
+        // Without its edges' polygons BRepTools::Triangulation() reports the
+        // face as unmeshed and BRepMesh would triangulate it again
+        QVector<EdgePolygon> faceEdges;
+        faceEdges.reserve(edges.Extent());
+        const uchar* edgeData = data + padded(sizeof(FaceHeader) + qint64(face->nodeCount) * 3 * sizeof(float)
+                                              + qint64(face->triangleCount) * 3 * sizeof(quint32));
+        for (int e = 1; e <= edges.Extent(); ++e) {
+            const EdgeHeader* edge = reinterpret_cast<const EdgeHeader*>(edgeData);
+            if (edge->nodeCount < 2) {
+                return false;
+            }
+            const quint32* indices = reinterpret_cast<const quint32*>(edgeData + sizeof(EdgeHeader));
+            TColStd_Array1OfInteger polygonNodes(1, static_cast<int>(edge->nodeCount));
+            for (quint32 i = 0; i < edge->nodeCount; ++i) {
+                if (indices[i] < 1 || indices[i] > face->nodeCount) {
+                    return false;
+                }
+                polygonNodes.SetValue(static_cast<int>(i) + 1, static_cast<int>(indices[i]));
+            }
+            Handle(Poly_PolygonOnTriangulation) polygon;
+            if (edge->hasParameters) {
+                const double* parameters = reinterpret_cast<const double*>(
+                    edgeData + sizeof(EdgeHeader) + padded(qint64(edge->nodeCount) * sizeof(quint32)));
+                TColStd_Array1OfReal polygonParameters(1, static_cast<int>(edge->nodeCount));
+                for (quint32 i = 0; i < edge->nodeCount; ++i) {
+                    polygonParameters.SetValue(static_cast<int>(i) + 1, parameters[i]);
+                }
+                polygon = new Poly_PolygonOnTriangulation(polygonNodes, polygonParameters);
+            } else {
+                polygon = new Poly_PolygonOnTriangulation(polygonNodes);
+            }
+            polygon->Deflection(edge->deflection);
+            faceEdges.append({ TopoDS::Edge(edges(e)), polygon });
+            edgeData += edgeDataSize(*edge);
+        }
+
+        triangulations.append(triangulation);
+        polygons.append(faceEdges);
+        data = edgeData;
+    }
+
+    // Edge polygons are stored against the face's location, as BRepMesh does
+    BRep_Builder builder;
+    for (int f = 1; f <= faces.Extent(); ++f) {
+        const TopoDS_Face& face = TopoDS::Face(faces(f));
+        builder.UpdateFace(face, triangulations.at(f - 1));
+        for (const EdgePolygon& edge : polygons.at(f - 1)) {
+            builder.UpdateEdge(edge.edge, edge.polygon, triangulations.at(f - 1), face.Location());
+        }
+    }
+    return true;
+}
+
+bool MeshCache::appendShape(QByteArray& data, quint64 key, const TopoDS_Shape& shape) const
+{
+    if (shape.IsNull()) {
+        return false;
+    }
+    TopTools_IndexedMapOfShape faces;
+    TopExp::MapShapes(shape, TopAbs_FACE, faces);
+    if (faces.IsEmpty()) {
+        return false;
+    }
+
+    // Only complete meshes are stored: every face triangulated and every
+    // edge of it carrying a polygon on that triangulation
+    QVector<Handle(Poly_Triangulation)> triangulations;
+    QVector<QVector<Handle(Poly_PolygonOnTriangulation)>> polygons;
+    triangulations.reserve(faces.Extent());
+    polygons.reserve(faces.Extent());
+    for (int f = 1; f <= faces.Extent(); ++f) {
+        const TopoDS_Face& face = TopoDS::Face(faces(f));
+        TopLoc_Location location;
+        Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(face, location);
+        if (triangulation.IsNull() || triangulation->NbTriangles() == 0) {
+            return false;
+        }
+        TopTools_IndexedMapOfShape edges;
+        TopExp::MapShapes(face, TopAbs_EDGE, edges);
+        QVector<Handle(Poly_PolygonOnTriangulation)> faceEdges;
+        faceEdges.reserve(edges.Extent());
+        for (int e = 1; e <= edges.Extent(); ++e) {
+            Handle(Poly_PolygonOnTriangulation) polygon =
+                BRep_Tool::PolygonOnTriangulation(TopoDS::Edge(edges(e)), triangulation, location);
+            if (polygon.IsNull()) {
+                return false;
+            }
+            faceEdges.append(polygon);
+        }
+        triangulations.append(triangulation);
+        polygons.append(faceEdges);
+    }
+
+    EntryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.key = key;
+    header.faceCount = static_cast<quint32>(faces.Extent());
+    appendRaw(data, header);
+
+    // Nodes stay in the face's own frame, which is what UpdateFace expects back
+    for (int f = 0; f < triangulations.size(); ++f) {
+        const Handle(Poly_Triangulation)& triangulation = triangulations.at(f);
+        FaceHeader face;
+        std::memset(&face, 0, sizeof(face));
+        face.nodeCount = static_cast<quint32>(triangulation->NbNodes());
+        face.triangleCount = static_cast<quint32>(triangulation->NbTriangles());
+        face.edgeCount = static_cast<quint32>(polygons.at(f).size());
+        face.deflection = triangulation->Deflection();
+        appendRaw(data, face);
+        for (int i = 1; i <= triangulation->NbNodes(); ++i) {
+            const gp_Pnt node = triangulation->Node(i);
+            appendRaw(data, static_cast<float>(node.X()));
+            appendRaw(data, static_cast<float>(node.Y()));
+            appendRaw(data, static_cast<float>(node.Z()));
+        }
+        for (int i = 1; i <= triangulation->NbTriangles(); ++i) {
+            int n1, n2, n3;
+            triangulation->Triangle(i).Get(n1, n2, n3);
+            appendRaw(data, static_cast<quint32>(n1));
+            appendRaw(data, static_cast<quint32>(n2));
+            appendRaw(data, static_cast<quint32>(n3));
+        }
+        data.append(static_cast<int>(padded(data.size()) - data.size()), '\0');
+
+        for (const Handle(Poly_PolygonOnTriangulation)& polygon : polygons.at(f)) {
+            EdgeHeader edge;
+            std::memset(&edge, 0, sizeof(edge));
+            edge.nodeCount = static_cast<quint32>(polygon->NbNodes());
+            edge.hasParameters = polygon->HasParameters() ? 1 : 0;
+            edge.deflection = polygon->Deflection();
+            appendRaw(data, edge);
+            for (int i = 1; i <= polygon->NbNodes(); ++i) {
+                appendRaw(data, static_cast<quint32>(polygon->Node(i)));
+            }
+            data.append(static_cast<int>(padded(data.size()) - data.size()), '\0');
+            if (polygon->HasParameters()) {
+                for (int i = 1; i <= polygon->NbNodes(); ++i) {
+                    appendRaw(data, polygon->Parameter(i));
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool MeshCache::appendMapped(QByteArray& data, quint64 key) const
+{
+    if (!m_mapping) {
+        return false;
+    }
+    const qint64 offset = m_index.value(key, -1);
+    const qint64 size = entrySize(offset);
+    if (size == 0) {
+        return false;
+    }
+    data.append(reinterpret_cast<const char*>(m_mapping + offset), static_cast<int>(size));
+    return true;
+}
+
+bool MeshCache::save(const QString& path, const QVector<Entry>& entries)
+{
+    QByteArray data;
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    appendRaw(data, header);
+
+    QVector<IndexRecord> index;
+    QSet<quint64> written;
+    for (const Entry& entry : entries) {
+        if (entry.key == 0 || written.contains(entry.key)) {
+            continue;
+        }
+        const qint64 offset = data.size();
+        if (appendShape(data, entry.key, entry.shape) || appendMapped(data, entry.key)) {
+            index.append({ entry.key, static_cast<quint64>(offset) });
+            written.insert(entry.key);
+        }
+    }
+
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.entryCount = index.size();
+    header.indexOffset = data.size();
+    std::memcpy(data.data(), &header, sizeof(header));
+    if (!index.isEmpty()) {
+        data.append(reinterpret_cast<const char*>(index.constData()),
+                    index.size() * static_cast<int>(sizeof(IndexRecord)));
+    }
+
+    // The target may be the file we have mapped
+    close();
+    QFile output(path);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || output.write(data) != data.size()) {
+        LOG_ERROR("mesh", "Cannot write %1", path);
+        return false;
+    }
+    output.close();
+
+    LOG_INFO("mesh", "Saved %1 meshes (%2 KB) to %3", index.size(), data.size() / 1024, path);
+    return open(path);
+}
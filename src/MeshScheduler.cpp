@@ -0,0 +1,96 @@
+#include "MeshScheduler.h"
+#include "Logger.h"
+#include <QRunnable>
+#include <QThread>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepTools.hxx>
+#include <Standard_Failure.hxx>
+#include <algorithm>
+
+class MeshTask : public QRunnable
+{
+public:
+    MeshTask(MeshScheduler* scheduler, int generation, int objectID, const TopoDS_Shape& shape,
+             double deflection, double angle)
+        : m_scheduler(scheduler)
+        , m_generation(generation)
+        , m_objectID(objectID)
+        , m_shape(shape)
+        , m_deflection(deflection)
+        , m_angle(angle)
+    {
+    }
+    
+    void run() override
+    {
+        // Cancelled while queued: report without meshing, so every request is counted off
+        const bool meshed = m_generation == m_scheduler->m_generation.load();
+        if (meshed) {
+            try {
+                // Parallel mode meshes the faces of one shape concurrently as well
+                BRepMesh_IncrementalMesh mesher(m_shape, m_deflection, Standard_False, m_angle, Standard_True);
+            } catch (Standard_Failure const& ex) {
+                LOG_WARNING("mesh", "Meshing object %1 failed: %2", m_objectID, ex.GetMessageString());
+            }
+        }
+        
+        MeshScheduler* scheduler = m_scheduler;
+        int objectID = m_objectID;
+        TopoDS_Shape shape = m_shape;
+        QMetaObject::invokeMethod(scheduler, [scheduler, objectID, shape, meshed]() {
+            scheduler->taskFinished(objectID, shape, meshed);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    MeshScheduler* m_scheduler;
+    int m_generation;
+    int m_objectID;
+    TopoDS_Shape m_shape;
+    double m_deflection;
+    double m_angle;
+};
+
+MeshScheduler::MeshScheduler(QObject* parent)
+    : QObject(parent)
+    , m_pending(0)
+    , m_generation(0)
+{
+    // Leave one core to the UI thread
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+}
+
+MeshScheduler::~MeshScheduler()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void MeshScheduler::schedule(int objectID, const TopoDS_Shape& shape, double deflection, double angle)
+{
+    if (shape.IsNull()) {
+        return;
+    }
+    m_pending.ref();
+    m_pool.start(new MeshTask(this, m_generation.load(), objectID, shape, deflection, angle));
+}
+
+void MeshScheduler::cancelPending()
+{
+    // Queued tasks stay in the pool and finish at once; clearing the pool
+    // would leave m_pending guessing which of them had started
+    m_generation.ref();
+}
+
+void MeshScheduler::taskFinished(int objectID, const TopoDS_Shape& shape, bool meshed)
+{
+    m_pending.deref();
+    if (meshed) {
+        emit meshReady(objectID, shape);
+    }
+}
+
+bool MeshScheduler::isMeshed(const TopoDS_Shape& shape, double deflection)
+{
+    return !shape.IsNull() && BRepTools::Triangulation(shape, deflection);
+}
@@ -1,4 +1,5 @@
 #include "OCCTViewer.h"
+#include "Logger.h"
 #include <AIS_Shape.hxx>
 #include <Aspect_Handle.hxx>
 #include <Aspect_DisplayConnection.hxx>
@@ -21,7 +22,8 @@
 #include <gp_Ax2.hxx>
 #include <gp_Dir.hxx>
 #include <AIS_Point.hxx>
-#include <QDebug>
+#include <AIS_RubberBand.hxx>
+#include <Graphic3d_Vec2.hxx>
 
 #ifdef _WIN32
 #include <WNT_Window.hxx>
@@ -35,10 +37,18 @@ OCCTViewer::OCCTViewer(QWidget *parent)
     , m_isPanning(false)
     , m_isZooming(false)
     , m_altWasPressed(false)
+    , m_isBanding(false)
+    , m_bandLasso(false)
     , m_hasTrackingLine(false)
     , m_hasSnapMarker(false)
     , m_occNeedsRedraw(true)
+    , m_cameraTimer(nullptr)
 {
+    m_cameraTimer = new QTimer(this);
+    m_cameraTimer->setSingleShot(true);
+    m_cameraTimer->setInterval(150);
+    connect(m_cameraTimer, &QTimer::timeout, this, &OCCTViewer::cameraChanged);
+    
     // Enable mouse tracking
     setMouseTracking(true);
     setFocusPolicy(Qt::StrongFocus);
@@ -142,6 +152,7 @@ void OCCTViewer::resizeEvent(QResizeEvent *event)
     if (!m_view.IsNull()) {
         m_view->MustBeResized();
         m_view->Redraw();
+        notifyCameraChanged();
     }
 }
 
@@ -186,6 +197,12 @@ void OCCTViewer::mousePressEvent(QMouseEvent *event)
         // Check if Ctrl is pressed for selection/command mode
         if (event->modifiers() & Qt::ControlModifier) {
             emit viewClicked(event->pos().x(), event->pos().y(), event->button());
+        } else if (event->modifiers() & Qt::ShiftModifier) {
+            // Shift-drag selects by area, Shift+Alt-drag by lasso
+            m_isBanding = true;
+            m_bandLasso = (event->modifiers() & Qt::AltModifier);
+            m_bandPoints.clear();
+            m_bandPoints.append(event->pos());
         } else {
             m_isRotating = true;
             m_view->StartRotation(event->pos().x(), event->pos().y());
@@ -204,12 +221,16 @@ void OCCTViewer::mousePressEvent(QMouseEvent *event)
         // Context menu or selection
         m_context->MoveTo(event->pos().x(), event->pos().y(), m_view, Standard_True);
         m_context->Select(Standard_True);
+        emit pickSelectionChanged();
     }
 }
 
 void OCCTViewer::mouseReleaseEvent(QMouseEvent *event)
 {
     if (event->button() == Qt::LeftButton) {
+        if (m_isBanding) {
+            finishAreaSelection(event->pos());
+        }
         m_isRotating = false;
     }
     else if (event->button() == Qt::MiddleButton) {
@@ -222,10 +243,18 @@ void OCCTViewer::mouseMoveEvent(QMouseEvent *event)
 {
     QPoint currentPos = event->pos();
 
-    if (m_isRotating) {
+    if (m_isBanding) {
+        // Keep the lasso path light: one vertex per few pixels of travel
+        if (m_bandLasso && (currentPos - m_bandPoints.last()).manhattanLength() >= 4) {
+            m_bandPoints.append(currentPos);
+        }
+        updateRubberBand(currentPos);
+    }
+    else if (m_isRotating) {
         // Rotate view
         m_view->Rotation(currentPos.x(), currentPos.y());
         m_view->Redraw();
+        notifyCameraChanged();
     }
     else if (m_isPanning) {
         // Pan view
@@ -233,6 +262,7 @@ void OCCTViewer::mouseMoveEvent(QMouseEvent *event)
         int dy = currentPos.y() - m_lastPos.y();
         m_view->Pan(dx, -dy);
         m_view->Redraw();
+        notifyCameraChanged();
     }
     else {
         // Check if Alt key is pressed for highlighting
@@ -255,6 +285,69 @@ void OCCTViewer::mouseMoveEvent(QMouseEvent *event)
     m_lastPos = currentPos;
 }
 
+void OCCTViewer::updateRubberBand(const QPoint& pos)
+{
+    if (m_rubberBand.IsNull()) {
+        m_rubberBand = new AIS_RubberBand(Quantity_NOC_LIGHTBLUE, Aspect_TOL_SOLID,
+                                          Quantity_NOC_LIGHTBLUE, 0.8, 1.0);
+        m_rubberBand->SetZLayer(Graphic3d_ZLayerId_TopOSD);
+        m_rubberBand->SetTransformPersistence(new Graphic3d_TransformPers(Graphic3d_TMF_2d, Aspect_TOTP_LEFT_UPPER));
+        m_rubberBand->SetDisplayMode(0);
+        m_rubberBand->SetMutable(Standard_True);
+    }
+    
+    // 2D persistence from the upper-left corner: y grows upwards, so negate it
+    m_rubberBand->ClearPoints();
+    const QPoint& start = m_bandPoints.first();
+    if (m_bandLasso) {
+        for (const QPoint& p : m_bandPoints) {
+            m_rubberBand->AddPoint(Graphic3d_Vec2i(p.x(), -p.y()));
+        }
+        m_rubberBand->AddPoint(Graphic3d_Vec2i(pos.x(), -pos.y()));
+    } else {
+        // Window (left to right) solid blue, crossing (right to left) dashed green
+        const bool crossing = pos.x() < start.x();
+        const Quantity_Color color(crossing ? Quantity_NOC_GREEN : Quantity_NOC_LIGHTBLUE);
+        m_rubberBand->SetLineType(crossing ? Aspect_TOL_DASH : Aspect_TOL_SOLID);
+        m_rubberBand->SetLineColor(color);
+        m_rubberBand->SetFillColor(color);
+        m_rubberBand->SetRectangle(qMin(start.x(), pos.x()), -qMax(start.y(), pos.y()),
+                                   qMax(start.x(), pos.x()), -qMin(start.y(), pos.y()));
+    }
+    
+    if (!m_context->IsDisplayed(m_rubberBand)) {
+        m_context->Display(m_rubberBand, 0, -1, Standard_False);
+    } else {
+        m_context->Redisplay(m_rubberBand, Standard_False);
+    }
+    m_view->Redraw();
+}
+
+void OCCTViewer::finishAreaSelection(const QPoint& pos)
+{
+    m_isBanding = false;
+    if (!m_rubberBand.IsNull() && m_context->IsDisplayed(m_rubberBand)) {
+        m_context->Remove(m_rubberBand, Standard_False);
+        m_view->Redraw();
+    }
+    
+    QVector<QPoint> region;
+    bool crossing = false;
+    const QPoint start = m_bandPoints.first();
+    if (m_bandLasso) {
+        region = m_bandPoints;
+        region.append(pos);
+    } else if (qAbs(pos.x() - start.x()) > 2 && qAbs(pos.y() - start.y()) > 2) {
+        region << start << QPoint(pos.x(), start.y()) << pos << QPoint(start.x(), pos.y());
+        crossing = pos.x() < start.x();
+    }
+    m_bandPoints.clear();
+    
+    if (region.size() >= 3) {
+        emit areaSelected(region, crossing);
+    }
+}
+
 void OCCTViewer::wheelEvent(QWheelEvent *event)
 {
     // Zoom in/out
@@ -268,6 +361,7 @@ void OCCTViewer::wheelEvent(QWheelEvent *event)
     }
     
     m_view->Redraw();
+    notifyCameraChanged();
 }
 
 void OCCTViewer::fitAll()
@@ -276,6 +370,7 @@ void OCCTViewer::fitAll()
         m_view->FitAll();
         m_view->ZFitAll();
         m_view->Redraw();
+        notifyCameraChanged();
     }
 }
 
@@ -398,6 +493,14 @@ void OCCTViewer::setSnapMarker(const gp_Pnt& position, int snapType, const QStri
                 markerColor = Quantity_NOC_RED;
                 markerType = Aspect_TOM_RING1;  // Ring
                 break;
+            case 0x20: // Grid
+                markerColor = Quantity_NOC_MAGENTA1;
+                markerType = Aspect_TOM_O_PLUS;
+                break;
+            case 0x80: // Grid line
+                markerColor = Quantity_NOC_GRAY80;
+                markerType = Aspect_TOM_O;
+                break;
             default:
                 markerColor = Quantity_NOC_YELLOW;
                 markerType = Aspect_TOM_X;  // X mark
@@ -428,10 +531,10 @@ void OCCTViewer::setSnapMarker(const gp_Pnt& position, int snapType, const QStri
         m_view->Redraw();
     }
     catch (Standard_Failure const& ex) {
-        qDebug() << "Exception in setSnapMarker:" << ex.GetMessageString();
+        LOG_WARNING("viewer", "Exception in setSnapMarker: %1", ex.GetMessageString());
     }
     catch (...) {
-        qDebug() << "Unknown exception in setSnapMarker";
+        LOG_WARNING("viewer", "Unknown exception in setSnapMarker");
     }
 }
 
@@ -448,10 +551,10 @@ void OCCTViewer::clearSnapMarker()
         }
     }
     catch (Standard_Failure const& ex) {
-        qDebug() << "Exception in clearSnapMarker:" << ex.GetMessageString();
+        LOG_WARNING("viewer", "Exception in clearSnapMarker: %1", ex.GetMessageString());
     }
     catch (...) {
-        qDebug() << "Unknown exception in clearSnapMarker";
+        LOG_WARNING("viewer", "Unknown exception in clearSnapMarker");
     }
     
     // Clear multiple snap markers
@@ -510,6 +613,12 @@ void OCCTViewer::updateOverlay()
     update();  // Trigger repaint to redraw overlays
 }
 
+void OCCTViewer::notifyCameraChanged()
+{
+    // Restart the timer - listeners run once the camera stops moving
+    m_cameraTimer->start();
+}
+
 gp_Pnt OCCTViewer::worldToScreen(const gp_Pnt& worldPoint)
 {
     Standard_Integer aWinX, aWinY;
@@ -0,0 +1,22 @@
+#include "ObjectIdAllocator.h"
+
+ObjectIdAllocator::Range ObjectIdAllocator::reserve(int count)
+{
+    if (count <= 0) {
+        return Range();
+    }
+    return Range(m_next.fetch_add(count, std::memory_order_relaxed), count);
+}
+
+bool ObjectIdAllocator::claim(int id)
+{
+    if (id <= 0) {
+        return false;
+    }
+    
+    // Raise the counter past the claimed ID unless another thread already did
+    int next = m_next.load(std::memory_order_relaxed);
+    while (next <= id && !m_next.compare_exchange_weak(next, id + 1, std::memory_order_relaxed)) {
+    }
+    return true;
+}
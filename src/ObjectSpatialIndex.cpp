@@ -0,0 +1,147 @@
+#include "ObjectSpatialIndex.h"
+#include <algorithm>
+
+namespace {
+const int kLeafSize = 4;
+}
+
+ObjectSpatialIndex::ObjectSpatialIndex()
+{
+}
+
+void ObjectSpatialIndex::clear()
+{
+    m_items.clear();
+    m_order.clear();
+    m_nodes.clear();
+}
+
+void ObjectSpatialIndex::add(int id, const double min[3], const double max[3])
+{
+    Item item;
+    item.id = id;
+    for (int k = 0; k < 3; ++k) {
+        item.min[k] = min[k];
+        item.max[k] = max[k];
+    }
+    m_items.push_back(item);
+}
+
+void ObjectSpatialIndex::build()
+{
+    m_nodes.clear();
+    m_order.resize(m_items.size());
+    for (size_t i = 0; i < m_order.size(); ++i) {
+        m_order[i] = static_cast<int>(i);
+    }
+    if (!m_order.empty()) {
+        m_nodes.reserve(2 * m_order.size() / kLeafSize + 1);
+        buildNode(0, static_cast<int>(m_order.size()));
+    }
+}
+
+int ObjectSpatialIndex::buildNode(int begin, int end)
+{
+    Node node;
+    for (int k = 0; k < 3; ++k) {
+        node.min[k] = 1e100;
+        node.max[k] = -1e100;
+    }
+    for (int i = begin; i < end; ++i) {
+        const Item& item = m_items[m_order[i]];
+        for (int k = 0; k < 3; ++k) {
+            node.min[k] = std::min(node.min[k], item.min[k]);
+            node.max[k] = std::max(node.max[k], item.max[k]);
+        }
+    }
+    node.left = node.right = -1;
+    node.first = begin;
+    node.count = end - begin;
+    
+    const int index = static_cast<int>(m_nodes.size());
+    m_nodes.push_back(node);
+    if (end - begin <= kLeafSize) {
+        return index;
+    }
+    
+    // Median split on the longest axis of the node
+    int axis = 0;
+    for (int k = 1; k < 3; ++k) {
+        if (node.max[k] - node.min[k] > node.max[axis] - node.min[axis]) {
+            axis = k;
+        }
+    }
+    const int mid = (begin + end) / 2;
+    std::nth_element(m_order.begin() + begin, m_order.begin() + mid, m_order.begin() + end,
+                     [this, axis](int lhs, int rhs) {
+        const Item& l = m_items[lhs];
+        const Item& r = m_items[rhs];
+        return l.min[axis] + l.max[axis] < r.min[axis] + r.max[axis];
+    });
+    
+    const int left = buildNode(begin, mid);
+    const int right = buildNode(mid, end);
+    m_nodes[index].left = left;
+    m_nodes[index].right = right;
+    return index;
+}
+
+ObjectSpatialIndex::Containment ObjectSpatialIndex::classify(const Frustum& frustum,
+                                                              const double min[3], const double max[3])
+{
+    // Per plane, test the box corner furthest along the normal and the one furthest against it
+    Containment result = INSIDE;
+    for (int p = 0; p < frustum.planeCount; ++p) {
+        const gp_XYZ& n = frustum.normal[p];
+        double furthest = frustum.offset[p];
+        double nearest = frustum.offset[p];
+        for (int k = 0; k < 3; ++k) {
+            const double c = n.Coord(k + 1);
+            furthest += c * (c >= 0.0 ? max[k] : min[k]);
+            nearest += c * (c >= 0.0 ? min[k] : max[k]);
+        }
+        if (furthest < 0.0) {
+            return OUTSIDE;
+        }
+        if (nearest < 0.0) {
+            result = PARTIAL;
+        }
+    }
+    return result;
+}
+
+void ObjectSpatialIndex::query(const Frustum& frustum, std::vector<Hit>& result) const
+{
+    if (m_nodes.empty()) {
+        return;
+    }
+    // Grows as needed, so no subtree is ever skipped for lack of room
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        const Containment containment = classify(frustum, node.min, node.max);
+        if (containment == OUTSIDE) {
+            continue;
+        }
+        if (containment == INSIDE) {
+            // Whole subtree is inside - report it without further tests
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                result.push_back({ m_items[m_order[i]].id, true });
+            }
+        } else if (node.left < 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                const Item& item = m_items[m_order[i]];
+                const Containment c = classify(frustum, item.min, item.max);
+                if (c != OUTSIDE) {
+                    result.push_back({ item.id, c == INSIDE });
+                }
+            }
+        } else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
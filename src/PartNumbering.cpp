@@ -0,0 +1,64 @@
+#include "PartNumbering.h"
+#include <QHash>
+#include <algorithm>
+
+QString PartNumbering::prefix(TGraphicObject::ObjectType type)
+{
+    switch (type) {
+        case TGraphicObject::TYPE_BEAM:       return "B";
+        case TGraphicObject::TYPE_COLUMN:     return "C";
+        case TGraphicObject::TYPE_SLAB:       return "S";
+        case TGraphicObject::TYPE_WALL:       return "W";
+        case TGraphicObject::TYPE_FOUNDATION: return "F";
+        case TGraphicObject::TYPE_BRACE:      return "V";
+        case TGraphicObject::TYPE_PLATE:      return "P";
+        default:                              return "X";
+    }
+}
+
+QVector<PartNumbering::Group> PartNumbering::assign(const NCollection_Sequence<Handle(TGraphicObject)>& objects)
+{
+    QVector<Handle(TGraphicObject)> ordered;
+    ordered.reserve(objects.Length());
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(objects); it.More(); it.Next()) {
+        if (!it.Value().IsNull()) {
+            ordered.append(it.Value());
+        }
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const Handle(TGraphicObject)& a, const Handle(TGraphicObject)& b) {
+        return a->GetID() < b->GetID();
+    });
+    
+    QVector<Group> groups;
+    QHash<quint64, int> groupByHash;
+    groupByHash.reserve(ordered.size());
+    QHash<QString, int> lastNumber;     // Per prefix
+    
+    for (const Handle(TGraphicObject)& object : ordered) {
+        const quint64 hash = object->GetPartHash();
+        int index = hash != 0 ? groupByHash.value(hash, -1) : -1;
+        
+        if (index < 0) {
+            const QString typePrefix = prefix(object->GetType());
+            const int number = ++lastNumber[typePrefix];
+            
+            Group group;
+            group.hash = hash;
+            group.partMark = typePrefix.toLower() + QString::number(number);
+            group.assemblyMark = typePrefix + QString::number(number);
+            
+            index = groups.size();
+            groups.append(group);
+            if (hash != 0) {
+                groupByHash.insert(hash, index);
+            }
+        }
+        
+        Group& group = groups[index];
+        group.objectIDs.append(object->GetID());
+        object->SetPartMark(group.partMark);
+        object->SetAssemblyMark(group.assemblyMark);
+    }
+    
+    return groups;
+}
@@ -0,0 +1,168 @@
+#include "PreviewOutline.h"
+#include "Logger.h"
+#include <BRepAdaptor_Curve.hxx>
+#include <BRep_Tool.hxx>
+#include <GCPnts_TangentialDeflection.hxx>
+#include <Graphic3d_AspectLine3d.hxx>
+#include <Graphic3d_AttribBuffer.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+#include <gp_Ax1.hxx>
+#include <gp_Mat.hxx>
+#include <gp_Trsf.hxx>
+
+PreviewOutline::PreviewOutline(const Quantity_Color& color)
+    : m_color(color)
+{
+    // The outline moves every frame; keep it out of culling and Fit All
+    SetInfiniteState(Standard_True);
+    SetMutable(Standard_True);
+    SetZLayer(Graphic3d_ZLayerId_Top);
+}
+
+void PreviewOutline::addSegment(const gp_XYZ& a, const gp_XYZ& b)
+{
+    m_local.push_back(a);
+    m_local.push_back(b);
+}
+
+void PreviewOutline::addBox(const gp_XYZ& min, const gp_XYZ& max)
+{
+    gp_XYZ c[8];
+    for (int i = 0; i < 8; ++i) {
+        c[i] = gp_XYZ((i & 1) ? max.X() : min.X(), (i & 2) ? max.Y() : min.Y(), (i & 4) ? max.Z() : min.Z());
+    }
+    const int edges[12][2] = { { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },
+                               { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },
+                               { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } };
+    for (const int* e : edges) {
+        addSegment(c[e[0]], c[e[1]]);
+    }
+}
+
+void PreviewOutline::addSweptSection(const TopoDS_Shape& section, double deflection)
+{
+    const gp_XYZ along(1.0, 0.0, 0.0);
+    for (TopExp_Explorer exp(section, TopAbs_EDGE); exp.More(); exp.Next()) {
+        const TopoDS_Edge& edge = TopoDS::Edge(exp.Current());
+        if (BRep_Tool::Degenerated(edge)) {
+            continue;
+        }
+        try {
+            BRepAdaptor_Curve curve(edge);
+            std::vector<gp_XYZ> points;
+            if (curve.GetType() == GeomAbs_Line) {
+                points.push_back(curve.Value(curve.FirstParameter()).XYZ());
+                points.push_back(curve.Value(curve.LastParameter()).XYZ());
+            } else {
+                GCPnts_TangentialDeflection sampler(curve, 0.2, deflection);
+                for (int i = 1; i <= sampler.NbPoints(); ++i) {
+                    points.push_back(sampler.Value(i).XYZ());
+                }
+            }
+            for (size_t i = 1; i < points.size(); ++i) {
+                addSegment(points[i - 1], points[i]);
+                addSegment(points[i - 1] + along, points[i] + along);
+            }
+        } catch (Standard_Failure const& ex) {
+            LOG_WARNING("preview", "Outline skipping edge: %1", ex.GetMessageString());
+        }
+    }
+    
+    // Longitudinal lines at the section corners only, not at every arc sample
+    TopTools_IndexedMapOfShape vertices;
+    TopExp::MapShapes(section, TopAbs_VERTEX, vertices);
+    for (int i = 1; i <= vertices.Extent(); ++i) {
+        const gp_XYZ p = BRep_Tool::Pnt(TopoDS::Vertex(vertices(i))).XYZ();
+        addSegment(p, p + along);
+    }
+}
+
+void PreviewOutline::setPlacement(const gp_GTrsf& placement)
+{
+    m_placement = placement;
+    if (m_segments.IsNull() || m_segments->VertexNumber() != static_cast<int>(m_local.size())) {
+        return;     // Not displayed yet - Compute() uses the new placement
+    }
+    
+    // Rewrite the vertices in place; the driver re-uploads only the invalidated range
+    for (size_t i = 0; i < m_local.size(); ++i) {
+        gp_XYZ p = m_local[i];
+        m_placement.Transforms(p);
+        m_segments->SetVertice(static_cast<int>(i) + 1, gp_Pnt(p));
+    }
+    Handle(Graphic3d_AttribBuffer) attribs = Handle(Graphic3d_AttribBuffer)::DownCast(m_segments->Attributes());
+    if (!attribs.IsNull()) {
+        attribs->Invalidate(0, static_cast<int>(m_local.size()) - 1);
+    }
+}
+
+gp_GTrsf PreviewOutline::sweepPlacement(const gp_Pnt& start, const gp_Pnt& end)
+{
+    gp_Vec direction(start, end);
+    const double length = direction.Magnitude();
+    
+    // Same rotation SteelProfile::extrudeSection applies to the extruded section
+    gp_Trsf rotation;
+    if (length > 1e-6) {
+        direction.Normalize();
+        const gp_Vec localX(1, 0, 0);
+        const double angle = localX.Angle(direction);
+        if (angle > 1e-6) {
+            gp_Vec rotAxis = localX.Crossed(direction);
+            gp_Dir axisDir = rotAxis.Magnitude() > 1e-6 ? gp_Dir(rotAxis) : gp_Dir(0, 0, 1);
+            rotation.SetRotation(gp_Ax1(gp_Pnt(0, 0, 0), axisDir), angle);
+        }
+    }
+    
+    gp_GTrsf placement;
+    placement.SetVectorialPart(gp_Mat(gp_Vec(1, 0, 0).Transformed(rotation).XYZ() * length,
+                                      gp_Vec(0, 1, 0).Transformed(rotation).XYZ(),
+                                      gp_Vec(0, 0, 1).Transformed(rotation).XYZ()));
+    placement.SetTranslationPart(start.XYZ());
+    return placement;
+}
+
+gp_GTrsf PreviewOutline::boxPlacement(const gp_Pnt& origin, double sx, double sy, double sz)
+{
+    gp_GTrsf placement;
+    placement.SetVectorialPart(gp_Mat(gp_XYZ(sx, 0, 0), gp_XYZ(0, sy, 0), gp_XYZ(0, 0, sz)));
+    placement.SetTranslationPart(origin.XYZ());
+    return placement;
+}
+
+void PreviewOutline::Compute(const Handle(PrsMgr_PresentationManager)& presentationManager,
+                             const Handle(Prs3d_Presentation)& presentation,
+                             const Standard_Integer mode)
+{
+    Q_UNUSED(presentationManager);
+    if (mode != 0 || m_local.empty()) {
+        return;
+    }
+    
+    // Allocated once per display; later moves only rewrite the vertices
+    m_segments = new Graphic3d_ArrayOfSegments(static_cast<int>(m_local.size()), 0,
+                                               Graphic3d_ArrayFlags_AttribsMutable);
+    for (const gp_XYZ& local : m_local) {
+        gp_XYZ p = local;
+        m_placement.Transforms(p);
+        m_segments->AddVertex(gp_Pnt(p));
+    }
+    
+    Handle(Graphic3d_Group) group = presentation->CurrentGroup();
+    group->SetGroupPrimitivesAspect(new Graphic3d_AspectLine3d(m_color, Aspect_TOL_SOLID, 2.0));
+    group->AddPrimitiveArray(m_segments);
+}
+
+void PreviewOutline::ComputeSelection(const Handle(SelectMgr_Selection)& selection,
+                                      const Standard_Integer mode)
+{
+    // Never picked
+    Q_UNUSED(selection);
+    Q_UNUSED(mode);
+}
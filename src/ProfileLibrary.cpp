@@ -0,0 +1,329 @@
+#include "ProfileLibrary.h"
+#include "Logger.h"
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QTextStream>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct FileHeader {
+    char magic[8];          // "EMPLIB01"
+    quint32 version;
+    quint32 recordSize;
+    quint64 recordCount;
+    quint64 recordOffset;
+    quint64 reserved[4];
+};
+
+const char kMagic[8] = { 'E', 'M', 'P', 'L', 'I', 'B', '0', '1' };
+const quint32 kVersion = 1;
+
+static_assert(sizeof(FileHeader) == 64, "catalogue header layout changed");
+static_assert(sizeof(ProfileLibrary::Record) == 160, "catalogue record layout changed");
+
+inline ushort foldChar(ushort c)
+{
+    return (c >= 'a' && c <= 'z') ? ushort(c - 'a' + 'A') : c;
+}
+
+// Case-insensitive comparison of a record name against a key.
+// With prefixOnly, names starting with the key compare equal.
+int compareKey(const char* name, const QString& key, bool prefixOnly)
+{
+    const QChar* k = key.constData();
+    const int n = key.size();
+    for (int i = 0; i < ProfileLibrary::NameLength; ++i) {
+        if (i == n) {
+            return (prefixOnly || name[i] == '\0') ? 0 : 1;
+        }
+        ushort a = foldChar(static_cast<unsigned char>(name[i]));
+        ushort b = foldChar(k[i].unicode());
+        if (a != b) {
+            return a < b ? -1 : 1;
+        }
+    }
+    return n > ProfileLibrary::NameLength ? -1 : 0;
+}
+
+bool recordLess(const ProfileLibrary::Record& lhs, const ProfileLibrary::Record& rhs)
+{
+    for (int i = 0; i < ProfileLibrary::NameLength; ++i) {
+        ushort a = foldChar(static_cast<unsigned char>(lhs.name[i]));
+        ushort b = foldChar(static_cast<unsigned char>(rhs.name[i]));
+        if (a != b) return a < b;
+        if (a == 0) break;
+    }
+    return false;
+}
+
+// Column labels rather than data: none of the dimension fields is a number
+bool isHeaderRow(const QStringList& fields)
+{
+    if (fields.size() < 3) {
+        return false;
+    }
+    for (int i = 2; i < fields.size(); ++i) {
+        bool ok = false;
+        fields[i].trimmed().toDouble(&ok);
+        if (ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parseShape(const QString& token, SteelProfile::SectionShape& shape)
+{
+    const QString t = token.trimmed().toUpper();
+    if (t == "I" || t == "H" || t == "W" || t == "IPE" || t == "HE") {
+        shape = SteelProfile::SECTION_I;
+    } else if (t == "U" || t == "C" || t == "UPN" || t == "UPE" || t == "CHANNEL") {
+        shape = SteelProfile::SECTION_CHANNEL;
+    } else if (t == "L" || t == "ANGLE") {
+        shape = SteelProfile::SECTION_ANGLE;
+    } else if (t == "RHS" || t == "SHS") {
+        shape = SteelProfile::SECTION_RHS;
+    } else if (t == "CHS" || t == "PIPE") {
+        shape = SteelProfile::SECTION_CHS;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+ProfileLibrary& ProfileLibrary::instance()
+{
+    static ProfileLibrary library;
+    return library;
+}
+
+ProfileLibrary::ProfileLibrary()
+    : m_mapping(nullptr)
+    , m_records(nullptr)
+    , m_count(0)
+{
+}
+
+ProfileLibrary::~ProfileLibrary()
+{
+    close();
+}
+
+QString ProfileLibrary::defaultCatalogPath()
+{
+    return QCoreApplication::applicationDirPath() + "/profiles.csv";
+}
+
+bool ProfileLibrary::open(const QString& path, QString* error)
+{
+    close();
+
+    QString binaryPath = path;
+    QFileInfo info(path);
+    if (info.suffix().compare("csv", Qt::CaseInsensitive) == 0) {
+        // Compile next to the CSV unless an up-to-date binary already exists
+        binaryPath = info.absolutePath() + "/" + info.completeBaseName() + ".eplib";
+        QFileInfo binaryInfo(binaryPath);
+        if (!binaryInfo.exists() || binaryInfo.lastModified() < info.lastModified()) {
+            if (!compileCatalog(path, binaryPath, error)) {
+                return false;
+            }
+        }
+    }
+
+    m_file.setFileName(binaryPath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("Cannot open %1").arg(binaryPath);
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    if (size < static_cast<qint64>(sizeof(FileHeader))) {
+        if (error) *error = QString("%1 is not a profile catalogue").arg(binaryPath);
+        m_file.close();
+        return false;
+    }
+
+    m_mapping = m_file.map(0, size);
+    if (!m_mapping) {
+        if (error) *error = QString("Cannot map %1").arg(binaryPath);
+        m_file.close();
+        return false;
+    }
+
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(m_mapping);
+    const bool valid = std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0
+                    && header->version == kVersion
+                    && header->recordSize == sizeof(Record)
+                    && header->recordOffset % alignof(Record) == 0
+                    && header->recordOffset + header->recordCount * sizeof(Record) <= static_cast<quint64>(size);
+    if (!valid) {
+        if (error) *error = QString("%1 has an unsupported catalogue format").arg(binaryPath);
+        close();
+        return false;
+    }
+
+    m_records = reinterpret_cast<const Record*>(m_mapping + header->recordOffset);
+    m_count = static_cast<int>(header->recordCount);
+
+    LOG_INFO("profile", "Mapped %1 sections from %2", m_count, binaryPath);
+    return true;
+}
+
+void ProfileLibrary::close()
+{
+    if (m_mapping) {
+        m_file.unmap(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_records = nullptr;
+    m_count = 0;
+}
+
+QString ProfileLibrary::name(int index) const
+{
+    const Record& r = m_records[index];
+    return QString::fromLatin1(r.name, static_cast<int>(qstrnlen(r.name, NameLength)));
+}
+
+int ProfileLibrary::find(const QString& name) const
+{
+    int index = lowerBound(name);
+    if (index < m_count && compareKey(m_records[index].name, name, false) == 0) {
+        return index;
+    }
+    return -1;
+}
+
+int ProfileLibrary::lowerBound(const QString& prefix) const
+{
+    int lo = 0, hi = m_count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (compareKey(m_records[mid].name, prefix, false) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+int ProfileLibrary::upperBound(const QString& prefix) const
+{
+    int lo = 0, hi = m_count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (compareKey(m_records[mid].name, prefix, true) <= 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool ProfileLibrary::compileCatalog(const QString& csvPath, const QString& binaryPath, QString* error)
+{
+    QFile input(csvPath);
+    if (!input.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) *error = QString("Cannot open %1").arg(csvPath);
+        return false;
+    }
+
+    std::vector<Record> records;
+    QTextStream in(&input);
+    int lineNumber = 0;
+    int skipped = 0;
+    bool firstRow = true;
+    auto reject = [&csvPath, &lineNumber, &skipped](const QString& reason) {
+        LOG_WARNING("profile", "%1:%2: %3, row skipped", csvPath, lineNumber, reason);
+        skipped++;
+    };
+
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        const QStringList fields = line.split(line.contains(';') ? ';' : ',');
+        if (firstRow) {
+            firstRow = false;
+            if (isHeaderRow(fields)) {
+                continue;
+            }
+        }
+
+        SteelProfile::SectionShape shape;
+        if (fields.size() < 8 || !parseShape(fields[1], shape)) {
+            reject("expected name,shape,h,b,tw,tf,r,t");
+            continue;
+        }
+
+        const QByteArray name = fields[0].trimmed().toLatin1();
+        if (name.isEmpty() || name.size() >= NameLength) {
+            reject("invalid section name");
+            continue;
+        }
+
+        double values[6];
+        bool numbers = true;
+        for (int i = 0; i < 6 && numbers; ++i) {
+            values[i] = fields[i + 2].trimmed().toDouble(&numbers);
+            if (!numbers) {
+                reject(QString("bad number '%1'").arg(fields[i + 2]));
+            }
+        }
+        if (!numbers) {
+            continue;
+        }
+
+        Record record;
+        std::memset(&record, 0, sizeof(record));
+        std::memcpy(record.name, name.constData(), name.size());
+        record.shape = shape;
+        record.dim = { values[0], values[1], values[2], values[3], values[4], values[5] };
+        record.props = SteelProfile::computeSectionProperties({ shape, record.dim });
+        records.push_back(record);
+    }
+
+    if (records.empty() && skipped > 0) {
+        if (error) *error = QString("%1: none of the %2 rows could be read").arg(csvPath).arg(skipped);
+        return false;
+    }
+
+    std::stable_sort(records.begin(), records.end(), recordLess);
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.recordSize = sizeof(Record);
+    header.recordCount = records.size();
+    header.recordOffset = sizeof(FileHeader);
+
+    QFile output(binaryPath);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = QString("Cannot write %1").arg(binaryPath);
+        return false;
+    }
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!records.empty()) {
+        output.write(reinterpret_cast<const char*>(records.data()),
+                     static_cast<qint64>(records.size() * sizeof(Record)));
+    }
+    output.close();
+
+    LOG_INFO("profile", "Compiled %1 sections into %2 (%3 rows skipped)", static_cast<int>(records.size()), binaryPath, skipped);
+    return true;
+}
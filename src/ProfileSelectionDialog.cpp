@@ -1,9 +1,109 @@
 #include "ProfileSelectionDialog.h"
+#include "ProfileLibrary.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPushButton>
 #include <QGroupBox>
 #include <QDialogButtonBox>
+#include <QFileDialog>
+#include <QMessageBox>
+
+namespace {
+const int kFetchBatch = 200;
+}
+
+ProfileListModel::ProfileListModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_type(SteelProfile::IPE)
+    , m_first(0)
+    , m_total(0)
+    , m_loaded(0)
+{
+}
+
+void ProfileListModel::setSource(SteelProfile::ProfileType type, const QString& prefix)
+{
+    beginResetModel();
+    m_type = type;
+    m_indices.clear();
+    m_first = 0;
+    m_total = 0;
+    
+    if (type == SteelProfile::LIBRARY) {
+        // Sorted catalogue: the prefix matches form one contiguous range
+        const ProfileLibrary& library = ProfileLibrary::instance();
+        if (prefix.isEmpty()) {
+            m_total = library.count();
+        } else {
+            m_first = library.lowerBound(prefix);
+            m_total = library.upperBound(prefix) - m_first;
+        }
+    } else {
+        // Built-in tables are short and kept in size order, filter in place
+        const int count = SteelProfile::getSizeCount(type);
+        for (int i = 0; i < count; ++i) {
+            if (QLatin1String(SteelProfile::getEntry(type, i).name).startsWith(prefix, Qt::CaseInsensitive)) {
+                m_indices.append(i);
+            }
+        }
+        m_total = m_indices.size();
+    }
+    
+    m_loaded = qMin(m_total, kFetchBatch);
+    endResetModel();
+}
+
+int ProfileListModel::catalogIndex(int row) const
+{
+    if (row < 0 || row >= m_loaded) {
+        return -1;
+    }
+    return m_type == SteelProfile::LIBRARY ? m_first + row : m_indices[row];
+}
+
+QString ProfileListModel::sizeName(int row) const
+{
+    int index = catalogIndex(row);
+    if (index < 0) {
+        return QString();
+    }
+    if (m_type == SteelProfile::LIBRARY) {
+        return ProfileLibrary::instance().name(index);
+    }
+    return QLatin1String(SteelProfile::getEntry(m_type, index).name);
+}
+
+int ProfileListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_loaded;
+}
+
+QVariant ProfileListModel::data(const QModelIndex &index, int role) const
+{
+    if (role != Qt::DisplayRole || !index.isValid()) {
+        return QVariant();
+    }
+    return sizeName(index.row());
+}
+
+bool ProfileListModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_loaded < m_total;
+}
+
+void ProfileListModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    int count = qMin(kFetchBatch, m_total - m_loaded);
+    if (count <= 0) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), m_loaded, m_loaded + count - 1);
+    m_loaded += count;
+    endInsertRows();
+}
 
 ProfileSelectionDialog::ProfileSelectionDialog(QWidget *parent)
     : QDialog(parent), m_useProfile(true)
@@ -24,16 +124,29 @@ ProfileSelectionDialog::ProfileSelectionDialog(QWidget *parent)
     m_profileTypeCombo->addItem("HEB - Wide Flange (Medium)", (int)SteelProfile::HEB);
     m_profileTypeCombo->addItem("HEM - Wide Flange (Heavy)", (int)SteelProfile::HEM);
     m_profileTypeCombo->addItem("RHS - Rectangular Hollow Section", (int)SteelProfile::RHS);
+    m_profileTypeCombo->addItem("Library - External Catalogue", (int)SteelProfile::LIBRARY);
     
-    typeLayout->addWidget(m_profileTypeCombo);
+    QHBoxLayout *typeRow = new QHBoxLayout();
+    typeRow->addWidget(m_profileTypeCombo, 1);
+    QPushButton *openCatalogBtn = new QPushButton("Open Catalog...", this);
+    typeRow->addWidget(openCatalogBtn);
+    typeLayout->addLayout(typeRow);
     mainLayout->addWidget(typeGroup);
     
     // Size selection
     QGroupBox *sizeGroup = new QGroupBox("Available Sizes", this);
     QVBoxLayout *sizeLayout = new QVBoxLayout(sizeGroup);
     
-    m_sizeList = new QListWidget(this);
+    m_filterEdit = new QLineEdit(this);
+    m_filterEdit->setPlaceholderText("Filter by name prefix, e.g. HEB 3");
+    m_filterEdit->setClearButtonEnabled(true);
+    sizeLayout->addWidget(m_filterEdit);
+    
+    m_sizeModel = new ProfileListModel(this);
+    m_sizeList = new QListView(this);
+    m_sizeList->setModel(m_sizeModel);
     m_sizeList->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_sizeList->setUniformItemSizes(true);
     sizeLayout->addWidget(m_sizeList);
     
     mainLayout->addWidget(sizeGroup);
@@ -65,10 +178,14 @@ ProfileSelectionDialog::ProfileSelectionDialog(QWidget *parent)
     // Connect signals
     connect(m_profileTypeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &ProfileSelectionDialog::onProfileTypeChanged);
-    connect(m_sizeList, &QListWidget::itemSelectionChanged,
+    connect(m_sizeList->selectionModel(), &QItemSelectionModel::currentChanged,
             this, &ProfileSelectionDialog::updateDimensions);
-    connect(m_sizeList, &QListWidget::itemDoubleClicked,
+    connect(m_sizeList, &QListView::doubleClicked,
             this, &ProfileSelectionDialog::accept);
+    connect(m_filterEdit, &QLineEdit::textChanged,
+            this, &ProfileSelectionDialog::onFilterChanged);
+    connect(openCatalogBtn, &QPushButton::clicked,
+            this, &ProfileSelectionDialog::onOpenCatalog);
     connect(useRectangularBtn, &QPushButton::clicked,
             this, &ProfileSelectionDialog::onUseRectangular);
     connect(dialogButtons, &QDialogButtonBox::accepted, this, &QDialog::accept);
@@ -76,7 +193,7 @@ ProfileSelectionDialog::ProfileSelectionDialog(QWidget *parent)
     
     // Initialize with IPE profiles
     updateSizeList();
-    m_sizeList->setCurrentRow(6); // Default to IPE 200
+    selectRow(SteelProfile::getDefaultSizeIndex(SteelProfile::IPE)); // Default to IPE 200
 }
 
 SteelProfile::ProfileType ProfileSelectionDialog::getSelectedProfileType() const
@@ -87,9 +204,9 @@ SteelProfile::ProfileType ProfileSelectionDialog::getSelectedProfileType() const
 
 QString ProfileSelectionDialog::getSelectedSize() const
 {
-    QListWidgetItem *item = m_sizeList->currentItem();
-    if (item) {
-        return item->text();
+    QString size = m_sizeModel->sizeName(m_sizeList->currentIndex().row());
+    if (!size.isEmpty()) {
+        return size;
     }
     return "IPE 200";
 }
@@ -112,37 +229,86 @@ void ProfileSelectionDialog::onUseRectangular()
     accept();
 }
 
-void ProfileSelectionDialog::updateSizeList()
+void ProfileSelectionDialog::onFilterChanged(const QString& text)
 {
-    m_sizeList->clear();
-    
-    SteelProfile::ProfileType type = getSelectedProfileType();
-    QStringList sizes = SteelProfile::getAvailableSizes(type);
+    Q_UNUSED(text);
+    updateSizeList();
+}
+
+void ProfileSelectionDialog::onOpenCatalog()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, "Open Profile Catalog", QString(),
+                                                    "Profile Catalogs (*.csv *.eplib);;All Files (*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
     
-    for (const QString& size : sizes) {
-        m_sizeList->addItem(size);
+    QString error;
+    if (!ProfileLibrary::instance().open(fileName, &error)) {
+        QMessageBox::warning(this, "Open Profile Catalog", error);
     }
     
-    if (m_sizeList->count() > 0) {
-        m_sizeList->setCurrentRow(0);
-        updateDimensions();
+    // Show the library (or its now empty state) whether or not the open succeeded
+    int libraryItem = m_profileTypeCombo->findData((int)SteelProfile::LIBRARY);
+    if (m_profileTypeCombo->currentIndex() == libraryItem) {
+        updateSizeList();
+    } else {
+        m_profileTypeCombo->setCurrentIndex(libraryItem);
     }
 }
 
+void ProfileSelectionDialog::updateSizeList()
+{
+    m_sizeModel->setSource(getSelectedProfileType(), m_filterEdit->text().trimmed());
+    selectRow(0);
+}
+
+void ProfileSelectionDialog::selectRow(int row)
+{
+    if (row >= 0 && row < m_sizeModel->rowCount()) {
+        QModelIndex index = m_sizeModel->index(row);
+        m_sizeList->setCurrentIndex(index);
+        m_sizeList->scrollTo(index);
+    }
+    updateDimensions();
+}
+
 void ProfileSelectionDialog::updateDimensions()
 {
-    QListWidgetItem *item = m_sizeList->currentItem();
-    if (!item) {
+    int row = m_sizeList->currentIndex().row();
+    int catalogIndex = m_sizeModel->catalogIndex(row);
+    if (catalogIndex < 0) {
         m_dimensionsLabel->setText("Select a profile to see dimensions");
         return;
     }
     
-    QString size = item->text();
+    // Look up by catalogue index - no name search per selection change
+    QString size = m_sizeModel->sizeName(row);
     SteelProfile::ProfileType type = getSelectedProfileType();
-    SteelProfile::Dimensions dim = SteelProfile::getDimensions(type, size);
+    SteelProfile::SectionDescriptor section = SteelProfile::getSection(type, catalogIndex);
+    const SteelProfile::Dimensions& dim = section.dim;
+    const SteelProfile::SectionProperties& props = SteelProfile::getSectionProperties(type, catalogIndex);
     
     QString dimText;
-    if (type == SteelProfile::RHS) {
+    if (section.shape == SteelProfile::SECTION_CHS) {
+        dimText = QString("<b>%1</b><br>"
+                         "Outside Diameter: %2 mm<br>"
+                         "Wall Thickness: %3 mm")
+                         .arg(size)
+                         .arg(dim.height, 0, 'f', 1)
+                         .arg(dim.thickness, 0, 'f', 1);
+    } else if (section.shape == SteelProfile::SECTION_ANGLE) {
+        dimText = QString("<b>%1</b><br>"
+                         "Leg (h): %2 mm<br>"
+                         "Leg (b): %3 mm<br>"
+                         "Thickness (t): %4 mm<br>"
+                         "Root Radius (r): %5 mm")
+                         .arg(size)
+                         .arg(dim.height, 0, 'f', 1)
+                         .arg(dim.width, 0, 'f', 1)
+                         .arg(dim.thickness, 0, 'f', 1)
+                         .arg(dim.radius, 0, 'f', 1);
+    } else if (section.shape == SteelProfile::SECTION_RHS) {
         dimText = QString("<b>%1</b><br>"
                          "Height: %2 mm<br>"
                          "Width: %3 mm<br>"
@@ -166,5 +332,17 @@ void ProfileSelectionDialog::updateDimensions()
                          .arg(dim.radius, 0, 'f', 1);
     }
     
+    dimText += QString("<br><br>"
+                       "Area (A): %1 cm&sup2;<br>"
+                       "Mass (G): %2 kg/m<br>"
+                       "Iy: %3 cm&#8308; &nbsp; Iz: %4 cm&#8308;<br>"
+                       "Wel,y: %5 cm&sup3; &nbsp; Wpl,y: %6 cm&sup3;")
+                       .arg(props.area / 1e2, 0, 'f', 2)
+                       .arg(props.weightPerMetre, 0, 'f', 1)
+                       .arg(props.Iy / 1e4, 0, 'f', 0)
+                       .arg(props.Iz / 1e4, 0, 'f', 0)
+                       .arg(props.Wely / 1e3, 0, 'f', 1)
+                       .arg(props.Wply / 1e3, 0, 'f', 1);
+    
     m_dimensionsLabel->setText(dimText);
 }
@@ -4,11 +4,87 @@
 #include <QColorDialog>
 #include <QMessageBox>
 #include <QCheckBox>
+#include <QLineEdit>
+
+namespace {
+
+const char* const kVaries = "<varies>";
+
+// True if every object yields the same value; value is the first object's
+template <typename T, typename Getter>
+bool commonValue(const NCollection_Sequence<Handle(TGraphicObject)>& objects, Getter get, T& value)
+{
+    value = get(objects.First());
+    for (int i = 2; i <= objects.Length(); i++) {
+        if (!(get(objects.Value(i)) == value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QString formatPoint(const gp_Pnt& p)
+{
+    return QString("(%1, %2, %3)").arg(p.X(), 0, 'f', 1).arg(p.Y(), 0, 'f', 1).arg(p.Z(), 0, 'f', 1);
+}
+
+QString sectionText(const Handle(TBeam)& beam)
+{
+    if (beam->IsProfileSection()) {
+        return QString("<b>Steel Profile: %1</b>").arg(beam->GetProfileSize());
+    }
+    double width, height;
+    beam->GetSectionDimensions(width, height);
+    return QString("<b>Rectangular: %1 × %2 mm</b>").arg(width, 0, 'f', 0).arg(height, 0, 'f', 0);
+}
+
+// Setters below touch a widget only when its value differs, so refreshing
+// with unchanged data triggers no relayout or repaint
+
+void setLabelText(QLabel* label, const QString& text)
+{
+    if (label->text() != text) {
+        label->setText(text);
+    }
+}
+
+void setLineEdit(QLineEdit* edit, bool shared, const QString& value)
+{
+    const QString text = shared ? value : QString();
+    if (edit->text() != text) {
+        edit->setText(text);
+    }
+    const QString placeholder = shared ? QString() : QString(kVaries);
+    if (edit->placeholderText() != placeholder) {
+        edit->setPlaceholderText(placeholder);
+    }
+}
+
+void setCheckBox(QCheckBox* box, bool shared, bool value)
+{
+    if (box->isTristate() == shared) {
+        box->setTristate(!shared);
+    }
+    const Qt::CheckState state = shared ? (value ? Qt::Checked : Qt::Unchecked) : Qt::PartiallyChecked;
+    if (box->checkState() != state) {
+        box->setCheckState(state);
+    }
+}
+
+} // namespace
 
 PropertiesPanel::PropertiesPanel(QWidget* parent)
     : QDockWidget("Properties", parent)
+    , m_statistics(new SelectionStatistics(this))
+    , m_refreshTimer(new QTimer(this))
+    , m_refreshPending(false)
     , m_updatingUI(false)
 {
+    // Selection changes are applied at most once per frame (~60 Hz)
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(16);
+    connect(m_refreshTimer, &QTimer::timeout, this, &PropertiesPanel::onRefreshTimeout);
+    
     m_selectedColor[0] = 200;
     m_selectedColor[1] = 200;
     m_selectedColor[2] = 200;
@@ -20,6 +96,8 @@ PropertiesPanel::PropertiesPanel(QWidget* parent)
                 QDockWidget::DockWidgetFloatable |
                 QDockWidget::DockWidgetClosable);
     setAllowedAreas(Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea);
+    
+    connect(m_statistics, &SelectionStatistics::finished, this, &PropertiesPanel::onStatisticsFinished);
 }
 
 PropertiesPanel::~PropertiesPanel()
@@ -200,6 +278,10 @@ void PropertiesPanel::createCommonPropertiesGroup()
     m_objectIDLabel = new QLabel("-");
     layout->addRow("ID:", m_objectIDLabel);
     
+    // Part / assembly mark (read-only, set by Number Parts)
+    m_partMarkLabel = new QLabel("-");
+    layout->addRow("Mark:", m_partMarkLabel);
+    
     // Name
     m_nameEdit = new QLineEdit();
     connect(m_nameEdit, &QLineEdit::textChanged, this, &PropertiesPanel::onNameChanged);
@@ -264,9 +346,102 @@ void PropertiesPanel::createTypeSpecificGroup()
 {
     m_typeSpecificGroup = new QGroupBox("Type Specific", m_mainWidget);
     m_typeSpecificLayout = new QVBoxLayout(m_typeSpecificGroup);
+    
+    // One widget set per object type, built once and shown or hidden on selection
+    createBeamWidgets();
+    createColumnWidgets();
+    createSlabWidgets();
+    
+    m_mixedTypeLabel = new QLabel("Mixed types - common properties only");
+    m_typeSpecificLayout->addWidget(m_mixedTypeLabel);
+    showTypeSpecificWidget(nullptr);
+    
     m_mainLayout->addWidget(m_typeSpecificGroup);
 }
 
+void PropertiesPanel::createBeamWidgets()
+{
+    m_beamWidget = new QWidget(m_typeSpecificGroup);
+    QFormLayout* layout = new QFormLayout(m_beamWidget);
+    layout->setContentsMargins(0, 0, 0, 0);
+    
+    m_beamStartLabel = new QLabel("-");
+    layout->addRow("Start Point:", m_beamStartLabel);
+    
+    m_beamEndLabel = new QLabel("-");
+    layout->addRow("End Point:", m_beamEndLabel);
+    
+    m_beamLengthLabel = new QLabel("-");
+    layout->addRow("Length:", m_beamLengthLabel);
+    
+    m_beamDirectionLabel = new QLabel("-");
+    layout->addRow("Direction:", m_beamDirectionLabel);
+    
+    m_beamSectionLabel = new QLabel("-");
+    layout->addRow("Section:", m_beamSectionLabel);
+    
+    m_typeSpecificLayout->addWidget(m_beamWidget);
+}
+
+void PropertiesPanel::createColumnWidgets()
+{
+    m_columnWidget = new QWidget(m_typeSpecificGroup);
+    QFormLayout* layout = new QFormLayout(m_columnWidget);
+    layout->setContentsMargins(0, 0, 0, 0);
+    
+    m_columnBaseLabel = new QLabel("-");
+    layout->addRow("Base Point:", m_columnBaseLabel);
+    
+    m_columnWidthSpin = createDimensionSpin(50, 5000);
+    connect(m_columnWidthSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &PropertiesPanel::onColumnPropertyChanged);
+    layout->addRow("Width:", m_columnWidthSpin);
+    
+    m_columnDepthSpin = createDimensionSpin(50, 5000);
+    connect(m_columnDepthSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &PropertiesPanel::onColumnPropertyChanged);
+    layout->addRow("Depth:", m_columnDepthSpin);
+    
+    m_columnHeightSpin = createDimensionSpin(100, 20000);
+    connect(m_columnHeightSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &PropertiesPanel::onColumnPropertyChanged);
+    layout->addRow("Height:", m_columnHeightSpin);
+    
+    m_typeSpecificLayout->addWidget(m_columnWidget);
+}
+
+void PropertiesPanel::createSlabWidgets()
+{
+    m_slabWidget = new QWidget(m_typeSpecificGroup);
+    QFormLayout* layout = new QFormLayout(m_slabWidget);
+    layout->setContentsMargins(0, 0, 0, 0);
+    
+    m_slabCorner1Label = new QLabel("-");
+    layout->addRow("Corner 1:", m_slabCorner1Label);
+    
+    m_slabCorner2Label = new QLabel("-");
+    layout->addRow("Corner 2:", m_slabCorner2Label);
+    
+    m_slabThicknessSpin = createDimensionSpin(50, 1000);
+    connect(m_slabThicknessSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, &PropertiesPanel::onSlabPropertyChanged);
+    layout->addRow("Thickness:", m_slabThicknessSpin);
+    
+    m_slabAreaLabel = new QLabel("-");
+    layout->addRow("Area:", m_slabAreaLabel);
+    
+    m_typeSpecificLayout->addWidget(m_slabWidget);
+}
+
+void PropertiesPanel::showTypeSpecificWidget(QWidget* widget)
+{
+    // setVisible() is a no-op when unchanged, so browsing same-type objects costs no relayout
+    m_beamWidget->setVisible(widget == m_beamWidget);
+    m_columnWidget->setVisible(widget == m_columnWidget);
+    m_slabWidget->setVisible(widget == m_slabWidget);
+    m_mixedTypeLabel->setVisible(widget == m_mixedTypeLabel);
+}
+
 void PropertiesPanel::createStatisticsGroup()
 {
     m_statisticsGroup = new QGroupBox("Statistics", m_mainWidget);
@@ -278,6 +453,12 @@ void PropertiesPanel::createStatisticsGroup()
     m_surfaceAreaLabel = new QLabel("-");
     layout->addRow("Surface Area:", m_surfaceAreaLabel);
     
+    m_weightLabel = new QLabel("-");
+    layout->addRow("Weight:", m_weightLabel);
+    
+    m_totalBeamLengthLabel = new QLabel("-");
+    layout->addRow("Beam Length:", m_totalBeamLengthLabel);
+    
     m_creationTimeLabel = new QLabel("-");
     layout->addRow("Created:", m_creationTimeLabel);
     
@@ -287,296 +468,406 @@ void PropertiesPanel::createStatisticsGroup()
     m_mainLayout->addWidget(m_statisticsGroup);
 }
 
+
 void PropertiesPanel::setObject(const Handle(TGraphicObject)& object)
 {
-    m_currentObject = object;
-    
-    if (object.IsNull()) {
+    NCollection_Sequence<Handle(TGraphicObject)> objects;
+    if (!object.IsNull()) {
+        objects.Append(object);
+    }
+    setObjects(objects);
+}
+
+void PropertiesPanel::setObjects(const NCollection_Sequence<Handle(TGraphicObject)>& objects)
+{
+    if (objects.IsEmpty()) {
         clearProperties();
         return;
     }
     
+    // The first change shows at once; further changes within a frame are
+    // coalesced into one refresh when the timer fires
+    m_pendingObjects = objects;
+    m_refreshPending = true;
+    if (!m_refreshTimer->isActive()) {
+        refresh();
+        m_refreshTimer->start();
+    }
+}
+
+void PropertiesPanel::onRefreshTimeout()
+{
+    if (m_refreshPending) {
+        refresh();
+        m_refreshTimer->start();
+    }
+}
+
+void PropertiesPanel::refresh()
+{
+    m_refreshPending = false;
+    
+    const bool unchanged = isUnchangedSelection(m_pendingObjects);
+    if (!unchanged) {
+        m_statistics->cancel();
+    }
+    m_objects = m_pendingObjects;
+    m_pendingObjects.Clear();
+    m_currentObject = m_objects.First();
+    
     m_updatingUI = true;
     
     enableEditing(true);
     updateCommonProperties();
     updateGeometryProperties();
-    updateStatistics();
     
-    // Clear previous type-specific widgets
-    QLayoutItem* item;
-    while ((item = m_typeSpecificLayout->takeAt(0)) != nullptr) {
-        delete item->widget();
-        delete item;
+    // Quantities are recomputed only for a new or modified selection
+    if (!unchanged) {
+        updateStatistics();
     }
     
-    // Add type-specific properties
-    Handle(TBeam) beam = Handle(TBeam)::DownCast(object);
-    if (!beam.IsNull()) {
-        updateBeamProperties();
-        m_updatingUI = false;
-        return;
+    // Type-specific fields only when the whole selection shares a type
+    TGraphicObject::ObjectType type;
+    if (commonValue(m_objects, [](const Handle(TGraphicObject)& o) { return o->GetType(); }, type)) {
+        switch (type) {
+            case TGraphicObject::TYPE_BEAM:
+                updateBeamProperties();
+                showTypeSpecificWidget(m_beamWidget);
+                break;
+            case TGraphicObject::TYPE_COLUMN:
+                updateColumnProperties();
+                showTypeSpecificWidget(m_columnWidget);
+                break;
+            case TGraphicObject::TYPE_SLAB:
+                updateSlabProperties();
+                showTypeSpecificWidget(m_slabWidget);
+                break;
+            default:
+                showTypeSpecificWidget(nullptr);
+                break;
+        }
+    } else {
+        showTypeSpecificWidget(m_mixedTypeLabel);
     }
     
-    Handle(TColumn) column = Handle(TColumn)::DownCast(object);
-    if (!column.IsNull()) {
-        updateColumnProperties();
-        m_updatingUI = false;
-        return;
+    m_updatingUI = false;
+}
+
+bool PropertiesPanel::isUnchangedSelection(const NCollection_Sequence<Handle(TGraphicObject)>& objects) const
+{
+    if (objects.Length() != m_objects.Length()) {
+        return false;
     }
-    
-    Handle(TSlab) slab = Handle(TSlab)::DownCast(object);
-    if (!slab.IsNull()) {
-        updateSlabProperties();
-        m_updatingUI = false;
-        return;
+    for (int i = 1; i <= objects.Length(); i++) {
+        if (objects.Value(i) != m_objects.Value(i)
+            || objects.Value(i)->GetModificationTime() > m_statisticsTime) {
+            return false;
+        }
     }
-    
-    m_updatingUI = false;
+    return true;
+}
+
+QList<int> PropertiesPanel::selectedIDs() const
+{
+    QList<int> ids;
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(m_objects); it.More(); it.Next()) {
+        ids.append(it.Value()->GetID());
+    }
+    return ids;
 }
 
 void PropertiesPanel::updateCommonProperties()
 {
     if (m_currentObject.IsNull()) return;
     
-    m_objectTypeLabel->setText(m_currentObject->GetTypeName());
-    m_objectIDLabel->setText(QString::number(m_currentObject->GetID()));
-    m_nameEdit->setText(m_currentObject->GetName());
-    m_descriptionEdit->setText(m_currentObject->GetDescription());
-    
-    QString layer = m_currentObject->GetLayer();
-    int layerIndex = m_layerCombo->findText(layer);
-    if (layerIndex >= 0) {
-        m_layerCombo->setCurrentIndex(layerIndex);
+    QString typeName;
+    bool sameType = commonValue(m_objects, [](const Handle(TGraphicObject)& o) { return o->GetTypeName(); }, typeName);
+    if (isMultiple()) {
+        setLabelText(m_objectTypeLabel, QString("%1 (%2 objects)").arg(sameType ? typeName : QString("Mixed")).arg(m_objects.Length()));
+        setLabelText(m_objectIDLabel, kVaries);
     } else {
-        m_layerCombo->setEditText(layer);
+        setLabelText(m_objectTypeLabel, typeName);
+        setLabelText(m_objectIDLabel, QString::number(m_currentObject->GetID()));
     }
     
-    m_materialEdit->setText(m_currentObject->GetMaterial());
-    m_visibleCheckBox->setChecked(m_currentObject->IsVisible());
-    m_lockedCheckBox->setChecked(m_currentObject->IsLocked());
+    QString mark;
+    if (commonValue(m_objects, [](const Handle(TGraphicObject)& o) { return o->GetPartMark(); }, mark)) {
+        setLabelText(m_partMarkLabel, mark.isEmpty() ? QString("-")
+            : QString("%1 / %2").arg(mark).arg(m_currentObject->GetAssemblyMark()));
+    } else {
+        setLabelText(m_partMarkLabel, kVaries);
+    }
     
-    int r, g, b;
-    m_currentObject->GetColor(r, g, b);
-    m_selectedColor[0] = r;
-    m_selectedColor[1] = g;
-    m_selectedColor[2] = b;
+    // Names identify single objects - renaming a whole selection is not offered
+    setLineEdit(m_nameEdit, !isMultiple(), m_currentObject->GetName());
+    m_nameEdit->setEnabled(!isMultiple());
+    
+    QString text;
+    bool shared = commonValue(m_objects, [](const Handle(TGraphicObject)& o) { return o->GetDescription(); }, text);
+    setLineEdit(m_descriptionEdit, shared, text);
+    
+    QString layer;
+    if (commonValue(m_objects, [](const Handle(TGraphicObject)& o) { return o->GetLayer(); }, layer)) {
+        int layerIndex = m_layerCombo->findText(layer);
+        if (layerIndex >= 0) {
+            if (m_layerCombo->currentIndex() != layerIndex) {
+                m_layerCombo->setCurrentIndex(layerIndex);
+            }
+        } else if (m_layerCombo->currentText() != layer) {
+            m_layerCombo->setEditText(layer);
+        }
+        m_layerCombo->lineEdit()->setPlaceholderText(QString());
+    } else {
+        m_layerCombo->setCurrentIndex(-1);
+        m_layerCombo->lineEdit()->setPlaceholderText(kVaries);
+    }
     
-    QString colorStyle = QString("background-color: rgb(%1, %2, %3);").arg(r).arg(g).arg(b);
-    m_colorButton->setStyleSheet(colorStyle);
+    shared = commonValue(m_objects, [](const Handle(TGraphicObject)& o) { return o->GetMaterial(); }, text);
+    setLineEdit(m_materialEdit, shared, text);
+    
+    bool flag;
+    shared = commonValue(m_objects, [](const Handle(TGraphicObject)& o) { return o->IsVisible(); }, flag);
+    setCheckBox(m_visibleCheckBox, shared, flag);
+    shared = commonValue(m_objects, [](const Handle(TGraphicObject)& o) { return o->IsLocked(); }, flag);
+    setCheckBox(m_lockedCheckBox, shared, flag);
+    
+    QRgb rgb;
+    auto colorOf = [](const Handle(TGraphicObject)& o) {
+        int r, g, b;
+        o->GetColor(r, g, b);
+        return qRgb(r, g, b);
+    };
+    QString colorStyle;
+    QString colorText = kVaries;
+    if (commonValue(m_objects, colorOf, rgb)) {
+        m_selectedColor[0] = qRed(rgb);
+        m_selectedColor[1] = qGreen(rgb);
+        m_selectedColor[2] = qBlue(rgb);
+        
+        colorStyle = QString("background-color: rgb(%1, %2, %3);")
+            .arg(m_selectedColor[0]).arg(m_selectedColor[1]).arg(m_selectedColor[2]);
+        colorText = "Select Color";
+    }
+    // Restyling re-polishes the button - skip it when nothing changed
+    if (m_colorButton->styleSheet() != colorStyle) {
+        m_colorButton->setStyleSheet(colorStyle);
+    }
+    if (m_colorButton->text() != colorText) {
+        m_colorButton->setText(colorText);
+    }
 }
 
 void PropertiesPanel::updateGeometryProperties()
 {
     if (m_currentObject.IsNull()) return;
     
-    gp_Pnt center = m_currentObject->GetCenterPoint();
-    m_centerPointLabel->setText(QString("(%1, %2, %3)")
-        .arg(center.X(), 0, 'f', 1)
-        .arg(center.Y(), 0, 'f', 1)
-        .arg(center.Z(), 0, 'f', 1));
+    if (isMultiple()) {
+        setLabelText(m_centerPointLabel, kVaries);
+        setLabelText(m_boundingBoxLabel, kVaries);
+        return;
+    }
+    
+    setLabelText(m_centerPointLabel, formatPoint(m_currentObject->GetCenterPoint()));
     
     double xmin, ymin, zmin, xmax, ymax, zmax;
     m_currentObject->GetBoundingBox(xmin, ymin, zmin, xmax, ymax, zmax);
-    m_boundingBoxLabel->setText(QString("X[%1, %2]\nY[%3, %4]\nZ[%5, %6]")
+    setLabelText(m_boundingBoxLabel, QString("X[%1, %2]\nY[%3, %4]\nZ[%5, %6]")
         .arg(xmin, 0, 'f', 1).arg(xmax, 0, 'f', 1)
         .arg(ymin, 0, 'f', 1).arg(ymax, 0, 'f', 1)
         .arg(zmin, 0, 'f', 1).arg(zmax, 0, 'f', 1));
 }
 
-void PropertiesPanel::updateBeamProperties()
+QDoubleSpinBox* PropertiesPanel::createDimensionSpin(double minimum, double maximum) const
 {
-    Handle(TBeam) beam = Handle(TBeam)::DownCast(m_currentObject);
-    if (beam.IsNull()) return;
-    
-    QFormLayout* layout = new QFormLayout();
-    
-    // Start point
-    gp_Pnt start = beam->GetStartPoint();
-    m_beamStartLabel = new QLabel(QString("(%1, %2, %3)")
-        .arg(start.X(), 0, 'f', 1)
-        .arg(start.Y(), 0, 'f', 1)
-        .arg(start.Z(), 0, 'f', 1));
-    layout->addRow("Start Point:", m_beamStartLabel);
-    
-    // End point
-    gp_Pnt end = beam->GetEndPoint();
-    m_beamEndLabel = new QLabel(QString("(%1, %2, %3)")
-        .arg(end.X(), 0, 'f', 1)
-        .arg(end.Y(), 0, 'f', 1)
-        .arg(end.Z(), 0, 'f', 1));
-    layout->addRow("End Point:", m_beamEndLabel);
-    
-    // Length
-    m_beamLengthLabel = new QLabel(QString("%1 mm (%2 m)")
-        .arg(beam->GetLength(), 0, 'f', 1)
-        .arg(beam->GetLength() / 1000.0, 0, 'f', 3));
-    layout->addRow("Length:", m_beamLengthLabel);
-    
-    // Direction
-    gp_Vec dir = beam->GetDirection();
-    m_beamDirectionLabel = new QLabel(QString("(%1, %2, %3)")
-        .arg(dir.X(), 0, 'f', 3)
-        .arg(dir.Y(), 0, 'f', 3)
-        .arg(dir.Z(), 0, 'f', 3));
-    layout->addRow("Direction:", m_beamDirectionLabel);
-    
-    // Section type
-    if (beam->IsProfileSection()) {
-        QLabel* sectionLabel = new QLabel(QString("<b>Steel Profile: %1</b>")
-            .arg(beam->GetProfileSize()));
-        layout->addRow("Section:", sectionLabel);
-    } else {
-        double width, height;
-        beam->GetSectionDimensions(width, height);
-        QLabel* sectionLabel = new QLabel(QString("<b>Rectangular: %1 × %2 mm</b>")
-            .arg(width, 0, 'f', 0)
-            .arg(height, 0, 'f', 0));
-        layout->addRow("Section:", sectionLabel);
+    // One step below the real minimum is reserved for "<varies>"
+    QDoubleSpinBox* spin = new QDoubleSpinBox();
+    spin->setProperty("realMinimum", minimum);
+    spin->setRange(minimum, maximum);
+    spin->setSpecialValueText(kVaries);
+    spin->setSuffix(" mm");
+    return spin;
+}
+
+void PropertiesPanel::setSpinValue(QDoubleSpinBox* spin, bool shared, double value)
+{
+    const double realMinimum = spin->property("realMinimum").toDouble();
+    const double minimum = shared ? realMinimum : realMinimum - 1.0;
+    if (spin->minimum() != minimum) {
+        spin->setMinimum(minimum);
+    }
+    const double target = shared ? value : minimum;
+    if (spin->value() != target) {
+        spin->setValue(target);
     }
-    
-    m_typeSpecificLayout->addLayout(layout);
+}
+
+bool PropertiesPanel::hasSpinValue(const QDoubleSpinBox* spin) const
+{
+    return spin->value() >= spin->property("realMinimum").toDouble();
+}
+
+void PropertiesPanel::updateBeamProperties()
+{
+    auto beamOf = [](const Handle(TGraphicObject)& o) { return Handle(TBeam)::DownCast(o); };
+    QString text;
+    
+    bool shared = commonValue(m_objects, [&](const Handle(TGraphicObject)& o) {
+        return formatPoint(beamOf(o)->GetStartPoint());
+    }, text);
+    setLabelText(m_beamStartLabel, shared ? text : QString(kVaries));
+    
+    shared = commonValue(m_objects, [&](const Handle(TGraphicObject)& o) {
+        return formatPoint(beamOf(o)->GetEndPoint());
+    }, text);
+    setLabelText(m_beamEndLabel, shared ? text : QString(kVaries));
+    
+    shared = commonValue(m_objects, [&](const Handle(TGraphicObject)& o) {
+        double length = beamOf(o)->GetLength();
+        return QString("%1 mm (%2 m)").arg(length, 0, 'f', 1).arg(length / 1000.0, 0, 'f', 3);
+    }, text);
+    setLabelText(m_beamLengthLabel, shared ? text : QString(kVaries));
+    
+    shared = commonValue(m_objects, [&](const Handle(TGraphicObject)& o) {
+        gp_Vec dir = beamOf(o)->GetDirection();
+        return QString("(%1, %2, %3)").arg(dir.X(), 0, 'f', 3).arg(dir.Y(), 0, 'f', 3).arg(dir.Z(), 0, 'f', 3);
+    }, text);
+    setLabelText(m_beamDirectionLabel, shared ? text : QString(kVaries));
+    
+    shared = commonValue(m_objects, [&](const Handle(TGraphicObject)& o) { return sectionText(beamOf(o)); }, text);
+    setLabelText(m_beamSectionLabel, shared ? text : QString(kVaries));
 }
 
 void PropertiesPanel::updateColumnProperties()
 {
-    Handle(TColumn) column = Handle(TColumn)::DownCast(m_currentObject);
-    if (column.IsNull()) return;
-    
-    QFormLayout* layout = new QFormLayout();
-    
-    // Base point
-    gp_Pnt base = column->GetBasePoint();
-    m_columnBaseLabel = new QLabel(QString("(%1, %2, %3)")
-        .arg(base.X(), 0, 'f', 1)
-        .arg(base.Y(), 0, 'f', 1)
-        .arg(base.Z(), 0, 'f', 1));
-    layout->addRow("Base Point:", m_columnBaseLabel);
-    
-    // Dimensions
-    double width, depth, height;
-    column->GetDimensions(width, depth, height);
-    
-    m_columnWidthSpin = new QDoubleSpinBox();
-    m_columnWidthSpin->setRange(50, 5000);
-    m_columnWidthSpin->setValue(width);
-    m_columnWidthSpin->setSuffix(" mm");
-    connect(m_columnWidthSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
-            this, &PropertiesPanel::onColumnPropertyChanged);
-    layout->addRow("Width:", m_columnWidthSpin);
-    
-    m_columnDepthSpin = new QDoubleSpinBox();
-    m_columnDepthSpin->setRange(50, 5000);
-    m_columnDepthSpin->setValue(depth);
-    m_columnDepthSpin->setSuffix(" mm");
-    connect(m_columnDepthSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
-            this, &PropertiesPanel::onColumnPropertyChanged);
-    layout->addRow("Depth:", m_columnDepthSpin);
-    
-    m_columnHeightSpin = new QDoubleSpinBox();
-    m_columnHeightSpin->setRange(100, 20000);
-    m_columnHeightSpin->setValue(height);
-    m_columnHeightSpin->setSuffix(" mm");
-    connect(m_columnHeightSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
-            this, &PropertiesPanel::onColumnPropertyChanged);
-    layout->addRow("Height:", m_columnHeightSpin);
-    
-    m_typeSpecificLayout->addLayout(layout);
+    auto columnOf = [](const Handle(TGraphicObject)& o) { return Handle(TColumn)::DownCast(o); };
+    
+    QString text;
+    bool shared = commonValue(m_objects, [&](const Handle(TGraphicObject)& o) {
+        return formatPoint(columnOf(o)->GetBasePoint());
+    }, text);
+    setLabelText(m_columnBaseLabel, shared ? text : QString(kVaries));
+    
+    auto dimension = [&](int index) {
+        return [&, index](const Handle(TGraphicObject)& o) {
+            double d[3];
+            columnOf(o)->GetDimensions(d[0], d[1], d[2]);
+            return d[index];
+        };
+    };
+    double value;
+    
+    shared = commonValue(m_objects, dimension(0), value);
+    setSpinValue(m_columnWidthSpin, shared, value);
+    
+    shared = commonValue(m_objects, dimension(1), value);
+    setSpinValue(m_columnDepthSpin, shared, value);
+    
+    shared = commonValue(m_objects, dimension(2), value);
+    setSpinValue(m_columnHeightSpin, shared, value);
 }
 
 void PropertiesPanel::updateSlabProperties()
 {
-    Handle(TSlab) slab = Handle(TSlab)::DownCast(m_currentObject);
-    if (slab.IsNull()) return;
-    
-    QFormLayout* layout = new QFormLayout();
-    
-    // Corners
-    gp_Pnt corner1, corner2;
-    slab->GetCorners(corner1, corner2);
-    
-    m_slabCorner1Label = new QLabel(QString("(%1, %2, %3)")
-        .arg(corner1.X(), 0, 'f', 1)
-        .arg(corner1.Y(), 0, 'f', 1)
-        .arg(corner1.Z(), 0, 'f', 1));
-    layout->addRow("Corner 1:", m_slabCorner1Label);
-    
-    m_slabCorner2Label = new QLabel(QString("(%1, %2, %3)")
-        .arg(corner2.X(), 0, 'f', 1)
-        .arg(corner2.Y(), 0, 'f', 1)
-        .arg(corner2.Z(), 0, 'f', 1));
-    layout->addRow("Corner 2:", m_slabCorner2Label);
-    
-    // Thickness
-    m_slabThicknessSpin = new QDoubleSpinBox();
-    m_slabThicknessSpin->setRange(50, 1000);
-    m_slabThicknessSpin->setValue(slab->GetThickness());
-    m_slabThicknessSpin->setSuffix(" mm");
-    connect(m_slabThicknessSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
-            this, &PropertiesPanel::onSlabPropertyChanged);
-    layout->addRow("Thickness:", m_slabThicknessSpin);
-    
-    // Area
-    m_slabAreaLabel = new QLabel(QString("%1 m²")
-        .arg(slab->GetArea() / 1e6, 0, 'f', 2));
-    layout->addRow("Area:", m_slabAreaLabel);
-    
-    m_typeSpecificLayout->addLayout(layout);
+    auto slabOf = [](const Handle(TGraphicObject)& o) { return Handle(TSlab)::DownCast(o); };
+    QString text;
+    
+    bool shared = commonValue(m_objects, [&](const Handle(TGraphicObject)& o) {
+        gp_Pnt corner1, corner2;
+        slabOf(o)->GetCorners(corner1, corner2);
+        return formatPoint(corner1);
+    }, text);
+    setLabelText(m_slabCorner1Label, shared ? text : QString(kVaries));
+    
+    shared = commonValue(m_objects, [&](const Handle(TGraphicObject)& o) {
+        gp_Pnt corner1, corner2;
+        slabOf(o)->GetCorners(corner1, corner2);
+        return formatPoint(corner2);
+    }, text);
+    setLabelText(m_slabCorner2Label, shared ? text : QString(kVaries));
+    
+    double thickness;
+    shared = commonValue(m_objects, [&](const Handle(TGraphicObject)& o) { return slabOf(o)->GetThickness(); }, thickness);
+    setSpinValue(m_slabThicknessSpin, shared, thickness);
+    
+    shared = commonValue(m_objects, [&](const Handle(TGraphicObject)& o) {
+        return QString("%1 m²").arg(slabOf(o)->GetArea() / 1e6, 0, 'f', 2);
+    }, text);
+    setLabelText(m_slabAreaLabel, shared ? text : QString(kVaries));
 }
 
 void PropertiesPanel::updateStatistics()
 {
     if (m_currentObject.IsNull()) return;
     
-    double volume = m_currentObject->GetVolume();
-    m_volumeLabel->setText(QString("%1 m³").arg(volume / 1e9, 0, 'f', 6));
-    
-    double area = m_currentObject->GetSurfaceArea();
-    m_surfaceAreaLabel->setText(QString("%1 m²").arg(area / 1e6, 0, 'f', 3));
-    
-    m_creationTimeLabel->setText(m_currentObject->GetCreationTime().toString("yyyy-MM-dd hh:mm:ss"));
-    m_modificationTimeLabel->setText(m_currentObject->GetModificationTime().toString("yyyy-MM-dd hh:mm:ss"));
+    // Quantities arrive from the worker; times are cheap and shown now
+    setLabelText(m_volumeLabel, "Computing...");
+    setLabelText(m_surfaceAreaLabel, "Computing...");
+    setLabelText(m_weightLabel, "Computing...");
+    setLabelText(m_totalBeamLengthLabel, "Computing...");
+    m_statisticsTime = QDateTime::currentDateTime();
+    m_statistics->start(m_objects);
+    
+    if (isMultiple()) {
+        setLabelText(m_creationTimeLabel, kVaries);
+        setLabelText(m_modificationTimeLabel, kVaries);
+    } else {
+        setLabelText(m_creationTimeLabel, m_currentObject->GetCreationTime().toString("yyyy-MM-dd hh:mm:ss"));
+        setLabelText(m_modificationTimeLabel, m_currentObject->GetModificationTime().toString("yyyy-MM-dd hh:mm:ss"));
+    }
+}
+
+void PropertiesPanel::onStatisticsFinished(const SelectionStatistics::Totals& totals)
+{
+    setLabelText(m_volumeLabel, QString("%1 m³").arg(totals.volume / 1e9, 0, 'f', 6));
+    setLabelText(m_surfaceAreaLabel, QString("%1 m²").arg(totals.surfaceArea / 1e6, 0, 'f', 3));
+    setLabelText(m_weightLabel, QString("%1 kg").arg(totals.weight, 0, 'f', 1));
+    if (totals.beamCount > 0) {
+        setLabelText(m_totalBeamLengthLabel, QString("%1 m (%2 beams)").arg(totals.beamLength / 1000.0, 0, 'f', 3).arg(totals.beamCount));
+    } else {
+        setLabelText(m_totalBeamLengthLabel, "-");
+    }
 }
 
 void PropertiesPanel::clearProperties()
 {
+    m_refreshTimer->stop();
+    m_refreshPending = false;
+    m_pendingObjects.Clear();
+    
+    m_statistics->cancel();
+    m_objects.Clear();
+    m_currentObject.Nullify();
+    
     m_updatingUI = true;
     
-    m_objectTypeLabel->setText("-");
-    m_objectIDLabel->setText("-");
-    m_nameEdit->clear();
-    m_descriptionEdit->clear();
+    setLabelText(m_objectTypeLabel, "-");
+    setLabelText(m_objectIDLabel, "-");
+    setLabelText(m_partMarkLabel, "-");
+    setLineEdit(m_nameEdit, true, QString());
+    setLineEdit(m_descriptionEdit, true, QString());
     m_layerCombo->setCurrentIndex(0);
-    m_materialEdit->clear();
-    m_visibleCheckBox->setChecked(true);
-    m_lockedCheckBox->setChecked(false);
+    m_layerCombo->lineEdit()->setPlaceholderText(QString());
+    setLineEdit(m_materialEdit, true, QString());
+    setCheckBox(m_visibleCheckBox, true, true);
+    setCheckBox(m_lockedCheckBox, true, false);
+    m_colorButton->setText("Select Color");
     
-    m_centerPointLabel->setText("-");
-    m_boundingBoxLabel->setText("-");
+    setLabelText(m_centerPointLabel, "-");
+    setLabelText(m_boundingBoxLabel, "-");
     
-    m_volumeLabel->setText("-");
-    m_surfaceAreaLabel->setText("-");
-    m_creationTimeLabel->setText("-");
-    m_modificationTimeLabel->setText("-");
+    setLabelText(m_volumeLabel, "-");
+    setLabelText(m_surfaceAreaLabel, "-");
+    setLabelText(m_weightLabel, "-");
+    setLabelText(m_totalBeamLengthLabel, "-");
+    setLabelText(m_creationTimeLabel, "-");
+    setLabelText(m_modificationTimeLabel, "-");
     
-    // Clear type-specific widgets
-    QLayoutItem* item;
-    while ((item = m_typeSpecificLayout->takeAt(0)) != nullptr) {
-        delete item->widget();
-        delete item;
-    }
+    showTypeSpecificWidget(nullptr);
     
     enableEditing(false);
     m_updatingUI = false;
 }
 
-void PropertiesPanel::setMultipleSelection(int count)
-{
-    clearProperties();
-    m_objectTypeLabel->setText(QString("Multiple Objects (%1)").arg(count));
-    m_objectIDLabel->setText("Multiple");
-}
-
 void PropertiesPanel::enableEditing(bool enabled)
 {
     m_nameEdit->setEnabled(enabled);
@@ -591,7 +882,7 @@ void PropertiesPanel::enableEditing(bool enabled)
 
 void PropertiesPanel::onNameChanged()
 {
-    if (m_updatingUI || m_currentObject.IsNull()) return;
+    if (m_updatingUI || m_currentObject.IsNull() || isMultiple()) return;
     m_currentObject->SetName(m_nameEdit->text());
     emit nameChanged(m_currentObject->GetID(), m_nameEdit->text());
 }
@@ -599,21 +890,34 @@ void PropertiesPanel::onNameChanged()
 void PropertiesPanel::onDescriptionChanged()
 {
     if (m_updatingUI || m_currentObject.IsNull()) return;
-    m_currentObject->SetDescription(m_descriptionEdit->text());
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(m_objects); it.More(); it.Next()) {
+        it.Value()->SetDescription(m_descriptionEdit->text());
+    }
+    m_descriptionEdit->setPlaceholderText(QString());
 }
 
 void PropertiesPanel::onLayerChanged(int index)
 {
-    if (m_updatingUI || m_currentObject.IsNull()) return;
+    if (m_updatingUI || m_currentObject.IsNull() || index < 0) return;
     QString layer = m_layerCombo->currentText();
-    m_currentObject->SetLayer(layer);
-    emit layerChanged(m_currentObject->GetID(), layer);
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(m_objects); it.More(); it.Next()) {
+        it.Value()->SetLayer(layer);
+        emit layerChanged(it.Value()->GetID(), layer);
+    }
+    m_layerCombo->lineEdit()->setPlaceholderText(QString());
 }
 
 void PropertiesPanel::onMaterialChanged()
 {
     if (m_updatingUI || m_currentObject.IsNull()) return;
-    m_currentObject->SetMaterial(m_materialEdit->text());
+    
+    // Weight depends on the material - stop the running pass before writing
+    m_statistics->cancel();
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(m_objects); it.More(); it.Next()) {
+        it.Value()->SetMaterial(m_materialEdit->text());
+    }
+    m_materialEdit->setPlaceholderText(QString());
+    updateStatistics();
 }
 
 void PropertiesPanel::onColorButtonClicked()
@@ -631,29 +935,39 @@ void PropertiesPanel::onColorButtonClicked()
         QString colorStyle = QString("background-color: rgb(%1, %2, %3);")
             .arg(m_selectedColor[0]).arg(m_selectedColor[1]).arg(m_selectedColor[2]);
         m_colorButton->setStyleSheet(colorStyle);
+        m_colorButton->setText("Select Color");
         
-        m_currentObject->SetColor(m_selectedColor[0], m_selectedColor[1], m_selectedColor[2]);
-        emit colorChanged(m_currentObject->GetID(), m_selectedColor[0], m_selectedColor[1], m_selectedColor[2]);
+        for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(m_objects); it.More(); it.Next()) {
+            it.Value()->SetColor(m_selectedColor[0], m_selectedColor[1], m_selectedColor[2]);
+            emit colorChanged(it.Value()->GetID(), m_selectedColor[0], m_selectedColor[1], m_selectedColor[2]);
+        }
     }
 }
 
 void PropertiesPanel::onVisibilityChanged(int state)
 {
-    if (m_updatingUI || m_currentObject.IsNull()) return;
-    m_currentObject->SetVisible(state == Qt::Checked);
-    emit propertyChanged(m_currentObject->GetID());
+    if (m_updatingUI || m_currentObject.IsNull() || state == Qt::PartiallyChecked) return;
+    m_visibleCheckBox->setTristate(false);
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(m_objects); it.More(); it.Next()) {
+        it.Value()->SetVisible(state == Qt::Checked);
+    }
+    emit propertiesChanged(selectedIDs());
 }
 
 void PropertiesPanel::onLockChanged(int state)
 {
-    if (m_updatingUI || m_currentObject.IsNull()) return;
-    m_currentObject->SetLocked(state == Qt::Checked);
+    if (m_updatingUI || m_currentObject.IsNull() || state == Qt::PartiallyChecked) return;
+    m_lockedCheckBox->setTristate(false);
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(m_objects); it.More(); it.Next()) {
+        it.Value()->SetLocked(state == Qt::Checked);
+    }
+    emit propertiesChanged(selectedIDs());
 }
 
 void PropertiesPanel::onApplyProperties()
 {
     if (m_currentObject.IsNull()) return;
-    emit propertyChanged(m_currentObject->GetID());
+    emit propertiesChanged(selectedIDs());
     QMessageBox::information(this, "Properties", "Properties applied successfully!");
 }
 
@@ -667,28 +981,45 @@ void PropertiesPanel::onColumnPropertyChanged()
 {
     if (m_updatingUI) return;
     
-    Handle(TColumn) column = Handle(TColumn)::DownCast(m_currentObject);
-    if (column.IsNull()) return;
-    
-    column->SetDimensions(
-        m_columnWidthSpin->value(),
-        m_columnDepthSpin->value(),
-        m_columnHeightSpin->value()
-    );
+    // Only fields showing a value are applied; "<varies>" keeps each column's own
+    m_statistics->cancel();
+    QList<int> ids;
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(m_objects); it.More(); it.Next()) {
+        Handle(TColumn) column = Handle(TColumn)::DownCast(it.Value());
+        if (column.IsNull()) continue;
+        
+        double width, depth, height;
+        column->GetDimensions(width, depth, height);
+        if (hasSpinValue(m_columnWidthSpin)) width = m_columnWidthSpin->value();
+        if (hasSpinValue(m_columnDepthSpin)) depth = m_columnDepthSpin->value();
+        if (hasSpinValue(m_columnHeightSpin)) height = m_columnHeightSpin->value();
+        column->SetDimensions(width, depth, height);
+        ids.append(column->GetID());
+    }
     
     updateStatistics();
-    emit propertyChanged(m_currentObject->GetID());
+    emit propertiesChanged(ids);
+    
+    // Re-read the edited values, e.g. a "<varies>" field that is now shared
+    setObjects(m_objects);
 }
 
 void PropertiesPanel::onSlabPropertyChanged()
 {
-    if (m_updatingUI) return;
-    
-    Handle(TSlab) slab = Handle(TSlab)::DownCast(m_currentObject);
-    if (slab.IsNull()) return;
-    
-    slab->SetThickness(m_slabThicknessSpin->value());
+    if (m_updatingUI || !hasSpinValue(m_slabThicknessSpin)) return;
+    
+    m_statistics->cancel();
+    QList<int> ids;
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(m_objects); it.More(); it.Next()) {
+        Handle(TSlab) slab = Handle(TSlab)::DownCast(it.Value());
+        if (slab.IsNull()) continue;
+        slab->SetThickness(m_slabThicknessSpin->value());
+        ids.append(slab->GetID());
+    }
     
     updateStatistics();
-    emit propertyChanged(m_currentObject->GetID());
+    emit propertiesChanged(ids);
+    
+    // Re-read the edited values, e.g. a "<varies>" field that is now shared
+    setObjects(m_objects);
 }
@@ -0,0 +1,166 @@
+#include "SelectionStatistics.h"
+#include "TBeam.h"
+#include "Logger.h"
+#include <QRunnable>
+#include <QVector>
+#include <BRepGProp.hxx>
+#include <GProp_GProps.hxx>
+#include <Standard_Failure.hxx>
+
+namespace {
+
+// What the worker needs of one object, copied on the GUI thread so edits
+// that replace an object's shape cannot race with the pass
+struct Item {
+    int id;
+    TopoDS_Shape shape;     // Measured on the worker when measured is false
+    QString material;
+    bool measured;          // Quantities below already known from the parameters
+    double volume;
+    double surfaceArea;
+    double weight;
+    bool beam;
+    double beamLength;
+};
+
+} // namespace
+
+class StatisticsTask : public QRunnable
+{
+public:
+    StatisticsTask(SelectionStatistics* owner, int generation,
+                   const QVector<Item>& items,
+                   const std::shared_ptr<std::atomic<bool>>& cancel)
+        : m_owner(owner)
+        , m_generation(generation)
+        , m_items(items)
+        , m_cancel(cancel)
+    {
+    }
+    
+    void run() override
+    {
+        SelectionStatistics::Totals totals;
+        for (const Item& item : m_items) {
+            if (m_cancel->load(std::memory_order_relaxed)) {
+                return;
+            }
+            if (item.measured) {
+                totals.volume += item.volume;
+                totals.surfaceArea += item.surfaceArea;
+                totals.weight += item.weight;
+            } else if (!item.shape.IsNull()) {
+                try {
+                    GProp_GProps volume, surface;
+                    BRepGProp::VolumeProperties(item.shape, volume);
+                    BRepGProp::SurfaceProperties(item.shape, surface);
+                    totals.volume += volume.Mass();
+                    totals.surfaceArea += surface.Mass();
+                    // Volume is in mm3
+                    totals.weight += volume.Mass() * 1e-9 * TGraphicObject::GetMaterialDensity(item.material);
+                } catch (Standard_Failure const& ex) {
+                    LOG_WARNING("properties", "No quantities for object %1: %2", item.id, ex.GetMessageString());
+                }
+            }
+            
+            if (item.beam) {
+                totals.beamLength += item.beamLength;
+                totals.beamCount++;
+            }
+            totals.objectCount++;
+        }
+        
+        SelectionStatistics* owner = m_owner;
+        int generation = m_generation;
+        QMetaObject::invokeMethod(owner, [owner, generation, totals]() {
+            owner->taskFinished(generation, totals);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    SelectionStatistics* m_owner;
+    int m_generation;
+    QVector<Item> m_items;
+    std::shared_ptr<std::atomic<bool>> m_cancel;
+};
+
+SelectionStatistics::SelectionStatistics(QObject* parent)
+    : QObject(parent)
+    , m_generation(0)
+    , m_running(false)
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+SelectionStatistics::~SelectionStatistics()
+{
+    cancel();
+}
+
+void SelectionStatistics::start(const NCollection_Sequence<Handle(TGraphicObject)>& objects)
+{
+    cancel();
+    
+    // Members compute their quantities from parameters in O(1); only other
+    // objects leave a B-rep integration for the worker
+    QVector<Item> snapshot;
+    snapshot.reserve(objects.Length());
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(objects); it.More(); it.Next()) {
+        const Handle(TGraphicObject)& object = it.Value();
+        if (object.IsNull()) {
+            continue;
+        }
+        Item item;
+        item.id = object->GetID();
+        item.material = object->GetMaterial();
+        item.measured = false;
+        item.volume = item.surfaceArea = item.weight = 0.0;
+        item.beam = false;
+        item.beamLength = 0.0;
+        
+        const TGraphicObject::ObjectType type = object->GetType();
+        if (type == TGraphicObject::TYPE_BEAM || type == TGraphicObject::TYPE_COLUMN
+            || type == TGraphicObject::TYPE_SLAB) {
+            item.measured = true;
+            item.volume = object->GetVolume();
+            item.surfaceArea = object->GetSurfaceArea();
+            item.weight = object->GetWeight();
+        } else {
+            item.shape = object->GetShape();
+        }
+        
+        Handle(TBeam) beam = Handle(TBeam)::DownCast(object);
+        if (!beam.IsNull()) {
+            item.beam = true;
+            item.beamLength = beam->GetLength();
+        }
+        snapshot.append(item);
+    }
+    
+    m_cancel = std::make_shared<std::atomic<bool>>(false);
+    m_running = true;
+    m_pool.start(new StatisticsTask(this, ++m_generation, snapshot, m_cancel));
+}
+
+void SelectionStatistics::cancel()
+{
+    if (m_cancel) {
+        m_cancel->store(true, std::memory_order_relaxed);
+    }
+    // The task checks the flag per object, so this returns almost at once
+    m_pool.clear();
+    m_pool.waitForDone();
+    m_running = false;
+    
+    // A result already queued from the cancelled pass is dropped by generation
+    ++m_generation;
+}
+
+void SelectionStatistics::taskFinished(int generation, const Totals& totals)
+{
+    if (generation != m_generation) {
+        return;
+    }
+    m_running = false;
+    emit finished(totals);
+}
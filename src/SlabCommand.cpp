@@ -1,8 +1,5 @@
 #include "SlabCommand.h"
 #include "OCCTViewer.h"
-#include <BRepPrimAPI_MakeBox.hxx>
-#include <BRepBuilderAPI_MakeEdge.hxx>
-#include <BRepBuilderAPI_MakeWire.hxx>
 #include <Precision.hxx>
 #include <Standard_Failure.hxx>
 #include <algorithm>
@@ -23,9 +20,9 @@ void SlabCommand::execute(const gp_Pnt& point)
                          .arg(point.Y(), 0, 'f', 1)
                          .arg(point.Z(), 0, 'f', 1));
     } else if (m_points.size() == 2) {
-        TopoDS_Shape slab = createSlab(m_points[0], m_points[1]);
+        m_lastCorner1 = m_points[0];
+        m_lastCorner2 = m_points[1];
         clearPreview();
-        displayShape(slab);
         
         double length = std::abs(m_points[1].X() - m_points[0].X());
         double width = std::abs(m_points[1].Y() - m_points[0].Y());
@@ -35,7 +32,9 @@ void SlabCommand::execute(const gp_Pnt& point)
                          .arg(length, 0, 'f', 0)
                          .arg(width, 0, 'f', 0)
                          .arg(area, 0, 'f', 2));
-        emit commandCompleted(slab);
+        
+        // The controller builds and displays the parametric TSlab from the getters
+        emit commandCompleted(TopoDS_Shape());
         m_points.clear();
     }
 }
@@ -55,22 +54,13 @@ void SlabCommand::updatePreview(const gp_Pnt& point)
                 return;
             }
             
-            // Create rectangle outline at Z level
-            gp_Pnt p1 = m_points[0];
-            gp_Pnt p2(point.X(), p1.Y(), p1.Z());
-            gp_Pnt p3(point.X(), point.Y(), p1.Z());
-            gp_Pnt p4(p1.X(), point.Y(), p1.Z());
-            
-            // Create wire outline (tracking rectangle)
-            BRepBuilderAPI_MakeWire wireBuilder;
-            wireBuilder.Add(BRepBuilderAPI_MakeEdge(p1, p2));
-            wireBuilder.Add(BRepBuilderAPI_MakeEdge(p2, p3));
-            wireBuilder.Add(BRepBuilderAPI_MakeEdge(p3, p4));
-            wireBuilder.Add(BRepBuilderAPI_MakeEdge(p4, p1));
-            
-            if (wireBuilder.IsDone() && !wireBuilder.Wire().IsNull()) {
-                showPreview(wireBuilder.Wire());
+            // Unit slab box stretched from the first corner to the cursor
+            if (m_outline.IsNull()) {
+                m_outline = new PreviewOutline();
+                m_outline->addBox(gp_XYZ(0, 0, 0), gp_XYZ(1, 1, 1));
             }
+            const gp_Pnt& p1 = m_points[0];
+            showOutline(PreviewOutline::boxPlacement(p1, point.X() - p1.X(), point.Y() - p1.Y(), m_thickness));
             
             double area = length * width / 1000000.0; // Convert to m²
         
@@ -106,19 +96,3 @@ void SlabCommand::setThickness(double thickness)
 {
     m_thickness = thickness;
 }
-
-TopoDS_Shape SlabCommand::createSlab(const gp_Pnt& corner1, const gp_Pnt& corner2)
-{
-    double minX = std::min(corner1.X(), corner2.X());
-    double minY = std::min(corner1.Y(), corner2.Y());
-    double minZ = std::min(corner1.Z(), corner2.Z());
-    
-    double maxX = std::max(corner1.X(), corner2.X());
-    double maxY = std::max(corner1.Y(), corner2.Y());
-    
-    gp_Pnt baseCorner(minX, minY, minZ);
-    double length = maxX - minX;
-    double width = maxY - minY;
-    
-    return BRepPrimAPI_MakeBox(baseCorner, length, width, m_thickness).Shape();
-}
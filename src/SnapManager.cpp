@@ -1,5 +1,7 @@
 #include "SnapManager.h"
 #include "TObjectCollection.h"
+#include "TBeam.h"
+#include "Logger.h"
 #include <AIS_ListOfInteractive.hxx>
 #include <AIS_ListIteratorOfListOfInteractive.hxx>
 #include <AIS_Shape.hxx>
@@ -10,25 +12,47 @@
 #include <TopExp.hxx>
 #include <BRep_Tool.hxx>
 #include <BRepAdaptor_Curve.hxx>
-#include <BRepAdaptor_Surface.hxx>
 #include <Bnd_Box.hxx>
 #include <BRepBndLib.hxx>
-#include <GeomAPI_ProjectPointOnCurve.hxx>
 #include <GeomAbs_SurfaceType.hxx>
-#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
-#include <TopTools_ListIteratorOfListOfShape.hxx>
+#include <NCollection_List.hxx>
 #include <Precision.hxx>
 #include <SelectMgr_EntityOwner.hxx>
 #include <StdSelect_BRepOwner.hxx>
 #include <IntAna_IntConicQuad.hxx>
 #include <gp_Lin.hxx>
 #include <gp_Pln.hxx>
-#include <QDebug>
+#include <gp_Pnt2d.hxx>
+#include <Graphic3d_Camera.hxx>
+#include <Standard_Failure.hxx>
+#include <algorithm>
 #include <cmath>
 
+namespace {
+
+// A segment passing near the pick ray, with its endpoints in normalised device coordinates
+struct RaySegment {
+    const EdgeSnapIndex* index;
+    int segment;
+    int objectID;
+    gp_Pnt2d a;
+    gp_Pnt2d b;
+};
+
+// Bounds the pairwise crossing test on very dense framing
+const int kMaxIntersectionSegments = 64;
+
+inline double cross2d(double ax, double ay, double bx, double by)
+{
+    return ax * by - ay * bx;
+}
+
+} // namespace
+
 SnapManager::SnapManager()
     : m_enabledSnaps(Endpoint | Midpoint | Vertex | Center)
     , m_snapTolerancePixels(25.0)
+    , m_queryStamp(0)
 {
 }
 
@@ -98,149 +122,55 @@ SnapManager::SnapPoint SnapManager::findSnapPoint(int screenX, int screenY,
         // Get all visible shapes
         QList<TopoDS_Shape> shapes = getVisibleShapes(context);
         
-        qDebug() << "SnapManager: Found" << shapes.size() << "visible shapes";
+        LOG_TRACE("snap", "Found %1 visible shapes", shapes.size());
         
-        // Find snap points from geometry
+        // Filter the precomputed snap data of each shape
         QList<SnapPoint> candidates;
+        std::vector<char> interior;     // Beam centreline points sit inside the solid
+        const gp_Lin ray(rayStart, rayDir);
+        ++m_queryStamp;
         
         for (const TopoDS_Shape& shape : shapes) {
             if (shape.IsNull()) continue;
             
             try {
-                // Check if this is a beam-like object (elongated in one dimension)
-                Bnd_Box bbox;
-                BRepBndLib::Add(shape, bbox);
-                if (!bbox.IsVoid()) {
-                    Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
-                    bbox.Get(xmin, ymin, zmin, xmax, ymax, zmax);
-                    
-                    double dx = xmax - xmin;
-                    double dy = ymax - ymin;
-                    double dz = zmax - zmin;
-                    
-                    double maxDim = std::max({dx, dy, dz});
-                    double minDim = std::min({dx, dy, dz});
-                    
-                    // Determine if this is a beam/column (elongated in ONE dimension)
-                    // or a slab (flat in one dimension but extended in TWO dimensions)
-                    bool isBeamLike = false;
-                    if (maxDim > minDim * 5.0) {
-                        // Check if it's elongated in one direction (beam/column)
-                        // A beam has ONE large dimension and TWO small dimensions
-                        // A slab has TWO large dimensions and ONE small dimension
-                        std::vector<double> dims = {dx, dy, dz};
-                        std::sort(dims.begin(), dims.end());
-                        // dims[0] = smallest, dims[1] = middle, dims[2] = largest
-                        
-                        // If middle dimension is also small (similar to smallest), it's a beam
-                        // If middle dimension is large (similar to largest), it's a slab
-                        if (dims[1] / dims[0] > 3.0) {
-                            // Middle is much larger than smallest -> Slab (two large dims)
-                            isBeamLike = false;
-                        } else {
-                            // Middle is similar to smallest -> Beam (one large dim)
-                            isBeamLike = true;
-                        }
-                    }
-                    
-                    // If beam/column, use centerline and flange endpoints
-                    if (isBeamLike) {
-                        gp_Pnt centerStart, centerEnd;
-                        
-                        // Determine beam orientation and calculate points
-                        if (dx == maxDim) {
-                            // Horizontal beam along X
-                            centerStart = gp_Pnt(xmin, (ymin+ymax)/2, (zmin+zmax)/2);
-                            centerEnd = gp_Pnt(xmax, (ymin+ymax)/2, (zmin+zmax)/2);
-                            
-                            // Add centerline endpoints
-                            candidates.append(SnapPoint(centerStart, Endpoint, "Beam Center Start", cursor3D.Distance(centerStart)));
-                            candidates.append(SnapPoint(centerEnd, Endpoint, "Beam Center End", cursor3D.Distance(centerEnd)));
-                            
-                            // Add BOTH top and bottom flange endpoints
-                            // The closest one will be selected based on cursor position
-                            gp_Pnt topStart(xmin, (ymin+ymax)/2, zmax);
-                            gp_Pnt topEnd(xmax, (ymin+ymax)/2, zmax);
-                            gp_Pnt bottomStart(xmin, (ymin+ymax)/2, zmin);
-                            gp_Pnt bottomEnd(xmax, (ymin+ymax)/2, zmin);
-                            
-                            candidates.append(SnapPoint(topStart, Endpoint, "Beam Top Start", cursor3D.Distance(topStart)));
-                            candidates.append(SnapPoint(topEnd, Endpoint, "Beam Top End", cursor3D.Distance(topEnd)));
-                            candidates.append(SnapPoint(bottomStart, Endpoint, "Beam Bottom Start", cursor3D.Distance(bottomStart)));
-                            candidates.append(SnapPoint(bottomEnd, Endpoint, "Beam Bottom End", cursor3D.Distance(bottomEnd)));
-                            
-                        } else if (dy == maxDim) {
-                            // Horizontal beam along Y
-                            centerStart = gp_Pnt((xmin+xmax)/2, ymin, (zmin+zmax)/2);
-                            centerEnd = gp_Pnt((xmin+xmax)/2, ymax, (zmin+zmax)/2);
-                            
-                            candidates.append(SnapPoint(centerStart, Endpoint, "Beam Center Start", cursor3D.Distance(centerStart)));
-                            candidates.append(SnapPoint(centerEnd, Endpoint, "Beam Center End", cursor3D.Distance(centerEnd)));
-                            
-                            gp_Pnt topStart((xmin+xmax)/2, ymin, zmax);
-                            gp_Pnt topEnd((xmin+xmax)/2, ymax, zmax);
-                            gp_Pnt bottomStart((xmin+xmax)/2, ymin, zmin);
-                            gp_Pnt bottomEnd((xmin+xmax)/2, ymax, zmin);
-                            
-                            candidates.append(SnapPoint(topStart, Endpoint, "Beam Top Start", cursor3D.Distance(topStart)));
-                            candidates.append(SnapPoint(topEnd, Endpoint, "Beam Top End", cursor3D.Distance(topEnd)));
-                            candidates.append(SnapPoint(bottomStart, Endpoint, "Beam Bottom Start", cursor3D.Distance(bottomStart)));
-                            candidates.append(SnapPoint(bottomEnd, Endpoint, "Beam Bottom End", cursor3D.Distance(bottomEnd)));
-                            
-                        } else {
-                            // Vertical column along Z
-                            centerStart = gp_Pnt((xmin+xmax)/2, (ymin+ymax)/2, zmin);
-                            centerEnd = gp_Pnt((xmin+xmax)/2, (ymin+ymax)/2, zmax);
-                            
-                            candidates.append(SnapPoint(centerStart, Endpoint, "Column Bottom", cursor3D.Distance(centerStart)));
-                            candidates.append(SnapPoint(centerEnd, Endpoint, "Column Top", cursor3D.Distance(centerEnd)));
-                        }
-                        
-                        if (isSnapEnabled(Midpoint)) {
-                            gp_Pnt mid((centerStart.X()+centerEnd.X())/2, 
-                                      (centerStart.Y()+centerEnd.Y())/2, 
-                                      (centerStart.Z()+centerEnd.Z())/2);
-                            candidates.append(SnapPoint(mid, Midpoint, "Beam Midpoint", cursor3D.Distance(mid)));
-                        }
-                        
-                        continue;
-                    }
-                }
-                
-                // For non-beam shapes, find all snap points
-                if (isSnapEnabled(Endpoint)) {
-                    findEndpoints(shape, cursor3D, candidates);
-                }
-                if (isSnapEnabled(Midpoint)) {
-                    findMidpoints(shape, cursor3D, candidates);
-                }
-                if (isSnapEnabled(Vertex)) {
-                    findVertices(shape, cursor3D, candidates);
-                }
-                if (isSnapEnabled(Center)) {
-                    findCenter(shape, cursor3D, candidates);
-                }
-                if (isSnapEnabled(Nearest)) {
-                    findNearest(shape, cursor3D, candidates);
-                }
+                ShapeSnapData& data = snapDataFor(shape);
+                collectCandidates(data, cursor3D, worldTolerance, candidates);
+                interior.resize(candidates.size(), data.beamLike);
                 
-                // Filter by world tolerance
-                for (int i = candidates.size() - 1; i >= 0; --i) {
-                    if (candidates[i].distance > worldTolerance) {
-                        candidates.removeAt(i);
+                if (!data.beamLike && isSnapEnabled(Nearest)) {
+                    EdgeSnapIndex::Hit hit = edgeIndexFor(shape, data).nearest(ray, worldTolerance);
+                    if (hit.valid && cursor3D.Distance(hit.point) <= worldTolerance) {
+                        candidates.append(SnapPoint(hit.point, Nearest, "Nearest", cursor3D.Distance(hit.point)));
+                        interior.push_back(0);
                     }
                 }
             } catch (...) {
                 continue;
             }
         }
+        sweepShapeData(shapes.size());
+        
+        // Drop candidates hidden behind other geometry
+        std::vector<gp_Pnt> points;
+        for (const SnapPoint& candidate : candidates) {
+            points.push_back(candidate.point);
+        }
+        std::vector<char> visible;
+        m_visibility.classify(view, points, visible);
+        interior.resize(candidates.size(), 0);
+        for (int i = candidates.size() - 1; i >= 0; --i) {
+            if (!visible[i] && !interior[i] && candidates[i].type != Center) {
+                candidates.removeAt(i);
+            }
+        }
         
         // Find closest in 3D world space with priority
         // Priority: Endpoint > Midpoint > Vertex > Center > Nearest
         SnapPoint bestSnap;
         bestSnap.distance = worldTolerance;
         
-        qDebug() << "SnapManager: Found" << candidates.size() << "candidates, tolerance:" << worldTolerance;
+        LOG_TRACE("snap", "Found %1 candidates, tolerance %2", candidates.size(), worldTolerance);
         
         // First pass: High-priority snaps
         for (const SnapPoint& candidate : candidates) {
@@ -270,11 +200,11 @@ SnapManager::SnapPoint SnapManager::findSnapPoint(int screenX, int screenY,
                 .arg(candidates.size());
         }
         
-        qDebug() << "SnapManager: Returning snap type:" << bestSnap.type;
+        LOG_TRACE("snap", "Returning snap type %1", static_cast<int>(bestSnap.type));
         
         return bestSnap;
     } catch (...) {
-        qDebug() << "Exception in findSnapPoint (catch all)";
+        LOG_WARNING("snap", "Exception in findSnapPoint");
         SnapPoint emptySnap;
         return emptySnap;
     }
@@ -290,62 +220,12 @@ SnapManager::SnapPoint SnapManager::findSnapPointFromObjects(int screenX, int sc
             return emptySnap;
         }
         
-        // Query all objects for their snap points
-        NCollection_Sequence<Handle(TGraphicObject)> objects = collection->GetAllObjects();
-        
-        // Find the closest snap point in SCREEN space, not world space
-        SnapPoint bestSnap;
-        bestSnap.type = None;
-        bestSnap.distance = 1e10;
-        double minScreenDist = 1e10;
-        
-        for (int i = 1; i <= objects.Size(); i++) {
-            Handle(TGraphicObject) obj = objects.Value(i);
-            if (obj.IsNull()) continue;
-            
-            try {
-                // Get all snap points from the object
-                QList<TGraphicObject::SnapPoint> snapPoints = obj->GetSnapPoints();
-                
-                // Check each snap point's distance in screen space
-                for (const TGraphicObject::SnapPoint& snap : snapPoints) {
-                    // Convert 3D snap point to screen coordinates
-                    Standard_Integer snapScreenX, snapScreenY;
-                    view->Convert(snap.point.X(), snap.point.Y(), snap.point.Z(), 
-                                 snapScreenX, snapScreenY);
-                    
-                    // Calculate screen-space distance
-                    double dx = snapScreenX - screenX;
-                    double dy = snapScreenY - screenY;
-                    double screenDist = std::sqrt(dx*dx + dy*dy);
-                    
-                    // Check if within tolerance and closer than current best
-                    if (screenDist < m_snapTolerancePixels && screenDist < minScreenDist) {
-                        minScreenDist = screenDist;
-                        bestSnap.point = snap.point;
-                        bestSnap.distance = screenDist;
-                        bestSnap.description = snap.description;
-                        
-                        // Map object snap type to SnapManager type
-                        if (snap.type & 0x01) {
-                            bestSnap.type = Endpoint;
-                        } else if (snap.type & 0x02) {
-                            bestSnap.type = Midpoint;
-                        } else if (snap.type & 0x04) {
-                            bestSnap.type = Center;
-                        } else {
-                            bestSnap.type = Vertex;
-                        }
-                    }
-                }
-            } catch (...) {
-                continue;
-            }
-        }
-        
-        return bestSnap;
+        // Same pipeline as the asynchronous SnapService, run inline
+        std::shared_ptr<const SnapScene> scene = sceneFor(collection);
+        QList<SnapPoint> ranked = rankCandidates(*scene, makeQuery(screenX, screenY, view));
+        return pickVisible(ranked, view);
     } catch (...) {
-        qDebug() << "Exception in findSnapPointFromObjects";
+        LOG_WARNING("snap", "Exception in findSnapPointFromObjects");
         SnapPoint emptySnap;
         return emptySnap;
     }
@@ -376,21 +256,8 @@ QList<SnapManager::SnapPoint> SnapManager::findAllSnapPoints(const gp_Pnt& curso
             if (shape.IsNull()) continue;
             
             try {
-                if (isSnapEnabled(Endpoint)) {
-                    findEndpoints(shape, cursorPoint, candidates);
-                }
-                if (isSnapEnabled(Midpoint)) {
-                    findMidpoints(shape, cursorPoint, candidates);
-                }
-                if (isSnapEnabled(Vertex)) {
-                    findVertices(shape, cursorPoint, candidates);
-                }
-                if (isSnapEnabled(Center)) {
-                    findCenter(shape, cursorPoint, candidates);
-                }
-                if (isSnapEnabled(Nearest)) {
-                    findNearest(shape, cursorPoint, candidates);
-                }
+                ShapeSnapData& data = snapDataFor(shape);
+                collectCandidates(data, cursorPoint, Precision::Infinite(), candidates);
             } catch (...) {
                 // Skip this shape if any error occurs
                 continue;
@@ -489,23 +356,426 @@ void SnapManager::findCenter(const TopoDS_Shape& shape, const gp_Pnt& cursor, QL
     }
 }
 
-void SnapManager::findNearest(const TopoDS_Shape& shape, const gp_Pnt& cursor, QList<SnapPoint>& candidates)
+std::shared_ptr<const SnapManager::ObjectSnapData> SnapManager::buildObjectData(const Handle(TGraphicObject)& object)
 {
-    TopExp_Explorer edgeExp(shape, TopAbs_EDGE);
+    std::shared_ptr<ObjectSnapData> data = std::make_shared<ObjectSnapData>();
+    data->id = object->GetID();
+    object->GetBoundingBox(data->min[0], data->min[1], data->min[2],
+                           data->max[0], data->max[1], data->max[2]);
     
-    while (edgeExp.More()) {
-        TopoDS_Edge edge = TopoDS::Edge(edgeExp.Current());
+    // Map object snap types to SnapManager types
+    for (const TGraphicObject::SnapPoint& snap : object->GetSnapPoints()) {
+        SnapType type = Vertex;
+        if (snap.type & 0x01) {
+            type = Endpoint;
+        } else if (snap.type & 0x02) {
+            type = Midpoint;
+        } else if (snap.type & 0x04) {
+            type = Center;
+        }
+        SnapPoint point(snap.point, type, snap.description, 0.0);
+        point.interior = (type == Center);
+        data->points.append(point);
+    }
+    
+    double diagonal = gp_Pnt(data->min[0], data->min[1], data->min[2])
+                          .Distance(gp_Pnt(data->max[0], data->max[1], data->max[2]));
+    std::shared_ptr<EdgeSnapIndex> edges = std::make_shared<EdgeSnapIndex>();
+    edges->addShape(object->GetShape(), std::max(0.1, diagonal * 0.001));
+    
+    // Beams also snap along their centreline
+    Handle(TBeam) beam = Handle(TBeam)::DownCast(object);
+    if (!beam.IsNull()) {
+        edges->addSegment(beam->GetStartPoint(), beam->GetEndPoint(), true);
+    }
+    edges->build();
+    data->edges = edges;
+    
+    return data;
+}
+
+std::shared_ptr<const SnapManager::SnapScene> SnapManager::sceneFor(TObjectCollection* collection)
+{
+    if (m_scene && m_scene->objectCount == collection->GetObjectCount()) {
+        return m_scene;
+    }
+    
+    std::shared_ptr<SnapScene> scene = std::make_shared<SnapScene>();
+    scene->objectCount = collection->GetObjectCount();
+    
+    // Rebuild only objects whose shape changed; entries of removed objects drop out
+    QHash<int, ObjectCacheEntry> live;
+    NCollection_Sequence<Handle(TGraphicObject)> objects = collection->GetAllObjects();
+    for (int i = 1; i <= objects.Size(); i++) {
+        const Handle(TGraphicObject)& obj = objects.Value(i);
+        if (obj.IsNull()) continue;
+        
+        ObjectCacheEntry entry = m_objectData.value(obj->GetID());
+        // Shapes still being meshed are owned by a worker thread
+        if (!collection->IsMeshPending(obj->GetID()) && !obj->GetShape().IsNull()
+            && (!entry.data || !entry.source.IsSame(obj->GetShape()))) {
+            try {
+                entry.data = buildObjectData(obj);
+                entry.source = obj->GetShape();
+            } catch (Standard_Failure const& ex) {
+                LOG_WARNING("snap", "No snap data for object %1: %2", obj->GetID(), ex.GetMessageString());
+                continue;
+            }
+        }
+        if (!entry.data) continue;
+        
+        live.insert(obj->GetID(), entry);
+        if (obj->IsVisible() && !collection->IsMeshPending(obj->GetID())) {
+            scene->objects.push_back(entry.data);
+        }
+    }
+    m_objectData.swap(live);
+    
+    m_scene = scene;
+    return m_scene;
+}
+
+SnapManager::SnapQuery SnapManager::makeQuery(int screenX, int screenY, const Handle(V3d_View)& view) const
+{
+    SnapQuery query;
+    query.screenX = screenX;
+    query.screenY = screenY;
+    if (!view->Window().IsNull()) {
+        view->Window()->Size(query.width, query.height);
+    }
+    query.camera = new Graphic3d_Camera(view->Camera());
+    query.workPlane = m_workPlane;
+    query.tolerancePixels = m_snapTolerancePixels;
+    query.enabledTypes = m_enabledSnaps;
+    return query;
+}
+
+QList<SnapManager::SnapPoint> SnapManager::rankCandidates(const SnapScene& scene, const SnapQuery& query)
+{
+    QList<SnapPoint> ranked;
+    if (query.camera.IsNull() || query.width <= 0 || query.height <= 0) {
+        return ranked;
+    }
+    
+    const Graphic3d_Camera& camera = *query.camera;
+    auto pixelDistance = [&](const gp_Pnt& p) {
+        gp_Pnt ndc = camera.Project(p);
+        double dx = (ndc.X() + 1.0) * 0.5 * query.width - query.screenX;
+        double dy = (1.0 - ndc.Y()) * 0.5 * query.height - query.screenY;
+        return std::sqrt(dx*dx + dy*dy);
+    };
+    auto rayThrough = [&](double ndcX, double ndcY, gp_Lin& ray) {
+        gp_Pnt nearPnt = camera.UnProject(gp_Pnt(ndcX, ndcY, -1.0));
+        gp_Pnt farPnt = camera.UnProject(gp_Pnt(ndcX, ndcY, 1.0));
+        if (nearPnt.Distance(farPnt) < Precision::Confusion()) {
+            return false;
+        }
+        ray = gp_Lin(nearPnt, gp_Dir(gp_Vec(nearPnt, farPnt)));
+        return true;
+    };
+    
+    // Pick ray through the cursor; tolerance in world units at the focal plane
+    gp_Lin ray;
+    if (!rayThrough(2.0 * (query.screenX + 0.5) / query.width - 1.0,
+                    1.0 - 2.0 * (query.screenY + 0.5) / query.height, ray)) {
+        return ranked;
+    }
+    const double tolerance = query.tolerancePixels * camera.ViewDimensions().Y() / query.height;
+    // Pixel size varies with depth in perspective, so only cull by box in orthographic views
+    const bool cullPoints = camera.IsOrthographic();
+    const bool nearestEnabled = (query.enabledTypes & Nearest) != 0;
+    const bool intersectionEnabled = (query.enabledTypes & Intersection) != 0;
+    
+    SnapPoint nearest;
+    nearest.distance = query.tolerancePixels;
+    std::vector<RaySegment> nearRay;
+    std::vector<int> hits;
+    
+    for (size_t i = 0; i < scene.objects.size(); ++i) {
+        if ((i & 63) == 0 && query.latestSerial && query.latestSerial->load() != query.serial) {
+            return QList<SnapPoint>();     // Superseded by a newer query
+        }
         
-        BRepAdaptor_Curve curve(edge);
-        GeomAPI_ProjectPointOnCurve projector(cursor, curve.Curve().Curve());
+        const ObjectSnapData& object = *scene.objects[i];
+        const bool nearBox = EdgeSnapIndex::rayNearBox(ray, object.min, object.max, tolerance);
         
-        if (projector.NbPoints() > 0) {
-            gp_Pnt nearestPoint = projector.NearestPoint();
-            double dist = cursor.Distance(nearestPoint);
-            candidates.append(SnapPoint(nearestPoint, Nearest, "Nearest", dist));
+        if (nearBox || !cullPoints) {
+            for (const SnapPoint& snap : object.points) {
+                double dist = pixelDistance(snap.point);
+                if (dist < query.tolerancePixels) {
+                    SnapPoint candidate = snap;
+                    candidate.distance = dist;
+                    ranked.append(candidate);
+                }
+            }
         }
         
-        edgeExp.Next();
+        if (!nearBox || !object.edges) {
+            continue;
+        }
+        const EdgeSnapIndex& index = *object.edges;
+        
+        if (nearestEnabled) {
+            EdgeSnapIndex::Hit hit = index.nearest(ray, tolerance);
+            if (hit.valid) {
+                double dist = pixelDistance(hit.point);
+                if (dist < nearest.distance) {
+                    nearest = SnapPoint(hit.point, Nearest, "Nearest", dist);
+                    nearest.interior = index.segment(hit.segment).interior;
+                }
+            }
+        }
+        
+        if (intersectionEnabled) {
+            hits.clear();
+            index.collect(ray, tolerance, hits);
+            for (int s : hits) {
+                if (static_cast<int>(nearRay.size()) >= kMaxIntersectionSegments) {
+                    break;
+                }
+                const EdgeSnapIndex::Segment& seg = index.segment(s);
+                gp_Pnt a = camera.Project(seg.a);
+                gp_Pnt b = camera.Project(seg.b);
+                nearRay.push_back({ &index, s, object.id, gp_Pnt2d(a.X(), a.Y()), gp_Pnt2d(b.X(), b.Y()) });
+            }
+        }
+    }
+    
+    // Point snaps first, closest first
+    std::stable_sort(ranked.begin(), ranked.end(), [](const SnapPoint& lhs, const SnapPoint& rhs) {
+        return lhs.distance < rhs.distance;
+    });
+    
+    // Apparent intersections: segments of different objects crossing on screen
+    SnapPoint crossing;
+    crossing.distance = query.tolerancePixels;
+    for (size_t i = 0; i < nearRay.size(); ++i) {
+        const RaySegment& s1 = nearRay[i];
+        const double d1x = s1.b.X() - s1.a.X(), d1y = s1.b.Y() - s1.a.Y();
+        
+        for (size_t j = i + 1; j < nearRay.size(); ++j) {
+            const RaySegment& s2 = nearRay[j];
+            if (s1.objectID == s2.objectID) {
+                continue;
+            }
+            
+            const double d2x = s2.b.X() - s2.a.X(), d2y = s2.b.Y() - s2.a.Y();
+            const double denom = cross2d(d1x, d1y, d2x, d2y);
+            if (std::abs(denom) < 1e-12) {
+                continue;   // Parallel on screen
+            }
+            const double wx = s2.a.X() - s1.a.X(), wy = s2.a.Y() - s1.a.Y();
+            const double t = cross2d(wx, wy, d2x, d2y) / denom;
+            const double u = cross2d(wx, wy, d1x, d1y) / denom;
+            if (t < 0.0 || t > 1.0 || u < 0.0 || u > 1.0) {
+                continue;
+            }
+            
+            // Ray through the crossing, so the 3D points are exact in perspective too
+            gp_Lin crossRay;
+            if (!rayThrough(s1.a.X() + t * d1x, s1.a.Y() + t * d1y, crossRay)) {
+                continue;
+            }
+            
+            gp_Pnt p1, p2;
+            s1.index->closestToRay(s1.segment, crossRay, p1);
+            s2.index->closestToRay(s2.segment, crossRay, p2);
+            
+            // Report the point on the edge nearer the eye
+            const bool firstNearer = gp_Vec(p1, p2).Dot(gp_Vec(camera.Direction())) > 0.0;
+            const gp_Pnt& p = firstNearer ? p1 : p2;
+            double dist = pixelDistance(p);
+            if (dist < crossing.distance) {
+                const RaySegment& owner = firstNearer ? s1 : s2;
+                crossing = SnapPoint(p, Intersection, "Intersection", dist);
+                crossing.interior = owner.index->segment(owner.segment).interior;
+            }
+        }
+    }
+    
+    // Grid snaps in closed form from the cursor's plane coordinates
+    SnapPoint gridPoint, gridLine;
+    const StructuralGrid& grid = query.workPlane.getGrid();
+    if ((query.enabledTypes & (Grid | GridLine)) && !grid.isEmpty()) {
+        const gp_Pln plane = query.workPlane.getPlane();
+        const gp_Dir& normal = plane.Axis().Direction();
+        const double denom = ray.Direction().Dot(normal);
+        if (std::abs(denom) > 1e-9) {
+            const double t = gp_Vec(ray.Location(), plane.Location()).Dot(gp_Vec(normal)) / denom;
+            const gp_Pnt cursor = ray.Location().Translated(t * gp_Vec(ray.Direction()));
+            
+            // In perspective a pixel grows with depth
+            double gridTolerance = tolerance;
+            if (!camera.IsOrthographic() && camera.Distance() > 0.0) {
+                gridTolerance *= gp_Vec(camera.Eye(), cursor).Dot(gp_Vec(camera.Direction())) / camera.Distance();
+            }
+            
+            gp_Pnt snapped;
+            StructuralGrid::Snap snap;
+            if (query.workPlane.snapToGrid(cursor, gridTolerance, snapped, snap)) {
+                double dist = pixelDistance(snapped);
+                if (dist < query.tolerancePixels) {
+                    if (snap.kind == StructuralGrid::Snap::INTERSECTION && (query.enabledTypes & Grid)) {
+                        gridPoint = SnapPoint(snapped, Grid, snap.description, dist);
+                    } else if (snap.kind == StructuralGrid::Snap::LINE && (query.enabledTypes & GridLine)) {
+                        gridLine = SnapPoint(snapped, GridLine, snap.description, dist);
+                    }
+                }
+            }
+        }
+    }
+    
+    // Then Grid > Intersection > Nearest > GridLine
+    if (gridPoint.type != None) {
+        ranked.append(gridPoint);
+    }
+    if (crossing.type != None) {
+        ranked.append(crossing);
+    }
+    if (nearest.type != None) {
+        ranked.append(nearest);
+    }
+    if (gridLine.type != None) {
+        ranked.append(gridLine);
+    }
+    return ranked;
+}
+
+SnapManager::SnapPoint SnapManager::pickVisible(const QList<SnapPoint>& ranked, const Handle(V3d_View)& view)
+{
+    std::vector<gp_Pnt> points;
+    points.reserve(ranked.size());
+    for (const SnapPoint& snap : ranked) {
+        points.push_back(snap.point);
+    }
+    
+    // One pass against the depth buffer, then the best candidate not hidden
+    std::vector<char> visible;
+    m_visibility.classify(view, points, visible);
+    for (int i = 0; i < ranked.size(); ++i) {
+        if (visible[i] || ranked[i].interior) {
+            return ranked[i];
+        }
+    }
+    return SnapPoint();
+}
+
+SnapManager::ShapeSnapData& SnapManager::snapDataFor(const TopoDS_Shape& shape)
+{
+    ShapeSnapData* data = m_shapeData.ChangeSeek(shape);
+    if (!data) {
+        data = m_shapeData.Bound(shape, ShapeSnapData());
+        buildSnapData(shape, *data);
+    }
+    data->lastUsed = m_queryStamp;
+    return *data;
+}
+
+void SnapManager::buildSnapData(const TopoDS_Shape& shape, ShapeSnapData& data)
+{
+    BRepBndLib::Add(shape, data.box);
+    if (data.box.IsVoid()) {
+        return;
+    }
+    
+    Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
+    data.box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+    
+    double dx = xmax - xmin;
+    double dy = ymax - ymin;
+    double dz = zmax - zmin;
+    
+    // A beam/column is elongated in ONE dimension: the middle extent is
+    // similar to the smallest. A slab has TWO large dimensions.
+    double dims[3] = { dx, dy, dz };
+    std::sort(dims, dims + 3);
+    data.beamLike = dims[2] > dims[0] * 5.0 && dims[1] / dims[0] <= 3.0;
+    
+    const gp_Pnt origin;
+    if (!data.beamLike) {
+        findEndpoints(shape, origin, data.points);
+        findMidpoints(shape, origin, data.points);
+        findVertices(shape, origin, data.points);
+        findCenter(shape, origin, data.points);
+        return;
+    }
+    
+    // Beams and columns snap to their centreline and flange endpoints
+    gp_Pnt centerStart, centerEnd;
+    if (dx == dims[2]) {
+        // Horizontal beam along X
+        centerStart = gp_Pnt(xmin, (ymin+ymax)/2, (zmin+zmax)/2);
+        centerEnd = gp_Pnt(xmax, (ymin+ymax)/2, (zmin+zmax)/2);
+        data.points.append(SnapPoint(centerStart, Endpoint, "Beam Center Start", 0.0));
+        data.points.append(SnapPoint(centerEnd, Endpoint, "Beam Center End", 0.0));
+        data.points.append(SnapPoint(gp_Pnt(xmin, (ymin+ymax)/2, zmax), Endpoint, "Beam Top Start", 0.0));
+        data.points.append(SnapPoint(gp_Pnt(xmax, (ymin+ymax)/2, zmax), Endpoint, "Beam Top End", 0.0));
+        data.points.append(SnapPoint(gp_Pnt(xmin, (ymin+ymax)/2, zmin), Endpoint, "Beam Bottom Start", 0.0));
+        data.points.append(SnapPoint(gp_Pnt(xmax, (ymin+ymax)/2, zmin), Endpoint, "Beam Bottom End", 0.0));
+    } else if (dy == dims[2]) {
+        // Horizontal beam along Y
+        centerStart = gp_Pnt((xmin+xmax)/2, ymin, (zmin+zmax)/2);
+        centerEnd = gp_Pnt((xmin+xmax)/2, ymax, (zmin+zmax)/2);
+        data.points.append(SnapPoint(centerStart, Endpoint, "Beam Center Start", 0.0));
+        data.points.append(SnapPoint(centerEnd, Endpoint, "Beam Center End", 0.0));
+        data.points.append(SnapPoint(gp_Pnt((xmin+xmax)/2, ymin, zmax), Endpoint, "Beam Top Start", 0.0));
+        data.points.append(SnapPoint(gp_Pnt((xmin+xmax)/2, ymax, zmax), Endpoint, "Beam Top End", 0.0));
+        data.points.append(SnapPoint(gp_Pnt((xmin+xmax)/2, ymin, zmin), Endpoint, "Beam Bottom Start", 0.0));
+        data.points.append(SnapPoint(gp_Pnt((xmin+xmax)/2, ymax, zmin), Endpoint, "Beam Bottom End", 0.0));
+    } else {
+        // Vertical column along Z
+        centerStart = gp_Pnt((xmin+xmax)/2, (ymin+ymax)/2, zmin);
+        centerEnd = gp_Pnt((xmin+xmax)/2, (ymin+ymax)/2, zmax);
+        data.points.append(SnapPoint(centerStart, Endpoint, "Column Bottom", 0.0));
+        data.points.append(SnapPoint(centerEnd, Endpoint, "Column Top", 0.0));
+    }
+    
+    gp_Pnt mid((centerStart.XYZ() + centerEnd.XYZ()) / 2.0);
+    data.points.append(SnapPoint(mid, Midpoint, "Beam Midpoint", 0.0));
+}
+
+const EdgeSnapIndex& SnapManager::edgeIndexFor(const TopoDS_Shape& shape, ShapeSnapData& data)
+{
+    if (!data.edges) {
+        double diagonal = data.box.IsVoid() ? 0.0 : std::sqrt(data.box.SquareExtent());
+        data.edges = std::make_shared<EdgeSnapIndex>();
+        data.edges->addShape(shape, std::max(0.1, diagonal * 0.001));
+        data.edges->build();
+    }
+    return *data.edges;
+}
+
+void SnapManager::collectCandidates(const ShapeSnapData& data, const gp_Pnt& cursor, double tolerance,
+                                    QList<SnapPoint>& candidates) const
+{
+    for (const SnapPoint& snap : data.points) {
+        // Beam endpoints are always offered, like the beam outline itself
+        if (!isSnapEnabled(snap.type) && !(data.beamLike && snap.type == Endpoint)) {
+            continue;
+        }
+        double dist = cursor.Distance(snap.point);
+        if (dist <= tolerance) {
+            candidates.append(SnapPoint(snap.point, snap.type, snap.description, dist));
+        }
+    }
+}
+
+void SnapManager::sweepShapeData(int liveShapes)
+{
+    if (m_shapeData.Extent() <= liveShapes) {
+        return;
+    }
+    
+    // Entries not touched by this query belong to rebuilt or removed shapes
+    NCollection_List<TopoDS_Shape> stale;
+    NCollection_DataMap<TopoDS_Shape, ShapeSnapData, TopTools_ShapeMapHasher>::Iterator it(m_shapeData);
+    for (; it.More(); it.Next()) {
+        if (it.Value().lastUsed != m_queryStamp) {
+            stale.Append(it.Key());
+        }
+    }
+    for (NCollection_List<TopoDS_Shape>::Iterator key(stale); key.More(); key.Next()) {
+        m_shapeData.UnBind(key.Value());
     }
 }
 
@@ -551,136 +821,14 @@ QList<TopoDS_Shape> SnapManager::getVisibleShapes(const Handle(AIS_InteractiveCo
     return shapes;
 }
 
-bool SnapManager::isEdgeOnHorizontalFace(const TopoDS_Edge& edge, const TopoDS_Shape& shape)
-{
-    try {
-        // First check if the entire shape is a large flat box (typical slab)
-        Bnd_Box shapeBox;
-        BRepBndLib::Add(shape, shapeBox);
-        if (!shapeBox.IsVoid()) {
-            Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
-            shapeBox.Get(xmin, ymin, zmin, xmax, ymax, zmax);
-            double width = xmax - xmin;
-            double depth = ymax - ymin;
-            double height = zmax - zmin;
-            
-            // If shape is large in X-Y but thin in Z, it's likely a slab
-            double xyArea = width * depth;
-            if (xyArea > 1000000.0 && height < std::min(width, depth) * 0.2) {
-                return true;  // Skip all edges of slab-like shapes
-            }
-        }
-        
-        // Build edge-to-face map
-        TopTools_IndexedDataMapOfShapeListOfShape edgeFaceMap;
-        TopExp::MapShapesAndAncestors(shape, TopAbs_EDGE, TopAbs_FACE, edgeFaceMap);
-        
-        // Check if this edge has any parent faces
-        if (!edgeFaceMap.Contains(edge)) {
-            return false;  // Edge not on any face, keep it
-        }
-        
-        const TopTools_ListOfShape& faces = edgeFaceMap.FindFromKey(edge);
-        TopTools_ListIteratorOfListOfShape faceIt(faces);
-        
-        for (; faceIt.More(); faceIt.Next()) {
-            TopoDS_Face face = TopoDS::Face(faceIt.Value());
-            
-            // Check if face is planar and horizontal
-            BRepAdaptor_Surface surface(face);
-            if (surface.GetType() == GeomAbs_Plane) {
-                gp_Pln plane = surface.Plane();
-                gp_Dir normal = plane.Axis().Direction();
-                
-                // Check if normal is nearly vertical (face is horizontal)
-                double dotZ = std::abs(normal.Z());
-                if (dotZ > 0.9) {  // Face is mostly horizontal
-                    // Check face area - large faces are likely slabs
-                    Bnd_Box box;
-                    BRepBndLib::Add(face, box);
-                    if (!box.IsVoid()) {
-                        Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
-                        box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
-                        double width = xmax - xmin;
-                        double height = ymax - ymin;
-                        double area = width * height;
-                        
-                        // If face area > 1 m² (1,000,000 mm²), treat as slab
-                        if (area > 1000000.0) {
-                            return true;  // Skip this edge
-                        }
-                    }
-                }
-            }
-        }
-        
-        return false;  // Keep this edge
-    } catch (...) {
-        return false;  // On error, keep the edge
-    }
-}
-
 bool SnapManager::isPointVisible(const gp_Pnt& point, 
                                  const Handle(AIS_InteractiveContext)& context,
                                  const Handle(V3d_View)& view)
 {
+    Q_UNUSED(context);
     try {
-        if (view.IsNull() || context.IsNull()) {
-            return true;  // Assume visible if we can't check
-        }
-        
-        // Get view eye position and direction
-        Standard_Real eyeX, eyeY, eyeZ;
-        Standard_Real projX, projY, projZ;
-        view->Eye(eyeX, eyeY, eyeZ);
-        view->Proj(projX, projY, projZ);
-        
-        gp_Pnt eyePoint(eyeX, eyeY, eyeZ);
-        gp_Dir viewDir(projX, projY, projZ);
-        
-        // For orthographic view, eye is at infinity along view direction
-        // So we cast ray from point backwards along view direction
-        gp_Pnt rayStart = point.Translated(gp_Vec(viewDir.Reversed()) * 0.1);  // Start slightly behind point
-        gp_Dir rayDir = viewDir;
-        
-        // Check if any shape occludes this point from the view
-        // We do a simple depth check: convert point to screen space and check Z-depth
-        Standard_Integer screenX, screenY;
-        view->Convert(point.X(), point.Y(), point.Z(), screenX, screenY);
-        
-        // Convert screen coords back to get depth
-        Standard_Real worldX, worldY, worldZ;
-        view->Convert(screenX, screenY, worldX, worldY, worldZ);
-        
-        // Get view plane at the point
-        gp_Pnt projectedPoint(worldX, worldY, worldZ);
-        double pointDepth = eyePoint.Distance(point);
-        
-        // Check if any object is closer to camera at this screen position
-        // For now, we'll use a simpler heuristic: only snap to points that are
-        // "on top" based on Z-coordinate in most cases
-        
-        // Get all shapes and check if point is on their boundary
-        QList<TopoDS_Shape> shapes = getVisibleShapes(context);
-        
-        for (const TopoDS_Shape& shape : shapes) {
-            // Check if point is ON this shape (vertex/edge)
-            TopExp_Explorer vertexExp(shape, TopAbs_VERTEX);
-            while (vertexExp.More()) {
-                TopoDS_Vertex vertex = TopoDS::Vertex(vertexExp.Current());
-                gp_Pnt vPnt = BRep_Tool::Pnt(vertex);
-                if (point.Distance(vPnt) < Precision::Confusion()) {
-                    // Point is a vertex of this shape, so it's visible
-                    return true;
-                }
-                vertexExp.Next();
-            }
-        }
-        
-        // If we didn't find the point on any shape boundary, it might be occluded
-        // But for now, let's be permissive and return true
-        return true;
-        
+        // Depth buffer comparison; the buffer is read back once per camera change
+        return m_visibility.isVisible(view, point);
     } catch (...) {
         return true;  // Assume visible on error
     }
@@ -0,0 +1,83 @@
+#include "SnapService.h"
+#include "Logger.h"
+#include <QRunnable>
+#include <Standard_Failure.hxx>
+
+class SnapTask : public QRunnable
+{
+public:
+    SnapTask(SnapService* service, const std::shared_ptr<const SnapManager::SnapScene>& scene,
+             const SnapManager::SnapQuery& query)
+        : m_service(service)
+        , m_scene(scene)
+        , m_query(query)
+    {
+    }
+    
+    void run() override
+    {
+        QList<SnapManager::SnapPoint> ranked;
+        try {
+            ranked = SnapManager::rankCandidates(*m_scene, m_query);
+        } catch (Standard_Failure const& ex) {
+            LOG_WARNING("snap", "Snap query failed: %1", ex.GetMessageString());
+        }
+        
+        // Superseded while running: nobody wants this answer
+        if (m_service->m_latestSerial.load() != m_query.serial) {
+            return;
+        }
+        
+        SnapService* service = m_service;
+        int serial = m_query.serial;
+        QMetaObject::invokeMethod(service, [service, serial, ranked]() {
+            service->taskFinished(serial, ranked);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    SnapService* m_service;
+    std::shared_ptr<const SnapManager::SnapScene> m_scene;
+    SnapManager::SnapQuery m_query;
+};
+
+SnapService::SnapService(QObject* parent)
+    : QObject(parent)
+    , m_latestSerial(0)
+{
+    // One worker: queries are short and only the newest matters
+    m_pool.setMaxThreadCount(1);
+}
+
+SnapService::~SnapService()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+int SnapService::request(const std::shared_ptr<const SnapManager::SnapScene>& scene, SnapManager::SnapQuery query)
+{
+    if (!scene) {
+        return m_latestSerial.load();
+    }
+    
+    // Drop the queued query, and let a running one see it was superseded
+    m_pool.clear();
+    query.serial = m_latestSerial.fetchAndAddOrdered(1) + 1;
+    query.latestSerial = &m_latestSerial;
+    m_pool.start(new SnapTask(this, scene, query));
+    return query.serial;
+}
+
+void SnapService::cancel()
+{
+    m_pool.clear();
+    m_latestSerial.fetchAndAddOrdered(1);
+}
+
+void SnapService::taskFinished(int serial, const QList<SnapManager::SnapPoint>& ranked)
+{
+    if (serial == m_latestSerial.load()) {
+        emit candidatesReady(serial, ranked);
+    }
+}
@@ -74,6 +74,24 @@ void SnapToolbar::setupUI()
     connect(m_nearestCheck, &QCheckBox::stateChanged, this, &SnapToolbar::onSnapCheckChanged);
     mainLayout->addWidget(m_nearestCheck);
     
+    m_intersectionCheck = new QCheckBox("Intersection", this);
+    m_intersectionCheck->setChecked(true);
+    m_intersectionCheck->setStyleSheet("QCheckBox { color: #e67e22; } QCheckBox::indicator { width: 16px; height: 16px; }");
+    connect(m_intersectionCheck, &QCheckBox::stateChanged, this, &SnapToolbar::onSnapCheckChanged);
+    mainLayout->addWidget(m_intersectionCheck);
+    
+    m_gridCheck = new QCheckBox("Grid point", this);
+    m_gridCheck->setChecked(true);
+    m_gridCheck->setStyleSheet("QCheckBox { color: #9b59b6; } QCheckBox::indicator { width: 16px; height: 16px; }");
+    connect(m_gridCheck, &QCheckBox::stateChanged, this, &SnapToolbar::onSnapCheckChanged);
+    mainLayout->addWidget(m_gridCheck);
+    
+    m_gridLineCheck = new QCheckBox("Grid line", this);
+    m_gridLineCheck->setChecked(false);
+    m_gridLineCheck->setStyleSheet("QCheckBox { color: #bdc3c7; } QCheckBox::indicator { width: 16px; height: 16px; }");
+    connect(m_gridLineCheck, &QCheckBox::stateChanged, this, &SnapToolbar::onSnapCheckChanged);
+    mainLayout->addWidget(m_gridLineCheck);
+    
     // Set overall widget style
     setStyleSheet(
         "QWidget { background-color: #2c3e50; color: white; border: 2px solid #34495e; border-radius: 5px; }"
@@ -100,6 +118,9 @@ void SnapToolbar::onToggleAllClicked()
     m_centerCheck->setChecked(m_allEnabled);
     m_vertexCheck->setChecked(m_allEnabled);
     m_nearestCheck->setChecked(false); // Nearest is off by default
+    m_intersectionCheck->setChecked(m_allEnabled);
+    m_gridCheck->setChecked(m_allEnabled);
+    m_gridLineCheck->setChecked(false); // Grid line is off by default
     
     m_toggleAllBtn->setText(m_allEnabled ? "All On" : "All Off");
     
@@ -120,6 +141,12 @@ void SnapToolbar::updateSnapTypes()
         types |= SnapManager::Vertex;
     if (m_nearestCheck->isChecked())
         types |= SnapManager::Nearest;
+    if (m_intersectionCheck->isChecked())
+        types |= SnapManager::Intersection;
+    if (m_gridCheck->isChecked())
+        types |= SnapManager::Grid;
+    if (m_gridLineCheck->isChecked())
+        types |= SnapManager::GridLine;
     
     emit snapTypesChanged(types);
 }
@@ -138,6 +165,12 @@ int SnapToolbar::getEnabledSnapTypes() const
         types |= SnapManager::Vertex;
     if (m_nearestCheck->isChecked())
         types |= SnapManager::Nearest;
+    if (m_intersectionCheck->isChecked())
+        types |= SnapManager::Intersection;
+    if (m_gridCheck->isChecked())
+        types |= SnapManager::Grid;
+    if (m_gridLineCheck->isChecked())
+        types |= SnapManager::GridLine;
     
     return types;
 }
@@ -149,4 +182,7 @@ void SnapToolbar::setEnabledSnapTypes(int types)
     m_centerCheck->setChecked(types & SnapManager::Center);
     m_vertexCheck->setChecked(types & SnapManager::Vertex);
     m_nearestCheck->setChecked(types & SnapManager::Nearest);
+    m_intersectionCheck->setChecked(types & SnapManager::Intersection);
+    m_gridCheck->setChecked(types & SnapManager::Grid);
+    m_gridLineCheck->setChecked(types & SnapManager::GridLine);
 }
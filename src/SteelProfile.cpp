@@ -1,4 +1,6 @@
 #include "SteelProfile.h"
+#include "ProfileLibrary.h"
+#include "Logger.h"
 #include <BRepBuilderAPI_MakeWire.hxx>
 #include <BRepBuilderAPI_MakeFace.hxx>
 #include <BRepPrimAPI_MakePrism.hxx>
@@ -12,131 +14,531 @@
 #include <TopoDS.hxx>
 #include <TopoDS_Wire.hxx>
 #include <TopExp_Explorer.hxx>
-#include <QDebug>
-#include <QFile>
-#include <QTextStream>
+#include <gp_Circ.hxx>
+#include <gp_Ax2.hxx>
 #include <cmath>
 
-QMap<QString, SteelProfile::Dimensions> SteelProfile::s_ipeProfiles;
-QMap<QString, SteelProfile::Dimensions> SteelProfile::s_heaProfiles;
-QMap<QString, SteelProfile::Dimensions> SteelProfile::s_hebProfiles;
-QMap<QString, SteelProfile::Dimensions> SteelProfile::s_hemProfiles;
-QMap<QString, SteelProfile::Dimensions> SteelProfile::s_rhsProfiles;
-bool SteelProfile::s_initialized = false;
-
-void SteelProfile::initializeProfiles()
-{
-    if (s_initialized) return;
-    
-    // IPE Profiles (European I-beams)
-    s_ipeProfiles["IPE 80"]  = {80,  46,  3.8, 5.2, 5, 0};
-    s_ipeProfiles["IPE 100"] = {100, 55,  4.1, 5.7, 7, 0};
-    s_ipeProfiles["IPE 120"] = {120, 64,  4.4, 6.3, 7, 0};
-    s_ipeProfiles["IPE 140"] = {140, 73,  4.7, 6.9, 7, 0};
-    s_ipeProfiles["IPE 160"] = {160, 82,  5.0, 7.4, 9, 0};
-    s_ipeProfiles["IPE 180"] = {180, 91,  5.3, 8.0, 9, 0};
-    s_ipeProfiles["IPE 200"] = {200, 100, 5.6, 8.5, 12, 0};
-    s_ipeProfiles["IPE 220"] = {220, 110, 5.9, 9.2, 12, 0};
-    s_ipeProfiles["IPE 240"] = {240, 120, 6.2, 9.8, 15, 0};
-    s_ipeProfiles["IPE 270"] = {270, 135, 6.6, 10.2, 15, 0};
-    s_ipeProfiles["IPE 300"] = {300, 150, 7.1, 10.7, 15, 0};
-    s_ipeProfiles["IPE 330"] = {330, 160, 7.5, 11.5, 18, 0};
-    s_ipeProfiles["IPE 360"] = {360, 170, 8.0, 12.7, 18, 0};
-    s_ipeProfiles["IPE 400"] = {400, 180, 8.6, 13.5, 21, 0};
-    s_ipeProfiles["IPE 450"] = {450, 190, 9.4, 14.6, 21, 0};
-    s_ipeProfiles["IPE 500"] = {500, 200, 10.2, 16.0, 21, 0};
-    s_ipeProfiles["IPE 550"] = {550, 210, 11.1, 17.2, 24, 0};
-    s_ipeProfiles["IPE 600"] = {600, 220, 12.0, 19.0, 24, 0};
-    
-    // HEA Profiles (European wide flange - light)
-    s_heaProfiles["HEA 100"] = {96,  100, 5.0, 8.0,  12, 0};
-    s_heaProfiles["HEA 120"] = {114, 120, 5.0, 8.0,  12, 0};
-    s_heaProfiles["HEA 140"] = {133, 140, 5.5, 8.5,  12, 0};
-    s_heaProfiles["HEA 160"] = {152, 160, 6.0, 9.0,  15, 0};
-    s_heaProfiles["HEA 180"] = {171, 180, 6.0, 9.5,  15, 0};
-    s_heaProfiles["HEA 200"] = {190, 200, 6.5, 10.0, 18, 0};
-    s_heaProfiles["HEA 220"] = {210, 220, 7.0, 11.0, 18, 0};
-    s_heaProfiles["HEA 240"] = {230, 240, 7.5, 12.0, 21, 0};
-    s_heaProfiles["HEA 260"] = {250, 260, 7.5, 12.5, 24, 0};
-    s_heaProfiles["HEA 280"] = {270, 280, 8.0, 13.0, 24, 0};
-    s_heaProfiles["HEA 300"] = {290, 300, 8.5, 14.0, 27, 0};
-    s_heaProfiles["HEA 320"] = {310, 300, 9.0, 15.5, 27, 0};
-    s_heaProfiles["HEA 340"] = {330, 300, 9.5, 16.5, 27, 0};
-    s_heaProfiles["HEA 360"] = {350, 300, 10.0, 17.5, 27, 0};
-    s_heaProfiles["HEA 400"] = {390, 300, 11.0, 19.0, 27, 0};
-    s_heaProfiles["HEA 450"] = {440, 300, 11.5, 21.0, 27, 0};
-    s_heaProfiles["HEA 500"] = {490, 300, 12.0, 23.0, 27, 0};
-    
-    // HEB Profiles (European wide flange - medium)
-    s_hebProfiles["HEB 100"] = {100, 100, 6.0, 10.0, 12, 0};
-    s_hebProfiles["HEB 120"] = {120, 120, 6.5, 11.0, 12, 0};
-    s_hebProfiles["HEB 140"] = {140, 140, 7.0, 12.0, 12, 0};
-    s_hebProfiles["HEB 160"] = {160, 160, 8.0, 13.0, 15, 0};
-    s_hebProfiles["HEB 180"] = {180, 180, 8.5, 14.0, 15, 0};
-    s_hebProfiles["HEB 200"] = {200, 200, 9.0, 15.0, 18, 0};
-    s_hebProfiles["HEB 220"] = {220, 220, 9.5, 16.0, 18, 0};
-    s_hebProfiles["HEB 240"] = {240, 240, 10.0, 17.0, 21, 0};
-    s_hebProfiles["HEB 260"] = {260, 260, 10.0, 17.5, 24, 0};
-    s_hebProfiles["HEB 280"] = {280, 280, 10.5, 18.0, 24, 0};
-    s_hebProfiles["HEB 300"] = {300, 300, 11.0, 19.0, 27, 0};
-    s_hebProfiles["HEB 320"] = {320, 300, 11.5, 20.5, 27, 0};
-    s_hebProfiles["HEB 340"] = {340, 300, 12.0, 21.5, 27, 0};
-    s_hebProfiles["HEB 360"] = {360, 300, 12.5, 22.5, 27, 0};
-    s_hebProfiles["HEB 400"] = {400, 300, 13.5, 24.0, 27, 0};
-    s_hebProfiles["HEB 450"] = {450, 300, 14.0, 26.0, 27, 0};
-    s_hebProfiles["HEB 500"] = {500, 300, 14.5, 28.0, 27, 0};
-    
-    // HEM Profiles (European wide flange - heavy)
-    s_hemProfiles["HEM 100"] = {120, 106, 12.0, 20.0, 12, 0};
-    s_hemProfiles["HEM 120"] = {140, 126, 12.5, 21.0, 12, 0};
-    s_hemProfiles["HEM 140"] = {160, 146, 13.0, 22.0, 12, 0};
-    s_hemProfiles["HEM 160"] = {180, 166, 14.0, 23.0, 15, 0};
-    s_hemProfiles["HEM 180"] = {200, 186, 14.5, 24.0, 15, 0};
-    s_hemProfiles["HEM 200"] = {220, 206, 15.0, 25.0, 18, 0};
-    s_hemProfiles["HEM 220"] = {240, 226, 15.5, 26.0, 18, 0};
-    s_hemProfiles["HEM 240"] = {270, 248, 18.0, 32.0, 21, 0};
-    s_hemProfiles["HEM 260"] = {290, 268, 18.0, 32.5, 24, 0};
-    s_hemProfiles["HEM 280"] = {310, 288, 18.5, 33.0, 24, 0};
-    s_hemProfiles["HEM 300"] = {340, 310, 21.0, 39.0, 27, 0};
-    s_hemProfiles["HEM 320"] = {359, 309, 21.0, 40.0, 27, 0};
-    s_hemProfiles["HEM 340"] = {377, 309, 21.0, 40.0, 27, 0};
-    s_hemProfiles["HEM 360"] = {395, 308, 21.0, 40.0, 27, 0};
-    
-    // RHS Profiles (Rectangular Hollow Sections)
-    s_rhsProfiles["RHS 50x30x3"]   = {50,  30,  0, 0, 0, 3.0};
-    s_rhsProfiles["RHS 60x40x3"]   = {60,  40,  0, 0, 0, 3.0};
-    s_rhsProfiles["RHS 80x40x3"]   = {80,  40,  0, 0, 0, 3.0};
-    s_rhsProfiles["RHS 80x60x3"]   = {80,  60,  0, 0, 0, 3.0};
-    s_rhsProfiles["RHS 100x50x4"]  = {100, 50,  0, 0, 0, 4.0};
-    s_rhsProfiles["RHS 100x60x4"]  = {100, 60,  0, 0, 0, 4.0};
-    s_rhsProfiles["RHS 120x80x5"]  = {120, 80,  0, 0, 0, 5.0};
-    s_rhsProfiles["RHS 140x80x5"]  = {140, 80,  0, 0, 0, 5.0};
-    s_rhsProfiles["RHS 150x100x5"] = {150, 100, 0, 0, 0, 5.0};
-    s_rhsProfiles["RHS 160x80x5"]  = {160, 80,  0, 0, 0, 5.0};
-    s_rhsProfiles["RHS 180x100x6"] = {180, 100, 0, 0, 0, 6.0};
-    s_rhsProfiles["RHS 200x100x6"] = {200, 100, 0, 0, 0, 6.0};
-    s_rhsProfiles["RHS 200x120x6"] = {200, 120, 0, 0, 0, 6.0};
-    s_rhsProfiles["RHS 250x150x8"] = {250, 150, 0, 0, 0, 8.0};
-    s_rhsProfiles["RHS 300x200x10"]= {300, 200, 0, 0, 0, 10.0};
-    
-    s_initialized = true;
+namespace {
+
+// Steel density used for catalogue masses
+constexpr double kSteelDensity = 7850.0;   // kg/m3
+
+// FNV-1a, evaluated at compile time for the tables and at runtime for lookups
+constexpr quint32 fnv1a(const char* s)
+{
+    quint32 h = 2166136261u;
+    while (*s) {
+        h ^= static_cast<unsigned char>(*s++);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Integral of |z - p| over [z0, z1]; first moment of a strip about a plastic axis
+constexpr double absMoment(double z0, double z1, double p)
+{
+    if (p <= z0) return ((z1 - p) * (z1 - p) - (z0 - p) * (z0 - p)) / 2.0;
+    if (p >= z1) return ((p - z0) * (p - z0) - (p - z1) * (p - z1)) / 2.0;
+    return ((p - z0) * (p - z0) + (z1 - p) * (z1 - p)) / 2.0;
+}
+
+// Sharp-cornered section made of up to three axis-aligned rectangles.
+// Used for the asymmetric shapes (channel, angle) where the centroid moves.
+struct RectSection {
+    double y0[3], y1[3], z0[3], z1[3];
+    int count;
+    
+    constexpr double area() const
+    {
+        double a = 0;
+        for (int i = 0; i < count; ++i) a += (y1[i] - y0[i]) * (z1[i] - z0[i]);
+        return a;
+    }
+    
+    // Centroid along z (alongY = false) or y (alongY = true)
+    constexpr double centroid(bool alongY) const
+    {
+        double m = 0;
+        for (int i = 0; i < count; ++i) {
+            double a = (y1[i] - y0[i]) * (z1[i] - z0[i]);
+            m += a * (alongY ? (y0[i] + y1[i]) : (z0[i] + z1[i])) / 2.0;
+        }
+        return m / area();
+    }
+    
+    // Second moment about the centroidal axis normal to z (alongY = false) or y
+    constexpr double inertia(bool alongY) const
+    {
+        double c = centroid(alongY);
+        double I = 0;
+        for (int i = 0; i < count; ++i) {
+            double w = alongY ? (z1[i] - z0[i]) : (y1[i] - y0[i]);
+            double d = alongY ? (y1[i] - y0[i]) : (z1[i] - z0[i]);
+            double m = alongY ? (y0[i] + y1[i]) / 2.0 : (z0[i] + z1[i]) / 2.0;
+            I += w * d * d * d / 12.0 + w * d * (m - c) * (m - c);
+        }
+        return I;
+    }
+    
+    // Plastic modulus about the equal-area axis, located by bisection
+    constexpr double plasticModulus(bool alongY) const
+    {
+        double lo = 1e30, hi = -1e30;
+        for (int i = 0; i < count; ++i) {
+            double a = alongY ? y0[i] : z0[i];
+            double b = alongY ? y1[i] : z1[i];
+            lo = a < lo ? a : lo;
+            hi = b > hi ? b : hi;
+        }
+        const double half = area() / 2.0;
+        for (int iter = 0; iter < 60; ++iter) {
+            double p = (lo + hi) / 2.0;
+            double below = 0;
+            for (int i = 0; i < count; ++i) {
+                double a = alongY ? y0[i] : z0[i];
+                double b = alongY ? y1[i] : z1[i];
+                double w = alongY ? (z1[i] - z0[i]) : (y1[i] - y0[i]);
+                double top = p < b ? p : b;
+                if (top > a) below += w * (top - a);
+            }
+            if (below < half) lo = p; else hi = p;
+        }
+        double p = (lo + hi) / 2.0;
+        double W = 0;
+        for (int i = 0; i < count; ++i) {
+            double w = alongY ? (z1[i] - z0[i]) : (y1[i] - y0[i]);
+            W += w * (alongY ? absMoment(y0[i], y1[i], p) : absMoment(z0[i], z1[i], p));
+        }
+        return W;
+    }
+};
+
+constexpr SteelProfile::SectionProperties sectionPropertiesOf(SteelProfile::SectionShape shape,
+                                                              const SteelProfile::Dimensions& dim)
+{
+    SteelProfile::SectionProperties props = {};
+    const double h = dim.height;
+    const double b = dim.width;
+    double ey = h / 2, ez = b / 2;  // extreme fibre distances for the elastic moduli
+    
+    if (shape == SteelProfile::SECTION_RHS) {
+        // Hot-finished hollow section (EN 10210): corner radii ro = 1.5t, ri = 1.0t
+        const double t = dim.thickness;
+        const double ro = 1.5 * t;
+        const double ri = t;
+        const double hi = h - 2 * t;
+        const double bi = b - 2 * t;
+        
+        // Area of one corner spandrel (square minus quarter circle) and its
+        // centroid offset from the corner: r(10 - 3pi)/(12 - 3pi) = 0.2234r
+        const double ao = (1.0 - M_PI / 4.0) * ro * ro;
+        const double ai = (1.0 - M_PI / 4.0) * ri * ri;
+        const double eo = 0.2234 * ro;
+        const double ei = 0.2234 * ri;
+        
+        props.area = 2 * t * (b + h - 2 * t) - 4 * (ao - ai);
+        props.perimeter = 2 * (b + h) - (8 - 2 * M_PI) * ro;
+        
+        const double yo = h / 2 - eo, yi = hi / 2 - ei;
+        const double zo = b / 2 - eo, zi = bi / 2 - ei;
+        props.Iy = (b * h * h * h - bi * hi * hi * hi) / 12.0 - 4 * ao * yo * yo + 4 * ai * yi * yi;
+        props.Iz = (h * b * b * b - hi * bi * bi * bi) / 12.0 - 4 * ao * zo * zo + 4 * ai * zi * zi;
+        props.Wply = (b * h * h - bi * hi * hi) / 4.0 - 4 * ao * yo + 4 * ai * yi;
+        props.Wplz = (h * b * b - hi * bi * bi) / 4.0 - 4 * ao * zo + 4 * ai * zi;
+    } else if (shape == SteelProfile::SECTION_CHS) {
+        const double t = dim.thickness;
+        const double d = h - 2 * t;
+        props.area = M_PI / 4.0 * (h * h - d * d);
+        props.perimeter = M_PI * h;
+        props.Iy = props.Iz = M_PI / 64.0 * (h * h * h * h - d * d * d * d);
+        props.Wply = props.Wplz = (h * h * h - d * d * d) / 6.0;
+        ez = h / 2;
+    } else if (shape == SteelProfile::SECTION_CHANNEL || shape == SteelProfile::SECTION_ANGLE) {
+        // Parallel-flange approximation, sharp corners plus root fillet area.
+        // Heel / web back at y = 0, bottom at z = 0.
+        const double r = dim.radius;
+        RectSection rs = {};
+        double fillets = 0;
+        if (shape == SteelProfile::SECTION_CHANNEL) {
+            const double tw = dim.webThickness;
+            const double tf = dim.flangeThickness;
+            rs = { { 0, tw, tw }, { tw, b, b }, { 0, 0, h - tf }, { h, tf, h }, 3 };
+            fillets = 2;
+            props.perimeter = 2 * h + 4 * b - 2 * tw - (4 - M_PI) * r;
+        } else {
+            const double t = dim.thickness;
+            rs = { { 0, t, 0 }, { t, b, 0 }, { 0, 0, 0 }, { h, t, 0 }, 2 };
+            fillets = 1;
+            props.perimeter = 2 * (h + b) - (2 - M_PI / 2.0) * r;
+        }
+        props.area = rs.area() + fillets * (1.0 - M_PI / 4.0) * r * r;
+        props.Iy = rs.inertia(false);
+        props.Iz = rs.inertia(true);
+        props.Wply = rs.plasticModulus(false);
+        props.Wplz = rs.plasticModulus(true);
+        
+        const double zc = rs.centroid(false);
+        const double yc = rs.centroid(true);
+        ey = zc > h - zc ? zc : h - zc;
+        ez = yc > b - yc ? yc : b - yc;
+    } else {
+        // Rolled I/H section with four root fillets of radius r
+        const double tw = dim.webThickness;
+        const double tf = dim.flangeThickness;
+        const double r = dim.radius;
+        const double hw = h - 2 * tf;   // clear web height
+        
+        props.area = 2 * b * tf + hw * tw + (4 - M_PI) * r * r;
+        props.perimeter = 2 * h + 4 * b - 2 * tw + 2 * M_PI * r - 8 * r;
+        
+        props.Iy = (b * h * h * h - (b - tw) * hw * hw * hw) / 12.0
+                 + 0.03 * r * r * r * r
+                 + 0.2146 * r * r * (hw - 0.4468 * r) * (hw - 0.4468 * r);
+        props.Iz = (2 * tf * b * b * b + hw * tw * tw * tw) / 12.0
+                 + 0.03 * r * r * r * r
+                 + 0.2146 * r * r * (tw + 0.4468 * r) * (tw + 0.4468 * r);
+        props.Wply = tw * h * h / 4.0 + (b - tw) * (h - tf) * tf
+                   + (4 - M_PI) / 2.0 * r * r * hw
+                   + (3 * M_PI - 10) / 3.0 * r * r * r;
+        props.Wplz = b * b * tf / 2.0 + hw * tw * tw / 4.0
+                   + (10.0 / 3.0 - M_PI) * r * r * r
+                   + (2 - M_PI / 2.0) * tw * r * r;
+    }
+    
+    props.Wely = ey > 0 ? props.Iy / ey : 0.0;
+    props.Welz = ez > 0 ? props.Iz / ez : 0.0;
+    props.weightPerMetre = props.area * 1e-6 * kSteelDensity;
+    return props;
+}
+
+constexpr SteelProfile::CatalogEntry ishape(const char* name, double h, double b, double tw, double tf, double r)
+{
+    return { name, fnv1a(name), { h, b, tw, tf, r, 0 },
+             sectionPropertiesOf(SteelProfile::SECTION_I, { h, b, tw, tf, r, 0 }) };
+}
+
+constexpr SteelProfile::CatalogEntry rhs(const char* name, double h, double b, double t)
+{
+    return { name, fnv1a(name), { h, b, 0, 0, 0, t },
+             sectionPropertiesOf(SteelProfile::SECTION_RHS, { h, b, 0, 0, 0, t }) };
+}
+
+// IPE Profiles (European I-beams)
+constexpr SteelProfile::CatalogEntry kIpeProfiles[] = {
+    ishape("IPE 80",     80, 46, 3.8, 5.2, 5),
+    ishape("IPE 100",    100, 55, 4.1, 5.7, 7),
+    ishape("IPE 120",    120, 64, 4.4, 6.3, 7),
+    ishape("IPE 140",    140, 73, 4.7, 6.9, 7),
+    ishape("IPE 160",    160, 82, 5.0, 7.4, 9),
+    ishape("IPE 180",    180, 91, 5.3, 8.0, 9),
+    ishape("IPE 200",    200, 100, 5.6, 8.5, 12),
+    ishape("IPE 220",    220, 110, 5.9, 9.2, 12),
+    ishape("IPE 240",    240, 120, 6.2, 9.8, 15),
+    ishape("IPE 270",    270, 135, 6.6, 10.2, 15),
+    ishape("IPE 300",    300, 150, 7.1, 10.7, 15),
+    ishape("IPE 330",    330, 160, 7.5, 11.5, 18),
+    ishape("IPE 360",    360, 170, 8.0, 12.7, 18),
+    ishape("IPE 400",    400, 180, 8.6, 13.5, 21),
+    ishape("IPE 450",    450, 190, 9.4, 14.6, 21),
+    ishape("IPE 500",    500, 200, 10.2, 16.0, 21),
+    ishape("IPE 550",    550, 210, 11.1, 17.2, 24),
+    ishape("IPE 600",    600, 220, 12.0, 19.0, 24),
+};
+
+// HEA Profiles (European wide flange - light)
+constexpr SteelProfile::CatalogEntry kHeaProfiles[] = {
+    ishape("HEA 100",    96, 100, 5.0, 8.0, 12),
+    ishape("HEA 120",    114, 120, 5.0, 8.0, 12),
+    ishape("HEA 140",    133, 140, 5.5, 8.5, 12),
+    ishape("HEA 160",    152, 160, 6.0, 9.0, 15),
+    ishape("HEA 180",    171, 180, 6.0, 9.5, 15),
+    ishape("HEA 200",    190, 200, 6.5, 10.0, 18),
+    ishape("HEA 220",    210, 220, 7.0, 11.0, 18),
+    ishape("HEA 240",    230, 240, 7.5, 12.0, 21),
+    ishape("HEA 260",    250, 260, 7.5, 12.5, 24),
+    ishape("HEA 280",    270, 280, 8.0, 13.0, 24),
+    ishape("HEA 300",    290, 300, 8.5, 14.0, 27),
+    ishape("HEA 320",    310, 300, 9.0, 15.5, 27),
+    ishape("HEA 340",    330, 300, 9.5, 16.5, 27),
+    ishape("HEA 360",    350, 300, 10.0, 17.5, 27),
+    ishape("HEA 400",    390, 300, 11.0, 19.0, 27),
+    ishape("HEA 450",    440, 300, 11.5, 21.0, 27),
+    ishape("HEA 500",    490, 300, 12.0, 23.0, 27),
+};
+
+// HEB Profiles (European wide flange - medium)
+constexpr SteelProfile::CatalogEntry kHebProfiles[] = {
+    ishape("HEB 100",    100, 100, 6.0, 10.0, 12),
+    ishape("HEB 120",    120, 120, 6.5, 11.0, 12),
+    ishape("HEB 140",    140, 140, 7.0, 12.0, 12),
+    ishape("HEB 160",    160, 160, 8.0, 13.0, 15),
+    ishape("HEB 180",    180, 180, 8.5, 14.0, 15),
+    ishape("HEB 200",    200, 200, 9.0, 15.0, 18),
+    ishape("HEB 220",    220, 220, 9.5, 16.0, 18),
+    ishape("HEB 240",    240, 240, 10.0, 17.0, 21),
+    ishape("HEB 260",    260, 260, 10.0, 17.5, 24),
+    ishape("HEB 280",    280, 280, 10.5, 18.0, 24),
+    ishape("HEB 300",    300, 300, 11.0, 19.0, 27),
+    ishape("HEB 320",    320, 300, 11.5, 20.5, 27),
+    ishape("HEB 340",    340, 300, 12.0, 21.5, 27),
+    ishape("HEB 360",    360, 300, 12.5, 22.5, 27),
+    ishape("HEB 400",    400, 300, 13.5, 24.0, 27),
+    ishape("HEB 450",    450, 300, 14.0, 26.0, 27),
+    ishape("HEB 500",    500, 300, 14.5, 28.0, 27),
+};
+
+// HEM Profiles (European wide flange - heavy)
+constexpr SteelProfile::CatalogEntry kHemProfiles[] = {
+    ishape("HEM 100",    120, 106, 12.0, 20.0, 12),
+    ishape("HEM 120",    140, 126, 12.5, 21.0, 12),
+    ishape("HEM 140",    160, 146, 13.0, 22.0, 12),
+    ishape("HEM 160",    180, 166, 14.0, 23.0, 15),
+    ishape("HEM 180",    200, 186, 14.5, 24.0, 15),
+    ishape("HEM 200",    220, 206, 15.0, 25.0, 18),
+    ishape("HEM 220",    240, 226, 15.5, 26.0, 18),
+    ishape("HEM 240",    270, 248, 18.0, 32.0, 21),
+    ishape("HEM 260",    290, 268, 18.0, 32.5, 24),
+    ishape("HEM 280",    310, 288, 18.5, 33.0, 24),
+    ishape("HEM 300",    340, 310, 21.0, 39.0, 27),
+    ishape("HEM 320",    359, 309, 21.0, 40.0, 27),
+    ishape("HEM 340",    377, 309, 21.0, 40.0, 27),
+    ishape("HEM 360",    395, 308, 21.0, 40.0, 27),
+};
+
+// RHS Profiles (Rectangular Hollow Sections)
+constexpr SteelProfile::CatalogEntry kRhsProfiles[] = {
+    rhs("RHS 50x30x3",   50, 30, 3.0),
+    rhs("RHS 60x40x3",   60, 40, 3.0),
+    rhs("RHS 80x40x3",   80, 40, 3.0),
+    rhs("RHS 80x60x3",   80, 60, 3.0),
+    rhs("RHS 100x50x4",  100, 50, 4.0),
+    rhs("RHS 100x60x4",  100, 60, 4.0),
+    rhs("RHS 120x80x5",  120, 80, 5.0),
+    rhs("RHS 140x80x5",  140, 80, 5.0),
+    rhs("RHS 150x100x5", 150, 100, 5.0),
+    rhs("RHS 160x80x5",  160, 80, 5.0),
+    rhs("RHS 180x100x6", 180, 100, 6.0),
+    rhs("RHS 200x100x6", 200, 100, 6.0),
+    rhs("RHS 200x120x6", 200, 120, 6.0),
+    rhs("RHS 250x150x8", 250, 150, 8.0),
+    rhs("RHS 300x200x10", 300, 200, 10.0),
+};
+
+template <int N>
+constexpr bool hashesUnique(const SteelProfile::CatalogEntry (&table)[N])
+{
+    for (int i = 0; i < N; ++i)
+        for (int j = i + 1; j < N; ++j)
+            if (table[i].nameHash == table[j].nameHash)
+                return false;
+    return true;
+}
+
+static_assert(hashesUnique(kIpeProfiles) && hashesUnique(kHeaProfiles) && hashesUnique(kHebProfiles) &&
+              hashesUnique(kHemProfiles) && hashesUnique(kRhsProfiles),
+              "profile name hashes must be unique within a type");
+
+struct CatalogTable {
+    const SteelProfile::CatalogEntry* entries;
+    int count;
+    int defaultIndex;
+};
+
+template <int N>
+constexpr CatalogTable makeTable(const SteelProfile::CatalogEntry (&table)[N], int defaultIndex)
+{
+    return { table, N, defaultIndex };
+}
+
+// Defaults match the sizes used when an unknown name is requested
+constexpr CatalogTable kTables[] = {
+    makeTable(kIpeProfiles, 6),     // IPE 200
+    makeTable(kHeaProfiles, 5),     // HEA 200
+    makeTable(kHebProfiles, 5),     // HEB 200
+    makeTable(kHemProfiles, 5),     // HEM 200
+    makeTable(kRhsProfiles, 4)      // RHS 100x50x4
+};
+
+const CatalogTable& tableFor(SteelProfile::ProfileType type)
+{
+    int index = static_cast<int>(type);
+    if (index < 0 || index >= static_cast<int>(sizeof(kTables) / sizeof(kTables[0]))) {
+        index = 0;
+    }
+    return kTables[index];
+}
+
+} // namespace
+
+const double SteelProfile::SteelDensity = kSteelDensity;
+
+int SteelProfile::getSizeCount(ProfileType type)
+{
+    if (type == LIBRARY) {
+        return ProfileLibrary::instance().count();
+    }
+    return tableFor(type).count;
+}
+
+int SteelProfile::getDefaultSizeIndex(ProfileType type)
+{
+    if (type == LIBRARY) {
+        return 0;
+    }
+    return tableFor(type).defaultIndex;
+}
+
+const SteelProfile::CatalogEntry& SteelProfile::getEntry(ProfileType type, int index)
+{
+    const CatalogTable& table = tableFor(type);
+    if (index < 0 || index >= table.count) {
+        index = table.defaultIndex;
+    }
+    return table.entries[index];
+}
+
+int SteelProfile::findSizeIndex(ProfileType type, const QString& size)
+{
+    if (type == LIBRARY) {
+        return ProfileLibrary::instance().find(size);
+    }
+    
+    // Hash the UTF-16 name in place (catalogue names are ASCII) - no allocation
+    quint32 h = 2166136261u;
+    const QChar* c = size.constData();
+    for (int i = 0; i < size.size(); ++i) {
+        h ^= static_cast<unsigned char>(c[i].unicode());
+        h *= 16777619u;
+    }
+    
+    const CatalogTable& table = tableFor(type);
+    for (int i = 0; i < table.count; ++i) {
+        if (table.entries[i].nameHash == h && size == QLatin1String(table.entries[i].name)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const SteelProfile::Dimensions& SteelProfile::getDimensions(ProfileType type, int index)
+{
+    if (type == LIBRARY) {
+        const ProfileLibrary& library = ProfileLibrary::instance();
+        if (index >= 0 && index < library.count()) {
+            return library.record(index).dim;
+        }
+        // Missing library entry: fall back to the IPE default
+        return getEntry(IPE, -1).dim;
+    }
+    return getEntry(type, index).dim;
+}
+
+const SteelProfile::SectionProperties& SteelProfile::getSectionProperties(ProfileType type, int index)
+{
+    if (type == LIBRARY) {
+        const ProfileLibrary& library = ProfileLibrary::instance();
+        if (index >= 0 && index < library.count()) {
+            return library.record(index).props;
+        }
+        return getEntry(IPE, -1).props;
+    }
+    return getEntry(type, index).props;
+}
+
+SteelProfile::SectionDescriptor SteelProfile::getSection(ProfileType type, int index)
+{
+    SectionDescriptor section = { getSectionShape(type), getDimensions(type, index) };
+    if (type == LIBRARY) {
+        const ProfileLibrary& library = ProfileLibrary::instance();
+        section.shape = (index >= 0 && index < library.count())
+                      ? static_cast<SectionShape>(library.record(index).shape)
+                      : SECTION_I;
+    }
+    return section;
+}
+
+SteelProfile::SectionShape SteelProfile::getSectionShape(ProfileType type)
+{
+    return type == RHS ? SECTION_RHS : SECTION_I;
+}
+
+SteelProfile::SectionProperties SteelProfile::computeSectionProperties(ProfileType type, const Dimensions& dim)
+{
+    return sectionPropertiesOf(getSectionShape(type), dim);
+}
+
+SteelProfile::SectionProperties SteelProfile::computeSectionProperties(const SectionDescriptor& section)
+{
+    return sectionPropertiesOf(section.shape, section.dim);
+}
+
+SteelProfile::SectionProperties SteelProfile::computeRectangularProperties(double width, double height)
+{
+    SectionProperties props = {};
+    props.area = width * height;
+    props.perimeter = 2 * (width + height);
+    props.Iy = width * height * height * height / 12.0;
+    props.Iz = height * width * width * width / 12.0;
+    props.Wely = width * height * height / 6.0;
+    props.Welz = height * width * width / 6.0;
+    props.Wply = width * height * height / 4.0;
+    props.Wplz = height * width * width / 4.0;
+    props.weightPerMetre = props.area * 1e-6 * kSteelDensity;
+    return props;
+}
+
+const SteelProfile::Dimensions& SteelProfile::getDimensions(ProfileType type, const QString& size)
+{
+    return getDimensions(type, findSizeIndex(type, size));
+}
+
+const SteelProfile::SectionProperties& SteelProfile::getSectionProperties(ProfileType type, const QString& size)
+{
+    return getSectionProperties(type, findSizeIndex(type, size));
+}
+
+SteelProfile::SectionDescriptor SteelProfile::getSection(ProfileType type, const QString& size)
+{
+    return getSection(type, findSizeIndex(type, size));
 }
 
 TopoDS_Shape SteelProfile::createProfile(ProfileType type, const QString& size, 
                                          const gp_Pnt& start, const gp_Pnt& end)
 {
-    initializeProfiles();
+    return createProfile(getSection(type, size), start, end);
+}
+
+TopoDS_Shape SteelProfile::createProfile(const SectionDescriptor& section,
+                                         const gp_Pnt& start, const gp_Pnt& end)
+{
+    const Dimensions& dim = section.dim;
     
-    Dimensions dim = getDimensions(type, size);
+    LOG_DEBUG("profile", "createProfile shape %1, length %2 mm, h=%3 b=%4 tw=%5 tf=%6 t=%7",
+              static_cast<int>(section.shape), start.Distance(end), dim.height, dim.width,
+              dim.webThickness, dim.flangeThickness, dim.thickness);
     
-    if (type == RHS) {
-        return createRHSProfile(dim, start, end);
-    } else {
-        return createIProfile(dim, start, end);
+    TopoDS_Face face = createSectionFace(section);
+    if (face.IsNull()) {
+        LOG_ERROR("profile", "Could not build section face");
+        return TopoDS_Shape();
+    }
+    
+    return extrudeSection(face, start, end);
+}
+
+TopoDS_Face SteelProfile::createSectionFace(const SectionDescriptor& section)
+{
+    switch (section.shape) {
+        case SECTION_I:       return createIFace(section.dim);
+        case SECTION_CHANNEL: return createChannelFace(section.dim);
+        case SECTION_ANGLE:   return createAngleFace(section.dim);
+        case SECTION_RHS:     return createRHSFace(section.dim);
+        case SECTION_CHS:     return createCHSFace(section.dim);
     }
+    return TopoDS_Face();
 }
 
-TopoDS_Shape SteelProfile::createIProfile(const Dimensions& dim, const gp_Pnt& start, const gp_Pnt& end)
+TopoDS_Face SteelProfile::createIFace(const Dimensions& dim)
 {
     double h = dim.height;      // Total height (vertical)
     double b = dim.width;       // Flange width (horizontal)
@@ -182,68 +584,67 @@ TopoDS_Shape SteelProfile::createIProfile(const Dimensions& dim, const gp_Pnt& s
     wiremaker.Add(BRepBuilderAPI_MakeEdge(p11, p12));
     wiremaker.Add(BRepBuilderAPI_MakeEdge(p12, p1));
     
-    TopoDS_Wire wire = wiremaker.Wire();
-    TopoDS_Face face = BRepBuilderAPI_MakeFace(wire);
-    
-    // Calculate beam direction and length
-    gp_Vec direction(start, end);
-    double length = direction.Magnitude();
-    
-    // Log to file
-    QFile logFile("beam_debug.log");
-    if (logFile.open(QIODevice::Append | QIODevice::Text)) {
-        QTextStream out(&logFile);
-        out << "  SteelProfile::createIProfile called\n";
-        out << "  Start: (" << start.X() << ", " << start.Y() << ", " << start.Z() << ")\n";
-        out << "  End: (" << end.X() << ", " << end.Y() << ", " << end.Z() << ")\n";
-        out << "  Length: " << length << " mm\n";
-        out << "  Profile: h=" << h << " b=" << b << " tw=" << tw << " tf=" << tf << "\n";
-        logFile.close();
-    }
-    
-    qDebug() << "SteelProfile: Start point" << start.X() << start.Y() << start.Z();
-    qDebug() << "SteelProfile: End point" << end.X() << end.Y() << end.Z();
-    qDebug() << "SteelProfile: Length" << length;
-    qDebug() << "SteelProfile: Profile dimensions - h:" << h << "b:" << b << "tw:" << tw << "tf:" << tf;
-    
-    if (length < 1e-6) {
-        qDebug() << "SteelProfile: ERROR - Length too small:" << length;
-        return TopoDS_Shape();
-    }
+    return BRepBuilderAPI_MakeFace(wiremaker.Wire());
+}
+
+TopoDS_Face SteelProfile::createChannelFace(const Dimensions& dim)
+{
+    double h = dim.height;
+    double b = dim.width;
+    double tw = dim.webThickness;
+    double tf = dim.flangeThickness;
     
-    // Extrude along X-axis (profile is in YZ plane)
-    gp_Vec extrudeVec(length, 0, 0);
-    TopoDS_Shape profile = BRepPrimAPI_MakePrism(face, extrudeVec);
+    // Web on the -Y side, flanges pointing towards +Y
+    double y0 = -b/2;
+    gp_Pnt p1(0, y0, 0);
+    gp_Pnt p2(0, b/2, 0);
+    gp_Pnt p3(0, b/2, tf);
+    gp_Pnt p4(0, y0 + tw, tf);
+    gp_Pnt p5(0, y0 + tw, h - tf);
+    gp_Pnt p6(0, b/2, h - tf);
+    gp_Pnt p7(0, b/2, h);
+    gp_Pnt p8(0, y0, h);
     
-    // Create transformation to align with beam direction
-    // The profile's local X-axis should align with beam direction
-    gp_Trsf transform;
+    BRepBuilderAPI_MakeWire wiremaker;
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p1, p2));
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p2, p3));
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p3, p4));
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p4, p5));
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p5, p6));
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p6, p7));
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p7, p8));
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p8, p1));
     
-    // First translate to start point
-    transform.SetTranslation(gp_Vec(gp_Pnt(0,0,0), start));
-    BRepBuilderAPI_Transform step1(profile, transform, Standard_False);
-    profile = step1.Shape();
+    return BRepBuilderAPI_MakeFace(wiremaker.Wire());
+}
+
+TopoDS_Face SteelProfile::createAngleFace(const Dimensions& dim)
+{
+    double h = dim.height;      // Vertical leg
+    double b = dim.width;       // Horizontal leg
+    double t = dim.thickness;
     
-    // Now rotate to align with beam direction
-    gp_Vec localX(1, 0, 0);  // Profile's extrusion direction
-    direction.Normalize();
+    // Heel at (-b/2, 0)
+    double y0 = -b/2;
+    gp_Pnt p1(0, y0, 0);
+    gp_Pnt p2(0, b/2, 0);
+    gp_Pnt p3(0, b/2, t);
+    gp_Pnt p4(0, y0 + t, t);
+    gp_Pnt p5(0, y0 + t, h);
+    gp_Pnt p6(0, y0, h);
     
-    double angle = localX.Angle(direction);
-    if (angle > 1e-6) {
-        gp_Vec rotAxis = localX.Crossed(direction);
-        if (rotAxis.Magnitude() > 1e-6) {
-            rotAxis.Normalize();
-            gp_Trsf rotation;
-            rotation.SetRotation(gp_Ax1(start, gp_Dir(rotAxis)), angle);
-            BRepBuilderAPI_Transform step2(profile, rotation, Standard_False);
-            profile = step2.Shape();
-        }
-    }
+    BRepBuilderAPI_MakeWire wiremaker;
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p1, p2));
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p2, p3));
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p3, p4));
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p4, p5));
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p5, p6));
+    wiremaker.Add(BRepBuilderAPI_MakeEdge(p6, p1));
     
-    return profile;
+    return BRepBuilderAPI_MakeFace(wiremaker.Wire());
 }
 
-TopoDS_Shape SteelProfile::createRHSProfile(const Dimensions& dim, const gp_Pnt& start, const gp_Pnt& end)
+TopoDS_Face SteelProfile::createRHSFace(const Dimensions& dim)
 {
     double h = dim.height;
     double b = dim.width;
@@ -264,7 +665,6 @@ TopoDS_Shape SteelProfile::createRHSProfile(const Dimensions& dim, const gp_Pnt&
     
     // Create inner rectangle (hollow part) in YZ plane
     double bi = b - 2*t;
-    double hi = h - 2*t;
     gp_Pnt pi1(0, -bi/2, t);
     gp_Pnt pi2(0, bi/2, t);
     gp_Pnt pi3(0, bi/2, h - t);
@@ -279,13 +679,38 @@ TopoDS_Shape SteelProfile::createRHSProfile(const Dimensions& dim, const gp_Pnt&
     // Create face with hole
     BRepBuilderAPI_MakeFace facemaker(outerWire.Wire());
     facemaker.Add(innerWire.Wire());
-    TopoDS_Face face = facemaker.Face();
+    return facemaker.Face();
+}
+
+TopoDS_Face SteelProfile::createCHSFace(const Dimensions& dim)
+{
+    double radius = dim.height / 2;
+    double t = dim.thickness;
+    if (radius <= t) {
+        return TopoDS_Face();
+    }
     
+    // Circle centred at mid-height, lying in the YZ plane
+    gp_Ax2 axis(gp_Pnt(0, 0, radius), gp_Dir(1, 0, 0));
+    TopoDS_Wire outerWire = BRepBuilderAPI_MakeWire(
+        BRepBuilderAPI_MakeEdge(gp_Circ(axis, radius)));
+    TopoDS_Wire innerWire = BRepBuilderAPI_MakeWire(
+        BRepBuilderAPI_MakeEdge(gp_Circ(axis, radius - t)));
+    
+    // The hole must run opposite to the outer boundary
+    BRepBuilderAPI_MakeFace facemaker(outerWire);
+    facemaker.Add(TopoDS::Wire(innerWire.Reversed()));
+    return facemaker.Face();
+}
+
+TopoDS_Shape SteelProfile::extrudeSection(const TopoDS_Face& face, const gp_Pnt& start, const gp_Pnt& end)
+{
     // Calculate beam direction and length
     gp_Vec direction(start, end);
     double length = direction.Magnitude();
     
     if (length < 1e-6) {
+        LOG_ERROR("profile", "Length too small: %1", length);
         return TopoDS_Shape();
     }
     
@@ -294,6 +719,7 @@ TopoDS_Shape SteelProfile::createRHSProfile(const Dimensions& dim, const gp_Pnt&
     TopoDS_Shape profile = BRepPrimAPI_MakePrism(face, extrudeVec);
     
     // Create transformation to align with beam direction
+    // The profile's local X-axis should align with beam direction
     gp_Trsf transform;
     
     // First translate to start point
@@ -308,13 +734,12 @@ TopoDS_Shape SteelProfile::createRHSProfile(const Dimensions& dim, const gp_Pnt&
     double angle = localX.Angle(direction);
     if (angle > 1e-6) {
         gp_Vec rotAxis = localX.Crossed(direction);
-        if (rotAxis.Magnitude() > 1e-6) {
-            rotAxis.Normalize();
-            gp_Trsf rotation;
-            rotation.SetRotation(gp_Ax1(start, gp_Dir(rotAxis)), angle);
-            BRepBuilderAPI_Transform step2(profile, rotation, Standard_False);
-            profile = step2.Shape();
-        }
+        // Anti-parallel to X: any perpendicular axis works, keep the section upright
+        gp_Dir axisDir = rotAxis.Magnitude() > 1e-6 ? gp_Dir(rotAxis) : gp_Dir(0, 0, 1);
+        gp_Trsf rotation;
+        rotation.SetRotation(gp_Ax1(start, axisDir), angle);
+        BRepBuilderAPI_Transform step2(profile, rotation, Standard_False);
+        profile = step2.Shape();
     }
     
     return profile;
@@ -322,49 +747,26 @@ TopoDS_Shape SteelProfile::createRHSProfile(const Dimensions& dim, const gp_Pnt&
 
 QStringList SteelProfile::getAvailableSizes(ProfileType type)
 {
-    initializeProfiles();
+    if (type == LIBRARY) {
+        // Large catalogues should be browsed through ProfileLibrary directly
+        const ProfileLibrary& library = ProfileLibrary::instance();
+        QStringList sizes;
+        sizes.reserve(library.count());
+        for (int i = 0; i < library.count(); ++i) {
+            sizes << library.name(i);
+        }
+        return sizes;
+    }
     
+    const CatalogTable& table = tableFor(type);
     QStringList sizes;
-    switch (type) {
-        case IPE:
-            sizes = s_ipeProfiles.keys();
-            break;
-        case HEA:
-            sizes = s_heaProfiles.keys();
-            break;
-        case HEB:
-            sizes = s_hebProfiles.keys();
-            break;
-        case HEM:
-            sizes = s_hemProfiles.keys();
-            break;
-        case RHS:
-            sizes = s_rhsProfiles.keys();
-            break;
+    sizes.reserve(table.count);
+    for (int i = 0; i < table.count; ++i) {
+        sizes << QLatin1String(table.entries[i].name);
     }
-    sizes.sort();
     return sizes;
 }
 
-SteelProfile::Dimensions SteelProfile::getDimensions(ProfileType type, const QString& size)
-{
-    initializeProfiles();
-    
-    switch (type) {
-        case IPE:
-            return s_ipeProfiles.value(size, {200, 100, 5.6, 8.5, 12, 0});
-        case HEA:
-            return s_heaProfiles.value(size, {200, 200, 6.5, 10.0, 18, 0});
-        case HEB:
-            return s_hebProfiles.value(size, {200, 200, 9.0, 15.0, 18, 0});
-        case HEM:
-            return s_hemProfiles.value(size, {220, 206, 15.0, 25.0, 18, 0});
-        case RHS:
-            return s_rhsProfiles.value(size, {100, 50, 0, 0, 0, 4.0});
-    }
-    return {200, 100, 5.6, 8.5, 12, 0};
-}
-
 QString SteelProfile::getProfileName(ProfileType type, const QString& size)
 {
     return size;
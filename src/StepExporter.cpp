@@ -0,0 +1,150 @@
+#include "StepExporter.h"
+#include "Logger.h"
+#include <IFSelect_ReturnStatus.hxx>
+#include <Interface_Static.hxx>
+#include <Quantity_Color.hxx>
+#include <STEPCAFControl_Writer.hxx>
+#include <Standard_Failure.hxx>
+#include <TCollection_ExtendedString.hxx>
+#include <TDataStd_Name.hxx>
+#include <TDF_Label.hxx>
+#include <TDocStd_Document.hxx>
+#include <TopLoc_Location.hxx>
+#include <XCAFApp_Application.hxx>
+#include <XCAFDoc_ColorTool.hxx>
+#include <XCAFDoc_DocumentTool.hxx>
+#include <XCAFDoc_ShapeTool.hxx>
+#include <QHash>
+#include <cmath>
+
+namespace {
+
+struct Part {
+    TDF_Label label;
+    Quantity_Color color;
+};
+
+// STEP places instances by rigid motions only; mirrored, scaled or
+// reversed shapes are written as parts of their own
+bool isInstantiable(const TopoDS_Shape& shape)
+{
+    const gp_Trsf& trsf = shape.Location().Transformation();
+    return shape.Orientation() == TopAbs_FORWARD
+        && std::abs(trsf.ScaleFactor() - 1.0) < 1e-9
+        && !trsf.IsNegative();
+}
+
+TCollection_ExtendedString toExtended(const QString& text)
+{
+    return TCollection_ExtendedString(text.toUtf8().constData(), Standard_True);
+}
+
+Quantity_Color objectColor(const Handle(TGraphicObject)& object)
+{
+    int r, g, b;
+    object->GetColor(r, g, b);
+    return Quantity_Color(r / 255.0, g / 255.0, b / 255.0, Quantity_TOC_RGB);
+}
+
+} // namespace
+
+StepExporter::StepExporter(const Options& options)
+    : m_options(options)
+    , m_partCount(0)
+    , m_instanceCount(0)
+{
+}
+
+bool StepExporter::exportObjects(const NCollection_Sequence<Handle(TGraphicObject)>& objects, const QString& fileName)
+{
+    m_error.clear();
+    m_partCount = 0;
+    m_instanceCount = 0;
+
+    if (objects.IsEmpty()) {
+        m_error = "There are no objects to export";
+        return false;
+    }
+
+    Handle(XCAFApp_Application) app = XCAFApp_Application::GetApplication();
+    Handle(TDocStd_Document) doc;
+    app->NewDocument("MDTV-XCAF", doc);
+
+    bool ok = true;
+    try {
+        Handle(XCAFDoc_ShapeTool) shapeTool = XCAFDoc_DocumentTool::ShapeTool(doc->Main());
+        Handle(XCAFDoc_ColorTool) colorTool = XCAFDoc_DocumentTool::ColorTool(doc->Main());
+
+        TDF_Label model = shapeTool->NewShape();
+        TDataStd_Name::Set(model, "Model");
+
+        // One part per shared TShape; members only add a located reference
+        QHash<const TopoDS_TShape*, Part> parts;
+        for (int i = 1; i <= objects.Length(); ++i) {
+            const Handle(TGraphicObject)& object = objects.Value(i);
+            if (object.IsNull() || object->GetShape().IsNull()) {
+                continue;
+            }
+
+            const TopoDS_Shape& shape = object->GetShape();
+            const Quantity_Color color = objectColor(object);
+            Part part;
+            TopLoc_Location placement;
+
+            if (m_options.instancing && isInstantiable(shape)) {
+                part = parts.value(shape.TShape().get());
+                if (part.label.IsNull()) {
+                    part.label = shapeTool->AddShape(shape.Located(TopLoc_Location()), Standard_False, Standard_False);
+                    part.color = color;
+                    const QString mark = object->GetPartMark();
+                    TDataStd_Name::Set(part.label, toExtended(mark.isEmpty() ? object->GetTypeName() : mark));
+                    colorTool->SetColor(part.label, color, XCAFDoc_ColorGen);
+                    parts.insert(shape.TShape().get(), part);
+                    ++m_partCount;
+                }
+                placement = shape.Location();
+            } else {
+                part.label = shapeTool->AddShape(shape, Standard_False, Standard_False);
+                part.color = color;
+                TDataStd_Name::Set(part.label, toExtended(object->GetName()));
+                colorTool->SetColor(part.label, color, XCAFDoc_ColorGen);
+                ++m_partCount;
+            }
+
+            TDF_Label instance = shapeTool->AddComponent(model, part.label, placement);
+            TDataStd_Name::Set(instance, toExtended(object->GetName()));
+            if (!color.IsEqual(part.color)) {
+                colorTool->SetColor(instance, color, XCAFDoc_ColorGen);
+            }
+            ++m_instanceCount;
+        }
+        LOG_DEBUG("export", "STEP: added %1 objects as %2 parts", m_instanceCount, m_partCount);
+        shapeTool->UpdateAssemblies();
+
+        // The writer initialises the STEP statics, so set them afterwards
+        STEPCAFControl_Writer writer;
+        writer.SetColorMode(Standard_True);
+        writer.SetNameMode(Standard_True);
+        Interface_Static::SetCVal("write.step.schema", m_options.schema == AP242 ? "AP242DIS" : "AP214IS");
+        Interface_Static::SetCVal("write.step.unit", "MM");
+
+        if (!writer.Transfer(doc, STEPControl_AsIs)) {
+            m_error = "STEP translation failed";
+            ok = false;
+        } else if (writer.Write(fileName.toUtf8().constData()) != IFSelect_RetDone) {
+            m_error = QString("Cannot write %1").arg(fileName);
+            ok = false;
+        }
+    } catch (Standard_Failure const& ex) {
+        m_error = QString("STEP export failed: %1").arg(ex.GetMessageString());
+        ok = false;
+    }
+    app->Close(doc);
+
+    if (ok) {
+        LOG_INFO("export", "Wrote %1 objects as %2 parts to %3", m_instanceCount, m_partCount, fileName);
+    } else {
+        LOG_ERROR("export", "%1", m_error);
+    }
+    return ok;
+}
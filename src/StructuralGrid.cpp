@@ -0,0 +1,303 @@
+#include "StructuralGrid.h"
+#include <BRepBuilderAPI_MakeEdge.hxx>
+#include <BRep_Builder.hxx>
+#include <TopoDS_Compound.hxx>
+#include <Prs3d_Drawer.hxx>
+#include <Prs3d_LineAspect.hxx>
+#include <TCollection_ExtendedString.hxx>
+#include <Quantity_Color.hxx>
+#include <QRegularExpression>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+bool axisLess(const StructuralGrid::Axis& lhs, const StructuralGrid::Axis& rhs)
+{
+    return lhs.position < rhs.position;
+}
+
+gp_Pnt planePoint(const gp_Ax3& plane, double u, double v)
+{
+    return gp_Pnt(plane.Location().XYZ() + u * plane.XDirection().XYZ() + v * plane.YDirection().XYZ());
+}
+
+// Bijective base-26: A=0 ... Z=25, AA=26 ...
+int lettersToIndex(const QString& letters)
+{
+    int index = 0;
+    for (QChar c : letters) {
+        index = index * 26 + (c.toUpper().unicode() - 'A' + 1);
+    }
+    return index - 1;
+}
+
+QString indexToLetters(int index)
+{
+    QString letters;
+    for (++index; index > 0; index = (index - 1) / 26) {
+        letters.prepend(QChar('A' + (index - 1) % 26));
+    }
+    return letters;
+}
+
+} // namespace
+
+StructuralGrid::StructuralGrid()
+    : m_extension(2000.0)
+{
+}
+
+QVector<double> StructuralGrid::parseCoordinates(const QString& text, bool* ok)
+{
+    QVector<double> positions;
+    if (ok) *ok = false;
+    
+    const QStringList tokens = text.split(QRegularExpression("[\\s;]+"), QString::SkipEmptyParts);
+    double current = 0.0;
+    for (int i = 0; i < tokens.size(); ++i) {
+        const QString& token = tokens[i];
+        int repeat = 1;
+        QString value = token;
+        const int star = token.indexOf('*');
+        if (star >= 0) {
+            bool repeatOk = false;
+            repeat = token.left(star).toInt(&repeatOk);
+            value = token.mid(star + 1);
+            if (!repeatOk || repeat < 1) {
+                return QVector<double>();
+            }
+        }
+        
+        bool valueOk = false;
+        const double number = value.toDouble(&valueOk);
+        if (!valueOk) {
+            return QVector<double>();
+        }
+        
+        // A leading plain value is the start coordinate, everything else a spacing
+        if (i == 0 && star < 0) {
+            current = number;
+            positions.append(current);
+            continue;
+        }
+        if (positions.isEmpty()) {
+            positions.append(current);
+        }
+        for (int r = 0; r < repeat; ++r) {
+            current += number;
+            positions.append(current);
+        }
+    }
+    
+    if (ok) *ok = true;
+    return positions;
+}
+
+QString StructuralGrid::formatCoordinates(const QVector<double>& positions)
+{
+    if (positions.isEmpty()) {
+        return QString();
+    }
+    
+    // Start value, then runs of equal spacing collapsed to n*d
+    QStringList parts;
+    parts << QString::number(positions[0]);
+    int i = 1;
+    while (i < positions.size()) {
+        const double spacing = positions[i] - positions[i - 1];
+        int run = 1;
+        while (i + run < positions.size()
+               && std::abs((positions[i + run] - positions[i + run - 1]) - spacing) < 1e-6) {
+            ++run;
+        }
+        parts << (run > 1 ? QString("%1*%2").arg(run).arg(spacing) : QString::number(spacing));
+        i += run;
+    }
+    return parts.join(' ');
+}
+
+QStringList StructuralGrid::makeLabels(Direction direction, const QString& labels, int count)
+{
+    QStringList given = labels.split(QRegularExpression("\\s+"), QString::SkipEmptyParts);
+    QStringList result;
+    
+    if (given.size() > 1) {
+        for (int i = 0; i < count; ++i) {
+            result << (i < given.size() ? given[i] : QString::number(i + 1));
+        }
+        return result;
+    }
+    
+    // A single label (or none) is the first of a sequence
+    const QString start = given.isEmpty() ? QString(direction == U ? "1" : "A") : given[0];
+    bool numeric = false;
+    const int first = start.toInt(&numeric);
+    const bool letters = !numeric && QRegularExpression("^[A-Za-z]+$").match(start).hasMatch();
+    for (int i = 0; i < count; ++i) {
+        if (numeric) {
+            result << QString::number(first + i);
+        } else if (letters) {
+            result << indexToLetters(lettersToIndex(start) + i);
+        } else {
+            result << QString("%1%2").arg(start).arg(i + 1);
+        }
+    }
+    return result;
+}
+
+bool StructuralGrid::setAxes(Direction direction, const QString& coordinates, const QString& labels)
+{
+    bool ok = false;
+    QVector<double> positions = parseCoordinates(coordinates, &ok);
+    if (!ok) {
+        return false;
+    }
+    setAxes(direction, positions, makeLabels(direction, labels, positions.size()));
+    return true;
+}
+
+void StructuralGrid::setAxes(Direction direction, const QVector<double>& positions, const QStringList& labels)
+{
+    const QStringList names = labels.size() == positions.size()
+                            ? labels : makeLabels(direction, QString(), positions.size());
+    QVector<Axis>& target = direction == U ? m_u : m_v;
+    target.clear();
+    target.reserve(positions.size());
+    for (int i = 0; i < positions.size(); ++i) {
+        target.append({ positions[i], names[i] });
+    }
+    std::stable_sort(target.begin(), target.end(), axisLess);
+}
+
+void StructuralGrid::clear()
+{
+    m_u.clear();
+    m_v.clear();
+}
+
+QString StructuralGrid::coordinatesText(Direction direction) const
+{
+    QVector<double> positions;
+    for (const Axis& a : axes(direction)) {
+        positions.append(a.position);
+    }
+    return formatCoordinates(positions);
+}
+
+QString StructuralGrid::labelsText(Direction direction) const
+{
+    QStringList labels;
+    for (const Axis& a : axes(direction)) {
+        labels << a.label;
+    }
+    return labels.join(' ');
+}
+
+int StructuralGrid::nearestAxis(Direction direction, double coordinate) const
+{
+    const QVector<Axis>& list = axes(direction);
+    if (list.isEmpty()) {
+        return -1;
+    }
+    
+    Axis key = { coordinate, QString() };
+    auto it = std::lower_bound(list.begin(), list.end(), key, axisLess);
+    if (it == list.end()) {
+        return list.size() - 1;
+    }
+    int index = static_cast<int>(it - list.begin());
+    if (index > 0 && coordinate - list[index - 1].position < it->position - coordinate) {
+        --index;
+    }
+    return index;
+}
+
+StructuralGrid::Snap StructuralGrid::snap(double u, double v, double tolerance) const
+{
+    Snap result;
+    const int iu = nearestAxis(U, u);
+    const int iv = nearestAxis(V, v);
+    const double du = iu >= 0 ? std::abs(u - m_u[iu].position) : 1e100;
+    const double dv = iv >= 0 ? std::abs(v - m_v[iv].position) : 1e100;
+    
+    // Lines only exist within the span of the other family plus the extension
+    auto withinSpan = [this](const QVector<Axis>& other, double coordinate) {
+        if (other.isEmpty()) {
+            return true;
+        }
+        return coordinate >= other.first().position - m_extension
+            && coordinate <= other.last().position + m_extension;
+    };
+    
+    if (du <= tolerance && dv <= tolerance) {
+        result.kind = Snap::INTERSECTION;
+        result.u = m_u[iu].position;
+        result.v = m_v[iv].position;
+        result.description = QString("Grid %1/%2").arg(m_v[iv].label, m_u[iu].label);
+    } else if (du <= tolerance && du <= dv && withinSpan(m_v, v)) {
+        result.kind = Snap::LINE;
+        result.u = m_u[iu].position;
+        result.v = v;
+        result.description = QString("Grid line %1").arg(m_u[iu].label);
+    } else if (dv <= tolerance && withinSpan(m_u, u)) {
+        result.kind = Snap::LINE;
+        result.u = u;
+        result.v = m_v[iv].position;
+        result.description = QString("Grid line %1").arg(m_v[iv].label);
+    }
+    return result;
+}
+
+Handle(AIS_Shape) StructuralGrid::createLinesVisual(const gp_Ax3& plane) const
+{
+    BRep_Builder builder;
+    TopoDS_Compound compound;
+    builder.MakeCompound(compound);
+    
+    auto span = [this](const QVector<Axis>& other, double& from, double& to) {
+        from = (other.isEmpty() ? 0.0 : other.first().position) - m_extension;
+        to = (other.isEmpty() ? 0.0 : other.last().position) + m_extension;
+    };
+    
+    double from, to;
+    span(m_v, from, to);
+    for (const Axis& a : m_u) {
+        builder.Add(compound, BRepBuilderAPI_MakeEdge(planePoint(plane, a.position, from),
+                                                      planePoint(plane, a.position, to)).Edge());
+    }
+    span(m_u, from, to);
+    for (const Axis& a : m_v) {
+        builder.Add(compound, BRepBuilderAPI_MakeEdge(planePoint(plane, from, a.position),
+                                                      planePoint(plane, to, a.position)).Edge());
+    }
+    
+    Handle(AIS_Shape) visual = new AIS_Shape(compound);
+    visual->Attributes()->SetWireAspect(new Prs3d_LineAspect(Quantity_NOC_GRAY60, Aspect_TOL_DOTDASH, 1.0));
+    visual->SetColor(Quantity_NOC_GRAY60);
+    return visual;
+}
+
+QList<Handle(AIS_TextLabel)> StructuralGrid::createLabels(const gp_Ax3& plane) const
+{
+    QList<Handle(AIS_TextLabel)> labels;
+    const double vStart = (m_v.isEmpty() ? 0.0 : m_v.first().position) - m_extension;
+    const double uStart = (m_u.isEmpty() ? 0.0 : m_u.first().position) - m_extension;
+    
+    auto makeLabel = [&labels](const QString& text, const gp_Pnt& position) {
+        Handle(AIS_TextLabel) label = new AIS_TextLabel();
+        label->SetText(TCollection_ExtendedString(text.toUtf8().constData(), Standard_True));
+        label->SetPosition(position);
+        label->SetColor(Quantity_NOC_YELLOW);
+        label->SetHeight(16.0);
+        labels.append(label);
+    };
+    
+    for (const Axis& a : m_u) {
+        makeLabel(a.label, planePoint(plane, a.position, vStart));
+    }
+    for (const Axis& a : m_v) {
+        makeLabel(a.label, planePoint(plane, uStart, a.position));
+    }
+    return labels;
+}
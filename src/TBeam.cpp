@@ -1,10 +1,12 @@
 #include "TBeam.h"
+#include "GeometryHash.h"
+#include "Logger.h"
 #include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakePrism.hxx>
 #include <gp_Trsf.hxx>
 #include <gp_Ax1.hxx>
-#include <BRepBuilderAPI_Transform.hxx>
+#include <BRepBuilderAPI_MakeEdge.hxx>
 #include <cmath>
-#include <QDebug>
 #include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
 #include <TopoDS_Edge.hxx>
@@ -28,8 +30,8 @@ TBeam::TBeam()
     , m_useProfile(false)
     , m_profileType(SteelProfile::IPE)
     , m_profileSize("IPE 200")
+    , m_profileIndex(SteelProfile::getDefaultSizeIndex(SteelProfile::IPE))
 {
-    SetName(QString("Beam_%1").arg(GetID()));
     SetLayer("Structure");
     SetMaterial("Steel");
     SetColor(150, 150, 200); // Light blue for beams
@@ -44,8 +46,8 @@ TBeam::TBeam(const gp_Pnt& startPoint, const gp_Pnt& endPoint)
     , m_useProfile(false)
     , m_profileType(SteelProfile::IPE)
     , m_profileSize("IPE 200")
+    , m_profileIndex(SteelProfile::getDefaultSizeIndex(SteelProfile::IPE))
 {
-    SetName(QString("Beam_%1").arg(GetID()));
     SetLayer("Structure");
     SetMaterial("Steel");
     SetColor(150, 150, 200);
@@ -97,15 +99,25 @@ void TBeam::SetProfileSection(SteelProfile::ProfileType type, const QString& siz
 {
     m_profileType = type;
     m_profileSize = size;
+    m_profileIndex = SteelProfile::findSizeIndex(type, size);
     m_useProfile = true;
     BuildShape();
     UpdateModificationTime();
 }
 
+SteelProfile::SectionDescriptor TBeam::GetSection() const
+{
+    if (m_profileType == SteelProfile::LIBRARY) {
+        // Library indices change when another catalogue is opened - resolve by name
+        return SteelProfile::getSection(m_profileType, m_profileSize);
+    }
+    return SteelProfile::getSection(m_profileType, m_profileIndex);
+}
+
 void TBeam::GetSectionDimensions(double& width, double& height) const
 {
     if (m_useProfile) {
-        SteelProfile::Dimensions dim = SteelProfile::getDimensions(m_profileType, m_profileSize);
+        SteelProfile::Dimensions dim = GetSection().dim;
         width = dim.width;
         height = dim.height;
     } else {
@@ -114,51 +126,109 @@ void TBeam::GetSectionDimensions(double& width, double& height) const
     }
 }
 
-TopoDS_Shape TBeam::BuildShape()
+SteelProfile::SectionProperties TBeam::GetSectionProperties() const
 {
     if (m_useProfile) {
-        m_shape = SteelProfile::createProfile(m_profileType, m_profileSize, m_startPoint, m_endPoint);
+        if (m_profileType == SteelProfile::LIBRARY) {
+            return SteelProfile::getSectionProperties(m_profileType, m_profileSize);
+        }
+        return SteelProfile::getSectionProperties(m_profileType, m_profileIndex);
+    }
+    return SteelProfile::computeRectangularProperties(m_sectionWidth, m_sectionHeight);
+}
+
+double TBeam::GetVolume() const
+{
+    if (m_shape.IsNull()) {
+        return 0.0;
+    }
+    return GetSectionProperties().area * GetLength();
+}
+
+double TBeam::GetSurfaceArea() const
+{
+    if (m_shape.IsNull()) {
+        return 0.0;
+    }
+    SteelProfile::SectionProperties props = GetSectionProperties();
+    return props.perimeter * GetLength() + 2.0 * props.area;
+}
+
+double TBeam::GetWeight() const
+{
+    if (m_useProfile) {
+        // Catalogue mass per metre, length in mm
+        return GetSectionProperties().weightPerMetre * GetLength() / 1000.0;
+    }
+    return TGraphicObject::GetWeight();
+}
+
+quint64 TBeam::GetGeometryHash() const
+{
+    GeometryHash hash;
+    hash.add(static_cast<int>(TYPE_BEAM));
+    if (m_useProfile) {
+        // Hash the dimensions, not the name: the same section from the
+        // built-in tables and from a library catalogue is the same part
+        SteelProfile::SectionDescriptor section = GetSection();
+        hash.add(static_cast<int>(section.shape))
+            .addLength(section.dim.height)
+            .addLength(section.dim.width)
+            .addLength(section.dim.webThickness)
+            .addLength(section.dim.flangeThickness)
+            .addLength(section.dim.radius)
+            .addLength(section.dim.thickness);
     } else {
-        // Create rectangular beam
-        double length = GetLength();
-        if (length < 1e-6) {
-            m_shape = TopoDS_Shape();
-            return m_shape;
+        hash.add(-1).addLength(m_sectionWidth).addLength(m_sectionHeight);
+    }
+    return hash.addLength(GetLength()).value();
+}
+
+TopoDS_Shape TBeam::BuildLocalShape() const
+{
+    double length = GetLength();
+    if (length < 1e-6) {
+        return TopoDS_Shape();
+    }
+    
+    if (m_useProfile) {
+        // Section in the YZ plane, bottom at Z=0, extruded along X
+        TopoDS_Face face = SteelProfile::createSectionFace(GetSection());
+        if (face.IsNull()) {
+            LOG_ERROR("beam", "Could not build section face for beam %1", GetID());
+            return TopoDS_Shape();
         }
-        
-        // Create box at origin
-        TopoDS_Shape box = BRepPrimAPI_MakeBox(length, m_sectionWidth, m_sectionHeight).Shape();
-        
-        // Center on origin
-        gp_Trsf centerTransform;
-        centerTransform.SetTranslation(gp_Vec(0, -m_sectionWidth/2, -m_sectionHeight/2));
-        BRepBuilderAPI_Transform centerer(box, centerTransform, Standard_False);
-        box = centerer.Shape();
-        
-        // Rotate to align with beam direction
-        gp_Vec direction = GetDirection();
-        if (direction.Magnitude() > 1e-6) {
-            gp_Vec xAxis(1, 0, 0);
-            double angle = xAxis.Angle(direction);
-            
-            if (std::abs(angle) > 1e-6 && std::abs(angle - M_PI) > 1e-6) {
-                gp_Vec rotAxis = xAxis.Crossed(direction);
-                if (rotAxis.Magnitude() > 1e-6) {
-                    rotAxis.Normalize();
-                    gp_Trsf rotation;
-                    rotation.SetRotation(gp_Ax1(gp_Pnt(0,0,0), gp_Dir(rotAxis)), angle);
-                    BRepBuilderAPI_Transform rotator(box, rotation, Standard_False);
-                    box = rotator.Shape();
-                }
-            }
+        return BRepPrimAPI_MakePrism(face, gp_Vec(length, 0, 0)).Shape();
+    }
+    
+    // Rectangular section centred on the reference line
+    return BRepPrimAPI_MakeBox(gp_Pnt(0, -m_sectionWidth / 2, -m_sectionHeight / 2),
+                               length, m_sectionWidth, m_sectionHeight).Shape();
+}
+
+gp_Trsf TBeam::GetPlacement() const
+{
+    // Shortest rotation of +X onto the beam direction, then move to the start point
+    gp_Trsf rotation;
+    gp_Vec direction = GetDirection();
+    gp_Vec xAxis(1, 0, 0);
+    if (direction.Magnitude() > 1e-6) {
+        double angle = xAxis.Angle(direction);
+        if (angle > 1e-6) {
+            gp_Vec rotAxis = xAxis.Crossed(direction);
+            // Anti-parallel to X: any perpendicular axis works, keep the section upright
+            gp_Dir axisDir = rotAxis.Magnitude() > 1e-6 ? gp_Dir(rotAxis) : gp_Dir(0, 0, 1);
+            rotation.SetRotation(gp_Ax1(gp_Pnt(0, 0, 0), axisDir), angle);
         }
-        
-        // Translate to start position
-        gp_Trsf translation;
-        translation.SetTranslation(gp_Vec(gp_Pnt(0,0,0), m_startPoint));
-        BRepBuilderAPI_Transform translator(box, translation, Standard_False);
-        m_shape = translator.Shape();
     }
+    gp_Trsf translation;
+    translation.SetTranslation(gp_Vec(m_startPoint.XYZ()));
+    return translation * rotation;
+}
+
+TopoDS_Shape TBeam::BuildShape()
+{
+    m_shape = BuildPlacedShape();
     
     // Create or update AIS shape
     if (m_aisShape.IsNull()) {
@@ -181,20 +251,60 @@ Handle(AIS_Shape) TBeam::GetAISShape()
     return m_aisShape;
 }
 
+TopoDS_Shape TBeam::BuildCoarseShape() const
+{
+    // Far away a beam reads as its reference line
+    if (GetLength() < Precision::Confusion()) {
+        return TGraphicObject::BuildCoarseShape();
+    }
+    return BRepBuilderAPI_MakeEdge(m_startPoint, m_endPoint).Edge();
+}
+
+void TBeam::Translate(const gp_Vec& vector)
+{
+    m_startPoint.Translate(vector);
+    m_endPoint.Translate(vector);
+    TGraphicObject::Translate(vector);
+    CalculateSnapPoints();
+}
+
+void TBeam::Rotate(const gp_Ax1& axis, double angle)
+{
+    m_startPoint.Rotate(axis, angle);
+    m_endPoint.Rotate(axis, angle);
+    TGraphicObject::Rotate(axis, angle);
+    CalculateSnapPoints();
+}
+
+Handle(TGraphicObject) TBeam::CreateCopy(const gp_Trsf& placement) const
+{
+    Handle(TBeam) copy = new TBeam();
+    copy->m_startPoint = m_startPoint.Transformed(placement);
+    copy->m_endPoint = m_endPoint.Transformed(placement);
+    copy->m_sectionWidth = m_sectionWidth;
+    copy->m_sectionHeight = m_sectionHeight;
+    copy->m_useProfile = m_useProfile;
+    copy->m_profileType = m_profileType;
+    copy->m_profileSize = m_profileSize;
+    copy->m_profileIndex = m_profileIndex;
+    CopyCommonTo(copy, placement);
+    return copy;
+}
+
 QString TBeam::Serialize() const
 {
     QString data = TGraphicObject::Serialize();
     data += QString("StartX=%1;StartY=%2;StartZ=%3;")
-            .arg(m_startPoint.X()).arg(m_startPoint.Y()).arg(m_startPoint.Z());
+            .arg(m_startPoint.X(), 0, 'g', 15).arg(m_startPoint.Y(), 0, 'g', 15).arg(m_startPoint.Z(), 0, 'g', 15);
     data += QString("EndX=%1;EndY=%2;EndZ=%3;")
-            .arg(m_endPoint.X()).arg(m_endPoint.Y()).arg(m_endPoint.Z());
+            .arg(m_endPoint.X(), 0, 'g', 15).arg(m_endPoint.Y(), 0, 'g', 15).arg(m_endPoint.Z(), 0, 'g', 15);
     data += QString("UseProfile=%1;").arg(m_useProfile ? 1 : 0);
     
     if (m_useProfile) {
         data += QString("ProfileType=%1;ProfileSize=%2;")
                 .arg((int)m_profileType).arg(m_profileSize);
     } else {
-        data += QString("Width=%1;Height=%2;").arg(m_sectionWidth).arg(m_sectionHeight);
+        data += QString("Width=%1;Height=%2;").arg(m_sectionWidth, 0, 'g', 15).arg(m_sectionHeight, 0, 'g', 15);
     }
     
     return data;
@@ -202,9 +312,33 @@ QString TBeam::Serialize() const
 
 bool TBeam::Deserialize(const QString& data)
 {
-    // Basic deserialization - to be fully implemented
-    Q_UNUSED(data);
-    return TGraphicObject::Deserialize(data);
+    if (!TGraphicObject::Deserialize(data)) {
+        return false;
+    }
+    
+    const QHash<QString, QString> fields = ParseFields(data);
+    m_startPoint.SetCoord(FieldValue(fields, "StartX", m_startPoint.X()),
+                          FieldValue(fields, "StartY", m_startPoint.Y()),
+                          FieldValue(fields, "StartZ", m_startPoint.Z()));
+    m_endPoint.SetCoord(FieldValue(fields, "EndX", m_endPoint.X()),
+                        FieldValue(fields, "EndY", m_endPoint.Y()),
+                        FieldValue(fields, "EndZ", m_endPoint.Z()));
+    
+    m_useProfile = fields.value("UseProfile").toInt() != 0;
+    if (m_useProfile) {
+        int type = fields.value("ProfileType").toInt();
+        if (type < SteelProfile::IPE || type > SteelProfile::LIBRARY) {
+            m_validationError = QString("Unknown profile type %1").arg(type);
+            return false;
+        }
+        m_profileType = static_cast<SteelProfile::ProfileType>(type);
+        m_profileSize = fields.value("ProfileSize");
+        m_profileIndex = SteelProfile::findSizeIndex(m_profileType, m_profileSize);
+    } else {
+        m_sectionWidth = FieldValue(fields, "Width", m_sectionWidth);
+        m_sectionHeight = FieldValue(fields, "Height", m_sectionHeight);
+    }
+    return true;
 }
 
 bool TBeam::IsValid() const
@@ -235,12 +369,10 @@ void TBeam::CalculateSnapPoints()
     ClearSnapPoints();
     
     if (m_shape.IsNull()) {
-        qDebug() << "TBeam::CalculateSnapPoints() - Shape is null, cannot calculate snaps";
+        LOG_WARNING("beam", "CalculateSnapPoints: shape of beam %1 is null", GetID());
         return;
     }
     
-    qDebug() << "TBeam::CalculateSnapPoints() - Extracting wire geometry";
-    
     QMap<QString, gp_Pnt> allPoints;
     int wireCount = 0;
     int edgeCount = 0;
@@ -297,7 +429,7 @@ void TBeam::CalculateSnapPoints()
         wireExp.Next();
     }
     
-    qDebug() << "TBeam: Wires:" << wireCount << "Edges:" << edgeCount << "Points:" << allPoints.size();
+    LOG_TRACE("beam", "Beam %1: %2 wires, %3 edges, %4 points", GetID(), wireCount, edgeCount, allPoints.size());
     
     // Add all unique points as snap points
     int pointIndex = 0;
@@ -313,5 +445,4 @@ void TBeam::CalculateSnapPoints()
         pointIndex++;
     }
     
-    qDebug() << "TBeam: Total snap points added:" << m_snapPoints.size();
 }
@@ -1,7 +1,11 @@
 #include "TColumn.h"
+#include "GeometryHash.h"
+#include "Logger.h"
 #include <BRepPrimAPI_MakeBox.hxx>
 #include <gp_Trsf.hxx>
-#include <BRepBuilderAPI_Transform.hxx>
+#include <gp_Ax1.hxx>
+#include <algorithm>
+#include <cmath>
 
 IMPLEMENT_STANDARD_RTTIEXT(TColumn, TGraphicObject)
 
@@ -11,8 +15,8 @@ TColumn::TColumn()
     , m_width(400)
     , m_depth(400)
     , m_height(3000)
+    , m_rotation(0.0)
 {
-    SetName(QString("Column_%1").arg(GetID()));
     SetLayer("Structure");
     SetMaterial("Concrete");
     SetColor(180, 180, 180); // Gray for columns
@@ -24,8 +28,8 @@ TColumn::TColumn(const gp_Pnt& basePoint, double width, double depth, double hei
     , m_width(width)
     , m_depth(depth)
     , m_height(height)
+    , m_rotation(0.0)
 {
-    SetName(QString("Column_%1").arg(GetID()));
     SetLayer("Structure");
     SetMaterial("Concrete");
     SetColor(180, 180, 180);
@@ -43,6 +47,13 @@ void TColumn::SetBasePoint(const gp_Pnt& point)
     UpdateModificationTime();
 }
 
+void TColumn::SetRotation(double angle)
+{
+    m_rotation = angle;
+    BuildShape();
+    UpdateModificationTime();
+}
+
 void TColumn::SetDimensions(double width, double depth, double height)
 {
     m_width = width;
@@ -59,19 +70,38 @@ void TColumn::GetDimensions(double& width, double& depth, double& height) const
     height = m_height;
 }
 
-TopoDS_Shape TColumn::BuildShape()
+quint64 TColumn::GetGeometryHash() const
 {
-    // Create box at origin
-    TopoDS_Shape box = BRepPrimAPI_MakeBox(m_width, m_depth, m_height).Shape();
-    
-    // Translate to base point (centered at base)
+    // The local section has its longer side on X, so a column turned by 90
+    // degrees is the same part
+    return GeometryHash().add(static_cast<int>(TYPE_COLUMN))
+        .addLength(std::max(m_width, m_depth))
+        .addLength(std::min(m_width, m_depth))
+        .addLength(m_height)
+        .value();
+}
+
+TopoDS_Shape TColumn::BuildLocalShape() const
+{
+    // Centred on the base point, longer side along X
+    const double a = std::max(m_width, m_depth);
+    const double b = std::min(m_width, m_depth);
+    return BRepPrimAPI_MakeBox(gp_Pnt(-a / 2, -b / 2, 0), a, b, m_height).Shape();
+}
+
+gp_Trsf TColumn::GetPlacement() const
+{
+    const double turn = m_width < m_depth ? m_rotation + M_PI / 2 : m_rotation;
+    gp_Trsf placement;
+    placement.SetRotation(gp_Ax1(gp_Pnt(0, 0, 0), gp_Dir(0, 0, 1)), turn);
     gp_Trsf translation;
-    gp_Vec offset(m_basePoint.X() - m_width/2, 
-                  m_basePoint.Y() - m_depth/2, 
-                  m_basePoint.Z());
-    translation.SetTranslation(offset);
-    BRepBuilderAPI_Transform transformer(box, translation, Standard_False);
-    m_shape = transformer.Shape();
+    translation.SetTranslation(gp_Vec(m_basePoint.XYZ()));
+    return translation * placement;
+}
+
+TopoDS_Shape TColumn::BuildShape()
+{
+    m_shape = BuildPlacedShape();
     
     if (m_aisShape.IsNull()) {
         m_aisShape = new AIS_Shape(m_shape);
@@ -82,6 +112,16 @@ TopoDS_Shape TColumn::BuildShape()
     return m_shape;
 }
 
+double TColumn::GetVolume() const
+{
+    return m_width * m_depth * m_height;
+}
+
+double TColumn::GetSurfaceArea() const
+{
+    return 2.0 * (m_width * m_depth + m_width * m_height + m_depth * m_height);
+}
+
 Handle(AIS_Shape) TColumn::GetAISShape()
 {
     if (m_aisShape.IsNull() && !m_shape.IsNull()) {
@@ -90,16 +130,52 @@ Handle(AIS_Shape) TColumn::GetAISShape()
     return m_aisShape;
 }
 
+Handle(TGraphicObject) TColumn::CreateCopy(const gp_Trsf& placement) const
+{
+    // Columns stay vertical: a placement that tilts them cannot be stored
+    double angle = 0.0;
+    if (!IsPlanPlacement(placement, angle)) {
+        LOG_WARNING("model", "Column %1 was not copied: its copy would not be vertical", m_id);
+        return Handle(TGraphicObject)();
+    }
+    Handle(TColumn) copy = new TColumn();
+    copy->m_basePoint = m_basePoint.Transformed(placement);
+    copy->m_width = m_width;
+    copy->m_depth = m_depth;
+    copy->m_height = m_height;
+    copy->m_rotation = m_rotation + angle;
+    CopyCommonTo(copy, placement);
+    return copy;
+}
+
 QString TColumn::Serialize() const
 {
     QString data = TGraphicObject::Serialize();
     data += QString("BaseX=%1;BaseY=%2;BaseZ=%3;")
-            .arg(m_basePoint.X()).arg(m_basePoint.Y()).arg(m_basePoint.Z());
+            .arg(m_basePoint.X(), 0, 'g', 15).arg(m_basePoint.Y(), 0, 'g', 15).arg(m_basePoint.Z(), 0, 'g', 15);
     data += QString("Width=%1;Depth=%2;Height=%3;")
-            .arg(m_width).arg(m_depth).arg(m_height);
+            .arg(m_width, 0, 'g', 15).arg(m_depth, 0, 'g', 15).arg(m_height, 0, 'g', 15);
+    data += QString("Rotation=%1;").arg(m_rotation, 0, 'g', 15);
     return data;
 }
 
+bool TColumn::Deserialize(const QString& data)
+{
+    if (!TGraphicObject::Deserialize(data)) {
+        return false;
+    }
+    
+    const QHash<QString, QString> fields = ParseFields(data);
+    m_basePoint.SetCoord(FieldValue(fields, "BaseX", m_basePoint.X()),
+                         FieldValue(fields, "BaseY", m_basePoint.Y()),
+                         FieldValue(fields, "BaseZ", m_basePoint.Z()));
+    m_width = FieldValue(fields, "Width", m_width);
+    m_depth = FieldValue(fields, "Depth", m_depth);
+    m_height = FieldValue(fields, "Height", m_height);
+    m_rotation = FieldValue(fields, "Rotation", 0.0);
+    return true;
+}
+
 bool TColumn::IsValid() const
 {
     if (!TGraphicObject::IsValid()) {
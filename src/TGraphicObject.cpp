@@ -1,20 +1,24 @@
 #include "TGraphicObject.h"
+#include "GeometryCache.h"
+#include "GeometryHash.h"
+#include "Logger.h"
 #include <BRepBndLib.hxx>
 #include <Bnd_Box.hxx>
 #include <GProp_GProps.hxx>
 #include <BRepGProp.hxx>
+#include <gp.hxx>
 #include <gp_Trsf.hxx>
 #include <BRepBuilderAPI_Transform.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
 #include <TopLoc_Location.hxx>
-#include <QDebug>
+#include <Standard_Failure.hxx>
+#include <QStringList>
+#include <cmath>
 
 IMPLEMENT_STANDARD_RTTIEXT(TGraphicObject, Standard_Transient)
 
-int TGraphicObject::s_nextID = 1;
-
 TGraphicObject::TGraphicObject()
-    : m_id(s_nextID++)
-    , m_name(QString("Object_%1").arg(m_id))
+    : m_id(0)
     , m_state(STATE_NORMAL)
     , m_visible(true)
     , m_locked(false)
@@ -30,6 +34,14 @@ TGraphicObject::~TGraphicObject()
 {
 }
 
+QString TGraphicObject::GetName() const
+{
+    if (m_name.isEmpty()) {
+        return QString("%1_%2").arg(GetTypeName()).arg(m_id);
+    }
+    return m_name;
+}
+
 void TGraphicObject::SetColor(int r, int g, int b)
 {
     m_colorR = r;
@@ -88,6 +100,22 @@ double TGraphicObject::GetSurfaceArea() const
     return props.Mass();
 }
 
+double TGraphicObject::GetWeight() const
+{
+    // Volume is in mm3
+    return GetVolume() * 1e-9 * GetMaterialDensity(m_material);
+}
+
+double TGraphicObject::GetMaterialDensity(const QString& material)
+{
+    if (material.startsWith("Steel", Qt::CaseInsensitive)) return 7850.0;
+    if (material.startsWith("Concrete", Qt::CaseInsensitive)) return 2500.0;
+    if (material.startsWith("Alumin", Qt::CaseInsensitive)) return 2700.0;
+    if (material.startsWith("Timber", Qt::CaseInsensitive) ||
+        material.startsWith("Wood", Qt::CaseInsensitive)) return 500.0;
+    return 7850.0;
+}
+
 void TGraphicObject::GetBoundingBox(double& xmin, double& ymin, double& zmin,
                                     double& xmax, double& ymax, double& zmax) const
 {
@@ -96,15 +124,70 @@ void TGraphicObject::GetBoundingBox(double& xmin, double& ymin, double& zmin,
         return;
     }
     
-    Bnd_Box box;
-    BRepBndLib::Add(m_shape, box);
+    // Recompute only when the shape changed (the LOD pass asks every frame)
+    if (!m_boundingBoxSource.IsSame(m_shape)) {
+        m_boundingBox.SetVoid();
+        BRepBndLib::Add(m_shape, m_boundingBox);
+        m_boundingBoxSource = m_shape;
+    }
     
-    if (box.IsVoid()) {
+    if (m_boundingBox.IsVoid()) {
         xmin = ymin = zmin = xmax = ymax = zmax = 0.0;
         return;
     }
     
-    box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+    m_boundingBox.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+}
+
+TopoDS_Shape TGraphicObject::BuildCoarseShape() const
+{
+    double xmin, ymin, zmin, xmax, ymax, zmax;
+    GetBoundingBox(xmin, ymin, zmin, xmax, ymax, zmax);
+    
+    // Keep flat objects from producing a degenerate box
+    const double minSize = 1.0;
+    if (xmax - xmin < minSize) xmax = xmin + minSize;
+    if (ymax - ymin < minSize) ymax = ymin + minSize;
+    if (zmax - zmin < minSize) zmax = zmin + minSize;
+    
+    try {
+        return BRepPrimAPI_MakeBox(gp_Pnt(xmin, ymin, zmin), gp_Pnt(xmax, ymax, zmax)).Shape();
+    } catch (Standard_Failure const& ex) {
+        LOG_WARNING("lod", "BuildCoarseShape failed for object %1: %2", m_id, ex.GetMessageString());
+        return TopoDS_Shape();
+    }
+}
+
+TGraphicObject::DetailLevel TGraphicObject::GetDetailLevel() const
+{
+    if (m_aisShape.IsNull() || m_aisShape->Shape().IsSame(m_shape)) {
+        return DETAIL_FULL;
+    }
+    return DETAIL_COARSE;
+}
+
+bool TGraphicObject::SetDetailLevel(DetailLevel level)
+{
+    if (m_aisShape.IsNull() || m_shape.IsNull()) {
+        return false;
+    }
+    
+    TopoDS_Shape target = m_shape;
+    if (level == DETAIL_COARSE) {
+        if (!m_coarseSource.IsSame(m_shape)) {
+            m_coarseShape = BuildCoarseShape();
+            m_coarseSource = m_shape;
+        }
+        if (!m_coarseShape.IsNull()) {
+            target = m_coarseShape;
+        }
+    }
+    
+    if (m_aisShape->Shape().IsSame(target)) {
+        return false;
+    }
+    m_aisShape->SetShape(target);
+    return true;
 }
 
 void TGraphicObject::Translate(const gp_Vec& vector)
@@ -179,11 +262,86 @@ void TGraphicObject::Mirror(const gp_Ax2& plane)
     UpdateModificationTime();
 }
 
+Handle(TGraphicObject) TGraphicObject::CreateCopy(const gp_Trsf& placement) const
+{
+    Q_UNUSED(placement);
+    return Handle(TGraphicObject)();
+}
+
+quint64 TGraphicObject::GetPartHash() const
+{
+    const quint64 geometry = GetGeometryHash();
+    if (geometry == 0) {
+        return 0;
+    }
+    return GeometryHash().add(static_cast<qint64>(geometry)).add(m_material.trimmed().toUpper()).value();
+}
+
+bool TGraphicObject::IsPlanPlacement(const gp_Trsf& placement, double& angle)
+{
+    const double tolerance = 1.0e-9;
+    if (std::abs(placement.ScaleFactor() - 1.0) > tolerance || placement.IsNegative()
+        || !gp::DZ().Transformed(placement).IsEqual(gp::DZ(), tolerance)) {
+        return false;
+    }
+    const gp_Dir x = gp::DX().Transformed(placement);
+    angle = std::atan2(x.Y(), x.X());
+    return true;
+}
+
+bool TGraphicObject::HasPartShape() const
+{
+    const quint64 hash = GetGeometryHash();
+    if (hash == 0 || m_shape.IsNull()) {
+        return false;
+    }
+    const TopoDS_Shape local = GeometryCache::instance().find(hash);
+    return !local.IsNull() && local.TShape() == m_shape.TShape();
+}
+
+TopoDS_Shape TGraphicObject::BuildPlacedShape() const
+{
+    const quint64 hash = GetGeometryHash();
+    TopoDS_Shape local = hash != 0 ? GeometryCache::instance().find(hash) : TopoDS_Shape();
+    if (local.IsNull()) {
+        // Built without the lock; another thread may have stored the part meanwhile
+        local = GeometryCache::instance().findOrInsert(hash, BuildLocalShape());
+    }
+    if (local.IsNull()) {
+        return local;
+    }
+    return local.Moved(TopLoc_Location(GetPlacement()));
+}
+
+void TGraphicObject::CopyCommonTo(const Handle(TGraphicObject)& copy, const gp_Trsf& placement) const
+{
+    copy->m_description = m_description;
+    copy->m_layer = m_layer;
+    copy->m_material = m_material;
+    copy->m_partMark = m_partMark;
+    copy->m_assemblyMark = m_assemblyMark;
+    copy->m_visible = m_visible;
+    copy->m_colorR = m_colorR;
+    copy->m_colorG = m_colorG;
+    copy->m_colorB = m_colorB;
+    
+    // Same TShape under another location: no geometry is rebuilt and the
+    // triangulation already on the faces serves every copy
+    if (!m_shape.IsNull()) {
+        copy->m_shape = m_shape.Moved(TopLoc_Location(placement));
+    }
+    
+    copy->m_snapPoints.clear();
+    for (const SnapPoint& snap : m_snapPoints) {
+        copy->m_snapPoints.append(SnapPoint(snap.point.Transformed(placement), snap.type, snap.description));
+    }
+}
+
 QString TGraphicObject::Serialize() const
 {
     QString data;
     data += QString("ID=%1;").arg(m_id);
-    data += QString("Name=%1;").arg(m_name);
+    data += QString("Name=%1;").arg(GetName());
     data += QString("Type=%1;").arg((int)GetType());
     data += QString("Layer=%1;").arg(m_layer);
     data += QString("Material=%1;").arg(m_material);
@@ -195,9 +353,48 @@ QString TGraphicObject::Serialize() const
 
 bool TGraphicObject::Deserialize(const QString& data)
 {
-    // Basic deserialization - to be implemented
-    Q_UNUSED(data);
-    return false;
+    const QHash<QString, QString> fields = ParseFields(data);
+    if (fields.value("Type").toInt() != static_cast<int>(GetType())) {
+        m_validationError = QString("Record is not a %1").arg(GetTypeName());
+        return false;
+    }
+    
+    // ID 0 leaves numbering to the collection; the default name is not stored
+    m_id = fields.value("ID").toInt();
+    QString name = fields.value("Name");
+    m_name = (name == QString("%1_%2").arg(GetTypeName()).arg(m_id)) ? QString() : name;
+    m_layer = fields.value("Layer", m_layer);
+    m_material = fields.value("Material", m_material);
+    m_visible = fields.value("Visible", "1").toInt() != 0;
+    m_locked = fields.value("Locked", "0").toInt() != 0;
+    
+    QStringList color = fields.value("Color").split(',');
+    if (color.size() == 3) {
+        m_colorR = color[0].toInt();
+        m_colorG = color[1].toInt();
+        m_colorB = color[2].toInt();
+    }
+    return true;
+}
+
+QHash<QString, QString> TGraphicObject::ParseFields(const QString& data)
+{
+    QHash<QString, QString> fields;
+    const QStringList items = data.split(';', QString::SkipEmptyParts);
+    for (const QString& item : items) {
+        int separator = item.indexOf('=');
+        if (separator > 0) {
+            fields.insert(item.left(separator).trimmed(), item.mid(separator + 1));
+        }
+    }
+    return fields;
+}
+
+double TGraphicObject::FieldValue(const QHash<QString, QString>& fields, const QString& key, double fallback)
+{
+    bool ok = false;
+    double value = fields.value(key).toDouble(&ok);
+    return ok ? value : fallback;
 }
 
 bool TGraphicObject::IsValid() const
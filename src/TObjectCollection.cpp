@@ -1,14 +1,214 @@
 #include "TObjectCollection.h"
+#include "GeometryCache.h"
+#include "TBeam.h"
+#include "TColumn.h"
+#include "TSlab.h"
+#include "Logger.h"
 #include <Quantity_Color.hxx>
+#include <StdPrs_ToolTriangulatedShape.hxx>
+#include <AIS_Selection.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRep_Tool.hxx>
+#include <Graphic3d_Camera.hxx>
+#include <Poly_Triangulation.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <OSD_Parallel.hxx>
+#include <QFile>
+#include <QPointF>
+#include <QSet>
+#include <QTextStream>
+#include <QTimer>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace {
+
+// Screen-space selection region in pixels
+struct PixelRegion {
+    QVector<QPointF> polygon;
+    double xmin, ymin, xmax, ymax;
+    bool rectangle;
+    
+    bool contains(const QPointF& p) const
+    {
+        if (p.x() < xmin || p.x() > xmax || p.y() < ymin || p.y() > ymax) {
+            return false;
+        }
+        if (rectangle) {
+            return true;
+        }
+        // Even-odd rule, so a self-crossing lasso behaves predictably
+        bool inside = false;
+        for (int i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+            const QPointF& a = polygon[i];
+            const QPointF& b = polygon[j];
+            if ((a.y() > p.y()) != (b.y() > p.y())
+                && p.x() < (b.x() - a.x()) * (p.y() - a.y()) / (b.y() - a.y()) + a.x()) {
+                inside = !inside;
+            }
+        }
+        return inside;
+    }
+};
+
+double cross2d(const QPointF& o, const QPointF& a, const QPointF& b)
+{
+    return (a.x() - o.x()) * (b.y() - o.y()) - (a.y() - o.y()) * (b.x() - o.x());
+}
+
+bool segmentsCross(const QPointF& p1, const QPointF& p2, const QPointF& q1, const QPointF& q2)
+{
+    const double d1 = cross2d(q1, q2, p1);
+    const double d2 = cross2d(q1, q2, p2);
+    const double d3 = cross2d(p1, p2, q1);
+    const double d4 = cross2d(p1, p2, q2);
+    return ((d1 > 0) != (d2 > 0)) && ((d3 > 0) != (d4 > 0));
+}
+
+bool crossesBoundary(const PixelRegion& region, const QPointF& a, const QPointF& b)
+{
+    // Cheap reject on the segment's extent first
+    if (std::max(a.x(), b.x()) < region.xmin || std::min(a.x(), b.x()) > region.xmax
+        || std::max(a.y(), b.y()) < region.ymin || std::min(a.y(), b.y()) > region.ymax) {
+        return false;
+    }
+    const QVector<QPointF>& poly = region.polygon;
+    for (int i = 0, j = poly.size() - 1; i < poly.size(); j = i++) {
+        if (segmentsCross(a, b, poly[j], poly[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool triangleContains(const QPointF& a, const QPointF& b, const QPointF& c, const QPointF& p)
+{
+    const double d1 = cross2d(a, b, p);
+    const double d2 = cross2d(b, c, p);
+    const double d3 = cross2d(c, a, p);
+    const bool hasNeg = d1 < 0 || d2 < 0 || d3 < 0;
+    const bool hasPos = d1 > 0 || d2 > 0 || d3 > 0;
+    return !(hasNeg && hasPos);
+}
+
+// World to pixel through a camera; false outside the depth range
+struct Projector {
+    Handle(Graphic3d_Camera) camera;
+    double width;
+    double height;
+    
+    bool toPixel(const gp_Pnt& p, QPointF& pixel) const
+    {
+        const gp_Pnt ndc = camera->Project(p);
+        if (ndc.Z() < -1.0 || ndc.Z() > 1.0) {
+            return false;
+        }
+        pixel = QPointF((ndc.X() + 1.0) * 0.5 * width, (1.0 - ndc.Y()) * 0.5 * height);
+        return true;
+    }
+};
+
+// Exact test against the shape's triangulation; false if it has none
+bool testTriangulation(const TopoDS_Shape& shape, const Projector& projector,
+                       const PixelRegion& region, bool crossing, bool& hit)
+{
+    bool meshed = false;
+    bool allInside = true;
+    std::vector<QPointF> pixels;
+    std::vector<char> valid;
+    
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        TopLoc_Location location;
+        const Handle(Poly_Triangulation)& tri = BRep_Tool::Triangulation(TopoDS::Face(exp.Current()), location);
+        if (tri.IsNull()) {
+            continue;
+        }
+        meshed = true;
+        const gp_Trsf& trsf = location.Transformation();
+        
+        pixels.resize(tri->NbNodes());
+        valid.resize(tri->NbNodes());
+        for (int i = 1; i <= tri->NbNodes(); ++i) {
+            valid[i - 1] = projector.toPixel(tri->Node(i).Transformed(trsf), pixels[i - 1]);
+            const bool inside = valid[i - 1] && region.contains(pixels[i - 1]);
+            if (crossing && inside) {
+                hit = true;
+                return true;
+            }
+            if (!crossing && !inside) {
+                hit = false;
+                return true;
+            }
+        }
+        if (!crossing) {
+            continue;
+        }
+        
+        // No node inside: an edge may still cut the region, or the region sit inside a triangle
+        for (int t = 1; t <= tri->NbTriangles(); ++t) {
+            int n1, n2, n3;
+            tri->Triangle(t).Get(n1, n2, n3);
+            if (!valid[n1 - 1] || !valid[n2 - 1] || !valid[n3 - 1]) {
+                continue;
+            }
+            const QPointF& a = pixels[n1 - 1];
+            const QPointF& b = pixels[n2 - 1];
+            const QPointF& c = pixels[n3 - 1];
+            if (crossesBoundary(region, a, b) || crossesBoundary(region, b, c) || crossesBoundary(region, c, a)
+                || triangleContains(a, b, c, region.polygon.first())) {
+                hit = true;
+                return true;
+            }
+        }
+        allInside = false;
+    }
+    
+    hit = crossing ? false : allInside;
+    return meshed;
+}
+
+// Stand-in while the mesh is being built: the eight box corners
+bool testBox(const double b[6], const Projector& projector, const PixelRegion& region, bool crossing)
+{
+    if (crossing) {
+        return true;    // The frustum query already found the box touching the region
+    }
+    for (int corner = 0; corner < 8; ++corner) {
+        QPointF pixel;
+        gp_Pnt p(b[(corner & 1) ? 3 : 0], b[(corner & 2) ? 4 : 1], b[(corner & 4) ? 5 : 2]);
+        if (!projector.toPixel(p, pixel) || !region.contains(pixel)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
 
 TObjectCollection::TObjectCollection(const Handle(AIS_InteractiveContext)& context, QObject* parent)
     : QObject(parent)
     , m_context(context)
+    , m_coarseBelowPixels(12.0)
+    , m_fullAbovePixels(20.0)
+    , m_meshScheduler(new MeshScheduler(this))
+    , m_viewerUpdatePending(false)
+    , m_spatialIndexDirty(true)
 {
     m_layers.append("Default");
     m_layers.append("Structure");
     m_layers.append("Architecture");
     m_layers.append("Foundation");
+    
+    // Profiles with root radii carry most of the triangles - mesh them coarser
+    // and let them drop to their reference line when far away
+    m_displayQuality[TGraphicObject::TYPE_BEAM] = { 0.004, 20.0 * M_PI / 180.0, true };
+    m_displayQuality[TGraphicObject::TYPE_COLUMN] = { 0.002, 20.0 * M_PI / 180.0, false };
+    m_displayQuality[TGraphicObject::TYPE_SLAB] = { 0.002, 20.0 * M_PI / 180.0, false };
+    
+    connect(m_meshScheduler, &MeshScheduler::meshReady, this, &TObjectCollection::onMeshReady);
 }
 
 TObjectCollection::~TObjectCollection()
@@ -22,18 +222,73 @@ bool TObjectCollection::AddObject(const Handle(TGraphicObject)& object)
         return false;
     }
     
-    int id = object->GetID();
-    if (m_objects.IsBound(id)) {
-        return false; // Object already exists
+    if (!object->HasID()) {
+        object->SetID(m_idAllocator.allocate());
+    } else if (!claimID(object)) {
+        return false;
     }
     
+    int id = object->GetID();
     m_objects.Bind(id, object);
+    m_spatialIndexDirty = true;
     displayObject(object);
     
     emit objectAdded(id);
     return true;
 }
 
+int TObjectCollection::AddObjects(const NCollection_Sequence<Handle(TGraphicObject)>& objects)
+{
+    int unnumbered = 0;
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(objects); it.More(); it.Next()) {
+        if (!it.Value().IsNull() && !it.Value()->HasID()) {
+            unnumbered++;
+        }
+    }
+    ObjectIdAllocator::Range block = m_idAllocator.reserve(unnumbered);
+    int nextInBlock = 0;
+    
+    QList<int> added;
+    for (NCollection_Sequence<Handle(TGraphicObject)>::Iterator it(objects); it.More(); it.Next()) {
+        const Handle(TGraphicObject)& object = it.Value();
+        if (object.IsNull()) {
+            continue;
+        }
+        if (!object->HasID()) {
+            object->SetID(block.at(nextInBlock++));
+        } else if (!claimID(object)) {
+            continue;
+        }
+        m_objects.Bind(object->GetID(), object);
+        displayObject(object);
+        added.append(object->GetID());
+    }
+    
+    if (added.isEmpty()) {
+        return 0;
+    }
+    m_spatialIndexDirty = true;
+    if (!m_context.IsNull()) {
+        m_context->UpdateCurrentViewer();
+    }
+    
+    emit objectsAdded(added);
+    return added.size();
+}
+
+bool TObjectCollection::claimID(const Handle(TGraphicObject)& object)
+{
+    const int id = object->GetID();
+    if (m_objects.IsBound(id)) {
+        if (m_objects.Find(id) != object) {
+            LOG_WARNING("collection", "Object ID %1 of %2 is already used by %3",
+                        id, object->GetName(), m_objects.Find(id)->GetName());
+        }
+        return false;
+    }
+    return m_idAllocator.claim(id);
+}
+
 bool TObjectCollection::RemoveObject(int objectID)
 {
     if (!m_objects.IsBound(objectID)) {
@@ -43,6 +298,8 @@ bool TObjectCollection::RemoveObject(int objectID)
     Handle(TGraphicObject) object = m_objects.Find(objectID);
     eraseObject(object);
     m_objects.UnBind(objectID);
+    releaseMesh(objectID);
+    m_spatialIndexDirty = true;
     
     // Remove from selection if selected
     for (int i = 1; i <= m_selectedObjects.Length(); i++) {
@@ -73,6 +330,14 @@ void TObjectCollection::Clear()
     
     m_objects.Clear();
     m_selectedObjects.Clear();
+    m_idByPresentation.clear();
+    m_spatialIndexDirty = true;
+    m_meshScheduler->cancelPending();
+    m_meshInFlight.clear();
+    m_meshWaiters.clear();
+    m_meshCache.close();
+    m_idAllocator.reset();
+    GeometryCache::instance().clear();
     
     emit collectionCleared();
 }
@@ -218,6 +483,226 @@ NCollection_Sequence<Handle(TGraphicObject)> TObjectCollection::GetSelectedObjec
     return result;
 }
 
+void TObjectCollection::SelectObjects(const NCollection_Sequence<int>& objectIDs, bool replace)
+{
+    if (replace) {
+        for (int i = 1; i <= m_selectedObjects.Length(); i++) {
+            int id = m_selectedObjects.Value(i);
+            if (m_objects.IsBound(id)) {
+                m_objects.Find(id)->SetState(TGraphicObject::STATE_NORMAL);
+            }
+        }
+        m_selectedObjects.Clear();
+    }
+    
+    QSet<int> selected;
+    selected.reserve(m_selectedObjects.Length() + objectIDs.Length());
+    for (int i = 1; i <= m_selectedObjects.Length(); i++) {
+        selected.insert(m_selectedObjects.Value(i));
+    }
+    for (int i = 1; i <= objectIDs.Length(); i++) {
+        int id = objectIDs.Value(i);
+        if (!m_objects.IsBound(id) || selected.contains(id)) {
+            continue;
+        }
+        selected.insert(id);
+        m_selectedObjects.Append(id);
+        m_objects.Find(id)->SetState(TGraphicObject::STATE_SELECTED);
+    }
+    
+    syncContextSelection();
+    emit selectionChanged();
+}
+
+void TObjectCollection::SyncSelectionFromContext()
+{
+    if (m_context.IsNull()) {
+        return;
+    }
+    
+    for (int i = 1; i <= m_selectedObjects.Length(); i++) {
+        int id = m_selectedObjects.Value(i);
+        if (m_objects.IsBound(id)) {
+            m_objects.Find(id)->SetState(TGraphicObject::STATE_NORMAL);
+        }
+    }
+    m_selectedObjects.Clear();
+    
+    for (m_context->InitSelected(); m_context->MoreSelected(); m_context->NextSelected()) {
+        int id = FindObjectID(m_context->SelectedInteractive());
+        if (id >= 0) {
+            m_selectedObjects.Append(id);
+            m_objects.Find(id)->SetState(TGraphicObject::STATE_SELECTED);
+        }
+    }
+    
+    emit selectionChanged();
+}
+
+int TObjectCollection::FindObjectID(const Handle(AIS_InteractiveObject)& presentation) const
+{
+    int id = m_idByPresentation.value(presentation.get(), -1);
+    return m_objects.IsBound(id) ? id : -1;
+}
+
+void TObjectCollection::syncContextSelection()
+{
+    if (m_context.IsNull()) {
+        return;
+    }
+    
+    // Fill the context's selection directly and highlight once, instead of a
+    // SetSelected() per object that would re-highlight on every call
+    m_context->ClearSelected(Standard_False);
+    const Handle(AIS_Selection)& selection = m_context->Selection();
+    for (int i = 1; i <= m_selectedObjects.Length(); i++) {
+        Handle(AIS_Shape) aisShape = m_objects.Find(m_selectedObjects.Value(i))->GetAISShape();
+        if (aisShape.IsNull() || !m_context->IsDisplayed(aisShape)) {
+            continue;
+        }
+        Handle(SelectMgr_EntityOwner) owner = aisShape->GlobalSelOwner();
+        // AddSelect() leaves the owner's own flag alone, which IsSelected(),
+        // deselection and highlighting rely on
+        if (!owner.IsNull() && selection->AddSelect(owner) == AIS_SS_Added) {
+            owner->SetSelected(Standard_True);
+        }
+    }
+    m_context->HilightSelected(Standard_False);
+}
+
+NCollection_Sequence<int> TObjectCollection::PickObjects(const Handle(V3d_View)& view,
+                                                         const QVector<QPoint>& region, bool crossing)
+{
+    NCollection_Sequence<int> result;
+    if (view.IsNull() || region.size() < 3) {
+        return result;
+    }
+    
+    Standard_Integer width = 0, height = 0;
+    view->Window()->Size(width, height);
+    if (width <= 0 || height <= 0) {
+        return result;
+    }
+    
+    PixelRegion pixels;
+    pixels.xmin = pixels.ymin = 1e100;
+    pixels.xmax = pixels.ymax = -1e100;
+    for (const QPoint& p : region) {
+        pixels.polygon.append(QPointF(p));
+        pixels.xmin = std::min(pixels.xmin, double(p.x()));
+        pixels.xmax = std::max(pixels.xmax, double(p.x()));
+        pixels.ymin = std::min(pixels.ymin, double(p.y()));
+        pixels.ymax = std::max(pixels.ymax, double(p.y()));
+    }
+    pixels.rectangle = region.size() == 4
+        && ((region[0].x() == region[1].x() && region[1].y() == region[2].y()
+             && region[2].x() == region[3].x() && region[3].y() == region[0].y())
+         || (region[0].y() == region[1].y() && region[1].x() == region[2].x()
+             && region[2].y() == region[3].y() && region[3].x() == region[0].x()));
+    
+    Projector projector;
+    projector.camera = new Graphic3d_Camera(view->Camera());
+    projector.width = width;
+    projector.height = height;
+    
+    // Frustum through the region's bounding rectangle: four sides plus the near plane
+    gp_XYZ corners[8];
+    for (int i = 0; i < 8; ++i) {
+        const double px = (i & 1) ? pixels.xmax : pixels.xmin;
+        const double py = (i & 2) ? pixels.ymax : pixels.ymin;
+        const gp_Pnt ndc(2.0 * px / width - 1.0, 1.0 - 2.0 * py / height, (i & 4) ? 1.0 : -1.0);
+        corners[i] = projector.camera->UnProject(ndc).XYZ();
+    }
+    gp_XYZ centre(0.0, 0.0, 0.0);
+    for (const gp_XYZ& c : corners) {
+        centre += c / 8.0;
+    }
+    const int planes[5][3] = { { 0, 2, 4 }, { 1, 3, 5 }, { 0, 1, 4 }, { 2, 3, 6 }, { 0, 1, 2 } };
+    ObjectSpatialIndex::Frustum frustum;
+    for (const int* plane : planes) {
+        gp_XYZ normal = (corners[plane[1]] - corners[plane[0]]).Crossed(corners[plane[2]] - corners[plane[0]]);
+        if (normal.Modulus() < 1e-12) {
+            continue;   // Degenerate (zero-width) side
+        }
+        normal.Normalize();
+        if (normal.Dot(centre - corners[plane[0]]) < 0.0) {
+            normal.Reverse();
+        }
+        frustum.addPlane(normal, corners[plane[0]]);
+    }
+    
+    updateSpatialIndex();
+    std::vector<ObjectSpatialIndex::Hit> hits;
+    m_spatialIndex.query(frustum, hits);
+    
+    for (const ObjectSpatialIndex::Hit& candidate : hits) {
+        if (!m_objects.IsBound(candidate.id)) {
+            continue;
+        }
+        const Handle(TGraphicObject)& object = m_objects.Find(candidate.id);
+        if (!object->IsVisible()) {
+            continue;
+        }
+        
+        // A box inside the rectangle's frustum is inside the rectangle
+        bool hit = false;
+        if (candidate.inside && pixels.rectangle) {
+            hit = true;
+        } else if (m_meshInFlight.contains(candidate.id)
+                   || !testTriangulation(object->GetShape(), projector, pixels, crossing, hit)) {
+            double b[6];
+            object->GetBoundingBox(b[0], b[1], b[2], b[3], b[4], b[5]);
+            hit = testBox(b, projector, pixels, crossing);
+        }
+        if (hit) {
+            result.Append(candidate.id);
+        }
+    }
+    return result;
+}
+
+NCollection_Sequence<int> TObjectCollection::FindObjectsInBox(const double min[3], const double max[3])
+{
+    ObjectSpatialIndex::Frustum box;
+    for (int axis = 0; axis < 3; ++axis) {
+        gp_XYZ normal(0.0, 0.0, 0.0);
+        normal.SetCoord(axis + 1, 1.0);
+        box.addPlane(normal, gp_XYZ(min[0], min[1], min[2]));
+        box.addPlane(normal.Reversed(), gp_XYZ(max[0], max[1], max[2]));
+    }
+    
+    updateSpatialIndex();
+    std::vector<ObjectSpatialIndex::Hit> hits;
+    m_spatialIndex.query(box, hits);
+    
+    NCollection_Sequence<int> result;
+    for (const ObjectSpatialIndex::Hit& hit : hits) {
+        if (m_objects.IsBound(hit.id) && m_objects.Find(hit.id)->IsVisible()) {
+            result.Append(hit.id);
+        }
+    }
+    return result;
+}
+
+void TObjectCollection::updateSpatialIndex()
+{
+    if (!m_spatialIndexDirty) {
+        return;
+    }
+    m_spatialIndex.clear();
+    NCollection_DataMap<int, Handle(TGraphicObject)>::Iterator it(m_objects);
+    for (; it.More(); it.Next()) {
+        if (it.Value()->GetShape().IsNull()) {
+            continue;
+        }
+        double min[3], max[3];
+        it.Value()->GetBoundingBox(min[0], min[1], min[2], max[0], max[1], max[2]);
+        m_spatialIndex.add(it.Key(), min, max);
+    }
+    m_spatialIndex.build();
+    m_spatialIndexDirty = false;
+}
+
 void TObjectCollection::ShowObject(int objectID)
 {
     if (!m_objects.IsBound(objectID)) {
@@ -227,6 +712,12 @@ void TObjectCollection::ShowObject(int objectID)
     Handle(TGraphicObject) object = m_objects.Find(objectID);
     object->SetVisible(true);
     
+    if (m_meshProxies.contains(objectID)) {
+        // Still meshing - the real presentation appears in onMeshReady()
+        m_context->Display(m_meshProxies.value(objectID), Standard_False);
+        return;
+    }
+    
     Handle(AIS_Shape) aisShape = object->GetAISShape();
     if (!aisShape.IsNull() && !m_context.IsNull()) {
         m_context->Display(aisShape, Standard_False);
@@ -242,6 +733,10 @@ void TObjectCollection::HideObject(int objectID)
     Handle(TGraphicObject) object = m_objects.Find(objectID);
     object->SetVisible(false);
     
+    if (m_meshProxies.contains(objectID) && !m_context.IsNull()) {
+        m_context->Erase(m_meshProxies.value(objectID), Standard_False);
+    }
+    
     Handle(AIS_Shape) aisShape = object->GetAISShape();
     if (!aisShape.IsNull() && !m_context.IsNull()) {
         m_context->Erase(aisShape, Standard_False);
@@ -292,6 +787,115 @@ void TObjectCollection::CreateLayer(const QString& layer)
     }
 }
 
+TObjectCollection::DisplayQuality TObjectCollection::GetDisplayQuality(TGraphicObject::ObjectType type) const
+{
+    // OCCT defaults for types without their own settings
+    DisplayQuality fallback = { 0.001, 20.0 * M_PI / 180.0, false };
+    return m_displayQuality.value(type, fallback);
+}
+
+void TObjectCollection::SetDisplayQuality(TGraphicObject::ObjectType type, const DisplayQuality& quality)
+{
+    m_displayQuality[type] = quality;
+    
+    bool changed = false;
+    NCollection_DataMap<int, Handle(TGraphicObject)>::Iterator it(m_objects);
+    for (; it.More(); it.Next()) {
+        const Handle(TGraphicObject)& object = it.Value();
+        if (object->GetType() != type) {
+            continue;
+        }
+        if (!quality.levelOfDetail) {
+            object->SetDetailLevel(TGraphicObject::DETAIL_FULL);
+        }
+        applyDisplayQuality(object);
+        updateDisplay(object);
+        changed = true;
+    }
+    
+    if (changed && !m_context.IsNull()) {
+        m_context->UpdateCurrentViewer();
+    }
+}
+
+void TObjectCollection::SetDetailThresholds(double coarseBelowPixels, double fullAbovePixels)
+{
+    m_coarseBelowPixels = coarseBelowPixels;
+    m_fullAbovePixels = std::max(coarseBelowPixels, fullAbovePixels);
+}
+
+void TObjectCollection::GetDetailThresholds(double& coarseBelowPixels, double& fullAbovePixels) const
+{
+    coarseBelowPixels = m_coarseBelowPixels;
+    fullAbovePixels = m_fullAbovePixels;
+}
+
+int TObjectCollection::UpdateLevelOfDetail(const Handle(V3d_View)& view)
+{
+    if (view.IsNull() || m_context.IsNull()) {
+        return 0;
+    }
+    
+    int changed = 0;
+    NCollection_DataMap<int, Handle(TGraphicObject)>::Iterator it(m_objects);
+    for (; it.More(); it.Next()) {
+        const Handle(TGraphicObject)& object = it.Value();
+        if (!object->IsVisible() || !GetDisplayQuality(object->GetType()).levelOfDetail
+            || m_meshInFlight.contains(object->GetID())) {
+            continue;
+        }
+        
+        // Projected size: screen extent of the eight bounding box corners
+        double b[6];
+        object->GetBoundingBox(b[0], b[1], b[2], b[3], b[4], b[5]);
+        int xmin = INT_MAX, ymin = INT_MAX, xmax = INT_MIN, ymax = INT_MIN;
+        for (int corner = 0; corner < 8; ++corner) {
+            Standard_Integer px, py;
+            view->Convert(b[(corner & 1) ? 3 : 0], b[(corner & 2) ? 4 : 1], b[(corner & 4) ? 5 : 2], px, py);
+            xmin = std::min(xmin, px);
+            xmax = std::max(xmax, px);
+            ymin = std::min(ymin, py);
+            ymax = std::max(ymax, py);
+        }
+        double pixels = std::hypot(double(xmax - xmin), double(ymax - ymin));
+        
+        // Between the thresholds keep the current level so objects don't flicker
+        TGraphicObject::DetailLevel level = object->GetDetailLevel();
+        if (pixels < m_coarseBelowPixels) {
+            level = TGraphicObject::DETAIL_COARSE;
+        } else if (pixels > m_fullAbovePixels) {
+            level = TGraphicObject::DETAIL_FULL;
+        }
+        
+        if (object->SetDetailLevel(level)) {
+            updateDisplay(object);
+            changed++;
+        }
+    }
+    
+    if (changed > 0) {
+        m_context->UpdateCurrentViewer();
+    }
+    return changed;
+}
+
+void TObjectCollection::applyDisplayQuality(const Handle(TGraphicObject)& object)
+{
+    Handle(AIS_Shape) aisShape = object->GetAISShape();
+    if (aisShape.IsNull()) {
+        return;
+    }
+    DisplayQuality quality = GetDisplayQuality(object->GetType());
+    aisShape->SetOwnDeviationCoefficient(quality.deviationCoefficient);
+    aisShape->SetOwnDeviationAngle(quality.deviationAngle);
+    
+    // Drop a mesh made for the old settings now, so the presentation doesn't
+    // discard our background mesh and re-triangulate on the UI thread
+    if (!m_meshInFlight.contains(object->GetID())) {
+        StdPrs_ToolTriangulatedShape::ClearOnOwnDeflectionChange(object->GetShape(), aisShape->Attributes(), Standard_True);
+    }
+}
+
 void TObjectCollection::displayObject(const Handle(TGraphicObject)& object)
 {
     if (object.IsNull() || m_context.IsNull()) {
@@ -300,11 +904,22 @@ void TObjectCollection::displayObject(const Handle(TGraphicObject)& object)
     
     Handle(AIS_Shape) aisShape = object->GetAISShape();
     if (!aisShape.IsNull()) {
+        m_idByPresentation.insert(aisShape.get(), object->GetID());
+        applyDisplayQuality(object);
+        
         int r, g, b;
         object->GetColor(r, g, b);
         Quantity_Color color(r / 255.0, g / 255.0, b / 255.0, Quantity_TOC_RGB);
         m_context->SetColor(aisShape, color, Standard_False);
-        m_context->Display(aisShape, Standard_False);
+        
+        // Displaying an unmeshed shape would triangulate it on this thread
+        if (scheduleMesh(object)) {
+            showMeshProxy(object);
+            return;
+        }
+        if (object->IsVisible()) {
+            m_context->Display(aisShape, Standard_False);
+        }
     }
 }
 
@@ -314,8 +929,11 @@ void TObjectCollection::eraseObject(const Handle(TGraphicObject)& object)
         return;
     }
     
+    removeMeshProxy(object->GetID());
+    
     Handle(AIS_Shape) aisShape = object->GetAISShape();
     if (!aisShape.IsNull()) {
+        m_idByPresentation.remove(aisShape.get());
         m_context->Remove(aisShape, Standard_False);
     }
 }
@@ -326,24 +944,315 @@ void TObjectCollection::updateDisplay(const Handle(TGraphicObject)& object)
         return;
     }
     
+    m_spatialIndexDirty = true;
+    
     Handle(AIS_Shape) aisShape = object->GetAISShape();
     if (!aisShape.IsNull()) {
+        // A changed shape keeps its old presentation until the new mesh is in
+        if (scheduleMesh(object)) {
+            return;
+        }
         m_context->Redisplay(aisShape, Standard_False);
     }
 }
 
+void TObjectCollection::RefreshObject(int objectID)
+{
+    if (!m_objects.IsBound(objectID)) {
+        return;
+    }
+    updateDisplay(m_objects.Find(objectID));
+    scheduleViewerUpdate();
+}
+
+void TObjectCollection::RefreshObjects(const QList<int>& objectIDs)
+{
+    QList<int> refreshed;
+    for (int objectID : objectIDs) {
+        if (m_objects.IsBound(objectID)) {
+            updateDisplay(m_objects.Find(objectID));
+            refreshed.append(objectID);
+        }
+    }
+    if (refreshed.isEmpty()) {
+        return;
+    }
+    scheduleViewerUpdate();
+    emit objectsModified(refreshed);
+}
+
+QVector<PartNumbering::Group> TObjectCollection::NumberParts()
+{
+    QVector<PartNumbering::Group> groups = PartNumbering::assign(GetAllObjects());
+    LOG_INFO("collection", "Numbered %1 objects as %2 distinct parts", m_objects.Extent(), groups.size());
+    return groups;
+}
+
+bool TObjectCollection::scheduleMesh(const Handle(TGraphicObject)& object)
+{
+    const TopoDS_Shape& shape = object->GetShape();
+    Handle(AIS_Shape) aisShape = object->GetAISShape();
+    if (shape.IsNull() || aisShape.IsNull()) {
+        return false;
+    }
+    
+    int id = object->GetID();
+    if (m_meshInFlight.contains(id)) {
+        if (m_meshInFlight.value(id).IsSame(shape)) {
+            return true;    // Already queued - don't touch the shape while a worker may be writing it
+        }
+        releaseMesh(id);    // Rebuilt since; the old request still serves its copies
+    }
+    
+    // Warm the bounding box cache before a worker starts writing triangulations
+    double xmin, ymin, zmin, xmax, ymax, zmax;
+    object->GetBoundingBox(xmin, ymin, zmin, xmax, ymax, zmax);
+    
+    // Same deflection the shaded presentation will ask for, so it reuses our mesh
+    Handle(Prs3d_Drawer) drawer = aisShape->Attributes();
+    double deflection = StdPrs_ToolTriangulatedShape::GetDeflection(shape, drawer);
+    if (MeshScheduler::isMeshed(shape, deflection)) {
+        return false;
+    }
+    
+    // A copy of a shape still being meshed shares its faces - wait for that
+    // request instead of meshing the same TShape twice in parallel
+    auto waiters = m_meshWaiters.find(shape.TShape().get());
+    if (waiters != m_meshWaiters.end()) {
+        waiters->append(id);
+        m_meshInFlight.insert(id, shape);
+        emit meshingProgress(m_meshInFlight.size());
+        return true;
+    }
+    
+    // A part meshed in an earlier session takes its faces from the mesh cache
+    const quint64 cacheKey = meshCacheKey(object);
+    if (cacheKey != 0 && m_meshCache.attach(cacheKey, shape)
+        && MeshScheduler::isMeshed(shape, deflection)) {
+        return false;
+    }
+    
+    m_meshInFlight.insert(id, shape);
+    m_meshWaiters.insert(shape.TShape().get(), QVector<int>{ id });
+    m_meshScheduler->schedule(id, shape, deflection, drawer->DeviationAngle());
+    emit meshingProgress(m_meshInFlight.size());
+    return true;
+}
+
+quint64 TObjectCollection::meshCacheKey(const Handle(TGraphicObject)& object) const
+{
+    // Scaled or mirrored shapes no longer match the part their hash describes
+    Handle(AIS_Shape) aisShape = object->GetAISShape();
+    if (aisShape.IsNull() || !object->HasPartShape()) {
+        return 0;
+    }
+    const quint64 hash = object->GetGeometryHash();
+    
+    // Key on the quality settings rather than the resolved deflection, which
+    // follows each placement's bounding box; isMeshed() checks the result
+    Handle(Prs3d_Drawer) drawer = aisShape->Attributes();
+    const double deviation = drawer->TypeOfDeflection() == Aspect_TOD_RELATIVE
+        ? drawer->DeviationCoefficient() : drawer->MaximalChordialDeviation();
+    return MeshCache::key(hash, deviation, drawer->DeviationAngle());
+}
+
+void TObjectCollection::releaseMesh(int objectID)
+{
+    auto it = m_meshInFlight.find(objectID);
+    if (it == m_meshInFlight.end()) {
+        return;
+    }
+    auto waiters = m_meshWaiters.find(it.value().TShape().get());
+    if (waiters != m_meshWaiters.end()) {
+        waiters->removeOne(objectID);
+    }
+    m_meshInFlight.erase(it);
+    emit meshingProgress(m_meshInFlight.size());
+}
+
+void TObjectCollection::onMeshReady(int objectID, const TopoDS_Shape& shape)
+{
+    Q_UNUSED(objectID);
+    
+    // The mesh is on the TShape, so it serves every copy waiting on it,
+    // whether or not the object that asked for it still exists
+    auto waiters = m_meshWaiters.find(shape.TShape().get());
+    if (waiters == m_meshWaiters.end()) {
+        return;     // Requested before Clear()
+    }
+    const QVector<int> ready = waiters.value();
+    m_meshWaiters.erase(waiters);
+    for (int id : ready) {
+        m_meshInFlight.remove(id);
+    }
+    emit meshingProgress(m_meshInFlight.size());
+    
+    if (m_context.IsNull()) {
+        return;
+    }
+    for (int id : ready) {
+        if (!m_objects.IsBound(id)) {
+            continue;
+        }
+        Handle(TGraphicObject) object = m_objects.Find(id);
+        Handle(AIS_Shape) aisShape = object->GetAISShape();
+        if (aisShape.IsNull()) {
+            continue;
+        }
+        
+        if (m_meshProxies.contains(id)) {
+            removeMeshProxy(id);
+            if (object->IsVisible()) {
+                m_context->Display(aisShape, Standard_False);
+            }
+        } else {
+            m_context->Redisplay(aisShape, Standard_False);
+        }
+    }
+    scheduleViewerUpdate();
+}
+
+void TObjectCollection::showMeshProxy(const Handle(TGraphicObject)& object)
+{
+    int id = object->GetID();
+    removeMeshProxy(id);
+    
+    double xmin, ymin, zmin, xmax, ymax, zmax;
+    object->GetBoundingBox(xmin, ymin, zmin, xmax, ymax, zmax);
+    const double minSize = 1.0;
+    xmax = std::max(xmax, xmin + minSize);
+    ymax = std::max(ymax, ymin + minSize);
+    zmax = std::max(zmax, zmin + minSize);
+    
+    Handle(AIS_Shape) proxy = new AIS_Shape(
+        BRepPrimAPI_MakeBox(gp_Pnt(xmin, ymin, zmin), gp_Pnt(xmax, ymax, zmax)).Shape());
+    int r, g, b;
+    object->GetColor(r, g, b);
+    m_context->SetColor(proxy, Quantity_Color(r / 255.0, g / 255.0, b / 255.0, Quantity_TOC_RGB), Standard_False);
+    m_context->SetDisplayMode(proxy, AIS_WireFrame, Standard_False);
+    m_meshProxies.insert(id, proxy);
+    
+    if (object->IsVisible()) {
+        m_context->Display(proxy, Standard_False);
+        m_context->Deactivate(proxy);
+    }
+}
+
+void TObjectCollection::removeMeshProxy(int objectID)
+{
+    Handle(AIS_Shape) proxy = m_meshProxies.take(objectID);
+    if (!proxy.IsNull() && !m_context.IsNull()) {
+        m_context->Remove(proxy, Standard_False);
+    }
+}
+
+void TObjectCollection::scheduleViewerUpdate()
+{
+    // Mesh results arrive in bursts - repaint once per burst
+    if (m_viewerUpdatePending) {
+        return;
+    }
+    m_viewerUpdatePending = true;
+    QTimer::singleShot(30, this, [this]() {
+        m_viewerUpdatePending = false;
+        if (!m_context.IsNull()) {
+            m_context->UpdateCurrentViewer();
+        }
+    });
+}
+
 bool TObjectCollection::SaveToFile(const QString& filename)
 {
-    Q_UNUSED(filename);
-    // To be implemented
-    return false;
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        LOG_ERROR("model", "Cannot write %1", filename);
+        return false;
+    }
+    
+    QVector<int> ids;
+    ids.reserve(m_objects.Extent());
+    NCollection_DataMap<int, Handle(TGraphicObject)>::Iterator it(m_objects);
+    for (; it.More(); it.Next()) {
+        ids.append(it.Key());
+    }
+    std::sort(ids.begin(), ids.end());
+    
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    for (int id : ids) {
+        out << m_objects.Find(id)->Serialize() << '\n';
+    }
+    out.flush();
+    
+    // Shapes still meshing or never displayed keep their entry from the last save
+    QVector<MeshCache::Entry> meshes;
+    for (int id : ids) {
+        const Handle(TGraphicObject)& object = m_objects.Find(id);
+        const quint64 key = meshCacheKey(object);
+        if (key != 0) {
+            meshes.append({ key, m_meshInFlight.contains(id) ? TopoDS_Shape() : object->GetShape() });
+        }
+    }
+    m_meshCache.save(MeshCache::pathFor(filename), meshes);
+    
+    LOG_INFO("model", "Saved %1 objects to %2", ids.size(), filename);
+    return true;
 }
 
 bool TObjectCollection::LoadFromFile(const QString& filename)
 {
-    Q_UNUSED(filename);
-    // To be implemented
-    return false;
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        LOG_ERROR("model", "Cannot open %1", filename);
+        return false;
+    }
+    
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    QVector<Handle(TGraphicObject)> loaded;
+    int lineNumber = 0;
+    int records = 0;
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        ++records;
+        
+        Handle(TGraphicObject) object;
+        switch (TGraphicObject::ParseFields(line).value("Type").toInt()) {
+        case TGraphicObject::TYPE_BEAM:   object = new TBeam(); break;
+        case TGraphicObject::TYPE_COLUMN: object = new TColumn(); break;
+        case TGraphicObject::TYPE_SLAB:   object = new TSlab(); break;
+        default: break;
+        }
+        if (object.IsNull() || !object->Deserialize(line)) {
+            LOG_WARNING("model", "%1:%2: skipped unreadable object", filename, lineNumber);
+            continue;
+        }
+        loaded.append(object);
+    }
+    
+    // Clear first: it empties the GeometryCache, which the build below fills
+    // with the shared parts that later additions must reuse
+    Clear();
+    
+    // Members are independent and shared parts come from the locked
+    // GeometryCache, so the solids are built concurrently
+    OSD_Parallel::For(0, loaded.size(), [&loaded](int i) {
+        loaded.at(i)->BuildShape();
+    });
+    
+    m_meshCache.open(MeshCache::pathFor(filename));
+    NCollection_Sequence<Handle(TGraphicObject)> objects;
+    for (const Handle(TGraphicObject)& object : loaded) {
+        objects.Append(object);
+    }
+    int added = AddObjects(objects);
+    
+    LOG_INFO("model", "Loaded %1 of %2 objects from %3", added, records, filename);
+    return true;
 }
 
 NCollection_Sequence<Handle(TGraphicObject)> TObjectCollection::FindObjects(
@@ -574,11 +1483,31 @@ void TObjectCollection::DeleteLayer(const QString& layer)
     m_layers.removeAll(layer);
 }
 
-NCollection_Sequence<Handle(TGraphicObject)> TObjectCollection::CopyObjects(const NCollection_Sequence<int>& objectIDs)
+NCollection_Sequence<Handle(TGraphicObject)> TObjectCollection::CopyObjects(const NCollection_Sequence<int>& objectIDs,
+                                                                             const gp_Trsf& placement)
 {
-    Q_UNUSED(objectIDs);
-    // To be implemented - needs deep copy of objects
-    return NCollection_Sequence<Handle(TGraphicObject)>();
+    NCollection_Sequence<Handle(TGraphicObject)> copies;
+    for (int i = 1; i <= objectIDs.Length(); i++) {
+        int id = objectIDs.Value(i);
+        if (!m_objects.IsBound(id)) {
+            continue;
+        }
+        Handle(TGraphicObject) copy = m_objects.Find(id)->CreateCopy(placement);
+        if (!copy.IsNull()) {
+            copies.Append(copy);
+        }
+    }
+    return copies;
+}
+
+int TObjectCollection::ArrayObjects(const NCollection_Sequence<int>& objectIDs, const QVector<gp_Trsf>& placements)
+{
+    NCollection_Sequence<Handle(TGraphicObject)> copies;
+    for (const gp_Trsf& placement : placements) {
+        NCollection_Sequence<Handle(TGraphicObject)> batch = CopyObjects(objectIDs, placement);
+        copies.Append(batch);
+    }
+    return AddObjects(copies);
 }
 
 void TObjectCollection::ScaleObjects(const NCollection_Sequence<int>& objectIDs, const gp_Pnt& center, double factor)
@@ -1,7 +1,10 @@
 #include "TSlab.h"
+#include "GeometryHash.h"
+#include "Logger.h"
 #include <BRepPrimAPI_MakeBox.hxx>
 #include <gp_Trsf.hxx>
-#include <BRepBuilderAPI_Transform.hxx>
+#include <gp_Ax1.hxx>
+#include <algorithm>
 #include <cmath>
 
 IMPLEMENT_STANDARD_RTTIEXT(TSlab, TGraphicObject)
@@ -11,8 +14,8 @@ TSlab::TSlab()
     , m_corner1(0, 0, 0)
     , m_corner2(5000, 5000, 0)
     , m_thickness(200)
+    , m_rotation(0.0)
 {
-    SetName(QString("Slab_%1").arg(GetID()));
     SetLayer("Structure");
     SetMaterial("Concrete");
     SetColor(200, 200, 180); // Light gray for slabs
@@ -23,8 +26,8 @@ TSlab::TSlab(const gp_Pnt& corner1, const gp_Pnt& corner2, double thickness)
     , m_corner1(corner1)
     , m_corner2(corner2)
     , m_thickness(thickness)
+    , m_rotation(0.0)
 {
-    SetName(QString("Slab_%1").arg(GetID()));
     SetLayer("Structure");
     SetMaterial("Concrete");
     SetColor(200, 200, 180);
@@ -49,6 +52,24 @@ void TSlab::GetCorners(gp_Pnt& corner1, gp_Pnt& corner2) const
     corner2 = m_corner2;
 }
 
+void TSlab::SetRotation(double angle)
+{
+    m_rotation = angle;
+    BuildShape();
+    UpdateModificationTime();
+}
+
+void TSlab::GetPlanSize(double& dx, double& dy) const
+{
+    // Diagonal projected on the rotated sides
+    const double x = m_corner2.X() - m_corner1.X();
+    const double y = m_corner2.Y() - m_corner1.Y();
+    const double c = std::cos(m_rotation);
+    const double s = std::sin(m_rotation);
+    dx = std::abs(x * c + y * s);
+    dy = std::abs(y * c - x * s);
+}
+
 void TSlab::SetThickness(double thickness)
 {
     m_thickness = thickness;
@@ -58,29 +79,50 @@ void TSlab::SetThickness(double thickness)
 
 double TSlab::GetArea() const
 {
-    double dx = std::abs(m_corner2.X() - m_corner1.X());
-    double dy = std::abs(m_corner2.Y() - m_corner1.Y());
+    double dx, dy;
+    GetPlanSize(dx, dy);
     return dx * dy;
 }
 
-TopoDS_Shape TSlab::BuildShape()
+quint64 TSlab::GetGeometryHash() const
 {
-    // Calculate dimensions
-    double xmin = std::min(m_corner1.X(), m_corner2.X());
-    double ymin = std::min(m_corner1.Y(), m_corner2.Y());
-    double zmin = std::min(m_corner1.Z(), m_corner2.Z());
-    
-    double width = std::abs(m_corner2.X() - m_corner1.X());
-    double depth = std::abs(m_corner2.Y() - m_corner1.Y());
-    
-    // Create box
-    TopoDS_Shape box = BRepPrimAPI_MakeBox(width, depth, m_thickness).Shape();
+    double dx, dy;
+    GetPlanSize(dx, dy);
+    return GeometryHash().add(static_cast<int>(TYPE_SLAB))
+        .addLength(std::max(dx, dy))
+        .addLength(std::min(dx, dy))
+        .addLength(m_thickness)
+        .value();
+}
+
+TopoDS_Shape TSlab::BuildLocalShape() const
+{
+    // Centred in plan on the origin, bottom at Z=0, longer side along X
+    double dx, dy;
+    GetPlanSize(dx, dy);
+    const double a = std::max(dx, dy);
+    const double b = std::min(dx, dy);
+    return BRepPrimAPI_MakeBox(gp_Pnt(-a / 2, -b / 2, 0), a, b, m_thickness).Shape();
+}
+
+gp_Trsf TSlab::GetPlacement() const
+{
+    double dx, dy;
+    GetPlanSize(dx, dy);
     
-    // Translate to position
+    const double turn = dx < dy ? m_rotation + M_PI / 2 : m_rotation;
+    gp_Trsf placement;
+    placement.SetRotation(gp_Ax1(gp_Pnt(0, 0, 0), gp_Dir(0, 0, 1)), turn);
     gp_Trsf translation;
-    translation.SetTranslation(gp_Vec(xmin, ymin, zmin));
-    BRepBuilderAPI_Transform transformer(box, translation, Standard_False);
-    m_shape = transformer.Shape();
+    translation.SetTranslation(gp_Vec((m_corner1.X() + m_corner2.X()) / 2,
+                                      (m_corner1.Y() + m_corner2.Y()) / 2,
+                                      std::min(m_corner1.Z(), m_corner2.Z())));
+    return translation * placement;
+}
+
+TopoDS_Shape TSlab::BuildShape()
+{
+    m_shape = BuildPlacedShape();
     
     if (m_aisShape.IsNull()) {
         m_aisShape = new AIS_Shape(m_shape);
@@ -91,6 +133,18 @@ TopoDS_Shape TSlab::BuildShape()
     return m_shape;
 }
 
+double TSlab::GetVolume() const
+{
+    return GetArea() * m_thickness;
+}
+
+double TSlab::GetSurfaceArea() const
+{
+    double dx, dy;
+    GetPlanSize(dx, dy);
+    return 2.0 * (dx * dy + (dx + dy) * m_thickness);
+}
+
 Handle(AIS_Shape) TSlab::GetAISShape()
 {
     if (m_aisShape.IsNull() && !m_shape.IsNull()) {
@@ -99,17 +153,52 @@ Handle(AIS_Shape) TSlab::GetAISShape()
     return m_aisShape;
 }
 
+Handle(TGraphicObject) TSlab::CreateCopy(const gp_Trsf& placement) const
+{
+    // Slabs stay level: a placement that tilts them cannot be stored
+    double angle = 0.0;
+    if (!IsPlanPlacement(placement, angle)) {
+        LOG_WARNING("model", "Slab %1 was not copied: its copy would not be level", m_id);
+        return Handle(TGraphicObject)();
+    }
+    Handle(TSlab) copy = new TSlab();
+    copy->m_corner1 = m_corner1.Transformed(placement);
+    copy->m_corner2 = m_corner2.Transformed(placement);
+    copy->m_thickness = m_thickness;
+    copy->m_rotation = m_rotation + angle;
+    CopyCommonTo(copy, placement);
+    return copy;
+}
+
 QString TSlab::Serialize() const
 {
     QString data = TGraphicObject::Serialize();
     data += QString("Corner1X=%1;Corner1Y=%2;Corner1Z=%3;")
-            .arg(m_corner1.X()).arg(m_corner1.Y()).arg(m_corner1.Z());
+            .arg(m_corner1.X(), 0, 'g', 15).arg(m_corner1.Y(), 0, 'g', 15).arg(m_corner1.Z(), 0, 'g', 15);
     data += QString("Corner2X=%1;Corner2Y=%2;Corner2Z=%3;")
-            .arg(m_corner2.X()).arg(m_corner2.Y()).arg(m_corner2.Z());
-    data += QString("Thickness=%1;").arg(m_thickness);
+            .arg(m_corner2.X(), 0, 'g', 15).arg(m_corner2.Y(), 0, 'g', 15).arg(m_corner2.Z(), 0, 'g', 15);
+    data += QString("Thickness=%1;Rotation=%2;").arg(m_thickness, 0, 'g', 15).arg(m_rotation, 0, 'g', 15);
     return data;
 }
 
+bool TSlab::Deserialize(const QString& data)
+{
+    if (!TGraphicObject::Deserialize(data)) {
+        return false;
+    }
+    
+    const QHash<QString, QString> fields = ParseFields(data);
+    m_corner1.SetCoord(FieldValue(fields, "Corner1X", m_corner1.X()),
+                       FieldValue(fields, "Corner1Y", m_corner1.Y()),
+                       FieldValue(fields, "Corner1Z", m_corner1.Z()));
+    m_corner2.SetCoord(FieldValue(fields, "Corner2X", m_corner2.X()),
+                       FieldValue(fields, "Corner2Y", m_corner2.Y()),
+                       FieldValue(fields, "Corner2Z", m_corner2.Z()));
+    m_thickness = FieldValue(fields, "Thickness", m_thickness);
+    m_rotation = FieldValue(fields, "Rotation", 0.0);
+    return true;
+}
+
 bool TSlab::IsValid() const
 {
     if (!TGraphicObject::IsValid()) {
@@ -4,6 +4,7 @@
 #include <TopoDS_Face.hxx>
 #include <Quantity_Color.hxx>
 #include <Graphic3d_MaterialAspect.hxx>
+#include <ElSLib.hxx>
 
 WorkPlane::WorkPlane(PlaneType type)
     : m_type(type)
@@ -59,17 +60,12 @@ QString WorkPlane::getName() const
 
 void WorkPlane::setOffset(double offset)
 {
-    m_offset = offset;
-    
-    // Recreate plane with offset
-    gp_Pnt origin = m_plane.Location();
+    // Move the plane along its normal by the change in offset,
+    // keeping its axes so the grid stays aligned
     gp_Dir normal = m_plane.Axis().Direction();
+    m_plane.Translate(gp_Vec(normal).Multiplied(offset - m_offset));
     
-    // Move origin along normal by offset
-    origin.Translate(gp_Vec(normal).Multiplied(offset - m_offset));
-    
-    gp_Ax3 axis(origin, normal);
-    m_plane = gp_Pln(axis);
+    m_offset = offset;
 }
 
 Handle(AIS_Shape) WorkPlane::createVisual(double size) const
@@ -107,3 +103,17 @@ Handle(AIS_Shape) WorkPlane::createVisual(double size) const
     
     return aisShape;
 }
+
+bool WorkPlane::snapToGrid(const gp_Pnt& point, double tolerance,
+                           gp_Pnt& snapped, StructuralGrid::Snap& snap) const
+{
+    Standard_Real u, v;
+    ElSLib::Parameters(m_plane, point, u, v);
+    
+    snap = m_grid.snap(u, v, tolerance);
+    if (snap.kind == StructuralGrid::Snap::NONE) {
+        return false;
+    }
+    snapped = ElSLib::Value(snap.u, snap.v, m_plane);
+    return true;
+}
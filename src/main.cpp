@@ -1,9 +1,126 @@
 #include "MainWindow.h"
+#include "ProfileLibrary.h"
+#include "StepExporter.h"
+#include "IfcExporter.h"
+#include "GltfExporter.h"
+#include "TObjectCollection.h"
+#include "Logger.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
 #include <QSurfaceFormat>
 
+namespace {
+
+bool isBatchExport(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--export-step") == 0 || qstrcmp(argv[i], "--export-ifc") == 0
+            || qstrcmp(argv[i], "--export-glb") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void setApplicationInfo()
+{
+    QCoreApplication::setApplicationName("Tekla-Like CAD");
+    QCoreApplication::setApplicationVersion("1.0");
+    QCoreApplication::setOrganizationName("Structural CAD");
+}
+
+// Logging and the section catalogue, used by both the GUI and batch runs
+void startServices()
+{
+    // Log records are formatted and written on a background thread
+    Logger::instance().start(QCoreApplication::applicationDirPath() + "/cad.log");
+    
+    // Map the external section catalogue if one ships with the executable
+    QString catalogPath = ProfileLibrary::defaultCatalogPath();
+    if (QFile::exists(catalogPath)) {
+        ProfileLibrary::instance().open(catalogPath);
+    }
+}
+
+// TeklaLikeCAD <model> [--export-step <file>] [--export-ifc <file>] [--export-glb <file>]
+//              [--ap242] [--no-instancing] [--chunk-size <count>]
+int runBatchExport(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Writes a saved model to STEP, IFC or glTF without opening a window.");
+    parser.addHelpOption();
+    QCommandLineOption stepOption("export-step", "Write the model to <file> as STEP.", "file");
+    QCommandLineOption ifcOption("export-ifc", "Write the model to <file> as IFC4.", "file");
+    QCommandLineOption glbOption("export-glb", "Write the model to <file> as binary glTF.", "file");
+    QCommandLineOption ap242Option("ap242", "Use the AP242 schema instead of AP214.");
+    QCommandLineOption flatOption("no-instancing", "Write every member as a part of its own.");
+    QCommandLineOption chunkOption("chunk-size", "IFC members per relationship batch.", "count", "1000");
+    parser.addOptions({ stepOption, ifcOption, glbOption, ap242Option, flatOption, chunkOption });
+    parser.addPositionalArgument("model", "Model file saved by the application.");
+    parser.process(arguments);
+    
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    Handle(AIS_InteractiveContext) noViewer;
+    TObjectCollection collection(noViewer);
+    if (!collection.LoadFromFile(parser.positionalArguments().first())) {
+        return 1;
+    }
+    
+    const NCollection_Sequence<Handle(TGraphicObject)> objects = collection.GetAllObjects();
+    const int chunkSize = parser.value(chunkOption).toInt();
+    
+    if (parser.isSet(stepOption)) {
+        StepExporter::Options options;
+        options.schema = parser.isSet(ap242Option) ? StepExporter::AP242 : StepExporter::AP214;
+        options.instancing = !parser.isSet(flatOption);
+        
+        StepExporter exporter(options);
+        if (!exporter.exportObjects(objects, parser.value(stepOption))) {
+            return 1;
+        }
+    }
+    
+    if (parser.isSet(ifcOption)) {
+        IfcExporter::Options options;
+        options.chunkSize = chunkSize;
+        
+        IfcExporter exporter(options);
+        if (!exporter.exportObjects(objects, parser.value(ifcOption))) {
+            return 1;
+        }
+    }
+    
+    if (parser.isSet(glbOption)) {
+        GltfExporter exporter;
+        if (!exporter.exportObjects(objects, parser.value(glbOption))) {
+            return 1;
+        }
+    }
+    LOG_INFO("export", "Batch export finished in %1 ms", timer.elapsed());
+    return 0;
+}
+
+} // namespace
+
 int main(int argc, char *argv[])
 {
+    // Batch export needs no display
+    if (isBatchExport(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        setApplicationInfo();
+        startServices();
+        int result = runBatchExport(app.arguments());
+        Logger::instance().stop();
+        return result;
+    }
+    
     // Set OpenGL format for better compatibility
     QSurfaceFormat format;
     format.setDepthBufferSize(24);
@@ -14,14 +131,14 @@ int main(int argc, char *argv[])
 
     QApplication app(argc, argv);
     
-    // Set application information
-    app.setApplicationName("Tekla-Like CAD");
-    app.setApplicationVersion("1.0");
-    app.setOrganizationName("Structural CAD");
+    setApplicationInfo();
+    startServices();
 
     // Create and show main window
     MainWindow mainWindow;
     mainWindow.show();
 
-    return app.exec();
+    int result = app.exec();
+    Logger::instance().stop();
+    return result;
 }